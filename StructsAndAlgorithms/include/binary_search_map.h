@@ -0,0 +1,150 @@
+#pragma once
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <common.h>
+#include <struct_exception.h>
+#include <binary_search_tree.h>
+
+//This namespace contains implementation details
+namespace map_impl
+{
+	//Comparers that can't compare other types with the key only take the key, so the tree converts other types to the key once per search
+	template<typename Key, bool transparent>
+	struct lookup_as
+	{
+		using lookup_type = Key;
+	};
+
+	template<typename Key>
+	struct lookup_as<Key, true> {};
+
+	//Orders the key-value pairs of a map by their keys. It is transparent, so the map can be searched with a key instead of a whole pair
+	template<typename Key, typename Value, typename Comparer>
+	struct key_comparer : lookup_as<Key, sorting_impl::is_transparent<Comparer>::value>
+	{
+		using is_transparent = void;
+		using pair_type = std::pair<Key, Value>;
+
+		Comparer comparer;
+
+		key_comparer() : comparer(sorting_impl::make_default_comparer<Comparer, Key>()) {}
+
+		key_comparer(Comparer&& comp) : comparer(std::move(comp)) {}
+
+		bool operator()(const pair_type& lhs, const pair_type& rhs) const
+		{
+			return comparer(lhs.first, rhs.first);
+		}
+
+		template<typename K>
+		bool operator()(const K& lhs, const pair_type& rhs) const
+		{
+			return comparer(lhs, rhs.first);
+		}
+
+		template<typename K>
+		bool operator()(const pair_type& lhs, const K& rhs) const
+		{
+			return comparer(lhs.first, rhs);
+		}
+	};
+}
+
+//A sorted map of unique keys to values, stored as key-value pairs in a binary_search_tree. Every function of the tree can be used with a key in place of a pair,
+//such as find(), remove(), contains(), lower_bound() and equal_range(). The keys of the pairs must not be changed through the tree.
+//If the comparer is transparent, like std::less<>, then the map can be searched with any type the comparer can order against the key (such as a string_view for string keys),
+//without building a key. Otherwise, other types are converted to the key once per search
+template<typename Key, typename Value, typename Comparer = std::function<bool(const Key&, const Key&)>, typename Allocator = std::allocator<std::pair<Key, Value>>>
+class binary_search_map : public binary_search_tree<std::pair<Key, Value>, map_impl::key_comparer<Key, Value, Comparer>, Allocator>
+{
+	using base = binary_search_tree<std::pair<Key, Value>, map_impl::key_comparer<Key, Value, Comparer>, Allocator>;
+
+public:
+	using iterator = typename base::iterator;
+	using const_iterator = typename base::const_iterator;
+
+	//Default constructor for a binary search map
+	binary_search_map() : base() {}
+
+	binary_search_map(Comparer&& comp) : base(map_impl::key_comparer<Key, Value, Comparer>(std::move(comp))) {}
+
+	binary_search_map(Comparer&& comp, const Allocator& alloc) : base(map_impl::key_comparer<Key, Value, Comparer>(std::move(comp)), alloc) {}
+
+	//Inserts a key-value pair. Returns end() if the key is already in the map
+	iterator insert(const std::pair<Key, Value>& pair)
+	{
+		return base::insert(pair);
+	}
+
+	iterator insert(std::pair<Key, Value>&& pair)
+	{
+		return base::insert(std::move(pair));
+	}
+
+	//Inserts a key with a value. Returns end() if the key is already in the map, in which case its value is left unchanged
+	template<typename K, typename V>
+	iterator insert(K&& key, V&& value)
+	{
+		std::pair<iterator, bool> result = try_emplace(std::forward<K>(key), std::forward<V>(value));
+		return result.second ? result.first : this->end();
+	}
+
+	//Inserts a key with a value built from "args", but only if the key is not in the map yet. The map is searched once, and nothing is built if the key is already there.
+	//Returns an iterator to the pair with the key, and true if it was inserted. A key passed as an rvalue is moved into the pair, since the search is finished by then
+	template<typename K, typename... Args>
+	std::pair<iterator, bool> try_emplace(K&& key, Args&&... args)
+	{
+		return base::try_emplace(key, std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)), std::forward_as_tuple(std::forward<Args>(args)...));
+	}
+
+	//Gets the value of a key. If the key is not in the map, then it is inserted with a default constructed value first. The map is only searched once
+	template<typename K>
+	Value& operator[](K&& key)
+	{
+		return base::valueOf(try_emplace(std::forward<K>(key)).first).second;
+	}
+
+	//Gets the value of a key. Throws a struct_exception if the key is not in the map
+	template<typename K>
+	Value& at(const K& key)
+	{
+		iterator found = this->find(key);
+		if (found == this->end())
+		{
+			throw struct_exception("The key is not in the map");
+		}
+		return base::valueOf(found).second;
+	}
+
+	//Gets the value of a key. Throws a struct_exception if the key is not in the map
+	template<typename K>
+	const Value& at(const K& key) const
+	{
+		const_iterator found = this->find(key);
+		if (found == this->end())
+		{
+			throw struct_exception("The key is not in the map");
+		}
+		return found->second;
+	}
+};
+
+//Used for printing the map to a stream
+template<typename Key, typename Value, typename Comparer, typename Allocator>
+std::ostream& operator<<(std::ostream& stream, const binary_search_map<Key, Value, Comparer, Allocator>& map)
+{
+	stream << "[";
+	for (auto i = map.begin(); i != map.end(); ++i)
+	{
+		if (i != map.begin())
+		{
+			stream << ", ";
+		}
+		stream << i->first << ": " << i->second;
+	}
+	return stream << "]";
+}
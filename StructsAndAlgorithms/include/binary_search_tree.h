@@ -8,39 +8,270 @@
 #include <struct_exception.h>
 #include <common.h>
 #include <functional>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <pool_allocator.h>
+#include <frozen_search_tree.h>
+#include <parallel_algorithms.h>
+
+//An augmentation stores extra information in every node of a binary_search_tree, which is worked out from the node's children.
+//"node_data" is added to every node, and "update(node)" is called when a node is created and whenever the children or the value of a node change, starting from the lowest node.
+//This augmentation stores nothing, so the tree doesn't do any extra work
+struct bst_no_augmentation
+{
+    template<typename T>
+    struct node_data {};
+
+    template<typename Node>
+    static void update(Node*) {}
+};
+
+//Stores how many nodes are in the subtree of every node. This lets the tree find the value at an index, and count values, in O(log n) time
+struct bst_order_statistics
+{
+    template<typename T>
+    struct node_data
+    {
+        int subtreeSize = 1; //How many nodes are in the subtree, including the node itself
+    };
+
+    template<typename Node>
+    static void update(Node* node)
+    {
+        node->subtreeSize = 1 + (node->leftChild != nullptr ? node->leftChild->subtreeSize : 0) + (node->rightChild != nullptr ? node->rightChild->subtreeSize : 0);
+    }
+};
+
+//A balancing policy decides how a binary_search_tree keeps itself balanced. "node_data" is added to every node to store what the policy needs.
+//This policy balances the tree as an AVL tree, where the heights of the two subtrees of every node differ by at most one. This keeps searches as fast as possible,
+//but an insert or remove can update the height of every node above it, and a remove can rotate at every level on the way up
+struct bst_avl_balancing
+{
+    struct node_data
+    {
+        int height = 1; //The height of the node from the bottom of the tree. For example, the lowest node has a height of 1, its parent has a height of 2, it's grand-parent has a height of 3, and so on
+    };
+};
+
+//This policy balances the tree as a red-black tree. An insert does at most two rotations and a remove at most three, and the recoloring on the way up is O(1) amortized,
+//so it is faster for trees that change often. The tree can be up to twice as tall as a perfectly balanced one, so searches can be a little slower than with AVL
+struct bst_red_black_balancing
+{
+    struct node_data
+    {
+        bool red = true; //The color of the node. New nodes are red. The root is black, a red node never has a red child, and every path down to a leaf passes through the same number of black nodes
+    };
+};
+
+//A duplicates policy decides what a binary_search_tree does with values that are equal to a value already in the tree. "node_data" is added to every node.
+//With this policy, every value in the tree is unique, and inserting a duplicate does nothing
+struct bst_unique_keys
+{
+    struct node_data {};
+};
+
+//Turns the tree into a multiset. Equal values share a single node that counts how many times the value was inserted, so memory and time grow with the number
+//of distinct values instead of the number of values. The node keeps the first value that was inserted, so values that are equal but not identical are not kept apart.
+//Iterating visits each distinct value once, and the iterator's getCount() says how many times it was inserted. select(), rank(), count_range() and advance() count distinct values
+struct bst_counted_keys
+{
+    struct node_data
+    {
+        int count = 1; //How many times the value of the node is in the tree
+    };
+};
+
+//This namespace contains implementation details
+namespace bst_impl
+{
+    //Checks if the nodes of a tree store the size of their subtree
+    template<typename Node, typename = void>
+    struct has_subtree_size : std::false_type {};
 
-//An AVL Binary Search Tree that stores a list of items in the form a tree. It's AVL, meaning, it can automatically balance itself to provide the best performance possible
-template<typename T, typename Comparer = std::function<bool(const T&,const T&)>>
+    template<typename Node>
+    struct has_subtree_size<Node, decltype(void(std::declval<Node&>().subtreeSize))> : std::true_type {};
+
+    //Checks if an iterator knows how many times its value is in a tree, which is true for the iterators of binary_search_tree
+    template<typename Iterator, typename = void>
+    struct has_get_count : std::false_type {};
+
+    template<typename Iterator>
+    struct has_get_count<Iterator, decltype(void(std::declval<const Iterator&>().getCount()))> : std::true_type {};
+}
+
+//A self-balancing Binary Search Tree that stores a list of items in the form a tree. By default it's AVL, meaning, it can automatically balance itself to provide the best performance possible
+//The nodes are created with the allocator. Using pool_allocator keeps the nodes close together in memory and lets clear() free them all at once
+//The augmentation decides what extra information is kept in each node. Using bst_order_statistics enables select(), rank(), count_range() and iterator advance()
+//The balancing policy decides how the tree is balanced. bst_red_black_balancing does fewer rotations than the default bst_avl_balancing, which suits trees with many inserts and removes
+//The duplicates policy decides what happens when a value is inserted twice. bst_counted_keys turns the tree into a multiset that keeps a count in each node
+//If the comparer is transparent (it has an "is_transparent" type, like std::less<>), then find(), remove(), count(), contains() and the bound functions take any value the comparer can order, without building a T
+template<typename T, typename Comparer = std::function<bool(const T&,const T&)>, typename Allocator = std::allocator<T>, typename Augmentation = bst_no_augmentation, typename Balancing = bst_avl_balancing, typename Duplicates = bst_unique_keys>
 class binary_search_tree
 {
     //Represents a node in the tree. Each node can have a parent node, and two child nodes.
-    struct node
+    struct node : Augmentation::template node_data<T>, Balancing::node_data, Duplicates::node_data
     {
         T data; //The data that this node contains
         node* parent; //The parent of this node. If the node doesn't have a parent, then this is nullptr
         node* leftChild; //The left child of the node. The left child's data is guaranteed to be less than the data of its parent. If the node doesn't have a left child, then this is nullptr
         node* rightChild; //The right child of the node. The right child's data is guaranteed to be greater than the data of its parent. If the node doesn't have a right child, then this is nullptr
-        int height = 1; //The height of the node from the bottom of the tree. For example, the lowest node has a height of 1, its parent has a height of 2, it's grand-parent has a height of 3, and so on
 
         //Constructs a node by copying the data into the data field
         node(const T& data, node* parent, node* leftChild, node* rightChild) :
             data(data),
             parent(parent),
             leftChild(leftChild),
-            rightChild(rightChild) {}
+            rightChild(rightChild)
+        {
+            Augmentation::update(this);
+        }
 
         //Constructs a node by moving the data into the data field
         node(T&& data, node* parent, node* leftChild, node* rightChild) :
             data(std::move(data)),
             parent(parent),
             leftChild(leftChild),
-            rightChild(rightChild) {}
+            rightChild(rightChild)
+        {
+            Augmentation::update(this);
+        }
+
+        //Constructs a node by building the data in place from "args"
+        template<typename... Args>
+        node(std::in_place_t, node* parent, Args&&... args) :
+            data(std::forward<Args>(args)...),
+            parent(parent),
+            leftChild(nullptr),
+            rightChild(nullptr)
+        {
+            Augmentation::update(this);
+        }
     };
 
+    //The allocator type used for creating nodes
+    using node_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<node>;
+    using node_traits = std::allocator_traits<node_allocator>;
+
     node* root = nullptr; //Represents the top most node in the tree. If this node is null, then the tree is empty.
     int treeSize = 0; //Represents how many nodes are in the tree.
+    int valueCount = 0; //How many values are in the tree, counting every duplicate. Only used with bst_counted_keys, since it is the same as treeSize otherwise
     bool selfBalancing = true; //Whether the tree is self-balancing or not
     Comparer comparer;
+    node_allocator allocator; //Used for creating and deleting the nodes of the tree
+
+    //Whether the nodes store the size of their subtrees
+    static constexpr bool OrderStatistics = bst_impl::has_subtree_size<node>::value;
+    //Whether the tree is balanced as a red-black tree instead of an AVL tree
+    static constexpr bool RedBlack = std::is_same<Balancing, bst_red_black_balancing>::value;
+    //Whether equal values are counted in a single node instead of being rejected
+    static constexpr bool Counted = std::is_same<Duplicates, bst_counted_keys>::value;
+
+    //Gets the value to search the tree with. With a transparent comparer, a value of any type the comparer can order is used as it is, without building a T
+    template<typename DataType>
+    static decltype(auto) lookupKey(const DataType& data)
+    {
+        return sorting_impl::lookup_key<Comparer, T>(data);
+    }
+
+    //Updates the augmentation data of a single node from its children
+    static void augment(node* x)
+    {
+        if constexpr (!std::is_same<Augmentation, bst_no_augmentation>::value)
+        {
+            Augmentation::update(x);
+        }
+    }
+
+    //Updates the augmentation data of a node and every node above it. Used after a node has been added or removed below "x"
+    static void augmentToRoot(node* x)
+    {
+        if constexpr (!std::is_same<Augmentation, bst_no_augmentation>::value)
+        {
+            for (; x != nullptr; x = x->parent)
+            {
+                Augmentation::update(x);
+            }
+        }
+    }
+
+    //Gets how many nodes are in a subtree. Only available with bst_order_statistics
+    static int getSubtreeSize(const node* subTree)
+    {
+        return subTree != nullptr ? subTree->subtreeSize : 0;
+    }
+
+    //Finds the node at an index within a subtree, where index 0 is the smallest value. Returns nullptr if the index is out of range.
+    //The template parameter is to allow both const and non-const nodes
+    template<typename NodeType>
+    static NodeType* selectNode(NodeType* subTree, int index)
+    {
+        while (subTree != nullptr)
+        {
+            int leftSize = getSubtreeSize(subTree->leftChild);
+            //If the index is in the left subtree, then go left
+            if (index < leftSize)
+            {
+                subTree = subTree->leftChild;
+            }
+            //If the index is past the left subtree and the node, then go right and skip over them
+            else if (index > leftSize)
+            {
+                index -= leftSize + 1;
+                subTree = subTree->rightChild;
+            }
+            else
+            {
+                return subTree;
+            }
+        }
+        return nullptr;
+    }
+
+    //Gets the index of a node in the tree, where index 0 is the smallest value. A nullptr node is the end of the tree
+    int indexOf(const node* x) const
+    {
+        if (x == nullptr)
+        {
+            return treeSize;
+        }
+        //Every node in the left subtree comes before the node
+        int index = getSubtreeSize(x->leftChild);
+        //Every time we go up from a right child, the parent and its left subtree also come before the node
+        while (x->parent != nullptr)
+        {
+            if (x->parent->rightChild == x)
+            {
+                index += getSubtreeSize(x->parent->leftChild) + 1;
+            }
+            x = x->parent;
+        }
+        return index;
+    }
+
+    //Allocates and constructs a new node. If the constructor throws, the memory is freed again
+    template<typename... Args>
+    node* createNode(Args&&... args)
+    {
+        node* newNode = node_traits::allocate(allocator, 1);
+        try
+        {
+            node_traits::construct(allocator, newNode, std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            node_traits::deallocate(allocator, newNode, 1);
+            throw;
+        }
+        return newNode;
+    }
+
+    //Destroys a node and frees its memory
+    void destroyNode(node* oldNode)
+    {
+        node_traits::destroy(allocator, oldNode);
+        node_traits::deallocate(allocator, oldNode, 1);
+    }
 
     //Updates the height values of a node and recursively update the heights of its parents
     void UpdateHeights(node* node)
@@ -149,14 +380,16 @@ class binary_search_tree
                 {
                     //Increase the tree size
                     treeSize++;
+                    if constexpr (Counted)
+                    {
+                        valueCount++;
+                    }
                     //Create the new node
-                    node* newNode = new node(std::forward<DataType>(data), parent, nullptr, nullptr);
+                    node* newNode = createNode(std::forward<DataType>(data), parent, nullptr, nullptr);
                     //Set the new node to be a left child of the parent
                     parent->leftChild = newNode;
-                    //Update the height value of the parent. This is only run when selfBalancing is enabled
-                    UpdateHeights(parent);
-                    //Rebalance the tree if necessary. This is only run when selfBalancing is enabled
-                    balance(newNode);
+                    //Rebalance the tree if necessary and update the augmentation data of the nodes above. Rebalancing is only run when selfBalancing is enabled
+                    balanceInserted(newNode);
                     //Return the new node
                     return newNode;
                 }
@@ -174,14 +407,16 @@ class binary_search_tree
                 {
                     //Increase the tree size
                     treeSize++;
+                    if constexpr (Counted)
+                    {
+                        valueCount++;
+                    }
                     //Create the new node
-                    node* newNode = new node(std::forward<DataType>(data), parent, nullptr, nullptr);
+                    node* newNode = createNode(std::forward<DataType>(data), parent, nullptr, nullptr);
                     //Set the new node to be a right child of the parent
                     parent->rightChild = newNode;
-                    //Update the height value of the parent. This is only run when selfBalancing is enabled
-                    UpdateHeights(parent);
-                    //Rebalance the tree if necessary. This is only run when selfBalancing is enabled
-                    balance(newNode);
+                    //Rebalance the tree if necessary and update the augmentation data of the nodes above. Rebalancing is only run when selfBalancing is enabled
+                    balanceInserted(newNode);
                     //Return the new node
                     return newNode;
                 }
@@ -191,9 +426,15 @@ class binary_search_tree
                     parent = parent->rightChild;
                 }
             }
-            //If the data is equal to the parent, then we can't insert or else the tree structure is damaged
+            //If the data is equal to the parent, then we can't insert or else the tree structure is damaged. A multiset counts the value in the existing node instead
             else
             {
+                if constexpr (Counted)
+                {
+                    parent->count++;
+                    valueCount++;
+                    return parent;
+                }
                 return nullptr;
             }
         }
@@ -231,26 +472,70 @@ class binary_search_tree
     template<typename DataType>
     const node* find(DataType&& dataToFind, const node* subtree) const
     {
-        //If the subtree is null, then return null
-        if (subtree == nullptr)
-        {
-            return nullptr;
-        }
-        //If the data of the subtree is equal to the data we are looking for, then return the subtree node
-        if (subtree->data == dataToFind)
+        while (subtree != nullptr)
         {
-            return subtree;
+            //If the data is less than the subtree node, then try to find the data in the left child subtree
+            if (comparer(dataToFind, subtree->data))
+            {
+                subtree = subtree->leftChild;
+            }
+            //If the data is greater than the subtree node, then try to find the data in the right child subtree
+            else if (comparer(subtree->data, dataToFind))
+            {
+                subtree = subtree->rightChild;
+            }
+            //Otherwise the data of the subtree is equal to the data we are looking for
+            else
+            {
+                return subtree;
+            }
         }
-        //If the data is less than the subtree node, then try to find the data in the left child subtree
-        if (comparer(dataToFind, subtree->data))
+        return nullptr;
+    }
+
+    //Finds the first node whose value is not less than "data", or nullptr if every value is less.
+    //If "inclusive" is false, then the first node whose value is greater than "data" is found instead. The template parameter is to allow both const and non-const nodes
+    template<typename NodeType, typename DataType>
+    NodeType* boundNode(NodeType* current, const DataType& data, bool inclusive) const
+    {
+        NodeType* result = nullptr;
+        while (current != nullptr)
         {
-            return find(std::forward<DataType>(dataToFind), subtree->leftChild);
+            //If the node comes after "data", then it is a candidate, and anything closer is in its left subtree
+            if (inclusive ? !comparer(current->data, data) : comparer(data, current->data))
+            {
+                result = current;
+                current = current->leftChild;
+            }
+            //Otherwise, the node and its left subtree all come before "data"
+            else
+            {
+                current = current->rightChild;
+            }
         }
-        //If the data is greater than the subtree node, then try to find the data in the right child subtree
-        else
+        return result;
+    }
+
+    //Finds the last node whose value is not greater than "data", or nullptr if every value is greater. The template parameter is to allow both const and non-const nodes
+    template<typename NodeType, typename DataType>
+    NodeType* floorNode(NodeType* current, const DataType& data) const
+    {
+        NodeType* result = nullptr;
+        while (current != nullptr)
         {
-            return find(std::forward<DataType>(dataToFind), subtree->rightChild);
+            //If "data" is less than the node, then the node and its right subtree are all too large
+            if (comparer(data, current->data))
+            {
+                current = current->leftChild;
+            }
+            //Otherwise the node is a candidate, and anything closer is in its right subtree
+            else
+            {
+                result = current;
+                current = current->rightChild;
+            }
         }
+        return result;
     }
 
     //Deletes a node from the tree. Returns true if a node has been deleted
@@ -268,6 +553,7 @@ class binary_search_tree
             auto mininumNode = minimum(node->rightChild);
             //Swap the values of the smallest value and the node we are deleting
             std::swap(node->data, mininumNode->data);
+            swapCounts(node, mininumNode);
             //Delete the smallest value node
             return remove(mininumNode);
         }
@@ -300,7 +586,7 @@ class binary_search_tree
                 root = nullptr;
             }
             //Delete the node
-            delete node;
+            destroyNode(node);
             //Decrease the tree size
             treeSize--;
             return true;
@@ -345,7 +631,7 @@ class binary_search_tree
                 root = child;
             }
             //Delete the node
-            delete node;
+            destroyNode(node);
             //Decrease the tree size
             treeSize--;
             return true;
@@ -516,11 +802,16 @@ class binary_search_tree
         {
             root = y;
         }
-        //Update the height of x
-        UpdateHeights(x);
+        //Update the heights of x and y. Red-black trees don't store heights
+        if constexpr (!RedBlack)
+        {
+            UpdateHeights(x);
+            UpdateHeights(y);
+        }
 
-        //Update the height of y
-        UpdateHeights(y);
+        //"x" is now below "y", so its augmentation data is updated first
+        augment(x);
+        augment(y);
     }
 
     //Rotates a series of nodes to the right. Used for rebalancing.
@@ -586,249 +877,1167 @@ class binary_search_tree
             root = x;
         }
 
-        //Update the height of y
-        UpdateHeights(y);
+        //Update the heights of y and x. Red-black trees don't store heights
+        if constexpr (!RedBlack)
+        {
+            UpdateHeights(y);
+            UpdateHeights(x);
+        }
 
-        //Update the height of x
-        UpdateHeights(x);
+        //"y" is now below "x", so its augmentation data is updated first
+        augment(y);
+        augment(x);
     }
 
-    //Used to balance a tree by applying node rotations when necessary
+    //Used to balance a tree by applying node rotations when necessary. This is called on the node that was inserted, or on the parent of the node that was removed.
+    //Only the nodes between "x" and the root can have become unbalanced, so they are walked from the bottom up, and each one is fixed with one or two rotations.
+    //The augmentation data of those nodes is updated during the same walk
     void balance(node* x)
     {
-        //If self-balancing is disabled, then there is nothing to do
+        //If self-balancing is disabled, then only the augmentation data needs to be updated
         if (!selfBalancing)
         {
+            augmentToRoot(x);
             return;
         }
-        //If the tree is empty, then no balancing is needed
-        if (root == nullptr)
-        {
-            return;
-        }
-
-        //Start at the root node and work our way down to node "x"
-        node* currentNode = root;
 
-        //Loop until we reach node "x" or until there are no more nodes left
-        while (currentNode != x && currentNode != nullptr)
+        while (x != nullptr)
         {
-            //Get how balance the current node is
-            int balance = getSubtreeBalance(currentNode);
-            //If the node is left-heavy, the node has a left child and the "x" node is a left child within the left subtree
-            if (balance > 1 && currentNode->leftChild != nullptr && comparer(x->data, currentNode->leftChild->data))
+            //Work out the height of the node from its children. A rotation further down can leave it out of date
+            int leftHeight = x->leftChild != nullptr ? x->leftChild->height : 0;
+            int rightHeight = x->rightChild != nullptr ? x->rightChild->height : 0;
+            x->height = (leftHeight > rightHeight ? leftHeight : rightHeight) + 1;
+            augment(x);
+
+            //Get how balanced the current node is
+            int balance = leftHeight - rightHeight;
+            //If the node is left-heavy
+            if (balance > 1)
             {
-                //Do a right rotation
-                rightRotation(currentNode);
-            }
-            //If the node is right-heavy, the node has a right child and the "x" node is a right child within the left subtree
-            else if (balance < -1 && currentNode->rightChild != nullptr && comparer(x->data, currentNode->rightChild->data))
-            {
-                //Do a right rotation
-                leftRotation(currentNode);
-            }
-            //If the node is left-heavy, the node has a left child and the "x" node is a right child within the left subtree
-            else if (balance > 1 && currentNode->leftChild != nullptr && comparer(x->data, currentNode->leftChild->data))
-            {
-                //Do a left rotation on the left child
-                leftRotation(currentNode->leftChild);
+                //If the left child is right-heavy, then do a left rotation on the left child first
+                if (getSubtreeBalance(x->leftChild) < 0)
+                {
+                    leftRotation(x->leftChild);
+                }
                 //Do a right rotation on the current node
-                rightRotation(currentNode);
+                rightRotation(x);
             }
-            //If the node is right-heavy, the node has a right child and the "x" node is a left child within the left subtree
-            else if (balance < -1 && currentNode->rightChild != nullptr && comparer(x->data, currentNode->rightChild->data))
+            //If the node is right-heavy
+            else if (balance < -1)
             {
-                //Do a right rotation on the right child
-                rightRotation(currentNode->rightChild);
+                //If the right child is left-heavy, then do a right rotation on the right child first
+                if (getSubtreeBalance(x->rightChild) > 0)
+                {
+                    rightRotation(x->rightChild);
+                }
                 //Do a left rotation on the current node
-                leftRotation(currentNode);
-            }
-            //If the "x" node is somewhere in the left subtree
-            if (comparer(x->data, currentNode->data))
-            {
-                //Go to the left child
-                currentNode = currentNode->leftChild;
-            }
-            //If the "x" node is somewhere in the right subtree
-            else
-            {
-                //Go to the right child
-                currentNode = currentNode->rightChild;
+                leftRotation(x);
             }
+            //Go up to the parent. After a rotation, the parent is the node that took the place of "x"
+            x = x->parent;
         }
-
     }
 
-
-
-    /*An iterator for accessing nodes within the tree and iterating through them
-      This iterator can only go in the forward direction: http://www.cplusplus.com/reference/iterator/ForwardIterator/
-      The is_const flag is to determine if the fields of this class will be const or not
-      This is done this way because of two reasons:
-        1. The const_iterator should still allow the user to iterate over them
-        2. Doing it this way allows the constructor parameters to also be const, allowing const_iterators to be created in const functions in the binary_search_tree class
-    */
-    //This new version can be easily carried over to future projects
-    template<bool is_const>
-    class iterator_base
+    //Rebalances the tree after "newNode" has been inserted, and updates the augmentation data of the nodes above it
+    void balanceInserted(node* newNode)
     {
-        //Used for accessing the private details of the binary_search_tree class
-        friend class binary_search_tree<T, Comparer>;
-
-        //The type of node this iterator will be accessing. This type will be const if "is_const" is true
-        using NodeType = make_const_if_true<node, is_const>;
-        //The type of tree the iterator will be accessing. This type will be const if "is_const" is true
-        using TreeType = make_const_if_true<binary_search_tree<T, Comparer>, is_const>;
-
-        //The node that the iterator points to. This will be "const node*" if "is_const" is true
-        NodeType* nodePtr;
-
-        //Previous node that the iterator was previously. This will be "const node*" if "is_const" is true
-        NodeType* previousNode = nullptr;
-
-        //The binary search tree the iterator is a part of. This will be "const binary_search_tree<T, Comparer>*" if "is_const" is true
-        TreeType* tree;
-
-        //Constructs a new iterator from a node and tree
-        iterator_base(NodeType* node, TreeType* tree) : nodePtr(node), tree(tree) { }
-
-    public:
-        //An implicit copy constructor for implicity converting non-const iterators to const versions
-        iterator_base(const iterator_base<false>& other) : iterator_base(other.nodePtr, other.tree) {}
-        //An implicit move constructor for implicity converting non-const iterators to const versions
-        iterator_base(iterator_base<false>&& other) noexcept : iterator_base(other.nodePtr, other.tree)
+        if constexpr (RedBlack)
         {
-            other.nodePtr = nullptr;
-            other.previousNode = nullptr;
-            other.tree = nullptr;
+            //The augmentation data is brought up to date first, since the rotations work it out from the children of the rotated nodes
+            augmentToRoot(newNode);
+            if (selfBalancing)
+            {
+                redBlackInsertFixup(newNode);
+            }
+        }
+        else
+        {
+            //Update the height value of the parent
+            UpdateHeights(newNode->parent);
+            balance(newNode);
         }
+    }
 
-        //These type definitions are required for iterators
-        using value_type = T;
-        using reference = T&;
-        using pointer = T*;
-        using iterator_category = std::forward_iterator_tag;
-        using difference_type = int;
+    //Returns true if a node is red. Missing children count as black
+    static bool isRed(const node* x)
+    {
+        return x != nullptr && x->red;
+    }
 
-        //Pre-increments the iterator to the next value
-        //This is used to iterate over the tree using the in-order traversal method, which has been improvised to support iterators
-        iterator_base<is_const>& operator++()
+    //Restores the red-black rules after the red node "x" has been inserted. While the parent and the uncle are both red, the color problem is pushed up
+    //to the grand-parent by recoloring. Otherwise one or two rotations fix it for good
+    void redBlackInsertFixup(node* x)
+    {
+        while (isRed(x->parent))
         {
-
-            //If the node is null, then we are already at the end
-            if (nodePtr == nullptr)
+            node* parent = x->parent;
+            node* grandParent = parent->parent;
+            //If the parent is a red root, then making it black is enough
+            if (grandParent == nullptr)
             {
-                throw struct_exception("Cannot iterate past the end of the tree");
+                break;
             }
 
-            //If the node doesn't have a defined previous location. PreviousNode is null only when we first start iterating through the tree
-            if (previousNode == nullptr)
+            if (parent == grandParent->leftChild)
             {
-                //If the node has a rightmost child, then move down to the lowest value in that subtree
-                if (nodePtr->rightChild != nullptr)
+                node* uncle = grandParent->rightChild;
+                //If the uncle is red, then the parent and uncle become black, and the grand-parent becomes red and is checked next
+                if (isRed(uncle))
                 {
-                    nodePtr = tree->minimum(nodePtr->rightChild);
-                    previousNode = nullptr;
+                    parent->red = false;
+                    uncle->red = false;
+                    grandParent->red = true;
+                    x = grandParent;
                 }
-                //Otherwise, if the node has a parent, then jump to that
-                else if (nodePtr->parent != nullptr)
+                else
                 {
-                    previousNode = nodePtr;
-                    nodePtr = nodePtr->parent;
-                    //If we came from a right child, then keep going up until we reach a parent from the left side
-                    while (previousNode == nodePtr->rightChild)
+                    //If "x" is on the inside, then rotate it to the outside first
+                    if (x == parent->rightChild)
                     {
-                        //If the node does not have a parent, then we have reached the end
-                        if (nodePtr->parent == nullptr)
-                        {
-                            nodePtr = nullptr;
-                            previousNode = nullptr;
-                            break;
-                        }
-                        //If the node does have a parent, then keep going up the subtree
-                        else
-                        {
-                            previousNode = nodePtr;
-                            nodePtr = nodePtr->parent;
-                        }
+                        leftRotation(parent);
+                        x = parent;
+                        parent = x->parent;
                     }
-                }
-                //If the node does not have a parent, then we have reached the end, since the only node that cannot have a parent is root
-                else
-                {
-                    //We have reached the end of the tree
-                    nodePtr = nullptr;
-                    previousNode = nullptr;
+                    parent->red = false;
+                    grandParent->red = true;
+                    rightRotation(grandParent);
+                    break;
                 }
             }
-            //If we do have a previous location, then we can use that to determine what to do next
+            //The same as above, with left and right swapped
             else
             {
-                //If we came from a left child
-                if (previousNode == nodePtr->leftChild)
+                node* uncle = grandParent->leftChild;
+                if (isRed(uncle))
                 {
-                    //If the node we are on right now has a right child, then we can start traversing down it's subtree
-                    if (nodePtr->rightChild != nullptr)
-                    {
-                        //Find the lowest value in the subtree and start from there
-                        nodePtr = tree->minimum(nodePtr->rightChild);
-                        previousNode = nullptr;
-                    }
-                    //If the node does not have a right child, then go up to it's parent
-                    else
+                    parent->red = false;
+                    uncle->red = false;
+                    grandParent->red = true;
+                    x = grandParent;
+                }
+                else
+                {
+                    if (x == parent->leftChild)
                     {
-                        //If there is no parent, then we are at the end, since the only node that cannot have a parent is root
-                        if (nodePtr->parent == nullptr)
-                        {
-                            previousNode = nullptr;
-                            nodePtr = nullptr;
-                        }
-                        //If there is a parent, then go to it
-                        else
-                        {
-                            previousNode = nodePtr;
-                            nodePtr = nodePtr->parent;
-                            //If we came from a right child, then keep going up until we reach a parent from the left side
-                            while (previousNode == nodePtr->rightChild)
-                            {
-                                //If the node does not have a parent, then we have reached the end
-                                if (nodePtr->parent == nullptr)
-                                {
-                                    nodePtr = nullptr;
-                                    previousNode = nullptr;
-                                    break;
-                                }
-                                //If the node does have a parent, then keep going up the subtree
-                                else
-                                {
-                                    previousNode = nodePtr;
-                                    nodePtr = nodePtr->parent;
-                                }
-                            }
-                        }
+                        rightRotation(parent);
+                        x = parent;
+                        parent = x->parent;
                     }
+                    parent->red = false;
+                    grandParent->red = true;
+                    leftRotation(grandParent);
+                    break;
                 }
             }
-
-            return *this;
         }
-        //Post-increments the iterator to the next value
-        iterator_base<is_const> operator++(int)
+        root->red = false;
+    }
+
+    //Swaps how many times the values of two nodes are in the tree. Used when the values of two nodes are swapped
+    static void swapCounts(node* a, node* b)
+    {
+        if constexpr (Counted)
         {
-            //Store the previous state of the iterator
-            iterator_base<is_const> previous = *this;
-            //Increment the iterator
-            this->operator++();
-            //Return the previous state
-            return previous;
+            std::swap(a->count, b->count);
         }
+    }
 
-        iterator_base<is_const> getParent() {
-            if (nodePtr == nullptr) {
-                return iterator_base<is_const>(nullptr,tree);
+    //Removes a single value from a node. In a multiset the count of the node is lowered, and the node is only deleted once its last value is removed.
+    //Returns true if a value has been removed
+    bool removeOne(node* x)
+    {
+        if constexpr (Counted)
+        {
+            if (x == nullptr)
+            {
+                return false;
             }
-            else {
-                return iterator_base<is_const>(nodePtr->parent,tree);
+            valueCount--;
+            if (x->count > 1)
+            {
+                x->count--;
+                return true;
+            }
+        }
+        return removeNode(x);
+    }
+
+    //Deletes a node from the tree with the removal that matches the balancing policy. Returns true if a node has been deleted
+    bool removeNode(node* x)
+    {
+        if constexpr (RedBlack)
+        {
+            return removeRedBlack(x);
+        }
+        else
+        {
+            return remove(x);
+        }
+    }
+
+    //Removes a node from a red-black tree. Returns true if a node has been deleted
+    bool removeRedBlack(node* x)
+    {
+        if (x == nullptr)
+        {
+            return false;
+        }
+        //If the node has two children, then the smallest value of its right subtree takes its place, and that node is removed instead
+        if (x->leftChild != nullptr && x->rightChild != nullptr)
+        {
+            node* minimumNode = minimum(x->rightChild);
+            std::swap(x->data, minimumNode->data);
+            swapCounts(x, minimumNode);
+            x = minimumNode;
+        }
+
+        //The node now has at most one child, which takes its place
+        node* child = x->leftChild != nullptr ? x->leftChild : x->rightChild;
+        node* parent = x->parent;
+        if (child != nullptr)
+        {
+            child->parent = parent;
+        }
+        if (parent == nullptr)
+        {
+            root = child;
+        }
+        else if (parent->leftChild == x)
+        {
+            parent->leftChild = child;
+        }
+        else
+        {
+            parent->rightChild = child;
+        }
+        augmentToRoot(parent);
+
+        //Removing a black node leaves one path with a black node too few
+        if (selfBalancing && !x->red)
+        {
+            //If the child is red, then making it black makes up for the removed node
+            if (isRed(child))
+            {
+                child->red = false;
+            }
+            else
+            {
+                redBlackRemoveFixup(child, parent);
+            }
+        }
+
+        destroyNode(x);
+        treeSize--;
+        return true;
+    }
+
+    //Restores the red-black rules when the paths through "x" have one black node too few. "x" can be nullptr, so its parent is passed in separately.
+    //While the sibling and its children are all black, the sibling becomes red and the problem is pushed up to the parent. Otherwise at most three rotations fix it for good
+    void redBlackRemoveFixup(node* x, node* parent)
+    {
+        while (x != root && !isRed(x))
+        {
+            if (x == parent->leftChild)
+            {
+                //The sibling can't be nullptr, since the paths through it have at least one more black node than the paths through "x"
+                node* sibling = parent->rightChild;
+                //If the sibling is red, then rotate it above the parent, so "x" gets a black sibling
+                if (sibling->red)
+                {
+                    sibling->red = false;
+                    parent->red = true;
+                    leftRotation(parent);
+                    sibling = parent->rightChild;
+                }
+                //If both of the sibling's children are black, then the sibling can become red
+                if (!isRed(sibling->leftChild) && !isRed(sibling->rightChild))
+                {
+                    sibling->red = true;
+                    x = parent;
+                    parent = x->parent;
+                }
+                else
+                {
+                    //Make sure the outer child of the sibling is the red one
+                    if (!isRed(sibling->rightChild))
+                    {
+                        sibling->leftChild->red = false;
+                        sibling->red = true;
+                        rightRotation(sibling);
+                        sibling = parent->rightChild;
+                    }
+                    //Rotating the sibling above the parent adds a black node to the paths through "x"
+                    sibling->red = parent->red;
+                    parent->red = false;
+                    sibling->rightChild->red = false;
+                    leftRotation(parent);
+                    x = root;
+                }
+            }
+            //The same as above, with left and right swapped
+            else
+            {
+                node* sibling = parent->leftChild;
+                if (sibling->red)
+                {
+                    sibling->red = false;
+                    parent->red = true;
+                    rightRotation(parent);
+                    sibling = parent->leftChild;
+                }
+                if (!isRed(sibling->leftChild) && !isRed(sibling->rightChild))
+                {
+                    sibling->red = true;
+                    x = parent;
+                    parent = x->parent;
+                }
+                else
+                {
+                    if (!isRed(sibling->leftChild))
+                    {
+                        sibling->rightChild->red = false;
+                        sibling->red = true;
+                        leftRotation(sibling);
+                        sibling = parent->leftChild;
+                    }
+                    sibling->red = parent->red;
+                    parent->red = false;
+                    sibling->leftChild->red = false;
+                    rightRotation(parent);
+                    x = root;
+                }
+            }
+        }
+        if (x != nullptr)
+        {
+            x->red = false;
+        }
+    }
+
+    //Works out the height of a subtree by visiting every node in it. Red-black trees don't store the heights of their nodes
+    static int measureHeight(const node* subTree)
+    {
+        if (subTree == nullptr)
+        {
+            return 0;
+        }
+        return std::max(measureHeight(subTree->leftChild), measureHeight(subTree->rightChild)) + 1;
+    }
+
+    //Deletes every node in a subtree in a single post-order pass. The walk follows the parent pointers back up instead of using a stack or recursion,
+    //so it doesn't allocate any memory and can't overflow the stack on a deep tree. No rebalancing is done, and the subtree's parent is left untouched
+    void deleteSubtree(node* subTree)
+    {
+        if (subTree == nullptr)
+        {
+            return;
+        }
+
+        node* stop = subTree->parent;
+        node* current = subTree;
+        while (current != stop)
+        {
+            //Go down to a leaf. Left children are visited before right children
+            if (current->leftChild != nullptr)
+            {
+                current = current->leftChild;
+            }
+            else if (current->rightChild != nullptr)
+            {
+                current = current->rightChild;
+            }
+            //Delete the leaf, and unlink it from its parent so the parent becomes a leaf once its other child is gone
+            else
+            {
+                node* parent = current->parent;
+                if (current == subTree)
+                {
+                    parent = stop;
+                }
+                else if (parent->leftChild == current)
+                {
+                    parent->leftChild = nullptr;
+                }
+                else
+                {
+                    parent->rightChild = nullptr;
+                }
+                destroyNode(current);
+                current = parent;
+            }
+        }
+    }
+
+    //Copies how many times a value is in the tree from the iterator a node is built from. Only the iterators of another tree know this, and every other range holds each value once
+    template<typename Iterator>
+    static void copyCount(node* x, const Iterator& source)
+    {
+        if constexpr (Counted && bst_impl::has_get_count<Iterator>::value)
+        {
+            x->count = source.getCount();
+        }
+    }
+
+    //Builds a perfectly balanced subtree out of the next "count" values of a sorted range, and advances "current" past them.
+    //The values are read in order, so the middle value becomes the root of the subtree and each half becomes a child subtree.
+    //No comparisons are made, and the height of each node is worked out from the heights of its children. Returns the root of the subtree.
+    //For red-black trees, the nodes "redDepth" levels below the root of the subtree are colored red and the rest are black. These are the nodes on the last level if it isn't full
+    template<typename Iterator>
+    node* buildBalanced(Iterator& current, int count, node* parent, int redDepth)
+    {
+        if (count <= 0)
+        {
+            return nullptr;
+        }
+
+        //The left subtree gets the values before the middle, and the right subtree gets the values after it
+        int leftCount = (count - 1) / 2;
+        node* left = buildBalanced(current, leftCount, nullptr, redDepth - 1);
+
+        node* newNode = nullptr;
+        try
+        {
+            newNode = createNode(*current, parent, left, nullptr);
+        }
+        catch (...)
+        {
+            deleteSubtree(left);
+            throw;
+        }
+        copyCount(newNode, current);
+        ++current;
+        if (left != nullptr)
+        {
+            left->parent = newNode;
+        }
+
+        try
+        {
+            newNode->rightChild = buildBalanced(current, count - 1 - leftCount, newNode, redDepth - 1);
+        }
+        catch (...)
+        {
+            deleteSubtree(newNode);
+            throw;
+        }
+
+        if constexpr (RedBlack)
+        {
+            newNode->red = redDepth == 0;
+        }
+        else
+        {
+            //The right subtree is never smaller than the left subtree, so it decides the height
+            newNode->height = (newNode->rightChild != nullptr ? newNode->rightChild->height : 0) + 1;
+        }
+        augment(newNode);
+        return newNode;
+    }
+
+    //Replaces the contents of the tree with "count" values from a sorted range that has no duplicates.
+    //In a multiset, "values" is how many values the nodes hold together, which is more than "count" when the range is another tree with duplicates
+    template<typename Iterator>
+    void assignSorted(Iterator begin, int count, int values = -1)
+    {
+        //Every level above the last one is full, and the last level is full when the levels above it hold all of the values
+        int fullLevels = 0;
+        while ((2LL << fullLevels) - 1 <= count)
+        {
+            fullLevels++;
+        }
+        //Build the new nodes first, so the tree is left unchanged if an exception occurs
+        node* newRoot = buildBalanced(begin, count, nullptr, fullLevels);
+        clear();
+        root = newRoot;
+        treeSize = count;
+        valueCount = values < 0 ? count : values;
+    }
+
+    //Builds a multiset out of a sorted range that can have duplicates. Each run of equal values becomes one node, which keeps the first value of the run
+    template<typename Iterator>
+    static binary_search_tree<T, Comparer, Allocator, Augmentation, Balancing, Duplicates> fromSortedRuns(Iterator begin, Iterator end, Comparer comp, const Allocator& alloc)
+    {
+        std::vector<T> distinct;
+        std::vector<int> counts;
+        int total = 0;
+        for (; begin != end; ++begin)
+        {
+            //In a sorted range, a value equal to the one before it is not greater than it
+            if (!distinct.empty() && !comp(distinct.back(), *begin))
+            {
+                counts.back()++;
+            }
+            else
+            {
+                distinct.push_back(*begin);
+                counts.push_back(1);
+            }
+            total++;
+        }
+
+        binary_search_tree<T, Comparer, Allocator, Augmentation, Balancing, Duplicates> tree{ std::move(comp), alloc };
+        tree.assignSorted(std::make_move_iterator(distinct.begin()), static_cast<int>(distinct.size()), total);
+        //The nodes are visited in sorted order, which is the order of the counts
+        int index = 0;
+        for (auto i = tree.begin(); i != tree.end(); ++i)
+        {
+            i.nodePtr->count = counts[index++];
+        }
+        return tree;
+    }
+
+    //Join-based set operations. These work on detached AVL subtrees instead of the whole tree: the parent pointers of the nodes are only fixed when a node
+    //is given new children, and the root of the result is given a nullptr parent at the end. Nothing here reads the root or size of the tree, so independent
+    //subtrees can be worked on by different threads. The algorithms are from "Just Join for Parallel Ordered Sets" by Blelloch, Ferizovic and Sun
+
+    //Subtrees shorter than this are never split between threads, since starting a thread would cost more than it saves
+    static constexpr int MinimumParallelHeight = 12;
+
+    //The nodes that a set operation has taken out of the trees. They are only destroyed once every thread has finished, since the allocator may not be thread-safe
+    struct removed_nodes
+    {
+        std::vector<node*> subTrees; //The roots of the subtrees that have been removed
+        int matches = 0; //How many values were found in both trees
+
+        void append(removed_nodes&& other)
+        {
+            subTrees.insert(subTrees.end(), other.subTrees.begin(), other.subTrees.end());
+            matches += other.matches;
+        }
+    };
+
+    static int heightOf(const node* subTree)
+    {
+        return subTree != nullptr ? subTree->height : 0;
+    }
+
+    //Gives a node new children, and updates its height and augmentation data. Returns the node
+    static node* attach(node* x, node* left, node* right)
+    {
+        x->leftChild = left;
+        x->rightChild = right;
+        if (left != nullptr)
+        {
+            left->parent = x;
+        }
+        if (right != nullptr)
+        {
+            right->parent = x;
+        }
+        int leftHeight = heightOf(left);
+        int rightHeight = heightOf(right);
+        x->height = (leftHeight > rightHeight ? leftHeight : rightHeight) + 1;
+        augment(x);
+        return x;
+    }
+
+    //Unlinks a node from its parent and children, so it can be destroyed on its own
+    static node* detach(node* x)
+    {
+        x->parent = nullptr;
+        x->leftChild = nullptr;
+        x->rightChild = nullptr;
+        return x;
+    }
+
+    //Rotates a detached subtree and returns its new root. See leftRotation() and rightRotation() for how the rotations work
+    static node* rotateLeftDetached(node* x)
+    {
+        node* y = x->rightChild;
+        attach(x, x->leftChild, y->leftChild);
+        return attach(y, x, y->rightChild);
+    }
+
+    static node* rotateRightDetached(node* y)
+    {
+        node* x = y->leftChild;
+        attach(y, x->rightChild, y->rightChild);
+        return attach(x, x->leftChild, y);
+    }
+
+    //Joins two subtrees with a middle node, where every value in "left" is less than the middle value and every value in "right" is greater.
+    //The shorter subtree is attached along the spine of the taller one at the point where their heights match, and the nodes above it are rebalanced.
+    //This takes O(|height(left) - height(right)|) time. Returns the root of the joined subtree
+    static node* join(node* left, node* middle, node* right)
+    {
+        int leftHeight = heightOf(left);
+        int rightHeight = heightOf(right);
+        if (leftHeight > rightHeight + 1)
+        {
+            node* newRight = join(left->rightChild, middle, right);
+            attach(left, left->leftChild, newRight);
+            //The new right subtree is at most one taller than it used to be, so one or two rotations fix the balance
+            if (heightOf(newRight) > heightOf(left->leftChild) + 1)
+            {
+                if (heightOf(newRight->leftChild) > heightOf(newRight->rightChild))
+                {
+                    attach(left, left->leftChild, rotateRightDetached(newRight));
+                }
+                return rotateLeftDetached(left);
+            }
+            return left;
+        }
+        if (rightHeight > leftHeight + 1)
+        {
+            node* newLeft = join(left, middle, right->leftChild);
+            attach(right, newLeft, right->rightChild);
+            if (heightOf(newLeft) > heightOf(right->rightChild) + 1)
+            {
+                if (heightOf(newLeft->rightChild) > heightOf(newLeft->leftChild))
+                {
+                    attach(right, rotateLeftDetached(newLeft), right->rightChild);
+                }
+                return rotateRightDetached(right);
+            }
+            return right;
+        }
+        return attach(middle, left, right);
+    }
+
+    //Removes the largest node of a subtree and stores it in "last". Returns the root of the rest of the subtree
+    static node* splitLast(node* subTree, node*& last)
+    {
+        if (subTree->rightChild == nullptr)
+        {
+            last = subTree;
+            return subTree->leftChild;
+        }
+        node* rest = splitLast(subTree->rightChild, last);
+        return join(subTree->leftChild, subTree, rest);
+    }
+
+    //Removes the smallest node of a subtree and stores it in "first". Returns the root of the rest of the subtree
+    static node* splitFirst(node* subTree, node*& first)
+    {
+        if (subTree->leftChild == nullptr)
+        {
+            first = subTree;
+            return subTree->rightChild;
+        }
+        node* rest = splitFirst(subTree->leftChild, first);
+        return join(rest, subTree, subTree->rightChild);
+    }
+
+    //Joins two subtrees where every value in "left" is less than every value in "right". Returns the root of the joined subtree
+    static node* join(node* left, node* right)
+    {
+        if (left == nullptr)
+        {
+            return right;
+        }
+        node* last = nullptr;
+        node* rest = splitLast(left, last);
+        return join(rest, last, right);
+    }
+
+    //Splits a subtree into the values less than "data" and the values greater than "data", which are stored in "left" and "right".
+    //If a node equal to "data" is found, then it is detached and returned. Otherwise nullptr is returned. This takes O(log n) time
+    node* split(node* subTree, const T& data, node*& left, node*& right) const
+    {
+        if (subTree == nullptr)
+        {
+            left = nullptr;
+            right = nullptr;
+            return nullptr;
+        }
+        node* subLeft = subTree->leftChild;
+        node* subRight = subTree->rightChild;
+        if (comparer(data, subTree->data))
+        {
+            node* found = split(subLeft, data, left, right);
+            right = join(right, subTree, subRight);
+            return found;
+        }
+        if (comparer(subTree->data, data))
+        {
+            node* found = split(subRight, data, left, right);
+            left = join(subLeft, subTree, left);
+            return found;
+        }
+        left = subLeft;
+        right = subRight;
+        return detach(subTree);
+    }
+
+    //Runs two tasks, on two threads if "parallel" is true. The second task runs on the calling thread
+    template<typename First, typename Second>
+    static void runBoth(bool parallel, First&& first, Second&& second)
+    {
+        if (!parallel)
+        {
+            first();
+            second();
+            return;
+        }
+        parallel_impl::run_chunks(2, [&](int chunk) {
+            if (chunk == 1)
+            {
+                first();
+            }
+            else
+            {
+                second();
+            }
+        });
+    }
+
+    //Returns true if the two halves of a set operation should run on different threads
+    static bool runsInParallel(int parallelDepth, const node* a, const node* b)
+    {
+        return parallelDepth > 0 && heightOf(a) + heightOf(b) >= 2 * MinimumParallelHeight;
+    }
+
+    //Adds a subtree to the nodes that a set operation has removed, if it isn't empty
+    static void salvage(node* subTree, removed_nodes& removed)
+    {
+        if (subTree != nullptr)
+        {
+            removed.subTrees.push_back(subTree);
+        }
+    }
+
+    //The recursive part of a set operation. See unionNodes(), intersectNodes() and differenceNodes()
+    using set_operation = node* (binary_search_tree<T, Comparer, Allocator, Augmentation, Balancing, Duplicates>::*)(node*, node*, removed_nodes&, int) const;
+
+    //Runs a set operation on the two halves left after splitting, and stores their results in "left" and "right". "middle" is the node the halves will be joined around, if any.
+    //A set operation that throws has already added all of its subtrees to "removed". So if either half throws, the subtrees still held here are added to "removed" too:
+    //the result of a half that finished, the inputs of a half that never ran, and "middle"
+    void runHalves(set_operation operation, node* aLeft, node* bLeft, node* aRight, node* bRight, node* middle, node*& left, node*& right,
+        removed_nodes& removed, int parallelDepth, bool parallel) const
+    {
+        removed_nodes leftRemoved;
+        bool leftStarted = false;
+        bool leftDone = false;
+        bool rightStarted = false;
+        bool rightDone = false;
+        try
+        {
+            runBoth(parallel,
+                [&]() { leftStarted = true; left = (this->*operation)(aLeft, bLeft, leftRemoved, parallelDepth - 1); leftDone = true; },
+                [&]() { rightStarted = true; right = (this->*operation)(aRight, bRight, removed, parallelDepth - 1); rightDone = true; });
+        }
+        catch (...)
+        {
+            removed.append(std::move(leftRemoved));
+            if (leftDone)
+            {
+                salvage(left, removed);
+            }
+            else if (!leftStarted)
+            {
+                salvage(aLeft, removed);
+                salvage(bLeft, removed);
+            }
+            if (rightDone)
+            {
+                salvage(right, removed);
+            }
+            else if (!rightStarted)
+            {
+                salvage(aRight, removed);
+                salvage(bRight, removed);
+            }
+            if (middle != nullptr)
+            {
+                salvage(detach(middle), removed);
+            }
+            throw;
+        }
+        removed.append(std::move(leftRemoved));
+    }
+
+    //Works out the union of two subtrees. When a value is in both, the node from "a" is kept and the node from "b" is removed. Returns the root of the union.
+    //If the comparer throws, every node of both subtrees ends up in "removed"
+    node* unionNodes(node* a, node* b, removed_nodes& removed, int parallelDepth) const
+    {
+        if (a == nullptr)
+        {
+            return b;
+        }
+        if (b == nullptr)
+        {
+            return a;
+        }
+        node* bLeft;
+        node* bRight;
+        node* found;
+        //A split that throws leaves the subtree as it was
+        try
+        {
+            found = split(b, a->data, bLeft, bRight);
+        }
+        catch (...)
+        {
+            salvage(a, removed);
+            salvage(b, removed);
+            throw;
+        }
+        if (found != nullptr)
+        {
+            removed.subTrees.push_back(found);
+            removed.matches++;
+        }
+
+        node* left;
+        node* right;
+        runHalves(&binary_search_tree::unionNodes, a->leftChild, bLeft, a->rightChild, bRight, a, left, right, removed, parallelDepth, runsInParallel(parallelDepth, a, b));
+        return join(left, a, right);
+    }
+
+    //Works out the intersection of two subtrees. The nodes from "a" are kept, and every other node is removed. Returns the root of the intersection.
+    //If the comparer throws, every node of both subtrees ends up in "removed"
+    node* intersectNodes(node* a, node* b, removed_nodes& removed, int parallelDepth) const
+    {
+        if (a == nullptr || b == nullptr)
+        {
+            if (a != nullptr || b != nullptr)
+            {
+                removed.subTrees.push_back(a != nullptr ? a : b);
+            }
+            return nullptr;
+        }
+        node* bLeft;
+        node* bRight;
+        node* found;
+        try
+        {
+            found = split(b, a->data, bLeft, bRight);
+        }
+        catch (...)
+        {
+            salvage(a, removed);
+            salvage(b, removed);
+            throw;
+        }
+        if (found != nullptr)
+        {
+            removed.subTrees.push_back(found);
+            removed.matches++;
+        }
+
+        node* left;
+        node* right;
+        runHalves(&binary_search_tree::intersectNodes, a->leftChild, bLeft, a->rightChild, bRight, a, left, right, removed, parallelDepth, runsInParallel(parallelDepth, a, b));
+        if (found != nullptr)
+        {
+            return join(left, a, right);
+        }
+        removed.subTrees.push_back(detach(a));
+        return join(left, right);
+    }
+
+    //Works out the values of "a" that aren't in "b". Every node from "b" is removed. Returns the root of the difference.
+    //If the comparer throws, every node of both subtrees ends up in "removed"
+    node* differenceNodes(node* a, node* b, removed_nodes& removed, int parallelDepth) const
+    {
+        if (a == nullptr || b == nullptr)
+        {
+            if (b != nullptr)
+            {
+                removed.subTrees.push_back(b);
+            }
+            return a;
+        }
+        node* aLeft;
+        node* aRight;
+        node* found;
+        try
+        {
+            found = split(a, b->data, aLeft, aRight);
+        }
+        catch (...)
+        {
+            salvage(a, removed);
+            salvage(b, removed);
+            throw;
+        }
+        if (found != nullptr)
+        {
+            removed.subTrees.push_back(found);
+            removed.matches++;
+        }
+
+        node* bLeft = b->leftChild;
+        node* bRight = b->rightChild;
+        removed.subTrees.push_back(detach(b));
+        node* left;
+        node* right;
+        runHalves(&binary_search_tree::differenceNodes, aLeft, bLeft, aRight, bRight, nullptr, left, right, removed, parallelDepth, runsInParallel(parallelDepth, a, b));
+        return join(left, right);
+    }
+
+    //Runs a set operation on this tree and the subtree "otherRoot", and returns the root of the result.
+    //If the comparer throws part way through, the pieces of the two trees can't be put back together without comparing them again. So every node of both is destroyed,
+    //the tree is left empty, and the exception is rethrown
+    node* runSetOperation(set_operation operation, node* otherRoot, removed_nodes& removed, int threadCount, int totalSize)
+    {
+        try
+        {
+            return (this->*operation)(root, otherRoot, removed, parallelDepthFor(threadCount, totalSize));
+        }
+        catch (...)
+        {
+            abandonJoinedRoot(removed);
+            throw;
+        }
+    }
+
+    //Destroys every node of the tree after a join-based operation has thrown. Every node has been added to "removed" by then, so the tree is left empty
+    void abandonJoinedRoot(removed_nodes& removed)
+    {
+        root = nullptr;
+        treeSize = 0;
+        destroyRemoved(removed);
+    }
+
+    //Destroys the nodes that a set operation has removed
+    void destroyRemoved(removed_nodes& removed)
+    {
+        for (node* subTree : removed.subTrees)
+        {
+            //The parent pointer of the subtree can be left over from where the subtree used to be
+            subTree->parent = nullptr;
+            deleteSubtree(subTree);
+        }
+    }
+
+    //Sorts values with a comparer, and removes the duplicates if "removeDuplicates" is true. Values that are already sorted are only checked, not sorted again
+    static void sortValues(std::vector<T>& values, Comparer& comp, bool removeDuplicates)
+    {
+        if (!std::is_sorted(values.begin(), values.end(), comp))
+        {
+            std::sort(values.begin(), values.end(), comp);
+        }
+        if (removeDuplicates)
+        {
+            //Values are duplicates if neither one is less than the other
+            values.erase(std::unique(values.begin(), values.end(), [&comp](const T& a, const T& b) {
+                return !comp(a, b) && !comp(b, a);
+            }), values.end());
+        }
+    }
+
+    //Removes the values of a sorted array that has no duplicates from a subtree. The subtree is split at the middle value, and each half of the array is removed
+    //from each half of the subtree, which are then joined again. Removing m values from n takes O(m log(n / m + 1)) time. Returns the root of the rest of the subtree.
+    //If the comparer throws, every node of the subtree ends up in "removed"
+    node* eraseSorted(node* subTree, const T* values, int count, removed_nodes& removed) const
+    {
+        if (subTree == nullptr || count == 0)
+        {
+            return subTree;
+        }
+        int middle = count / 2;
+        node* left;
+        node* right;
+        node* found;
+        //A split that throws leaves the subtree as it was
+        try
+        {
+            found = split(subTree, values[middle], left, right);
+        }
+        catch (...)
+        {
+            salvage(subTree, removed);
+            throw;
+        }
+        if (found != nullptr)
+        {
+            removed.subTrees.push_back(found);
+            removed.matches++;
+        }
+        //If either half throws, then it has already added its nodes to "removed", and the other half is added too
+        try
+        {
+            left = eraseSorted(left, values, middle, removed);
+        }
+        catch (...)
+        {
+            salvage(right, removed);
+            throw;
+        }
+        try
+        {
+            right = eraseSorted(right, values + middle + 1, count - middle - 1, removed);
+        }
+        catch (...)
+        {
+            salvage(left, removed);
+            throw;
+        }
+        return join(left, right);
+    }
+
+    //Inserts a value that is not less than the value of "finger", which is a node that was just inserted or found. The search climbs up from "finger" only until it reaches
+    //a subtree whose range of values holds the new value, and then goes down from there, so inserting sorted values that are close together only visits a few nodes.
+    //Returns the node that holds the value, or nullptr if the value was already in the tree
+    template<typename DataType>
+    node* insertNear(node* finger, DataType&& data)
+    {
+        //A right child's range ends where its parent's range ends, and a left child's range ends at its parent's value
+        while (finger->parent != nullptr && (finger == finger->parent->rightChild || !comparer(data, finger->parent->data)))
+        {
+            finger = finger->parent;
+        }
+        return insert(std::forward<DataType>(data), finger);
+    }
+
+    //Makes a copy of the nodes of another tree with this tree's allocator, and returns the root of the copy
+    node* copyNodes(const binary_search_tree<T, Comparer, Allocator, Augmentation, Balancing, Duplicates>& other)
+    {
+        auto current = other.begin();
+        return buildBalanced(current, other.treeSize, nullptr, 0);
+    }
+
+    //Takes the nodes of another tree, and returns the root. The other tree is left empty.
+    //If the nodes can't be freed by this tree's allocator, or their heights are out of date because the other tree isn't self-balancing, then the values are copied instead
+    node* takeNodes(binary_search_tree<T, Comparer, Allocator, Augmentation, Balancing, Duplicates>&& other)
+    {
+        bool copy = !other.selfBalancing;
+        if constexpr (!node_traits::is_always_equal::value)
+        {
+            copy = copy || allocator != other.allocator;
+        }
+        if (copy)
+        {
+            node* copied = copyNodes(other);
+            other.clear();
+            return copied;
+        }
+        node* taken = other.root;
+        other.root = nullptr;
+        other.treeSize = 0;
+        return taken;
+    }
+
+    //Checks that the tree can be used with the join-based operations
+    void checkJoinable() const
+    {
+        static_assert(!RedBlack, "split(), join() and the set operations require bst_avl_balancing");
+        static_assert(!Counted, "split(), join() and the set operations require bst_unique_keys");
+        if (!selfBalancing)
+        {
+            throw struct_exception("split(), join() and the set operations require a self-balancing tree");
+        }
+    }
+
+    //Gets how many levels of a set operation split their work between two threads
+    int parallelDepthFor(int threadCount, int totalSize) const
+    {
+        int threads = parallel_impl::resolve_thread_count(threadCount, totalSize);
+        int depth = 0;
+        while ((1 << depth) < threads)
+        {
+            depth++;
+        }
+        return depth;
+    }
+
+    //Replaces the root of the tree with the result of a join-based operation
+    void setJoinedRoot(node* newRoot, int newSize)
+    {
+        root = newRoot;
+        if (root != nullptr)
+        {
+            root->parent = nullptr;
+        }
+        treeSize = newSize;
+    }
+
+    /*An iterator for accessing nodes within the tree and iterating through them
+      This iterator can only go in the forward direction: http://www.cplusplus.com/reference/iterator/ForwardIterator/
+      The is_const flag is to determine if the fields of this class will be const or not
+      This is done this way because of two reasons:
+        1. The const_iterator should still allow the user to iterate over them
+        2. Doing it this way allows the constructor parameters to also be const, allowing const_iterators to be created in const functions in the binary_search_tree class
+    */
+    //This new version can be easily carried over to future projects
+    template<bool is_const>
+    class iterator_base
+    {
+        //Used for accessing the private details of the binary_search_tree class
+        friend class binary_search_tree<T, Comparer, Allocator, Augmentation, Balancing, Duplicates>;
+
+        //The type of node this iterator will be accessing. This type will be const if "is_const" is true
+        using NodeType = make_const_if_true<node, is_const>;
+        //The type of tree the iterator will be accessing. This type will be const if "is_const" is true
+        using TreeType = make_const_if_true<binary_search_tree<T, Comparer, Allocator, Augmentation, Balancing, Duplicates>, is_const>;
+
+        //The node that the iterator points to. This will be "const node*" if "is_const" is true
+        NodeType* nodePtr;
+
+        //The binary search tree the iterator is a part of. This will be "const binary_search_tree<T, Comparer, Allocator, Augmentation, Balancing, Duplicates>*" if "is_const" is true
+        TreeType* tree;
+
+        //Constructs a new iterator from a node and tree
+        iterator_base(NodeType* node, TreeType* tree) : nodePtr(node), tree(tree) { }
+
+    public:
+        //An implicit copy constructor for implicity converting non-const iterators to const versions
+        iterator_base(const iterator_base<false>& other) : iterator_base(other.nodePtr, other.tree) {}
+        //An implicit move constructor for implicity converting non-const iterators to const versions
+        iterator_base(iterator_base<false>&& other) noexcept : iterator_base(other.nodePtr, other.tree)
+        {
+            other.nodePtr = nullptr;
+            other.tree = nullptr;
+        }
+
+        //These type definitions are required for iterators
+        using value_type = T;
+        using reference = T&;
+        using pointer = T*;
+        using iterator_category = std::forward_iterator_tag;
+        using difference_type = int;
+
+        //Pre-increments the iterator to the next value in sorted order
+        //If the node has a right subtree, then the next value is the smallest value in it. Otherwise, the next value is the first parent that is reached from a left child.
+        //This only follows the parent pointers, so the iterator doesn't need to remember where it came from
+        iterator_base<is_const>& operator++()
+        {
+            //If the node is null, then we are already at the end
+            if (nodePtr == nullptr)
+            {
+                throw struct_exception("Cannot iterate past the end of the tree");
+            }
+
+            //If the node has a right child, then move down to the lowest value in that subtree
+            if (nodePtr->rightChild != nullptr)
+            {
+                nodePtr = nodePtr->rightChild;
+                while (nodePtr->leftChild != nullptr)
+                {
+                    nodePtr = nodePtr->leftChild;
+                }
+            }
+            //Otherwise, keep going up while we are coming from a right child. Going past the root means we have reached the end
+            else
+            {
+                NodeType* child;
+                do
+                {
+                    child = nodePtr;
+                    nodePtr = nodePtr->parent;
+                } while (nodePtr != nullptr && nodePtr->rightChild == child);
+            }
+
+            return *this;
+        }
+        //Post-increments the iterator to the next value
+        iterator_base<is_const> operator++(int)
+        {
+            //Store the previous state of the iterator
+            iterator_base<is_const> previous = *this;
+            //Increment the iterator
+            this->operator++();
+            //Return the previous state
+            return previous;
+        }
+
+        iterator_base<is_const> getParent() {
+            if (nodePtr == nullptr) {
+                return iterator_base<is_const>(nullptr,tree);
+            }
+            else {
+                return iterator_base<is_const>(nodePtr->parent,tree);
             }
         }
 
@@ -854,11 +2063,60 @@ class binary_search_tree
             if (nodePtr == nullptr) {
                 return 0;
             }
+            else if constexpr (RedBlack) {
+                return measureHeight(nodePtr);
+            }
             else {
                 return nodePtr->height;
             }
         }
 
+        //Returns how many times the value is in the tree. This is always 1 unless the tree uses bst_counted_keys, and 0 for end()
+        int getCount() const {
+            if (nodePtr == nullptr) {
+                return 0;
+            }
+            else if constexpr (Counted) {
+                return nodePtr->count;
+            }
+            else {
+                return 1;
+            }
+        }
+
+        //Gets the augmentation data of the node, such as the subtree size with bst_order_statistics. Can't be used on end()
+        const typename Augmentation::template node_data<T>& getAugmentation() const {
+            if (nodePtr == nullptr) {
+                throw struct_exception("The end() iterator has no augmentation data");
+            }
+            return *nodePtr;
+        }
+
+        //Returns true if the node is red in a red-black tree. Always false for other trees and for end()
+        bool isRed() const {
+            if constexpr (RedBlack) {
+                return nodePtr != nullptr && nodePtr->red;
+            }
+            else {
+                return false;
+            }
+        }
+
+        //Moves the iterator forward by "count" values, or backwards if "count" is negative, in O(log n) time. Moving one past the largest value gives end().
+        //Only available when the tree uses the bst_order_statistics augmentation
+        iterator_base<is_const>& advance(int count)
+        {
+            static_assert(OrderStatistics, "advance() requires the bst_order_statistics augmentation");
+            //Find the index of the current value, and then find the node at the new index
+            int index = tree->indexOf(nodePtr) + count;
+            if (index < 0 || index > tree->treeSize)
+            {
+                throw struct_exception("Cannot advance the iterator outside of the tree");
+            }
+            nodePtr = selectNode(tree->root, index);
+            return *this;
+        }
+
         //Used to get the value of the iterator
         //This needs to be const because modifying the value in the tree would mess with the tree's structure
         const T& operator*() const
@@ -890,7 +2148,6 @@ class binary_search_tree
         iterator_base<is_const>& operator=(const iterator_base<false>& other) noexcept
         {
             nodePtr = other.nodePtr;
-            previousNode = other.previousNode;
             tree = other.tree;
             return *this;
         }
@@ -899,111 +2156,222 @@ class binary_search_tree
         iterator_base<is_const>& operator=(iterator_base<false>&& other) noexcept
         {
             nodePtr = other.nodePtr;
-            previousNode = other.previousNode;
             tree = other.tree;
 
             other.nodePtr = nullptr;
-            other.previousNode = nullptr;
             other.tree = nullptr;
             return *this;
         }
     };
 
+    //A view over the values of the tree from one iterator up to, but not including, another. Used for iterating over a range of values with a range-based for loop
+    template<bool is_const>
+    class range_view
+    {
+        iterator_base<is_const> first;
+        iterator_base<is_const> last;
+
+    public:
+        range_view(iterator_base<is_const> first, iterator_base<is_const> last) : first(first), last(last) {}
+
+        //Gets the iterator to the first value in the range
+        iterator_base<is_const> begin() const
+        {
+            return first;
+        }
+
+        //Gets the iterator that is one past the last value in the range
+        iterator_base<is_const> end() const
+        {
+            return last;
+        }
+
+        //Returns true if there are no values in the range
+        bool empty() const
+        {
+            return first == last;
+        }
+    };
+
 public:
     //A non_const version of the iterator
     using iterator = iterator_base<false>;
     //A const version of the iterator, where all the fields and constructor parameters are const
     using const_iterator = iterator_base<true>;
+    //A view over a range of values in the tree
+    using range_type = range_view<false>;
+    //A const view over a range of values in the tree
+    using const_range_type = range_view<true>;
+
+protected:
+    //Gets a changeable reference to the value an iterator points to. Only the parts of the value that the comparer doesn't look at may be changed, such as the value of a key-value pair
+    static T& valueOf(const iterator& it)
+    {
+        return it.nodePtr->data;
+    }
+
+public:
 
-    //Clears the tree
+    //Clears the tree. Every node is freed in a single O(n) pass, without rebalancing or allocating any memory.
+    //If the nodes don't need to be destroyed and the allocator can free all of its memory at once (such as a pool_allocator that isn't shared), then no nodes are visited at all
     void clear()
     {
-        if (root != nullptr)
+        if constexpr (std::is_trivially_destructible<node>::value && pool_impl::has_release_all<node_allocator>::value)
         {
-            for (auto i = begin(); i != end();)
+            if (root != nullptr && allocator.release_all())
             {
-                auto next = i;
-                next++;
-                remove(i);
-                i = next;
+                treeSize = 0;
+                valueCount = 0;
+                root = nullptr;
+                return;
             }
-            treeSize = 0;
-            root = nullptr;
         }
+        deleteSubtree(root);
+        treeSize = 0;
+        valueCount = 0;
+        root = nullptr;
     }
 
     //Default constructor for a binary search tree
-    binary_search_tree() : comparer(sorting_impl::DefaultComparer<T>) {}
+    binary_search_tree() : comparer(sorting_impl::make_default_comparer<Comparer, T>()) {}
 
     binary_search_tree(Comparer&& comp) : comparer(std::move(comp)) {}
 
-    //Constructs a new binary search tree from an intializer list
-    binary_search_tree(const std::initializer_list<T> list) : binary_search_tree(sorting_impl::DefaultComparer<T>)
+    //Constructs an empty tree that creates its nodes with the allocator
+    explicit binary_search_tree(const Allocator& alloc) : comparer(sorting_impl::make_default_comparer<Comparer, T>()), allocator(alloc) {}
+
+    binary_search_tree(Comparer&& comp, const Allocator& alloc) : comparer(std::move(comp)), allocator(alloc) {}
+
+    //Constructs a new binary search tree from an intializer list. Duplicate values are only added once, unless the tree uses bst_counted_keys
+    binary_search_tree(const std::initializer_list<T> list) : binary_search_tree(from_unsorted(list.begin(), list.end())) {}
+
+    //A copy constructor for creating a new tree from a copy. The copy is built as a perfectly balanced tree in O(n), without comparing any values
+    binary_search_tree(const binary_search_tree<T, Comparer, Allocator, Augmentation, Balancing, Duplicates>& toCopy) :
+        comparer(toCopy.comparer),
+        allocator(node_traits::select_on_container_copy_construction(toCopy.allocator))
+    {
+        assignSorted(toCopy.begin(), toCopy.treeSize, toCopy.valueCount);
+        selfBalancing = toCopy.selfBalancing;
+    }
+
+    //Creates a perfectly balanced tree from a range of values that is already sorted by the comparer and has no duplicates.
+    //This takes O(n) time and doesn't compare any values, so passing a range that isn't sorted will result in a broken tree.
+    //In a multiset the range can have duplicates, and each run of equal values becomes one node
+    template<typename Iterator>
+    static binary_search_tree<T, Comparer, Allocator, Augmentation, Balancing, Duplicates> from_sorted(Iterator begin, Iterator end, Comparer comp = sorting_impl::make_default_comparer<Comparer, T>(), const Allocator& alloc = Allocator())
     {
-        //Loop over all the values in the list and add them into the tree
-        for (const auto& value : list)
+        if constexpr (Counted)
+        {
+            return fromSortedRuns(begin, end, std::move(comp), alloc);
+        }
+        binary_search_tree<T, Comparer, Allocator, Augmentation, Balancing, Duplicates> tree{ std::move(comp), alloc };
+
+        //If the range can only be read once, then it has to be stored before the values can be counted
+        if constexpr (!std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<Iterator>::iterator_category>::value)
         {
-            insert(value);
+            std::vector<T> values(begin, end);
+            tree.assignSorted(std::make_move_iterator(values.begin()), static_cast<int>(values.size()));
         }
+        else
+        {
+            tree.assignSorted(begin, static_cast<int>(std::distance(begin, end)));
+        }
+        return tree;
     }
 
-    //A copy constructor for creating a new tree from a copy
-    binary_search_tree(const binary_search_tree<T, Comparer>& toCopy)
+    //Creates a perfectly balanced tree from a range of values in any order. The values are sorted and duplicates are removed, then the tree is built in O(n).
+    //In a multiset the duplicates are counted instead of removed
+    template<typename Iterator>
+    static binary_search_tree<T, Comparer, Allocator, Augmentation, Balancing, Duplicates> from_unsorted(Iterator begin, Iterator end, Comparer comp = sorting_impl::make_default_comparer<Comparer, T>(), const Allocator& alloc = Allocator())
     {
-        comparer = toCopy.comparer;
-
-        //Loop over all the values in the copy
-        for (auto& value : toCopy)
+        std::vector<T> values(begin, end);
+        sortValues(values, comp, !Counted);
+        if constexpr (Counted)
         {
-            //Insert them into the new tree
-            insert(value);
+            return fromSortedRuns(std::make_move_iterator(values.begin()), std::make_move_iterator(values.end()), std::move(comp), alloc);
         }
+        return from_sorted(std::make_move_iterator(values.begin()), std::make_move_iterator(values.end()), std::move(comp), alloc);
     }
 
-    //A move constructor for creating a new tree by moving the data from an old tree
-    binary_search_tree(binary_search_tree<T, Comparer>&& toMove) noexcept
+    //A move constructor for creating a new tree by moving the data from an old tree. The allocator is copied, so the old tree can still be used
+    binary_search_tree(binary_search_tree<T, Comparer, Allocator, Augmentation, Balancing, Duplicates>&& toMove) noexcept : allocator(toMove.allocator)
     {
         //Move the root node
         root = toMove.root;
         //Move the tree size
         treeSize = toMove.treeSize;
+        valueCount = toMove.valueCount;
         //Reset the root and treeSize of the old tree
         toMove.root = nullptr;
         toMove.treeSize = 0;
+        toMove.valueCount = 0;
 
         comparer = std::move(toMove.comparer);
     }
 
-    //A copy assignment operator for making a tree identical to a copy
-    binary_search_tree<T, Comparer>& operator=(const binary_search_tree<T, Comparer>& toCopy) noexcept
+    //A copy assignment operator for making a tree identical to a copy. The copy is built as a perfectly balanced tree in O(n), without comparing any values
+    binary_search_tree<T, Comparer, Allocator, Augmentation, Balancing, Duplicates>& operator=(const binary_search_tree<T, Comparer, Allocator, Augmentation, Balancing, Duplicates>& toCopy)
     {
-        //Clear the current tree
-        clear();
+        //Copying a tree into itself doesn't change anything
+        if (&toCopy == this)
+        {
+            return *this;
+        }
+
+        //If the allocator is copied too, then the old nodes have to be deleted with the old allocator first
+        if constexpr (node_traits::propagate_on_container_copy_assignment::value)
+        {
+            if (allocator != toCopy.allocator)
+            {
+                clear();
+            }
+            allocator = toCopy.allocator;
+        }
 
+        //Replace the current values with the copied values. If an exception occurs, the current tree is left unchanged
+        assignSorted(toCopy.begin(), toCopy.treeSize, toCopy.valueCount);
         comparer = toCopy.comparer;
+        selfBalancing = toCopy.selfBalancing;
+
+        //Return the current tree
+        return *this;
+    }
+
+    //A move assignment operator for taking the contents of an existing tree and moving them to the current tree.
+    //If the allocator isn't moved along with the nodes and the two allocators are different, then the values have to be copied instead
+    binary_search_tree<T, Comparer, Allocator, Augmentation, Balancing, Duplicates>& operator=(binary_search_tree<T, Comparer, Allocator, Augmentation, Balancing, Duplicates>&& toMove) noexcept(node_traits::propagate_on_container_move_assignment::value || node_traits::is_always_equal::value)
+    {
+        //Moving a tree into itself doesn't change anything
+        if (&toMove == this)
+        {
+            return *this;
+        }
 
-        //Loop over all the values in the copy
-        for (auto& value : toCopy)
+        if constexpr (!node_traits::propagate_on_container_move_assignment::value && !node_traits::is_always_equal::value)
         {
-            //Insert each of the values into the current tree
-            insert(value);
+            if (allocator != toMove.allocator)
+            {
+                assignSorted(toMove.begin(), toMove.treeSize, toMove.valueCount);
+                toMove.clear();
+                comparer = std::move(toMove.comparer);
+                return *this;
+            }
         }
 
-        //Return the current tree
-        return *this;
-    }
-
-    //A move assignment operator for taking the contents of an existing tree and moving them to the current tree
-    binary_search_tree<T, Comparer>& operator=(binary_search_tree<T, Comparer>&& toMove) noexcept
-    {
         //Clear the existing tree
         clear();
+        if constexpr (node_traits::propagate_on_container_move_assignment::value)
+        {
+            allocator = toMove.allocator;
+        }
         //Move the root and tree size values to the current tree
         root = toMove.root;
         treeSize = toMove.treeSize;
+        valueCount = toMove.valueCount;
         //Reset the root and tree size value of the old tree
         toMove.root = nullptr;
         toMove.treeSize = 0;
+        toMove.valueCount = 0;
 
         comparer = std::move(toMove.comparer);
 
@@ -1028,8 +2396,17 @@ public:
         {
             //Increase the tree size
             treeSize++;
+            if constexpr (Counted)
+            {
+                valueCount++;
+            }
             //Create the new node as the root
-            root = new node(std::forward<DataType>(data), nullptr, nullptr, nullptr);
+            root = createNode(std::forward<DataType>(data), nullptr, nullptr, nullptr);
+            //The root of a red-black tree is always black
+            if constexpr (RedBlack)
+            {
+                root->red = false;
+            }
             //Return an iterator to the root
             return iterator(root, this);
         }
@@ -1049,8 +2426,17 @@ public:
         {
             //Increase the tree size
             treeSize++;
+            if constexpr (Counted)
+            {
+                valueCount++;
+            }
             //Create the new node as the root
-            root = new node(std::forward<DataType>(data), nullptr, nullptr, nullptr);
+            root = createNode(std::forward<DataType>(data), nullptr, nullptr, nullptr);
+            //The root of a red-black tree is always black
+            if constexpr (RedBlack)
+            {
+                root->red = false;
+            }
             //Return an iterator to the root
             return iterator(root, this);
         }
@@ -1062,20 +2448,126 @@ public:
         }
     }
 
-    //Deletes a node from the tree. Returns true if a node has been deleted
+    //Inserts a value built in place from "args", but only if no value equal to "key" is in the tree yet. "key" must compare equal to the value that "args" builds.
+    //The tree is searched once, and the value is only built if it is inserted. Returns an iterator to the value with that key, and true if it was inserted.
+    //In a multiset, the count of an existing value is left unchanged
+    template<typename Key, typename... Args>
+    std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args)
+    {
+        const auto& lookup = lookupKey(key);
+        node* parent = nullptr;
+        node* current = root;
+        bool left = false;
+        //Find the node with the key, or the parent that a node with the key would be a child of
+        while (current != nullptr)
+        {
+            parent = current;
+            if (comparer(lookup, current->data))
+            {
+                left = true;
+                current = current->leftChild;
+            }
+            else if (comparer(current->data, lookup))
+            {
+                left = false;
+                current = current->rightChild;
+            }
+            else
+            {
+                return std::pair<iterator, bool>(iterator(current, this), false);
+            }
+        }
+
+        node* newNode = createNode(std::in_place, parent, std::forward<Args>(args)...);
+        treeSize++;
+        if constexpr (Counted)
+        {
+            valueCount++;
+        }
+        if (parent == nullptr)
+        {
+            root = newNode;
+            //The root of a red-black tree is always black
+            if constexpr (RedBlack)
+            {
+                root->red = false;
+            }
+        }
+        else
+        {
+            if (left)
+            {
+                parent->leftChild = newNode;
+            }
+            else
+            {
+                parent->rightChild = newNode;
+            }
+            balanceInserted(newNode);
+        }
+        return std::pair<iterator, bool>(iterator(newNode, this), true);
+    }
+
+    //Deletes a value from the tree. Returns true if a value has been deleted. In a multiset only one copy of the value is removed
     //The template parameter is to allow the function to take both rvalues and lvalues.
     template<typename DataType = T>
     bool remove(DataType&& data)
     {
-        //First, find the data in the tree. Then, delete that node from the tree
-        return remove(find(std::forward<DataType>(data), root));
+        //First, find the data in the tree. Then, delete that value from the tree
+        const auto& key = lookupKey(data);
+        return removeOne(find(key, root));
     }
 
-    //Deletes a node from the tree. Returns true if a node has been deleted
+    //Deletes the value an iterator points to. Returns true if a value has been deleted. In a multiset only one copy of the value is removed
     bool remove(iterator elementToDelete)
     {
         //Get the node that the iterator points to a delete it
-        return remove(elementToDelete.nodePtr);
+        return removeOne(elementToDelete.nodePtr);
+    }
+
+    //Deletes every copy of a value from the tree. Returns how many values were deleted, which is 0 or 1 unless the tree uses bst_counted_keys
+    template<typename DataType = T>
+    int remove_all(DataType&& data)
+    {
+        const auto& key = lookupKey(data);
+        node* found = find(key, root);
+        if (found == nullptr)
+        {
+            return 0;
+        }
+        int removed = 1;
+        if constexpr (Counted)
+        {
+            removed = found->count;
+            valueCount -= removed;
+        }
+        removeNode(found);
+        return removed;
+    }
+
+    //Returns true if the value is in the tree
+    template<typename DataType>
+    bool contains(const DataType& data) const
+    {
+        const auto& key = lookupKey(data);
+        return find(key, static_cast<const node*>(root)) != nullptr;
+    }
+
+    //Returns how many times a value is in the tree, which is 0 or 1 unless the tree uses bst_counted_keys
+    template<typename DataType>
+    int count(const DataType& data) const
+    {
+        const auto& key = lookupKey(data);
+        const node* found = find(key, static_cast<const node*>(root));
+        if (found == nullptr)
+        {
+            return 0;
+        }
+        if constexpr (Counted)
+        {
+            return found->count;
+        }
+        return 1;
     }
 
     //Attempts to find data in the tree and returns an iterator to that data. If the data could not be found, then the end() iterator is returned
@@ -1083,7 +2575,8 @@ public:
     iterator find(DataType&& data)
     {
         //Find the data in the tree and return an iterator to it
-        return iterator(find(std::forward<DataType>(data), root), this);
+        const auto& key = lookupKey(data);
+        return iterator(find(key, root), this);
     }
 
     //Attempts to find data in the tree and returns an iterator to that data. If the data could not be found, then the end() iterator is returned
@@ -1091,7 +2584,106 @@ public:
     const_iterator find(DataType&& data) const
     {
         //Find the data in the tree and return an iterator to it
-        return const_iterator(find(std::forward<DataType>(data), root), this);
+        const auto& key = lookupKey(data);
+        return const_iterator(find(key, static_cast<const node*>(root)), this);
+    }
+
+    //Returns an iterator to the first value that is not less than "data". Returns end() if every value is less than "data"
+    template<typename DataType = T>
+    iterator lower_bound(const DataType& data)
+    {
+        const auto& key = lookupKey(data);
+        return iterator(boundNode(root, key, true), this);
+    }
+
+    //Returns an iterator to the first value that is not less than "data". Returns end() if every value is less than "data"
+    template<typename DataType = T>
+    const_iterator lower_bound(const DataType& data) const
+    {
+        const auto& key = lookupKey(data);
+        return const_iterator(boundNode(static_cast<const node*>(root), key, true), this);
+    }
+
+    //Returns an iterator to the first value that is greater than "data". Returns end() if no value is greater than "data"
+    template<typename DataType = T>
+    iterator upper_bound(const DataType& data)
+    {
+        const auto& key = lookupKey(data);
+        return iterator(boundNode(root, key, false), this);
+    }
+
+    //Returns an iterator to the first value that is greater than "data". Returns end() if no value is greater than "data"
+    template<typename DataType = T>
+    const_iterator upper_bound(const DataType& data) const
+    {
+        const auto& key = lookupKey(data);
+        return const_iterator(boundNode(static_cast<const node*>(root), key, false), this);
+    }
+
+    //Returns the range of values that are equal to "data". Since there are no duplicates, the range has either zero or one values
+    template<typename DataType = T>
+    std::pair<iterator, iterator> equal_range(const DataType& data)
+    {
+        return std::pair<iterator, iterator>(lower_bound(data), upper_bound(data));
+    }
+
+    //Returns the range of values that are equal to "data". Since there are no duplicates, the range has either zero or one values
+    template<typename DataType = T>
+    std::pair<const_iterator, const_iterator> equal_range(const DataType& data) const
+    {
+        return std::pair<const_iterator, const_iterator>(lower_bound(data), upper_bound(data));
+    }
+
+    //Returns an iterator to the largest value that is not greater than "data". Returns end() if every value is greater than "data"
+    template<typename DataType = T>
+    iterator floor(const DataType& data)
+    {
+        const auto& key = lookupKey(data);
+        return iterator(floorNode(root, key), this);
+    }
+
+    //Returns an iterator to the largest value that is not greater than "data". Returns end() if every value is greater than "data"
+    template<typename DataType = T>
+    const_iterator floor(const DataType& data) const
+    {
+        const auto& key = lookupKey(data);
+        return const_iterator(floorNode(static_cast<const node*>(root), key), this);
+    }
+
+    //Returns an iterator to the smallest value that is not less than "data". Returns end() if every value is less than "data"
+    template<typename DataType = T>
+    iterator ceiling(const DataType& data)
+    {
+        return lower_bound(data);
+    }
+
+    //Returns an iterator to the smallest value that is not less than "data". Returns end() if every value is less than "data"
+    template<typename DataType = T>
+    const_iterator ceiling(const DataType& data) const
+    {
+        return lower_bound(data);
+    }
+
+    //Returns a view over every value that is greater than or equal to "low" and less than "high". Finding the range takes O(log n) time,
+    //and iterating over it takes O(k) time for k values. If "high" is not greater than "low", then the range is empty
+    range_type range(const T& low, const T& high)
+    {
+        if (!comparer(low, high))
+        {
+            return range_type(end(), end());
+        }
+        return range_type(lower_bound(low), lower_bound(high));
+    }
+
+    //Returns a view over every value that is greater than or equal to "low" and less than "high". Finding the range takes O(log n) time,
+    //and iterating over it takes O(k) time for k values. If "high" is not greater than "low", then the range is empty
+    const_range_type range(const T& low, const T& high) const
+    {
+        if (!comparer(low, high))
+        {
+            return const_range_type(end(), end());
+        }
+        return const_range_type(lower_bound(low), lower_bound(high));
     }
 
     //Returns the largest value in the tree. Returns end() if the tree is empty
@@ -1173,11 +2765,336 @@ public:
         return const_iterator(root, this);
     }
 
+    //Returns an iterator to the value at an index, where index 0 is the smallest value. Returns end() if the index is out of range.
+    //This takes O(log n) time, and is only available when the tree uses the bst_order_statistics augmentation
+    iterator select(int index)
+    {
+        static_assert(OrderStatistics, "select() requires the bst_order_statistics augmentation");
+        return iterator(index >= 0 ? selectNode(root, index) : nullptr, this);
+    }
+
+    //Returns an iterator to the value at an index, where index 0 is the smallest value. Returns end() if the index is out of range.
+    //This takes O(log n) time, and is only available when the tree uses the bst_order_statistics augmentation
+    const_iterator select(int index) const
+    {
+        static_assert(OrderStatistics, "select() requires the bst_order_statistics augmentation");
+        return const_iterator(index >= 0 ? selectNode(static_cast<const node*>(root), index) : nullptr, this);
+    }
+
+    //Returns how many values in the tree are less than "data". If "data" is in the tree, this is its index.
+    //This takes O(log n) time, and is only available when the tree uses the bst_order_statistics augmentation
+    int rank(const T& data) const
+    {
+        static_assert(OrderStatistics, "rank() requires the bst_order_statistics augmentation");
+        int count = 0;
+        const node* current = root;
+        while (current != nullptr)
+        {
+            //If the node is less than the data, then it and its whole left subtree are counted
+            if (comparer(current->data, data))
+            {
+                count += getSubtreeSize(current->leftChild) + 1;
+                current = current->rightChild;
+            }
+            else
+            {
+                current = current->leftChild;
+            }
+        }
+        return count;
+    }
+
+    //Returns how many values in the tree are greater than or equal to "low" and less than "high".
+    //This takes O(log n) time, and is only available when the tree uses the bst_order_statistics augmentation
+    int count_range(const T& low, const T& high) const
+    {
+        static_assert(OrderStatistics, "count_range() requires the bst_order_statistics augmentation");
+        if (!comparer(low, high))
+        {
+            return 0;
+        }
+        return rank(high) - rank(low);
+    }
+
+    //Moves every value that is not less than "data" out of this tree, and returns them as a new tree that shares this tree's allocator.
+    //Splitting takes O(log n) time. Working out the size of the new tree takes O(1) time with the bst_order_statistics augmentation, and O(k) time for k moved values without it.
+    //Iterators to the moved values are invalidated. Only available for AVL trees
+    binary_search_tree<T, Comparer, Allocator, Augmentation, Balancing, Duplicates> split(const T& data)
+    {
+        checkJoinable();
+        binary_search_tree<T, Comparer, Allocator, Augmentation, Balancing, Duplicates> result{ Comparer(comparer), Allocator(allocator) };
+
+        node* left;
+        node* right;
+        node* found = split(root, data, left, right);
+        if (found != nullptr)
+        {
+            right = join(nullptr, found, right);
+        }
+        setJoinedRoot(left, treeSize);
+        result.setJoinedRoot(right, 0);
+
+        int movedCount = 0;
+        if constexpr (OrderStatistics)
+        {
+            movedCount = getSubtreeSize(right);
+        }
+        else
+        {
+            for (auto i = result.cbegin(); i != result.cend(); ++i)
+            {
+                movedCount++;
+            }
+        }
+        treeSize -= movedCount;
+        result.treeSize = movedCount;
+        return result;
+    }
+
+    //Moves every value of another tree to the end of this tree. Every value in "other" has to be greater than every value in this tree, or a struct_exception is thrown.
+    //This takes O(log n + log m) time, unless the two trees use allocators that can't free each other's nodes, in which case the values of "other" are copied.
+    //Only available for AVL trees
+    void join(binary_search_tree<T, Comparer, Allocator, Augmentation, Balancing, Duplicates>&& other)
+    {
+        checkJoinable();
+        if (&other == this || other.root == nullptr)
+        {
+            return;
+        }
+        if (root != nullptr && !comparer(maximum(root)->data, minimum(other.root)->data))
+        {
+            throw struct_exception("Every value of the joined tree has to be greater than every value of the tree");
+        }
+        int newSize = treeSize + other.treeSize;
+        node* right = takeNodes(std::move(other));
+        node* first = nullptr;
+        node* rest = splitFirst(right, first);
+        setJoinedRoot(join(root, first, rest), newSize);
+    }
+
+    //Adds every value of another tree to this tree, moving its nodes instead of copying them. The other tree is left empty.
+    //Merging m values into n values takes O(m log(n / m + 1)) work, where m is the size of the smaller tree. By default everything runs on the calling thread.
+    //With a "threadCount" above 1, the two halves of every split are worked on by different threads until that many threads are busy, and a thread count of 0 means
+    //one thread per core. The comparer must then be safe to call from several threads at once.
+    //If the comparer throws, the values of both trees are destroyed and this tree is left empty, since the pieces can't be put back together without comparing them again.
+    //Only available for AVL trees
+    void union_with(binary_search_tree<T, Comparer, Allocator, Augmentation, Balancing, Duplicates>&& other, int threadCount = 1)
+    {
+        checkJoinable();
+        if (&other == this)
+        {
+            return;
+        }
+        int totalSize = treeSize + other.treeSize;
+        node* otherRoot = takeNodes(std::move(other));
+        removed_nodes removed;
+        node* newRoot = runSetOperation(&binary_search_tree::unionNodes, otherRoot, removed, threadCount, totalSize);
+        setJoinedRoot(newRoot, totalSize - removed.matches);
+        destroyRemoved(removed);
+    }
+
+    //Adds every value of another tree to this tree. The values of "other" are copied first, which takes O(m) time
+    void union_with(const binary_search_tree<T, Comparer, Allocator, Augmentation, Balancing, Duplicates>& other, int threadCount = 1)
+    {
+        checkJoinable();
+        if (&other == this)
+        {
+            return;
+        }
+        int totalSize = treeSize + other.treeSize;
+        node* otherRoot = copyNodes(other);
+        removed_nodes removed;
+        node* newRoot = runSetOperation(&binary_search_tree::unionNodes, otherRoot, removed, threadCount, totalSize);
+        setJoinedRoot(newRoot, totalSize - removed.matches);
+        destroyRemoved(removed);
+    }
+
+    //Removes every value that isn't also in another tree. The other tree is left empty. See union_with() for the running time and threads
+    void intersect_with(binary_search_tree<T, Comparer, Allocator, Augmentation, Balancing, Duplicates>&& other, int threadCount = 1)
+    {
+        checkJoinable();
+        if (&other == this)
+        {
+            return;
+        }
+        int totalSize = treeSize + other.treeSize;
+        node* otherRoot = takeNodes(std::move(other));
+        removed_nodes removed;
+        node* newRoot = runSetOperation(&binary_search_tree::intersectNodes, otherRoot, removed, threadCount, totalSize);
+        setJoinedRoot(newRoot, removed.matches);
+        destroyRemoved(removed);
+    }
+
+    //Removes every value that isn't also in another tree. The values of "other" are copied first, which takes O(m) time
+    void intersect_with(const binary_search_tree<T, Comparer, Allocator, Augmentation, Balancing, Duplicates>& other, int threadCount = 1)
+    {
+        checkJoinable();
+        if (&other == this)
+        {
+            return;
+        }
+        int totalSize = treeSize + other.treeSize;
+        node* otherRoot = copyNodes(other);
+        removed_nodes removed;
+        node* newRoot = runSetOperation(&binary_search_tree::intersectNodes, otherRoot, removed, threadCount, totalSize);
+        setJoinedRoot(newRoot, removed.matches);
+        destroyRemoved(removed);
+    }
+
+    //Removes every value that is also in another tree. The other tree is left empty. See union_with() for the running time and threads
+    void difference(binary_search_tree<T, Comparer, Allocator, Augmentation, Balancing, Duplicates>&& other, int threadCount = 1)
+    {
+        checkJoinable();
+        if (&other == this)
+        {
+            clear();
+            return;
+        }
+        int totalSize = treeSize + other.treeSize;
+        node* otherRoot = takeNodes(std::move(other));
+        removed_nodes removed;
+        node* newRoot = runSetOperation(&binary_search_tree::differenceNodes, otherRoot, removed, threadCount, totalSize);
+        setJoinedRoot(newRoot, treeSize - removed.matches);
+        destroyRemoved(removed);
+    }
+
+    //Removes every value that is also in another tree. The values of "other" are copied first, which takes O(m) time
+    void difference(const binary_search_tree<T, Comparer, Allocator, Augmentation, Balancing, Duplicates>& other, int threadCount = 1)
+    {
+        checkJoinable();
+        if (&other == this)
+        {
+            clear();
+            return;
+        }
+        int totalSize = treeSize + other.treeSize;
+        node* otherRoot = copyNodes(other);
+        removed_nodes removed;
+        node* newRoot = runSetOperation(&binary_search_tree::differenceNodes, otherRoot, removed, threadCount, totalSize);
+        setJoinedRoot(newRoot, treeSize - removed.matches);
+        destroyRemoved(removed);
+    }
+
+    //Inserts every value of a range. Returns how many values were inserted, which doesn't count the values that were already in the tree or repeated in the range.
+    //The values are sorted first. An AVL tree then builds a balanced subtree out of them and merges it in with union_with(), which splits and joins the tree
+    //and rebalances each affected subtree once. This takes O(m log(n / m + 1)) time after sorting, instead of O(m log n) for m calls to insert().
+    //Other trees insert the sorted values one at a time, starting each search from the node of the value before it instead of from the root.
+    //A thread count other than 1 lets union_with() merge on several threads. See union_with()
+    template<typename Iterator>
+    int insert_batch(Iterator begin, Iterator end, int threadCount = 1)
+    {
+        std::vector<T> values(begin, end);
+        int oldSize = getSize();
+        if constexpr (!RedBlack && !Counted)
+        {
+            if (selfBalancing)
+            {
+                sortValues(values, comparer, true);
+                binary_search_tree<T, Comparer, Allocator, Augmentation, Balancing, Duplicates> batch{ Comparer(comparer), allocator };
+                batch.assignSorted(std::make_move_iterator(values.begin()), static_cast<int>(values.size()));
+                union_with(std::move(batch), threadCount);
+                return getSize() - oldSize;
+            }
+        }
+
+        //A multiset keeps the repeated values, so each one adds to the count of its node
+        sortValues(values, comparer, !Counted);
+        node* finger = nullptr;
+        for (T& value : values)
+        {
+            if (finger == nullptr)
+            {
+                finger = insert(std::move(value)).nodePtr;
+            }
+            else
+            {
+                node* inserted = insertNear(finger, std::move(value));
+                finger = inserted != nullptr ? inserted : finger;
+            }
+        }
+        return getSize() - oldSize;
+    }
+
+    //Inserts every value of a list. See insert_batch()
+    int insert_batch(std::initializer_list<T> list, int threadCount = 1)
+    {
+        return insert_batch(list.begin(), list.end(), threadCount);
+    }
+
+    //Removes every value of a range. Returns how many values were removed. The values are sorted first. An AVL tree then splits itself at the middle value,
+    //removes each half of the values from each half of the tree and joins the halves again, which takes O(m log(n / m + 1)) time after sorting and doesn't allocate any nodes.
+    //Other trees remove the sorted values one at a time. In a multiset, each value in the range removes one copy.
+    //If the comparer throws while the values are sorted, the tree is unchanged. If it throws while an AVL tree is split apart, the tree is left empty
+    template<typename Iterator>
+    int erase_batch(Iterator begin, Iterator end)
+    {
+        std::vector<T> values(begin, end);
+        if constexpr (!RedBlack && !Counted)
+        {
+            if (selfBalancing)
+            {
+                sortValues(values, comparer, true);
+                removed_nodes removed;
+                removed.subTrees.reserve(values.size());
+                node* newRoot;
+                try
+                {
+                    newRoot = eraseSorted(root, values.data(), static_cast<int>(values.size()), removed);
+                }
+                catch (...)
+                {
+                    abandonJoinedRoot(removed);
+                    throw;
+                }
+                setJoinedRoot(newRoot, treeSize - removed.matches);
+                destroyRemoved(removed);
+                return removed.matches;
+            }
+        }
+
+        sortValues(values, comparer, false);
+        int oldSize = getSize();
+        for (const T& value : values)
+        {
+            remove(value);
+        }
+        return oldSize - getSize();
+    }
+
+    //Removes every value of a list. See erase_batch()
+    int erase_batch(std::initializer_list<T> list)
+    {
+        return erase_batch(list.begin(), list.end());
+    }
+
+    //Creates a read-only copy of the tree that stores the values in a single array, which is much faster to search on large trees. See frozen_search_tree.
+    //This takes O(n) time, so a frozen copy can be rebuilt whenever the tree has changed enough. A multiset stores each distinct value once in the frozen copy
+    frozen_search_tree<T, Comparer> freeze() const
+    {
+        std::vector<T> sorted;
+        sorted.reserve(treeSize);
+        for (auto i = begin(); i != end(); ++i)
+        {
+            sorted.push_back(*i);
+        }
+        return frozen_search_tree<T, Comparer>(sorted.begin(), sorted.end(), comparer);
+    }
+
     //Sets whether the tree is self balancing or not. By default, it is turned on
+    //Turning it back on for a red-black tree rebuilds the tree as a perfectly balanced tree, since the colors of the nodes can't be worked out for a tree of any shape
     void setSelfBalancing(bool value)
     {
+        if constexpr (RedBlack)
+        {
+            if (selfBalancing != value && value == true && root != nullptr)
+            {
+                //The new nodes are built from the old ones before the old ones are freed
+                assignSorted(cbegin(), treeSize, valueCount);
+            }
+            selfBalancing = value;
+        }
         //If the self balancing is being enabled
-        if (selfBalancing != value && value == true)
+        else if (selfBalancing != value && value == true)
         {
             //Update the field value
             selfBalancing = value;
@@ -1203,8 +3120,18 @@ public:
         return selfBalancing;
     }
 
-    //Gets how many elements are in the tree
+    //Gets how many elements are in the tree. In a multiset every copy of a value is counted
     int getSize() const
+    {
+        if constexpr (Counted)
+        {
+            return valueCount;
+        }
+        return treeSize;
+    }
+
+    //Gets how many different values are in the tree. This is the number of nodes, and is the same as getSize() unless the tree uses bst_counted_keys
+    int getDistinctSize() const
     {
         return treeSize;
     }
@@ -1215,11 +3142,11 @@ public:
         //The list of elements
         std::vector<T> elements{};
 
-        //Loop over all the values from lowest to largest
+        //Loop over all the values from lowest to largest. In a multiset, each value is added as many times as it is in the tree
         for (auto i = begin(); i != end(); i++)
         {
             //Add them to the list
-            elements.push_back(*i);
+            elements.insert(elements.end(), i.getCount(), *i);
         }
         //Return the list
         return elements;
@@ -1230,11 +3157,11 @@ public:
     {
         std::vector<T> elements{};
 
-        //Loop over all the values from lowest to largest
+        //Loop over all the values from lowest to largest. In a multiset, each value is added as many times as it is in the tree
         for (auto i = begin(); i != end(); i++)
         {
             //Add them to the list
-            elements.push_back(*i);
+            elements.insert(elements.end(), i.getCount(), *i);
         }
         //Return the list
         return elements;
@@ -1242,39 +3169,28 @@ public:
 };
 
 //Used for printing the tree to a stream
-template<typename T, typename Comparer>
-std::ostream& operator<<(std::ostream& stream, const binary_search_tree<T, Comparer>& tree)
+template<typename T, typename Comparer, typename Allocator, typename Augmentation, typename Balancing, typename Duplicates>
+std::ostream& operator<<(std::ostream& stream, const binary_search_tree<T, Comparer, Allocator, Augmentation, Balancing, Duplicates>& tree)
 {
-    //Get the size of the tree
-    int size = tree.getSize();
-    //if the tree is empty
-    if (size == 0)
+    //Print the beginning bracket
+    stream << "[";
+    bool first = true;
+    //Loop over all the values in the tree. In a multiset, each value is printed as many times as it is in the tree
+    for (auto i = tree.begin(); i != tree.end(); ++i)
     {
-        //Print a pair of brackets
-        stream << "[]";
-    }
-    //If the tree size is greater than 1
-    else
-    {
-        //Print the beginning bracket
-        stream << "[";
-        //Get the beginning of the tree
-        auto beginning = tree.begin();
-
-        //Loop over all the values except the last in the tree
-        for (int i = 0; i < (size - 1); i++)
+        for (int copy = 0; copy < i.getCount(); copy++)
         {
-            //Print them to the stream
-            stream << *beginning << ", ";
-
-            //Increment the beginning iterator
-            ++beginning;
+            //Every value except the first is separated from the one before it
+            if (!first)
+            {
+                stream << ", ";
+            }
+            stream << *i;
+            first = false;
         }
-
-        //Print the last value of the tree along with a closing bracket
-        stream << *beginning << "]";
     }
+    //Print the closing bracket
+    stream << "]";
     //Return a reference to the stream
     return stream;
 }
-
@@ -0,0 +1,280 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+#include <common.h>
+#include <struct_exception.h>
+#include <binary_search_tree.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BLOOM_FILTER_SSE2 1
+#endif
+
+//This namespace contains implementation details
+namespace bloom_impl
+{
+	//Odd constants that spread a 32-bit hash over the eight words of a block. Each one picks the bit that is set in one word
+	constexpr std::uint32_t Salts[8] = { 0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU, 0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U };
+}
+
+//An approximate set that answers "is this value definitely not in the set?" using a few bits per value. might_contain() never returns false for a value that was inserted,
+//but returns true for a small fraction of values that weren't (the false positive rate). Values can't be removed, because their bits are shared with other values.
+//The bits are split into blocks of 256 bits, and each value sets one bit in each of the eight 32-bit words of a single block. Blocks are 32 bytes and aligned,
+//so a lookup reads one cache line, and the eight words are checked at once with SSE2 when it is available
+template<typename T, typename Hasher = std::hash<T>>
+class blocked_bloom_filter
+{
+	//Eight 32-bit words. A value is in the filter if all of its eight bits are set
+	struct alignas(32) block
+	{
+		std::uint32_t words[8];
+	};
+
+	std::vector<block> blocks;
+	Hasher hasher{};
+	int valueCount = 0;
+	int expectedCount = 0;
+
+	//Works out how many blocks are needed to keep the false positive rate of "count" values at about "falsePositiveRate"
+	static std::size_t blocksFor(int count, double falsePositiveRate)
+	{
+		if (!(falsePositiveRate > 0.0 && falsePositiveRate < 1.0))
+		{
+			throw struct_exception("The false positive rate must be between 0 and 1");
+		}
+		//A plain Bloom filter needs 1.44 * log2(1 / rate) bits per value. Keeping every bit of a value in one block makes some blocks fuller than others,
+		//which is made up for with about a fifth more bits. Every value sets eight bits, which needs at least eight bits per value to keep the rate low
+		double bitsPerValue = std::max(8.0, 1.2 * 1.44 * std::log2(1.0 / falsePositiveRate));
+		double blockCount = std::ceil(bitsPerValue * (count > 0 ? count : 1) / 256.0);
+		return blockCount < 1.0 ? 1 : static_cast<std::size_t>(blockCount);
+	}
+
+	//Picks a block with the upper 32 bits of the hash, by scaling them to the number of blocks instead of using a slow modulo
+	std::size_t blockIndex(std::uint64_t hash) const
+	{
+		return static_cast<std::size_t>(((hash >> 32) * blocks.size()) >> 32);
+	}
+
+	//Works out which bit of each word the lower 32 bits of the hash set
+	static void makeMasks(std::uint64_t hash, std::uint32_t (&masks)[8])
+	{
+		std::uint32_t key = static_cast<std::uint32_t>(hash);
+		for (int i = 0; i < 8; i++)
+		{
+			masks[i] = 1U << ((key * bloom_impl::Salts[i]) >> 27);
+		}
+	}
+
+	std::uint64_t hashOf(const T& value) const
+	{
+		return hash_impl::mix(static_cast<std::uint64_t>(hasher(value)));
+	}
+
+public:
+	//Creates a filter sized for "expectedCount" values with a false positive rate of about "falsePositiveRate". Inserting more values than expected raises the rate.
+	//Throws a struct_exception if the rate isn't between 0 and 1
+	blocked_bloom_filter(int expectedCount = 1024, double falsePositiveRate = 0.01) :
+		blocks(blocksFor(expectedCount, falsePositiveRate), block{}),
+		expectedCount(expectedCount)
+	{
+	}
+
+	//Adds a value to the filter
+	void insert(const T& value)
+	{
+		std::uint64_t hash = hashOf(value);
+		alignas(16) std::uint32_t masks[8];
+		makeMasks(hash, masks);
+		block& target = blocks[blockIndex(hash)];
+#if defined(BLOOM_FILTER_SSE2)
+		__m128i* words = reinterpret_cast<__m128i*>(target.words);
+		_mm_store_si128(words, _mm_or_si128(_mm_load_si128(words), _mm_load_si128(reinterpret_cast<const __m128i*>(masks))));
+		_mm_store_si128(words + 1, _mm_or_si128(_mm_load_si128(words + 1), _mm_load_si128(reinterpret_cast<const __m128i*>(masks + 4))));
+#else
+		for (int i = 0; i < 8; i++)
+		{
+			target.words[i] |= masks[i];
+		}
+#endif
+		valueCount++;
+	}
+
+	//Adds every value in a range to the filter
+	template<typename Iterator>
+	void insert(Iterator begin, Iterator end)
+	{
+		for (; begin != end; ++begin)
+		{
+			insert(*begin);
+		}
+	}
+
+	//Returns false if the value is definitely not in the filter, and true if it probably is
+	bool might_contain(const T& value) const
+	{
+		std::uint64_t hash = hashOf(value);
+		alignas(16) std::uint32_t masks[8];
+		makeMasks(hash, masks);
+		const block& target = blocks[blockIndex(hash)];
+#if defined(BLOOM_FILTER_SSE2)
+		//Each word has its bit set if the word ANDed with the mask equals the mask. All sixteen bytes of both halves have to match
+		const __m128i* words = reinterpret_cast<const __m128i*>(target.words);
+		__m128i low = _mm_load_si128(reinterpret_cast<const __m128i*>(masks));
+		__m128i high = _mm_load_si128(reinterpret_cast<const __m128i*>(masks + 4));
+		__m128i matches = _mm_and_si128(_mm_cmpeq_epi32(_mm_and_si128(_mm_load_si128(words), low), low),
+			_mm_cmpeq_epi32(_mm_and_si128(_mm_load_si128(words + 1), high), high));
+		return _mm_movemask_epi8(matches) == 0xFFFF;
+#else
+		for (int i = 0; i < 8; i++)
+		{
+			if ((target.words[i] & masks[i]) == 0)
+			{
+				return false;
+			}
+		}
+		return true;
+#endif
+	}
+
+	//Removes every value from the filter, keeping its size
+	void clear()
+	{
+		std::fill(blocks.begin(), blocks.end(), block{});
+		valueCount = 0;
+	}
+
+	//Returns how many values have been inserted since the filter was created or cleared. Values inserted more than once are counted each time
+	int getSize() const
+	{
+		return valueCount;
+	}
+
+	//Returns how many values the filter was sized for
+	int getExpectedCount() const
+	{
+		return expectedCount;
+	}
+
+	//Returns how many bytes the bits of the filter take up
+	std::size_t getByteSize() const
+	{
+		return blocks.size() * sizeof(block);
+	}
+};
+
+//Wraps a set, such as a binary_search_tree, compact_search_tree, btree_set or skip_list, with a blocked_bloom_filter that is kept in sync with it.
+//contains(), find() and remove() ask the filter first, so most searches for values that aren't in the set are answered by reading one cache line instead of searching the set.
+//Removed values stay in the filter until it is rebuilt. Once the live and removed values in the filter are more than it was sized for, it is rebuilt from the set in O(n),
+//sized for twice as many values as the set has. This keeps the false positive rate near its target, and costs O(1) amortized per insert and remove.
+//The set must only be changed through the wrapper, or the filter will miss values
+template<typename T, typename Set = binary_search_tree<T>, typename Hasher = std::hash<T>>
+class bloom_filtered_set
+{
+	Set set;
+	blocked_bloom_filter<T, Hasher> filter;
+	double falsePositiveRate;
+	int removedCount = 0; //How many removed values are still in the filter
+
+	//Rebuilds the filter once the live and removed values in it are more than it was sized for
+	void rebuildIfNeeded()
+	{
+		if (set.getSize() + removedCount > filter.getExpectedCount())
+		{
+			rebuild();
+		}
+	}
+
+public:
+	//Creates an empty set with a filter sized for "expectedCount" values. The filter grows with the set, so this only avoids the first few rebuilds
+	bloom_filtered_set(int expectedCount = 1024, double falsePositiveRate = 0.01) :
+		filter(expectedCount, falsePositiveRate),
+		falsePositiveRate(falsePositiveRate)
+	{
+	}
+
+	//Wraps a set that already has values in it
+	bloom_filtered_set(Set&& existing, double falsePositiveRate = 0.01) :
+		set(std::move(existing)),
+		filter(1, falsePositiveRate),
+		falsePositiveRate(falsePositiveRate)
+	{
+		rebuild();
+	}
+
+	//Inserts a value into the set and the filter. Returns whatever the insert() of the set returns
+	template<typename DataType>
+	decltype(auto) insert(DataType&& data)
+	{
+		//The filter is updated first, so a value is never in the set without being in the filter
+		filter.insert(data);
+		decltype(auto) result = set.insert(std::forward<DataType>(data));
+		rebuildIfNeeded();
+		return result;
+	}
+
+	//Removes a value from the set. Returns true if it was in the set. Values that the filter rules out are never searched for
+	bool remove(const T& data)
+	{
+		if (!filter.might_contain(data) || !set.remove(data))
+		{
+			return false;
+		}
+		removedCount++;
+		rebuildIfNeeded();
+		return true;
+	}
+
+	//Returns true if the value is in the set
+	bool contains(const T& data) const
+	{
+		return filter.might_contain(data) && set.contains(data);
+	}
+
+	//Finds a value in the set. Returns the end() of the set if it's not there
+	decltype(auto) find(const T& data) const
+	{
+		return filter.might_contain(data) ? set.find(data) : set.end();
+	}
+
+	//Rebuilds the filter from the values in the set, sized for twice as many values so that it doesn't have to be rebuilt again soon
+	void rebuild()
+	{
+		int size = set.getSize();
+		filter = blocked_bloom_filter<T, Hasher>(size > 512 ? size * 2 : 1024, falsePositiveRate);
+		for (const T& value : set)
+		{
+			filter.insert(value);
+		}
+		removedCount = 0;
+	}
+
+	//Removes every value from the set and the filter
+	void clear()
+	{
+		set.clear();
+		filter.clear();
+		removedCount = 0;
+	}
+
+	int getSize() const
+	{
+		return set.getSize();
+	}
+
+	//Gets the wrapped set, for reading or iterating over it
+	const Set& getSet() const
+	{
+		return set;
+	}
+
+	const blocked_bloom_filter<T, Hasher>& getFilter() const
+	{
+		return filter;
+	}
+};
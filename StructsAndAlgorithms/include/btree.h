@@ -0,0 +1,1176 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <ostream>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <common.h>
+#include <struct_exception.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BTREE_SSE2 1
+#endif
+
+//This namespace contains implementation details
+namespace btree_impl
+{
+	//The default size of a node in bytes. Four cache lines gives leaves of about 60 ints, and a search only touches a few cache lines per node
+	constexpr std::size_t DefaultNodeBytes = CacheLineSize * 4;
+
+	//Used as the value type of a btree_set, which only stores keys
+	struct no_value {};
+
+	//Rounds "size" up to a multiple of "alignment"
+	constexpr std::size_t align_up(std::size_t size, std::size_t alignment)
+	{
+		return (size + alignment - 1) / alignment * alignment;
+	}
+
+	//Works out the size of a node that has a "header" sized header, then "keyCount" keys, then "valueCount" values, then "pointerCount" pointers.
+	//Every part is padded to its alignment, and the node is padded to whole cache lines
+	template<typename Key, typename Value>
+	constexpr std::size_t node_bytes(std::size_t header, int keyCount, int valueCount, int pointerCount)
+	{
+		std::size_t alignment = alignof(Key) > alignof(void*) ? alignof(Key) : alignof(void*);
+		alignment = alignof(Value) > alignment ? alignof(Value) : alignment;
+		std::size_t size = align_up(header, alignment) + sizeof(Key) * keyCount;
+		if (valueCount > 0)
+		{
+			size = align_up(size, alignof(Value)) + sizeof(Value) * valueCount;
+		}
+		size = align_up(size, alignof(void*)) + sizeof(void*) * pointerCount;
+		return align_up(size, CacheLineSize);
+	}
+
+	//Works out how many keys fit into a node of "nodeBytes" bytes. Each key comes with "valuesPerKey" values, and the node also has "extraValues" values and "pointerCount" pointers.
+	//Nodes always hold at least 4 keys, even if that makes them larger than "nodeBytes"
+	template<typename Key, typename Value>
+	constexpr int node_capacity(std::size_t nodeBytes, std::size_t header, int valuesPerKey, int extraValues, int pointerCount)
+	{
+		int capacity = static_cast<int>(nodeBytes / (sizeof(Key) + sizeof(Value) * valuesPerKey));
+		while (capacity > 4 && node_bytes<Key, Value>(header, capacity, capacity * valuesPerKey + extraValues, pointerCount) > nodeBytes)
+		{
+			capacity--;
+		}
+		return capacity > 4 ? capacity : 4;
+	}
+
+	//Counts how many of the first "count" keys are less than "key". The keys are sorted, so this is the index of the first key that is not less than "key".
+	//Every key is compared without branching, four at a time with SSE2 for 32-bit integers and floats, and two at a time for doubles
+	template<typename T>
+	int count_less(const T* keys, int count, const T& key)
+	{
+		int result = 0;
+		int i = 0;
+#if defined(BTREE_SSE2)
+		if constexpr (std::is_integral<T>::value && std::is_signed<T>::value && sizeof(T) == 4)
+		{
+			__m128i needle = _mm_set1_epi32(static_cast<int>(key));
+			//Each lane that is less than the key is -1, so subtracting the comparison adds 1 for each of those lanes
+			__m128i totals = _mm_setzero_si128();
+			for (; i + 4 <= count; i += 4)
+			{
+				__m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i));
+				totals = _mm_sub_epi32(totals, _mm_cmplt_epi32(values, needle));
+			}
+			alignas(16) int lanes[4];
+			_mm_store_si128(reinterpret_cast<__m128i*>(lanes), totals);
+			result = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+		}
+		else if constexpr (std::is_same<T, float>::value)
+		{
+			__m128 needle = _mm_set1_ps(key);
+			__m128i totals = _mm_setzero_si128();
+			for (; i + 4 <= count; i += 4)
+			{
+				__m128 values = _mm_loadu_ps(keys + i);
+				totals = _mm_sub_epi32(totals, _mm_castps_si128(_mm_cmplt_ps(values, needle)));
+			}
+			alignas(16) int lanes[4];
+			_mm_store_si128(reinterpret_cast<__m128i*>(lanes), totals);
+			result = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+		}
+		else if constexpr (std::is_same<T, double>::value)
+		{
+			__m128d needle = _mm_set1_pd(key);
+			__m128i totals = _mm_setzero_si128();
+			for (; i + 2 <= count; i += 2)
+			{
+				__m128d values = _mm_loadu_pd(keys + i);
+				totals = _mm_sub_epi64(totals, _mm_castpd_si128(_mm_cmplt_pd(values, needle)));
+			}
+			alignas(16) long long lanes[2];
+			_mm_store_si128(reinterpret_cast<__m128i*>(lanes), totals);
+			result = static_cast<int>(lanes[0] + lanes[1]);
+		}
+#endif
+		//Compare the rest of the keys one at a time
+		for (; i < count; i++)
+		{
+			result += static_cast<int>(keys[i] < key);
+		}
+		return result;
+	}
+
+	//The core of btree_set and btree_map. This is a B+ tree, where every key is stored in a leaf, and the leaves are linked together in sorted order.
+	//The internal nodes only store separator keys, where every key in child i is less than or equal to separator i, and greater than separator i - 1.
+	//Each node is sized to "NodeBytes" and aligned to a cache line. If "Mapped" is no_value, then only keys are stored
+	template<typename Key, typename Mapped, typename Comparer, std::size_t NodeBytes>
+	class btree
+	{
+	protected:
+		//Whether a value is stored with each key
+		static constexpr bool IsMap = !std::is_same<Mapped, no_value>::value;
+
+		//The part that every node starts with
+		struct node
+		{
+			int count = 0; //How many keys are in the node
+			bool isLeaf; //Whether the node is a leaf or an internal node
+
+			node(bool isLeaf) : isLeaf(isLeaf) {}
+		};
+
+		//How many keys fit into a leaf and into an internal node. Nodes always hold at least 4 keys, even if that makes them larger than "NodeBytes"
+		static constexpr int LeafCapacity = node_capacity<Key, Mapped>(NodeBytes, sizeof(node), IsMap ? 1 : 0, 0, 2);
+		static constexpr int InternalCapacity = node_capacity<Key, node*>(NodeBytes, sizeof(node), 1, 1, 0);
+		//Every node apart from the root has at least this many keys. Splitting a full internal node moves its middle key up to the parent,
+		//so only "InternalCapacity - 1" keys are left for the two halves
+		static constexpr int LeafMinimum = LeafCapacity / 2;
+		static constexpr int InternalMinimum = (InternalCapacity - 1) / 2;
+
+		struct leaf;
+
+		//The contents of a leaf of a map, which stores a value with each key
+		template<bool HasValues, typename Unused = void>
+		struct leaf_entries
+		{
+			Key keys[LeafCapacity];
+			Mapped values[LeafCapacity];
+			leaf* next = nullptr; //The leaf with the next larger keys
+			leaf* previous = nullptr; //The leaf with the next smaller keys
+		};
+
+		//The contents of a leaf of a set, which only stores keys
+		template<typename Unused>
+		struct leaf_entries<false, Unused>
+		{
+			Key keys[LeafCapacity];
+			leaf* next = nullptr; //The leaf with the next larger keys
+			leaf* previous = nullptr; //The leaf with the next smaller keys
+		};
+
+		//A node that stores keys, and values if this is a map
+		struct alignas(CacheLineSize) leaf : node, leaf_entries<IsMap>
+		{
+			leaf() : node(true) {}
+		};
+
+		//A node that stores separator keys and the children between them
+		struct alignas(CacheLineSize) internal : node
+		{
+			Key keys[InternalCapacity];
+			node* children[InternalCapacity + 1];
+
+			internal() : node(false) {}
+		};
+
+		static_assert(sizeof(leaf) <= NodeBytes || LeafCapacity == 4, "A leaf must fit into NodeBytes");
+		static_assert(sizeof(internal) <= NodeBytes || InternalCapacity == 4, "An internal node must fit into NodeBytes");
+
+		node* root = nullptr;
+		leaf* firstLeaf = nullptr;
+		leaf* lastLeaf = nullptr;
+		int treeSize = 0;
+		int height = 0;
+		Comparer comparer;
+		//Whether the comparer is the < operator, which lets numbers be compared directly
+		bool naturalOrder = false;
+
+		//Returns true if "a" comes before "b"
+		bool less(const Key& a, const Key& b) const
+		{
+			if constexpr (std::is_arithmetic<Key>::value)
+			{
+				if (naturalOrder)
+				{
+					return a < b;
+				}
+			}
+			return comparer(a, b);
+		}
+
+		//Gets the index of the first key in a node that is not less than "key"
+		int lowerBoundIn(const Key* keys, int count, const Key& key) const
+		{
+			if constexpr (std::is_arithmetic<Key>::value)
+			{
+				if (naturalOrder)
+				{
+					return count_less(keys, count, key);
+				}
+			}
+			return static_cast<int>(std::lower_bound(keys, keys + count, key, [this](const Key& a, const Key& b) { return static_cast<bool>(comparer(a, b)); }) - keys);
+		}
+
+		//Deletes a node and every node below it
+		static void deleteNode(node* n)
+		{
+			if (n->isLeaf)
+			{
+				delete static_cast<leaf*>(n);
+			}
+			else
+			{
+				internal* in = static_cast<internal*>(n);
+				for (int i = 0; i <= in->count; i++)
+				{
+					deleteNode(in->children[i]);
+				}
+				delete in;
+			}
+		}
+
+		//Moves a key, and its value if this is a map, from one leaf slot to another
+		static void moveSlot(leaf* from, int fromIndex, leaf* to, int toIndex)
+		{
+			to->keys[toIndex] = std::move(from->keys[fromIndex]);
+			if constexpr (IsMap)
+			{
+				to->values[toIndex] = std::move(from->values[fromIndex]);
+			}
+		}
+
+		//Shifts the slots of a leaf from "index" onwards one place to the right
+		static void shiftRight(leaf* l, int index)
+		{
+			std::move_backward(l->keys + index, l->keys + l->count, l->keys + l->count + 1);
+			if constexpr (IsMap)
+			{
+				std::move_backward(l->values + index, l->values + l->count, l->values + l->count + 1);
+			}
+		}
+
+		//Shifts the slots of a leaf after "index" one place to the left, overwriting the slot at "index"
+		static void shiftLeft(leaf* l, int index)
+		{
+			std::move(l->keys + index + 1, l->keys + l->count, l->keys + index);
+			if constexpr (IsMap)
+			{
+				std::move(l->values + index + 1, l->values + l->count, l->values + index);
+			}
+		}
+
+		//Splits the full child at "index" of a parent into two nodes, and adds the separator between them to the parent. The parent must not be full
+		void splitChild(internal* parent, int index)
+		{
+			node* child = parent->children[index];
+			node* right;
+			Key separator;
+
+			if (child->isLeaf)
+			{
+				leaf* left = static_cast<leaf*>(child);
+				leaf* newLeaf = new leaf();
+				//The right half of the keys go to the new leaf
+				int keep = left->count / 2;
+				for (int i = keep; i < left->count; i++)
+				{
+					moveSlot(left, i, newLeaf, i - keep);
+				}
+				newLeaf->count = left->count - keep;
+				left->count = keep;
+
+				//Link the new leaf in after the old one
+				newLeaf->next = left->next;
+				newLeaf->previous = left;
+				if (left->next != nullptr)
+				{
+					left->next->previous = newLeaf;
+				}
+				else
+				{
+					lastLeaf = newLeaf;
+				}
+				left->next = newLeaf;
+
+				//Every key in the left leaf is less than or equal to its last key
+				separator = left->keys[keep - 1];
+				right = newLeaf;
+			}
+			else
+			{
+				internal* left = static_cast<internal*>(child);
+				internal* newInternal = new internal();
+				//The middle key moves up to the parent, and the keys and children after it go to the new node
+				int middle = left->count / 2;
+				separator = std::move(left->keys[middle]);
+				std::move(left->keys + middle + 1, left->keys + left->count, newInternal->keys);
+				std::copy(left->children + middle + 1, left->children + left->count + 1, newInternal->children);
+				newInternal->count = left->count - middle - 1;
+				left->count = middle;
+				right = newInternal;
+			}
+
+			//Insert the separator and the new node into the parent
+			std::move_backward(parent->keys + index, parent->keys + parent->count, parent->keys + parent->count + 1);
+			std::copy_backward(parent->children + index + 1, parent->children + parent->count + 1, parent->children + parent->count + 2);
+			parent->keys[index] = std::move(separator);
+			parent->children[index + 1] = right;
+			parent->count++;
+		}
+
+		//Returns true if a node has no room for another key
+		static bool isFull(const node* n)
+		{
+			return n->count == (n->isLeaf ? LeafCapacity : InternalCapacity);
+		}
+
+		//Inserts a key, and a value if this is a map. Full nodes are split on the way down, so there is always room in the leaf at the bottom.
+		//Returns the leaf and the index of the new key, or a null leaf if the key is already in the tree
+		template<typename KeyType, typename... ValueArgs>
+		std::pair<leaf*, int> insertKey(KeyType&& key, ValueArgs&&... value)
+		{
+			if (root == nullptr)
+			{
+				leaf* newLeaf = new leaf();
+				root = newLeaf;
+				firstLeaf = newLeaf;
+				lastLeaf = newLeaf;
+				height = 1;
+			}
+			//If the root is full, then it becomes the child of a new root and gets split
+			else if (isFull(root))
+			{
+				internal* newRoot = new internal();
+				newRoot->children[0] = root;
+				root = newRoot;
+				height++;
+				splitChild(newRoot, 0);
+			}
+
+			node* current = root;
+			while (!current->isLeaf)
+			{
+				internal* in = static_cast<internal*>(current);
+				int index = lowerBoundIn(in->keys, in->count, key);
+				if (isFull(in->children[index]))
+				{
+					splitChild(in, index);
+					//The key goes to the new right node if it is greater than the new separator
+					if (less(in->keys[index], key))
+					{
+						index++;
+					}
+				}
+				current = in->children[index];
+			}
+
+			leaf* l = static_cast<leaf*>(current);
+			int index = lowerBoundIn(l->keys, l->count, key);
+			//If the key is already in the tree, then don't insert it
+			if (index < l->count && !less(key, l->keys[index]))
+			{
+				return std::pair<leaf*, int>(nullptr, 0);
+			}
+
+			shiftRight(l, index);
+			l->keys[index] = std::forward<KeyType>(key);
+			if constexpr (IsMap)
+			{
+				l->values[index] = Mapped(std::forward<ValueArgs>(value)...);
+			}
+			l->count++;
+			treeSize++;
+			return std::pair<leaf*, int>(l, index);
+		}
+
+		//Finds the leaf and index of the first key that is not less than "key". Returns a null leaf if every key is less than "key"
+		std::pair<leaf*, int> lowerBoundSlot(const Key& key) const
+		{
+			if (root == nullptr)
+			{
+				return std::pair<leaf*, int>(nullptr, 0);
+			}
+			node* current = root;
+			while (!current->isLeaf)
+			{
+				internal* in = static_cast<internal*>(current);
+				current = in->children[lowerBoundIn(in->keys, in->count, key)];
+			}
+			leaf* l = static_cast<leaf*>(current);
+			int index = lowerBoundIn(l->keys, l->count, key);
+			//If every key in the leaf is less, then the answer is the first key of the next leaf
+			if (index == l->count)
+			{
+				return std::pair<leaf*, int>(l->next, 0);
+			}
+			return std::pair<leaf*, int>(l, index);
+		}
+
+		//Finds the leaf and index of a key, or a null leaf if the key isn't in the tree
+		std::pair<leaf*, int> findSlot(const Key& key) const
+		{
+			auto slot = lowerBoundSlot(key);
+			if (slot.first != nullptr && less(key, slot.first->keys[slot.second]))
+			{
+				return std::pair<leaf*, int>(nullptr, 0);
+			}
+			return slot;
+		}
+
+		//Removes a key from the tree. Nodes that end up with too few keys borrow a key from a sibling, or are merged with one. Returns true if the key was removed
+		bool removeKey(const Key& key)
+		{
+			if (root == nullptr)
+			{
+				return false;
+			}
+
+			//Remember the path down to the leaf, so the nodes above can be fixed afterwards
+			internal* parents[64];
+			int childIndexes[64];
+			int depth = 0;
+
+			node* current = root;
+			while (!current->isLeaf)
+			{
+				internal* in = static_cast<internal*>(current);
+				int index = lowerBoundIn(in->keys, in->count, key);
+				parents[depth] = in;
+				childIndexes[depth] = index;
+				depth++;
+				current = in->children[index];
+			}
+
+			leaf* l = static_cast<leaf*>(current);
+			int index = lowerBoundIn(l->keys, l->count, key);
+			if (index == l->count || less(key, l->keys[index]))
+			{
+				return false;
+			}
+			shiftLeft(l, index);
+			l->count--;
+			treeSize--;
+			//The separators above still work, since every key in the leaf is still less than or equal to them
+
+			//Fix every node on the path that has too few keys, from the bottom up
+			node* child = l;
+			while (depth > 0 && child->count < (child->isLeaf ? LeafMinimum : InternalMinimum))
+			{
+				depth--;
+				fixUnderflow(parents[depth], childIndexes[depth]);
+				child = parents[depth];
+			}
+
+			//If the root is an internal node with a single child, then the child becomes the root
+			if (!root->isLeaf && root->count == 0)
+			{
+				internal* oldRoot = static_cast<internal*>(root);
+				root = oldRoot->children[0];
+				delete oldRoot;
+				height--;
+			}
+			//If the last key was removed, then the tree is empty
+			else if (root->isLeaf && root->count == 0)
+			{
+				delete static_cast<leaf*>(root);
+				root = nullptr;
+				firstLeaf = nullptr;
+				lastLeaf = nullptr;
+				height = 0;
+			}
+			return true;
+		}
+
+		//Fixes the child at "index" of a parent, which has one key fewer than the minimum
+		void fixUnderflow(internal* parent, int index)
+		{
+			node* child = parent->children[index];
+			node* leftSibling = index > 0 ? parent->children[index - 1] : nullptr;
+			node* rightSibling = index < parent->count ? parent->children[index + 1] : nullptr;
+			int minimum = child->isLeaf ? LeafMinimum : InternalMinimum;
+
+			//Borrow the last key of the left sibling
+			if (leftSibling != nullptr && leftSibling->count > minimum)
+			{
+				if (child->isLeaf)
+				{
+					leaf* l = static_cast<leaf*>(child);
+					leaf* from = static_cast<leaf*>(leftSibling);
+					shiftRight(l, 0);
+					moveSlot(from, from->count - 1, l, 0);
+					l->count++;
+					from->count--;
+					parent->keys[index - 1] = from->keys[from->count - 1];
+				}
+				else
+				{
+					internal* in = static_cast<internal*>(child);
+					internal* from = static_cast<internal*>(leftSibling);
+					//The separator comes down to the child, and the last key of the sibling goes up to replace it
+					std::move_backward(in->keys, in->keys + in->count, in->keys + in->count + 1);
+					std::copy_backward(in->children, in->children + in->count + 1, in->children + in->count + 2);
+					in->keys[0] = std::move(parent->keys[index - 1]);
+					in->children[0] = from->children[from->count];
+					in->count++;
+					parent->keys[index - 1] = std::move(from->keys[from->count - 1]);
+					from->count--;
+				}
+			}
+			//Borrow the first key of the right sibling
+			else if (rightSibling != nullptr && rightSibling->count > minimum)
+			{
+				if (child->isLeaf)
+				{
+					leaf* l = static_cast<leaf*>(child);
+					leaf* from = static_cast<leaf*>(rightSibling);
+					moveSlot(from, 0, l, l->count);
+					l->count++;
+					shiftLeft(from, 0);
+					from->count--;
+					parent->keys[index] = l->keys[l->count - 1];
+				}
+				else
+				{
+					internal* in = static_cast<internal*>(child);
+					internal* from = static_cast<internal*>(rightSibling);
+					in->keys[in->count] = std::move(parent->keys[index]);
+					in->children[in->count + 1] = from->children[0];
+					in->count++;
+					parent->keys[index] = std::move(from->keys[0]);
+					std::move(from->keys + 1, from->keys + from->count, from->keys);
+					std::copy(from->children + 1, from->children + from->count + 1, from->children);
+					from->count--;
+				}
+			}
+			//Neither sibling can spare a key, so merge the child with one of them
+			else if (leftSibling != nullptr)
+			{
+				mergeChildren(parent, index - 1);
+			}
+			else
+			{
+				mergeChildren(parent, index);
+			}
+		}
+
+		//Merges the child at "index + 1" of a parent into the child at "index", and removes the separator between them from the parent
+		void mergeChildren(internal* parent, int index)
+		{
+			node* leftNode = parent->children[index];
+			node* rightNode = parent->children[index + 1];
+
+			if (leftNode->isLeaf)
+			{
+				leaf* left = static_cast<leaf*>(leftNode);
+				leaf* right = static_cast<leaf*>(rightNode);
+				for (int i = 0; i < right->count; i++)
+				{
+					moveSlot(right, i, left, left->count + i);
+				}
+				left->count += right->count;
+				left->next = right->next;
+				if (right->next != nullptr)
+				{
+					right->next->previous = left;
+				}
+				else
+				{
+					lastLeaf = left;
+				}
+				delete right;
+			}
+			else
+			{
+				internal* left = static_cast<internal*>(leftNode);
+				internal* right = static_cast<internal*>(rightNode);
+				//The separator comes down between the keys of the two nodes
+				left->keys[left->count] = std::move(parent->keys[index]);
+				std::move(right->keys, right->keys + right->count, left->keys + left->count + 1);
+				std::copy(right->children, right->children + right->count + 1, left->children + left->count + 1);
+				left->count += right->count + 1;
+				delete right;
+			}
+
+			//Remove the separator and the right child from the parent
+			std::move(parent->keys + index + 1, parent->keys + parent->count, parent->keys + index);
+			std::copy(parent->children + index + 2, parent->children + parent->count + 1, parent->children + index + 1);
+			parent->count--;
+		}
+
+		//Builds the tree from "count" sorted keys without any duplicates, in O(n). "fill(leaf, index)" stores the next key, and value if this is a map, into a leaf slot.
+		//The leaves are filled evenly and as full as possible, and then each level of internal nodes is built on top of the level below
+		template<typename Fill>
+		void bulkLoad(std::size_t count, Fill fill)
+		{
+			clear();
+			if (count == 0)
+			{
+				return;
+			}
+
+			//Each node of the level being built, along with the largest key in it
+			std::vector<std::pair<node*, const Key*>> level;
+			//The nodes of the level above "level" while it is being built. They don't own their children until the level is finished
+			std::vector<std::pair<node*, const Key*>> upper;
+			try
+			{
+				std::size_t leafCount = (count + LeafCapacity - 1) / LeafCapacity;
+				level.reserve(leafCount);
+				leaf* previous = nullptr;
+				for (std::size_t i = 0; i < leafCount; i++)
+				{
+					//Spread the keys evenly, so every leaf has at least the minimum number of keys
+					int leafSize = static_cast<int>(count / leafCount + (i < count % leafCount ? 1 : 0));
+					leaf* l = new leaf();
+					l->previous = previous;
+					if (previous != nullptr)
+					{
+						previous->next = l;
+					}
+					else
+					{
+						firstLeaf = l;
+					}
+					previous = l;
+					lastLeaf = l;
+					level.emplace_back(l, nullptr);
+					for (int j = 0; j < leafSize; j++)
+					{
+						fill(l, j);
+						l->count++;
+					}
+					level.back().second = &l->keys[leafSize - 1];
+				}
+				treeSize = static_cast<int>(count);
+				height = 1;
+
+				//Build each level of internal nodes until there is only one node left
+				while (level.size() > 1)
+				{
+					std::size_t childCount = level.size();
+					std::size_t nodeCount = (childCount + InternalCapacity) / (InternalCapacity + 1);
+					upper.reserve(nodeCount);
+					std::size_t child = 0;
+					for (std::size_t i = 0; i < nodeCount; i++)
+					{
+						int children = static_cast<int>(childCount / nodeCount + (i < childCount % nodeCount ? 1 : 0));
+						internal* in = new internal();
+						upper.emplace_back(in, nullptr);
+						for (int j = 0; j < children; j++, child++)
+						{
+							in->children[j] = level[child].first;
+							//The separator after each child is the largest key in it
+							if (j < children - 1)
+							{
+								in->keys[j] = *level[child].second;
+							}
+						}
+						in->count = children - 1;
+						upper.back().second = level[child - 1].second;
+					}
+					//The nodes of the lower level are now owned by the upper level
+					level = std::move(upper);
+					upper.clear();
+					height++;
+				}
+				root = level.front().first;
+			}
+			catch (...)
+			{
+				//Delete the nodes of the unfinished upper level without their children, since the children are still in "level"
+				for (auto& entry : upper)
+				{
+					delete static_cast<internal*>(entry.first);
+				}
+				//Delete the nodes of the last finished level. Every node below it is owned by one of them
+				for (auto& entry : level)
+				{
+					deleteNode(entry.first);
+				}
+				root = nullptr;
+				firstLeaf = nullptr;
+				lastLeaf = nullptr;
+				treeSize = 0;
+				height = 0;
+				throw;
+			}
+		}
+
+		/*An iterator for going over the keys of the tree in sorted order. The is_const flag is to determine if the values of a map can be changed through the iterator.
+		  The keys can never be changed, since that would break the order of the tree*/
+		template<bool is_const>
+		class iterator_base
+		{
+			friend class btree<Key, Mapped, Comparer, NodeBytes>;
+
+			//The leaf that the iterator points to. This is nullptr for the end of the tree
+			leaf* current;
+			//The index of the key within the leaf
+			int index;
+
+			iterator_base(leaf* current, int index) : current(current), index(index) {}
+
+		public:
+			//An implicit copy constructor for implicity converting non-const iterators to const versions
+			iterator_base(const iterator_base<false>& other) : current(other.current), index(other.index) {}
+
+			//These type definitions are required for iterators
+			using value_type = typename std::conditional<IsMap, std::pair<const Key, Mapped>, Key>::type;
+			using reference = typename std::conditional<IsMap, std::pair<const Key&, make_const_if_true<Mapped, is_const>&>, const Key&>::type;
+			using pointer = const value_type*;
+			using iterator_category = std::forward_iterator_tag;
+			using difference_type = int;
+
+			//Pre-increments the iterator to the next key. Going past the last key of a leaf moves to the next leaf
+			iterator_base<is_const>& operator++()
+			{
+				if (current == nullptr)
+				{
+					throw struct_exception("Cannot iterate past the end of the tree");
+				}
+				if (++index == current->count)
+				{
+					current = current->next;
+					index = 0;
+				}
+				return *this;
+			}
+
+			//Post-increments the iterator to the next key
+			iterator_base<is_const> operator++(int)
+			{
+				iterator_base<is_const> previous = *this;
+				++(*this);
+				return previous;
+			}
+
+			//Gets the key the iterator points to
+			const Key& key() const
+			{
+				return current->keys[index];
+			}
+
+			//Gets the value the iterator points to. Only available for maps
+			make_const_if_true<Mapped, is_const>& value() const
+			{
+				static_assert(IsMap, "Only a btree_map stores values");
+				return current->values[index];
+			}
+
+			//Gets the key the iterator points to, or a pair of the key and value for a map
+			reference operator*() const
+			{
+				if constexpr (IsMap)
+				{
+					return reference(current->keys[index], current->values[index]);
+				}
+				else
+				{
+					return current->keys[index];
+				}
+			}
+
+			//Used for dereferencing the key. Only available for sets, since a map has no pair stored to point to
+			const Key* operator->() const
+			{
+				static_assert(!IsMap, "Use key() and value() to access the entries of a btree_map");
+				return &current->keys[index];
+			}
+
+			//Tests for equality
+			bool operator==(const iterator_base<is_const>& rhs) const
+			{
+				return current == rhs.current && (current == nullptr || index == rhs.index);
+			}
+
+			//Tests for inequality
+			bool operator!=(const iterator_base<is_const>& rhs) const
+			{
+				return !(*this == rhs);
+			}
+		};
+
+	public:
+		//A non_const version of the iterator. For a set, this can't change anything either
+		using iterator = iterator_base<false>;
+		//A const version of the iterator
+		using const_iterator = iterator_base<true>;
+
+		//Constructs an empty tree
+		btree() : comparer(sorting_impl::DefaultComparer<Key>)
+		{
+			naturalOrder = sorting_impl::is_natural_order<Key>(comparer);
+		}
+
+		//Constructs an empty tree that orders its keys with a comparer
+		btree(Comparer comp) : comparer(std::move(comp))
+		{
+			naturalOrder = sorting_impl::is_natural_order<Key>(comparer);
+		}
+
+		//A copy constructor. The copy is bulk loaded in O(n) without comparing any keys
+		btree(const btree& other) : comparer(other.comparer), naturalOrder(other.naturalOrder)
+		{
+			copyFrom(other);
+		}
+
+		//A move constructor for taking the nodes of another tree
+		btree(btree&& other) noexcept :
+			root(other.root),
+			firstLeaf(other.firstLeaf),
+			lastLeaf(other.lastLeaf),
+			treeSize(other.treeSize),
+			height(other.height),
+			comparer(std::move(other.comparer)),
+			naturalOrder(other.naturalOrder)
+		{
+			other.root = nullptr;
+			other.firstLeaf = nullptr;
+			other.lastLeaf = nullptr;
+			other.treeSize = 0;
+			other.height = 0;
+		}
+
+		btree& operator=(const btree& other)
+		{
+			if (&other != this)
+			{
+				comparer = other.comparer;
+				naturalOrder = other.naturalOrder;
+				copyFrom(other);
+			}
+			return *this;
+		}
+
+		btree& operator=(btree&& other) noexcept
+		{
+			if (&other != this)
+			{
+				clear();
+				root = other.root;
+				firstLeaf = other.firstLeaf;
+				lastLeaf = other.lastLeaf;
+				treeSize = other.treeSize;
+				height = other.height;
+				comparer = std::move(other.comparer);
+				naturalOrder = other.naturalOrder;
+				other.root = nullptr;
+				other.firstLeaf = nullptr;
+				other.lastLeaf = nullptr;
+				other.treeSize = 0;
+				other.height = 0;
+			}
+			return *this;
+		}
+
+		~btree()
+		{
+			clear();
+		}
+
+		//Removes every key from the tree
+		void clear()
+		{
+			if (root != nullptr)
+			{
+				deleteNode(root);
+			}
+			root = nullptr;
+			firstLeaf = nullptr;
+			lastLeaf = nullptr;
+			treeSize = 0;
+			height = 0;
+		}
+
+		//Removes a key from the tree. Returns true if the key was removed
+		bool remove(const Key& key)
+		{
+			return removeKey(key);
+		}
+
+		//Removes the key an iterator points to. Returns true if the key was removed
+		bool remove(const_iterator position)
+		{
+			if (position.current == nullptr)
+			{
+				return false;
+			}
+			return removeKey(position.current->keys[position.index]);
+		}
+
+		//Attempts to find a key in the tree and returns an iterator to it. If the key could not be found, then the end() iterator is returned
+		iterator find(const Key& key)
+		{
+			auto slot = findSlot(key);
+			return iterator(slot.first, slot.second);
+		}
+
+		//Attempts to find a key in the tree and returns an iterator to it. If the key could not be found, then the end() iterator is returned
+		const_iterator find(const Key& key) const
+		{
+			auto slot = findSlot(key);
+			return const_iterator(slot.first, slot.second);
+		}
+
+		//Returns true if the key is in the tree
+		bool contains(const Key& key) const
+		{
+			return findSlot(key).first != nullptr;
+		}
+
+		//Returns an iterator to the first key that is not less than "key". Returns end() if every key is less than "key"
+		iterator lower_bound(const Key& key)
+		{
+			auto slot = lowerBoundSlot(key);
+			return iterator(slot.first, slot.second);
+		}
+
+		//Returns an iterator to the first key that is not less than "key". Returns end() if every key is less than "key"
+		const_iterator lower_bound(const Key& key) const
+		{
+			auto slot = lowerBoundSlot(key);
+			return const_iterator(slot.first, slot.second);
+		}
+
+		//Returns an iterator to the first key that is greater than "key". Returns end() if no key is greater than "key"
+		iterator upper_bound(const Key& key)
+		{
+			iterator result = lower_bound(key);
+			if (result != end() && !less(key, result.key()))
+			{
+				++result;
+			}
+			return result;
+		}
+
+		//Returns an iterator to the first key that is greater than "key". Returns end() if no key is greater than "key"
+		const_iterator upper_bound(const Key& key) const
+		{
+			const_iterator result = lower_bound(key);
+			if (result != end() && !less(key, result.key()))
+			{
+				++result;
+			}
+			return result;
+		}
+
+		//Get the beginning iterator, which points to the smallest key
+		iterator begin()
+		{
+			return iterator(firstLeaf, 0);
+		}
+
+		//Get the beginning iterator, which points to the smallest key
+		const_iterator begin() const
+		{
+			return const_iterator(firstLeaf, 0);
+		}
+
+		//Get the beginning iterator, which points to the smallest key
+		const_iterator cbegin() const
+		{
+			return begin();
+		}
+
+		//Gets the ending iterator
+		iterator end()
+		{
+			return iterator(nullptr, 0);
+		}
+
+		//Gets the ending iterator
+		const_iterator end() const
+		{
+			return const_iterator(nullptr, 0);
+		}
+
+		//Gets the ending iterator
+		const_iterator cend() const
+		{
+			return end();
+		}
+
+		//Gets how many keys are in the tree
+		int getSize() const
+		{
+			return treeSize;
+		}
+
+		//Gets how many levels of nodes the tree has. An empty tree has a height of 0
+		int getHeight() const
+		{
+			return height;
+		}
+
+		//Gets how many keys fit into a leaf
+		static constexpr int getLeafCapacity()
+		{
+			return LeafCapacity;
+		}
+
+	protected:
+		//Creates an iterator to a slot found by insertKey() or findSlot()
+		iterator toIterator(std::pair<leaf*, int> slot)
+		{
+			return iterator(slot.first, slot.second);
+		}
+
+	private:
+		//Replaces the contents of the tree with a copy of another tree
+		void copyFrom(const btree& other)
+		{
+			leaf* source = other.firstLeaf;
+			int sourceIndex = 0;
+			bulkLoad(static_cast<std::size_t>(other.treeSize), [&source, &sourceIndex](leaf* l, int index) {
+				l->keys[index] = source->keys[sourceIndex];
+				if constexpr (IsMap)
+				{
+					l->values[index] = source->values[sourceIndex];
+				}
+				if (++sourceIndex == source->count)
+				{
+					source = source->next;
+					sourceIndex = 0;
+				}
+			});
+		}
+	};
+}
+
+//An ordered set stored in a B+ tree. Each node holds many keys and is sized to a few cache lines (or any size with "NodeBytes", such as 4096 for pages),
+//so a search touches far fewer cache lines than in binary_search_tree. Searching within a node uses SIMD for 32-bit integers, floats and doubles.
+//The keys must be default constructible and movable. Duplicate keys are not allowed
+template<typename T, typename Comparer = std::function<bool(const T&, const T&)>, std::size_t NodeBytes = btree_impl::DefaultNodeBytes>
+class btree_set : public btree_impl::btree<T, btree_impl::no_value, Comparer, NodeBytes>
+{
+	using base = btree_impl::btree<T, btree_impl::no_value, Comparer, NodeBytes>;
+
+public:
+	using base::base;
+	using typename base::iterator;
+	using typename base::const_iterator;
+
+	//Inserts a new key into the tree. Returns end() if the key is already in the tree
+	//The template parameter is to allow the function to take both rvalues and lvalues
+	template<typename DataType>
+	iterator insert(DataType&& data)
+	{
+		return this->toIterator(this->insertKey(T(std::forward<DataType>(data))));
+	}
+
+	//Creates a set from a range of keys that is already sorted by the comparer and has no duplicates. This takes O(n) time and doesn't compare any keys
+	template<typename Iterator>
+	static btree_set from_sorted(Iterator begin, Iterator end, Comparer comp = sorting_impl::DefaultComparer<T>)
+	{
+		btree_set set{ std::move(comp) };
+		std::vector<T> buffer;
+		std::size_t count;
+		//If the range can only be read once, then it has to be stored before the keys can be counted
+		if constexpr (!std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<Iterator>::iterator_category>::value)
+		{
+			buffer.assign(begin, end);
+			count = buffer.size();
+			auto next = buffer.begin();
+			set.bulkLoad(count, [&next](typename base::leaf* l, int index) { l->keys[index] = std::move(*next++); });
+		}
+		else
+		{
+			count = static_cast<std::size_t>(std::distance(begin, end));
+			set.bulkLoad(count, [&begin](typename base::leaf* l, int index) { l->keys[index] = *begin++; });
+		}
+		return set;
+	}
+
+	//Creates a set from a range of keys in any order. The keys are sorted and duplicates are removed, then the tree is built in O(n)
+	template<typename Iterator>
+	static btree_set from_unsorted(Iterator begin, Iterator end, Comparer comp = sorting_impl::DefaultComparer<T>)
+	{
+		std::vector<T> keys(begin, end);
+		std::sort(keys.begin(), keys.end(), comp);
+		keys.erase(std::unique(keys.begin(), keys.end(), [&comp](const T& a, const T& b) {
+			return !comp(a, b) && !comp(b, a);
+		}), keys.end());
+		return from_sorted(std::make_move_iterator(keys.begin()), std::make_move_iterator(keys.end()), std::move(comp));
+	}
+};
+
+//An ordered map stored in a B+ tree, with the same layout as btree_set. The keys and values are stored in separate arrays in each leaf,
+//so searching a leaf only reads the keys. Iterators give a pair of references to the key and value, or use key() and value()
+template<typename Key, typename Value, typename Comparer = std::function<bool(const Key&, const Key&)>, std::size_t NodeBytes = btree_impl::DefaultNodeBytes>
+class btree_map : public btree_impl::btree<Key, Value, Comparer, NodeBytes>
+{
+	using base = btree_impl::btree<Key, Value, Comparer, NodeBytes>;
+
+public:
+	using base::base;
+	using typename base::iterator;
+	using typename base::const_iterator;
+
+	//Inserts a key and value into the map. Returns end() if the key is already in the map
+	template<typename KeyType, typename ValueType>
+	iterator insert(KeyType&& key, ValueType&& value)
+	{
+		return this->toIterator(this->insertKey(Key(std::forward<KeyType>(key)), std::forward<ValueType>(value)));
+	}
+
+	//Gets the value for a key. If the key isn't in the map, then it is added with a default constructed value
+	Value& operator[](const Key& key)
+	{
+		auto slot = this->findSlot(key);
+		if (slot.first == nullptr)
+		{
+			slot = this->insertKey(Key(key));
+		}
+		return slot.first->values[slot.second];
+	}
+
+	//Gets the value for a key. Throws a struct_exception if the key isn't in the map
+	const Value& at(const Key& key) const
+	{
+		auto slot = this->findSlot(key);
+		if (slot.first == nullptr)
+		{
+			throw struct_exception("The key is not in the map");
+		}
+		return slot.first->values[slot.second];
+	}
+
+	//Creates a map from a range of key and value pairs that is already sorted by key and has no duplicate keys. This takes O(n) time and doesn't compare any keys
+	template<typename Iterator>
+	static btree_map from_sorted(Iterator begin, Iterator end, Comparer comp = sorting_impl::DefaultComparer<Key>)
+	{
+		btree_map map{ std::move(comp) };
+		std::vector<std::pair<Key, Value>> buffer(begin, end);
+		auto next = buffer.begin();
+		map.bulkLoad(buffer.size(), [&next](typename base::leaf* l, int index) {
+			l->keys[index] = std::move(next->first);
+			l->values[index] = std::move(next->second);
+			++next;
+		});
+		return map;
+	}
+};
+
+//Used for printing a set to a stream
+template<typename T, typename Comparer, std::size_t NodeBytes>
+std::ostream& operator<<(std::ostream& stream, const btree_set<T, Comparer, NodeBytes>& set)
+{
+	stream << "[";
+	for (auto i = set.begin(); i != set.end(); ++i)
+	{
+		if (i != set.begin())
+		{
+			stream << ", ";
+		}
+		stream << *i;
+	}
+	return stream << "]";
+}
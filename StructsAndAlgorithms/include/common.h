@@ -1,5 +1,12 @@
 #pragma once
 #include <string>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <functional>
+
+//The size of a cache line in bytes. Used for keeping data that is shared between threads on separate cache lines
+constexpr std::size_t CacheLineSize = 64;
 
 //This templated type will make a type const if "is_const" is true
 template<typename T, bool is_const>
@@ -14,6 +21,84 @@ namespace sorting_impl
 		return a < b;
 	}
 
+	//Returns true if the comparer is known to order values the same way as the < operator, which lets containers compare numbers directly instead of calling the comparer
+	template<typename T, typename Comparer>
+	bool is_natural_order(const Comparer& comparer)
+	{
+		if constexpr (std::is_same<Comparer, std::less<T>>::value)
+		{
+			return true;
+		}
+		else if constexpr (std::is_same<Comparer, std::function<bool(const T&, const T&)>>::value)
+		{
+			auto target = comparer.template target<int (*)(const T&, const T&)>();
+			return target != nullptr && *target == &DefaultComparer<T>;
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	//Makes the comparer that a container uses when none is given. Comparers that can hold a function pointer, such as std::function, are given DefaultComparer,
+	//and every other comparer, such as std::less or a struct, is default constructed
+	template<typename Comparer, typename T>
+	Comparer make_default_comparer()
+	{
+		if constexpr (std::is_constructible<Comparer, int (*)(const T&, const T&)>::value)
+		{
+			return Comparer(DefaultComparer<T>);
+		}
+		else
+		{
+			return Comparer();
+		}
+	}
+
+	//Checks if a comparer can compare values of different types. Like std::less<>, such comparers are marked with an "is_transparent" type
+	template<typename Comparer, typename = void>
+	struct is_transparent : std::false_type {};
+
+	template<typename Comparer>
+	struct is_transparent<Comparer, std::void_t<typename Comparer::is_transparent>> : std::true_type {};
+
+	//Checks if a transparent comparer only orders values by a key of type "lookup_type", which other values must be converted to first
+	template<typename Comparer, typename = void>
+	struct has_lookup_type : std::false_type {};
+
+	template<typename Comparer>
+	struct has_lookup_type<Comparer, std::void_t<typename Comparer::lookup_type>> : std::true_type {};
+
+	//Gets the value that a container of T should be searched with. A transparent comparer can compare "data" as it is, unless it names a "lookup_type" to convert to.
+	//Other comparers only take T, so "data" is converted to T here, once per search instead of once per comparison
+	template<typename Comparer, typename T, typename DataType>
+	decltype(auto) lookup_key(const DataType& data)
+	{
+		if constexpr (std::is_same<DataType, T>::value)
+		{
+			return (data);
+		}
+		else if constexpr (has_lookup_type<Comparer>::value)
+		{
+			if constexpr (std::is_same<DataType, typename Comparer::lookup_type>::value)
+			{
+				return (data);
+			}
+			else
+			{
+				return typename Comparer::lookup_type(data);
+			}
+		}
+		else if constexpr (is_transparent<Comparer>::value)
+		{
+			return (data);
+		}
+		else
+		{
+			return T(data);
+		}
+	}
+
 	//The default swapper.
 	template<typename T>
 	constexpr void DefaultSwapper(T& lhs, T& rhs)
@@ -24,5 +109,19 @@ namespace sorting_impl
 	}
 }
 
+//This namespace contains implementation details for hash containers
+namespace hash_impl
+{
+	//Mixes the bits of a hash, so that hashes like std::hash<int>, which returns the number itself, still spread evenly over every bit
+	inline std::uint64_t mix(std::uint64_t hash)
+	{
+		hash ^= hash >> 33;
+		hash *= 0xff51afd7ed558ccdULL;
+		hash ^= hash >> 33;
+		hash *= 0xc4ceb9fe1a85ec53ULL;
+		hash ^= hash >> 33;
+		return hash;
+	}
+}
 
 std::string version();
\ No newline at end of file
@@ -0,0 +1,750 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <limits>
+#include <new>
+#include <ostream>
+#include <type_traits>
+#include <utility>
+#include <common.h>
+#include <struct_exception.h>
+
+//A doubly linked list that stores all of its nodes in a single growable array, and links them together with 32-bit indices instead of pointers.
+//Each node only costs 8 bytes on top of its value, compared to 16 bytes for linked_list. Removed nodes are kept in a free list and reused by later inserts.
+//Iterators store an index rather than a pointer, so they stay valid when the array grows. Only removing the node an iterator points to invalidates it
+template<typename T>
+class compact_linked_list {
+public:
+	//The index that represents "no node", such as the next index of the last node
+	static constexpr std::uint32_t NoNode = std::numeric_limits<std::uint32_t>::max();
+	//The maximum amount of nodes the list can hold
+	static constexpr std::uint32_t MaxNodes = NoNode - 1;
+
+	//Represents a node in the list
+	struct node {
+		//The storage for the value of the node. The value is only constructed while the node is in use
+		alignas(T) unsigned char storage[sizeof(T)];
+		//The index of the next node. For nodes in the free list, this is the index of the next free node
+		std::uint32_t next;
+		//The index of the previous node
+		std::uint32_t prev;
+	};
+
+	//Represents an iterator for iterating over all the nodes in a compact_linked_list
+	template<bool is_const>
+	class node_iterator_base {
+
+		friend node_iterator_base<!is_const>;
+		friend class compact_linked_list<T>;
+
+		using list_type = make_const_if_true<compact_linked_list<T>, is_const>;
+
+		//The index of the node this iterator is currently accessing
+		std::uint32_t _index;
+		//The list the node came from
+		list_type* _list;
+
+	public:
+		using value_type = make_const_if_true<T, is_const>;
+		using reference = value_type&;
+		using pointer = value_type*;
+		using iterator_category = std::bidirectional_iterator_tag;
+		using difference_type = int;
+
+		node_iterator_base(std::uint32_t index, list_type* list) : _index(index), _list(list) {}
+
+		//Pre-increments the iterator to the next value
+		node_iterator_base<is_const>& operator++()
+		{
+			//If we are at the end of the list
+			if (_index == NoNode)
+			{
+				//We can't iterate past it
+				throw struct_exception("Attempting to iterate past the end of the list");
+			}
+
+			//Move to the next node
+			_index = _list->nodes[_index].next;
+			//Return the iterator
+			return *this;
+		}
+		//Post-increments the iterator to the next value
+		node_iterator_base<is_const> operator++(int)
+		{
+			//Store the current state of the iterator
+			node_iterator_base<is_const> previousState = *this;
+			++(*this);
+			//Return the previous state of the iterator
+			return previousState;
+		}
+
+		//Pre-decrements the iterator to the previous value
+		node_iterator_base<is_const>& operator--()
+		{
+			//If the index is NoNode, then the iterator refers to the element past the end of the list
+			if (_index == NoNode)
+			{
+				//If the list is empty, then there is no previous element
+				if (_list->last == NoNode)
+				{
+					throw struct_exception("Attempting to iterate over an empty linked list");
+				}
+				//Set this iterator to the last VALID node in the list
+				_index = _list->last;
+			}
+			//If there is no previous element, then we are at the beginning already
+			else if (_list->nodes[_index].prev == NoNode)
+			{
+				throw struct_exception("Attempting to iterate past the beginning of the list");
+			}
+			//Set the node to the previous element
+			else
+			{
+				_index = _list->nodes[_index].prev;
+			}
+			//Return a reference to the iterator
+			return *this;
+		}
+		//Post-decrements the iterator to the previous value
+		node_iterator_base<is_const> operator--(int)
+		{
+			//Store the current state of the iterator
+			node_iterator_base<is_const> previousState = *this;
+			--(*this);
+			//Return the previous state of the iterator
+			return previousState;
+		}
+
+		//Used to get the value of the iterator
+		reference operator*() const
+		{
+			//Return a reference to the value
+			return _list->valueAt(_index);
+		}
+		//Used for dereferencing the value
+		pointer operator->() const
+		{
+			//Return a pointer to the value
+			return &_list->valueAt(_index);
+		}
+
+		//Gets the index of the node this iterator points to. Returns NoNode for the end() iterator
+		std::uint32_t get_index() const {
+			return _index;
+		}
+
+		//Tests for equality
+		template <bool other_const>
+		bool operator==(const node_iterator_base<other_const>& rhs) const
+		{
+			return rhs._index == _index && rhs._list == _list;
+		}
+		//Tests for inequality
+		template <bool other_const>
+		bool operator!=(const node_iterator_base<other_const>& rhs) const
+		{
+			return rhs._index != _index || rhs._list != _list;
+		}
+	};
+
+	using const_node_iterator = node_iterator_base<true>;
+	using node_iterator = node_iterator_base<false>;
+
+	using iterator = node_iterator;
+	using const_iterator = const_node_iterator;
+
+private:
+	//The array that stores every node
+	node* nodes = nullptr;
+	//How many nodes the array can hold
+	std::uint32_t capacity = 0;
+	//How many nodes at the start of the array have been used at some point. Every node past this has never been used
+	std::uint32_t used = 0;
+	//The index of the first node in the list
+	std::uint32_t first = NoNode;
+	//The index of the last node in the list
+	std::uint32_t last = NoNode;
+	//The index of the first node in the free list
+	std::uint32_t freeHead = NoNode;
+	//How many nodes are in the list
+	int size = 0;
+
+	//Gets the value of a node
+	T& valueAt(std::uint32_t index)
+	{
+		return *std::launder(reinterpret_cast<T*>(nodes[index].storage));
+	}
+
+	//Gets the value of a node
+	const T& valueAt(std::uint32_t index) const
+	{
+		return *std::launder(reinterpret_cast<const T*>(nodes[index].storage));
+	}
+
+	//Allocates an array of nodes. The values are not constructed
+	static node* allocateNodes(std::uint32_t count)
+	{
+		return static_cast<node*>(::operator new(sizeof(node) * static_cast<std::size_t>(count), std::align_val_t(alignof(node))));
+	}
+
+	//Frees an array of nodes
+	static void freeNodes(node* array)
+	{
+		::operator delete(array, std::align_val_t(alignof(node)));
+	}
+
+	//Gets the capacity to grow to when the array is full
+	std::uint32_t grownCapacity() const
+	{
+		if (capacity == MaxNodes)
+		{
+			throw struct_exception("A compact_linked_list can't hold more than 2^32 - 2 nodes");
+		}
+		if (capacity < 8)
+		{
+			return 8;
+		}
+		return capacity > MaxNodes / 2 ? MaxNodes : capacity * 2;
+	}
+
+	//Copies the links of every used node into another array, and moves the values of the nodes that are in the list.
+	//If a value throws while being moved, the new array is left without any constructed values and the exception is rethrown
+	void relocateInto(node* newNodes)
+	{
+		//A trivially copyable value can be copied over with the links in one go
+		if constexpr (std::is_trivially_copyable<T>::value)
+		{
+			if (used != 0)
+			{
+				std::memcpy(newNodes, nodes, sizeof(node) * static_cast<std::size_t>(used));
+			}
+		}
+		else
+		{
+			for (std::uint32_t i = 0; i < used; i++)
+			{
+				newNodes[i].next = nodes[i].next;
+				newNodes[i].prev = nodes[i].prev;
+			}
+
+			std::uint32_t current = first;
+			try
+			{
+				for (; current != NoNode; current = nodes[current].next)
+				{
+					new (newNodes[current].storage) T(std::move_if_noexcept(valueAt(current)));
+				}
+			}
+			catch (...)
+			{
+				//Destroy every value that was moved before the exception
+				for (std::uint32_t i = first; i != current; i = nodes[i].next)
+				{
+					std::launder(reinterpret_cast<T*>(newNodes[i].storage))->~T();
+				}
+				throw;
+			}
+		}
+	}
+
+	//Destroys the values of every node that is in the list
+	void destroyValues()
+	{
+		if constexpr (!std::is_trivially_destructible<T>::value)
+		{
+			for (std::uint32_t i = first; i != NoNode; i = nodes[i].next)
+			{
+				valueAt(i).~T();
+			}
+		}
+	}
+
+	//Replaces the array with a new one that can hold "newCapacity" nodes
+	void reallocate(std::uint32_t newCapacity)
+	{
+		node* newNodes = allocateNodes(newCapacity);
+		try
+		{
+			relocateInto(newNodes);
+		}
+		catch (...)
+		{
+			freeNodes(newNodes);
+			throw;
+		}
+		destroyValues();
+		freeNodes(nodes);
+		nodes = newNodes;
+		capacity = newCapacity;
+	}
+
+	//Takes a node from the free list or the unused part of the array, and constructs its value. The node is not linked into the list.
+	//If the array has to grow, then the value is constructed before the old nodes are moved, so the arguments can refer to values in the list
+	template<typename... Args>
+	std::uint32_t createNode(Args&&... args)
+	{
+		if (size == static_cast<int>(std::numeric_limits<int>::max()))
+		{
+			throw struct_exception("The list is too large to hold any more nodes");
+		}
+
+		//Reuse a node from the free list
+		if (freeHead != NoNode)
+		{
+			std::uint32_t index = freeHead;
+			new (nodes[index].storage) T(std::forward<Args>(args)...);
+			freeHead = nodes[index].next;
+			return index;
+		}
+
+		//Use the next node that has never been used
+		if (used < capacity)
+		{
+			new (nodes[used].storage) T(std::forward<Args>(args)...);
+			return used++;
+		}
+
+		//The array is full, so move every node into a larger array
+		std::uint32_t newCapacity = grownCapacity();
+		node* newNodes = allocateNodes(newCapacity);
+		try
+		{
+			new (newNodes[used].storage) T(std::forward<Args>(args)...);
+		}
+		catch (...)
+		{
+			freeNodes(newNodes);
+			throw;
+		}
+		try
+		{
+			relocateInto(newNodes);
+		}
+		catch (...)
+		{
+			std::launder(reinterpret_cast<T*>(newNodes[used].storage))->~T();
+			freeNodes(newNodes);
+			throw;
+		}
+		destroyValues();
+		freeNodes(nodes);
+		nodes = newNodes;
+		capacity = newCapacity;
+		return used++;
+	}
+
+	//Links a node that has been created into the list, before the node at "before". NoNode adds the node to the back
+	void linkBefore(std::uint32_t index, std::uint32_t before)
+	{
+		if (before == NoNode)
+		{
+			nodes[index].prev = last;
+			nodes[index].next = NoNode;
+			if (last != NoNode)
+			{
+				nodes[last].next = index;
+			}
+			else
+			{
+				first = index;
+			}
+			last = index;
+		}
+		else
+		{
+			std::uint32_t previous = nodes[before].prev;
+			nodes[index].prev = previous;
+			nodes[index].next = before;
+			nodes[before].prev = index;
+			if (previous != NoNode)
+			{
+				nodes[previous].next = index;
+			}
+			else
+			{
+				first = index;
+			}
+		}
+		size++;
+	}
+
+	//Unlinks a node from the list, destroys its value and adds it to the free list
+	void removeNode(std::uint32_t index)
+	{
+		std::uint32_t previous = nodes[index].prev;
+		std::uint32_t next = nodes[index].next;
+
+		if (previous != NoNode)
+		{
+			nodes[previous].next = next;
+		}
+		else
+		{
+			first = next;
+		}
+
+		if (next != NoNode)
+		{
+			nodes[next].prev = previous;
+		}
+		else
+		{
+			last = previous;
+		}
+
+		valueAt(index).~T();
+		nodes[index].next = freeHead;
+		freeHead = index;
+		size--;
+	}
+
+	//Throws an exception if the iterator does not come from this list
+	template<bool is_const>
+	void checkIterator(const node_iterator_base<is_const>& iterator) const
+	{
+		if (iterator._list != this)
+		{
+			throw struct_exception("The passed in iterator does not belong to this list");
+		}
+	}
+
+public:
+	compact_linked_list() {}
+
+	//Constructs a list from a list of items
+	compact_linked_list(std::initializer_list<T> list) {
+		reserve(static_cast<int>(list.size()));
+		for (auto& i : list)
+		{
+			push_back(i);
+		}
+	}
+
+	//Copies a list. If the values are trivially copyable, then the whole array is copied with a single memcpy.
+	//Otherwise, the values are copied one at a time, keeping the same layout
+	compact_linked_list(const compact_linked_list<T>& copy)
+	{
+		if (copy.used == 0)
+		{
+			return;
+		}
+
+		nodes = allocateNodes(copy.used);
+		capacity = copy.used;
+
+		if constexpr (std::is_trivially_copyable<T>::value)
+		{
+			std::memcpy(nodes, copy.nodes, sizeof(node) * static_cast<std::size_t>(copy.used));
+		}
+		else
+		{
+			for (std::uint32_t i = 0; i < copy.used; i++)
+			{
+				nodes[i].next = copy.nodes[i].next;
+				nodes[i].prev = copy.nodes[i].prev;
+			}
+
+			std::uint32_t current = copy.first;
+			try
+			{
+				for (; current != NoNode; current = copy.nodes[current].next)
+				{
+					new (nodes[current].storage) T(copy.valueAt(current));
+				}
+			}
+			catch (...)
+			{
+				for (std::uint32_t i = copy.first; i != current; i = copy.nodes[i].next)
+				{
+					valueAt(i).~T();
+				}
+				freeNodes(nodes);
+				throw;
+			}
+		}
+
+		used = copy.used;
+		first = copy.first;
+		last = copy.last;
+		freeHead = copy.freeHead;
+		size = copy.size;
+	}
+
+	compact_linked_list(compact_linked_list<T>&& move) noexcept
+	{
+		swap(move);
+	}
+
+	compact_linked_list<T>& operator=(const compact_linked_list<T>& copy)
+	{
+		if (&copy != this)
+		{
+			compact_linked_list<T> temp{ copy };
+			swap(temp);
+		}
+		return *this;
+	}
+
+	compact_linked_list<T>& operator=(compact_linked_list<T>&& move) noexcept
+	{
+		if (&move != this)
+		{
+			clear();
+			freeNodes(nodes);
+			nodes = nullptr;
+			capacity = 0;
+			used = 0;
+			swap(move);
+		}
+		return *this;
+	}
+
+	~compact_linked_list()
+	{
+		destroyValues();
+		freeNodes(nodes);
+	}
+
+	//Swaps the contents of two lists
+	void swap(compact_linked_list<T>& other) noexcept
+	{
+		std::swap(nodes, other.nodes);
+		std::swap(capacity, other.capacity);
+		std::swap(used, other.used);
+		std::swap(first, other.first);
+		std::swap(last, other.last);
+		std::swap(freeHead, other.freeHead);
+		std::swap(size, other.size);
+	}
+
+	//Clears the list. The array is kept, so the list can be filled again without allocating
+	void clear()
+	{
+		destroyValues();
+		used = 0;
+		first = NoNode;
+		last = NoNode;
+		freeHead = NoNode;
+		size = 0;
+	}
+
+	//Makes sure the array can hold at least "newCapacity" nodes without growing
+	void reserve(int newCapacity)
+	{
+		if (newCapacity < 0 || static_cast<std::uint32_t>(newCapacity) > MaxNodes)
+		{
+			throw struct_exception("The capacity is out of range");
+		}
+		if (static_cast<std::uint32_t>(newCapacity) > capacity)
+		{
+			reallocate(static_cast<std::uint32_t>(newCapacity));
+		}
+	}
+
+	//Gets how many nodes the list can hold before the array has to grow
+	int getCapacity() const
+	{
+		return static_cast<int>(capacity);
+	}
+
+	//Gets an iterator to the first node
+	node_iterator begin() {
+		return node_iterator(first, this);
+	}
+
+	//Gets an iterator to the node after the last node
+	node_iterator end() {
+		return node_iterator(NoNode, this);
+	}
+
+	//Gets an iterator to the first node
+	const_node_iterator begin() const {
+		return const_node_iterator(first, this);
+	}
+
+	//Gets an iterator to the node after the last node
+	const_node_iterator end() const {
+		return const_node_iterator(NoNode, this);
+	}
+
+	//Gets an iterator to the first node
+	const_node_iterator cbegin() const {
+		return const_node_iterator(first, this);
+	}
+
+	//Gets an iterator to the node after the last node
+	const_node_iterator cend() const {
+		return const_node_iterator(NoNode, this);
+	}
+
+	//Adds a value to the front of the list
+	node_iterator push_front(const T& value)
+	{
+		return emplace_front(value);
+	}
+
+	//Adds a value to the front of the list
+	node_iterator push_front(T&& value)
+	{
+		return emplace_front(std::move(value));
+	}
+
+	//Adds a value to the back of the list
+	node_iterator push_back(const T& value)
+	{
+		return emplace_back(value);
+	}
+
+	//Adds a value to the back of the list
+	node_iterator push_back(T&& value)
+	{
+		return emplace_back(std::move(value));
+	}
+
+	//Constructs a new node at the front of the list
+	template<typename... Args>
+	node_iterator emplace_front(Args&&... arguments)
+	{
+		std::uint32_t index = createNode(std::forward<Args>(arguments)...);
+		linkBefore(index, first);
+		return node_iterator(index, this);
+	}
+
+	//Constructs a new node at the back of the list
+	template<typename... Args>
+	node_iterator emplace_back(Args&&... arguments)
+	{
+		std::uint32_t index = createNode(std::forward<Args>(arguments)...);
+		linkBefore(index, NoNode);
+		return node_iterator(index, this);
+	}
+
+	//Removes the first element from the list. Returns true if it was removed successfully
+	bool pop_front()
+	{
+		if (first == NoNode)
+		{
+			return false;
+		}
+		removeNode(first);
+		return true;
+	}
+
+	//Removes the last element from the list. Returns true if it was removed successfully
+	bool pop_back()
+	{
+		if (last == NoNode)
+		{
+			return false;
+		}
+		removeNode(last);
+		return true;
+	}
+
+	//Gets how many nodes are in the list
+	int getSize() const
+	{
+		return size;
+	}
+
+	//Inserts a new element before the specified position. Returns an iterator to the new node
+	node_iterator insert(const T& value, const node_iterator elementToInsertBefore)
+	{
+		checkIterator(elementToInsertBefore);
+		std::uint32_t index = createNode(value);
+		linkBefore(index, elementToInsertBefore._index);
+		return node_iterator(index, this);
+	}
+
+	//Inserts a new element before the specified position by moving the value. Returns an iterator to the new node
+	node_iterator insert(T&& value, const node_iterator elementToInsertBefore)
+	{
+		checkIterator(elementToInsertBefore);
+		std::uint32_t index = createNode(std::move(value));
+		linkBefore(index, elementToInsertBefore._index);
+		return node_iterator(index, this);
+	}
+
+	//Deletes an element at the specified position. The node is added to the free list and reused by a later insert
+	void pop_element(const node_iterator elementToRemove)
+	{
+		checkIterator(elementToRemove);
+		//Cannot delete the end() iterator, since that doesn't have a valid value
+		if (elementToRemove._index == NoNode)
+		{
+			throw struct_exception("The passed in iterator does not point to a valid element");
+		}
+		removeNode(elementToRemove._index);
+	}
+
+	//Finds a node with the specified value
+	const_node_iterator find(const T& value) const
+	{
+		for (std::uint32_t i = first; i != NoNode; i = nodes[i].next)
+		{
+			if (valueAt(i) == value)
+			{
+				return const_node_iterator(i, this);
+			}
+		}
+		return end();
+	}
+
+	//Finds a node with the specified value
+	node_iterator find(const T& value)
+	{
+		for (std::uint32_t i = first; i != NoNode; i = nodes[i].next)
+		{
+			if (valueAt(i) == value)
+			{
+				return node_iterator(i, this);
+			}
+		}
+		return end();
+	}
+
+	//Tests for equality
+	bool operator==(const compact_linked_list<T>& rhs) const
+	{
+		if (size != rhs.size)
+		{
+			return false;
+		}
+
+		for (std::uint32_t i = first, j = rhs.first; i != NoNode; i = nodes[i].next, j = rhs.nodes[j].next)
+		{
+			if (valueAt(i) != rhs.valueAt(j))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	//Tests for inequality
+	bool operator!=(const compact_linked_list<T>& rhs) const
+	{
+		return !(*this == rhs);
+	}
+};
+
+//Used for printing a compact_linked_list to a stream
+template<typename T>
+std::ostream& operator<<(std::ostream& os, const compact_linked_list<T>& list) {
+	os << '[';
+
+	bool first = true;
+	for (const auto& value : list) {
+		if (!first) {
+			os << ", ";
+		}
+		os << value;
+		first = false;
+	}
+
+	os << ']';
+
+	return os;
+}
@@ -0,0 +1,882 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <new>
+#include <ostream>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <common.h>
+#include <struct_exception.h>
+
+//A sorted set of unique items, balanced as an AVL tree, that is laid out for small keys. Every node is stored in a single growable array (the arena),
+//and the nodes are linked together with 31-bit indices instead of pointers. Nodes don't point to their parents, and the balance factor is kept in the top bit of each index instead of
+//storing a height, so a node only costs 8 bytes on top of its value (a 12 byte node for an int), compared to 28 bytes or more for binary_search_tree. More nodes fit into each cache line, so searches and traversals miss the cache less often.
+//Without parent pointers, iterators keep the path back up the tree in a small fixed-size stack, so they never allocate. Changing the tree invalidates its iterators
+template<typename T, typename Comparer = std::function<bool(const T&, const T&)>>
+class compact_search_tree {
+public:
+	//The index that represents "no node", such as the child index of a leaf. Indices only use the low 31 bits of a link
+	static constexpr std::uint32_t NoNode = (std::uint32_t(1) << 31) - 1;
+	//The maximum amount of nodes the tree can hold
+	static constexpr std::uint32_t MaxNodes = NoNode - 1;
+	//An AVL tree of 2^31 nodes is at most 45 levels tall, so this is how deep an iterator's stack ever has to go
+	static constexpr int MaxHeight = 48;
+
+	//Represents a node in the tree. An 8-bit balance factor would be padded out to the alignment of the indices,
+	//so the balance factor is kept in the top bit of each link instead
+	struct node {
+		//The storage for the value of the node. The value is only constructed while the node is in use
+		alignas(T) unsigned char storage[sizeof(T)];
+		//The index of the left child, with the top bit set if the left subtree is taller. For nodes in the free list, this is the index of the next free node
+		std::uint32_t leftLink;
+		//The index of the right child, with the top bit set if the right subtree is taller. Nodes in the free list have the top bit set on both links
+		std::uint32_t rightLink;
+
+		//Gets the index of the left child
+		std::uint32_t leftChild() const
+		{
+			return leftLink & NoNode;
+		}
+
+		//Gets the index of the right child
+		std::uint32_t rightChild() const
+		{
+			return rightLink & NoNode;
+		}
+
+		//Changes the left child without changing the balance factor
+		void setLeftChild(std::uint32_t index)
+		{
+			leftLink = (leftLink & TallerBit) | index;
+		}
+
+		//Changes the right child without changing the balance factor
+		void setRightChild(std::uint32_t index)
+		{
+			rightLink = (rightLink & TallerBit) | index;
+		}
+
+		//Gets the height of the right subtree minus the height of the left subtree, which is -1, 0 or 1
+		int balance() const
+		{
+			return static_cast<int>(rightLink >> 31) - static_cast<int>(leftLink >> 31);
+		}
+
+		//Changes the balance factor to -1, 0 or 1
+		void setBalance(int balance)
+		{
+			leftLink = (leftLink & NoNode) | (balance < 0 ? TallerBit : 0);
+			rightLink = (rightLink & NoNode) | (balance > 0 ? TallerBit : 0);
+		}
+
+		//Returns true if the node is in the free list
+		bool isFree() const
+		{
+			return (leftLink & rightLink & TallerBit) != 0;
+		}
+	};
+
+	//A read-only iterator over the values of the tree, in sorted order
+	class const_iterator {
+		friend class compact_search_tree<T, Comparer>;
+
+		//The tree the nodes come from
+		const compact_search_tree<T, Comparer>* tree = nullptr;
+		//The nodes whose values haven't been visited yet, on the way back up. The top of the stack is the current node
+		std::uint32_t path[MaxHeight];
+		int depth = 0;
+
+		//Adds a node and its chain of left children to the path
+		void pushLeft(std::uint32_t index)
+		{
+			for (; index != NoNode; index = tree->nodes[index].leftChild())
+			{
+				path[depth++] = index;
+			}
+		}
+
+		const_iterator(const compact_search_tree<T, Comparer>* tree) : tree(tree) {}
+
+	public:
+		//These type definitions are required for iterators
+		using value_type = T;
+		using reference = const T&;
+		using pointer = const T*;
+		using iterator_category = std::forward_iterator_tag;
+		using difference_type = std::ptrdiff_t;
+
+		//Creates an end iterator
+		const_iterator() = default;
+
+		//Moves to the next value in sorted order
+		const_iterator& operator++()
+		{
+			if (depth == 0)
+			{
+				throw struct_exception("Cannot iterate past the end of the tree");
+			}
+			std::uint32_t current = path[--depth];
+			pushLeft(tree->nodes[current].rightChild());
+			return *this;
+		}
+
+		const_iterator operator++(int)
+		{
+			const_iterator previous = *this;
+			++(*this);
+			return previous;
+		}
+
+		const T& operator*() const
+		{
+			return tree->valueAt(path[depth - 1]);
+		}
+
+		const T* operator->() const
+		{
+			return &tree->valueAt(path[depth - 1]);
+		}
+
+		//Gets the index of the node this iterator points to. Returns NoNode for the end() iterator
+		std::uint32_t get_index() const
+		{
+			return depth == 0 ? NoNode : path[depth - 1];
+		}
+
+		//Two iterators are equal if they point to the same node, or are both at the end
+		bool operator==(const const_iterator& rhs) const
+		{
+			return get_index() == rhs.get_index();
+		}
+
+		bool operator!=(const const_iterator& rhs) const
+		{
+			return !(*this == rhs);
+		}
+	};
+
+	using iterator = const_iterator;
+
+private:
+	//The top bit of a link, which is set on the side of the taller subtree
+	static constexpr std::uint32_t TallerBit = std::uint32_t(1) << 31;
+
+	//The array that stores every node
+	node* nodes = nullptr;
+	//How many nodes the array can hold
+	std::uint32_t capacity = 0;
+	//How many nodes at the start of the array have been used at some point. Every node past this has never been used
+	std::uint32_t used = 0;
+	//The index of the root node
+	std::uint32_t root = NoNode;
+	//The index of the first node in the free list
+	std::uint32_t freeHead = NoNode;
+	//How many values are in the tree
+	int treeSize = 0;
+	Comparer comparer;
+
+	//Gets the value of a node
+	T& valueAt(std::uint32_t index)
+	{
+		return *std::launder(reinterpret_cast<T*>(nodes[index].storage));
+	}
+
+	//Gets the value of a node
+	const T& valueAt(std::uint32_t index) const
+	{
+		return *std::launder(reinterpret_cast<const T*>(nodes[index].storage));
+	}
+
+	//Allocates an array of nodes. The values are not constructed
+	static node* allocateNodes(std::uint32_t count)
+	{
+		return static_cast<node*>(::operator new(sizeof(node) * static_cast<std::size_t>(count), std::align_val_t(alignof(node))));
+	}
+
+	//Frees an array of nodes
+	static void freeNodes(node* array)
+	{
+		::operator delete(array, std::align_val_t(alignof(node)));
+	}
+
+	//Gets the capacity to grow to when the array is full
+	std::uint32_t grownCapacity() const
+	{
+		if (capacity == MaxNodes)
+		{
+			throw struct_exception("A compact_search_tree can't hold more than 2^31 - 2 nodes");
+		}
+		if (capacity < 8)
+		{
+			return 8;
+		}
+		return capacity > MaxNodes / 2 ? MaxNodes : capacity * 2;
+	}
+
+	//Copies the links of every used node into another array, and copies or moves the values of the nodes that are in use.
+	//If a value throws, the new array is left without any constructed values and the exception is rethrown
+	template<bool move, typename Source>
+	static void transferNodes(Source* source, node* destination, std::uint32_t count)
+	{
+		//A trivially copyable value can be copied over with the links in one go
+		if constexpr (std::is_trivially_copyable<T>::value)
+		{
+			if (count != 0)
+			{
+				std::memcpy(destination, source, sizeof(node) * static_cast<std::size_t>(count));
+			}
+		}
+		else
+		{
+			std::uint32_t i = 0;
+			try
+			{
+				for (; i < count; i++)
+				{
+					destination[i].leftLink = source[i].leftLink;
+					destination[i].rightLink = source[i].rightLink;
+					if (!source[i].isFree())
+					{
+						T& value = *std::launder(reinterpret_cast<T*>(const_cast<unsigned char*>(source[i].storage)));
+						if constexpr (move)
+						{
+							new (destination[i].storage) T(std::move_if_noexcept(value));
+						}
+						else
+						{
+							new (destination[i].storage) T(static_cast<const T&>(value));
+						}
+					}
+				}
+			}
+			catch (...)
+			{
+				//Destroy every value that was transferred before the exception
+				destroyValues(destination, i);
+				throw;
+			}
+		}
+	}
+
+	//Destroys the values of the first "count" nodes of an array that are in use
+	static void destroyValues(node* array, std::uint32_t count)
+	{
+		if constexpr (!std::is_trivially_destructible<T>::value)
+		{
+			for (std::uint32_t i = 0; i < count; i++)
+			{
+				if (!array[i].isFree())
+				{
+					std::launder(reinterpret_cast<T*>(array[i].storage))->~T();
+				}
+			}
+		}
+	}
+
+	//Replaces the array with a new one that can hold "newCapacity" nodes
+	void reallocate(std::uint32_t newCapacity)
+	{
+		node* newNodes = allocateNodes(newCapacity);
+		try
+		{
+			transferNodes<true>(nodes, newNodes, used);
+		}
+		catch (...)
+		{
+			freeNodes(newNodes);
+			throw;
+		}
+		destroyValues(nodes, used);
+		freeNodes(nodes);
+		nodes = newNodes;
+		capacity = newCapacity;
+	}
+
+	//Takes a node from the free list or the unused part of the array, and constructs its value as a leaf.
+	//If the array has to grow, then the value is constructed before the old nodes are moved, so the arguments can refer to values in the tree
+	template<typename... Args>
+	std::uint32_t createNode(Args&&... args)
+	{
+		if (treeSize == std::numeric_limits<int>::max())
+		{
+			throw struct_exception("The tree is too large to hold any more nodes");
+		}
+
+		std::uint32_t index;
+		//Reuse a node from the free list
+		if (freeHead != NoNode)
+		{
+			index = freeHead;
+			new (nodes[index].storage) T(std::forward<Args>(args)...);
+			freeHead = nodes[index].leftChild();
+		}
+		//Use the next node that has never been used
+		else if (used < capacity)
+		{
+			index = used;
+			new (nodes[index].storage) T(std::forward<Args>(args)...);
+			used++;
+		}
+		//The array is full, so move every node into a larger array
+		else
+		{
+			std::uint32_t newCapacity = grownCapacity();
+			node* newNodes = allocateNodes(newCapacity);
+			try
+			{
+				new (newNodes[used].storage) T(std::forward<Args>(args)...);
+			}
+			catch (...)
+			{
+				freeNodes(newNodes);
+				throw;
+			}
+			try
+			{
+				transferNodes<true>(nodes, newNodes, used);
+			}
+			catch (...)
+			{
+				std::launder(reinterpret_cast<T*>(newNodes[used].storage))->~T();
+				freeNodes(newNodes);
+				throw;
+			}
+			destroyValues(nodes, used);
+			freeNodes(nodes);
+			nodes = newNodes;
+			capacity = newCapacity;
+			index = used++;
+		}
+
+		nodes[index].leftLink = NoNode;
+		nodes[index].rightLink = NoNode;
+		treeSize++;
+		return index;
+	}
+
+	//Destroys the value of a node and adds the node to the free list
+	void destroyNode(std::uint32_t index)
+	{
+		valueAt(index).~T();
+		nodes[index].leftLink = freeHead | TallerBit;
+		nodes[index].rightLink = TallerBit;
+		freeHead = index;
+		treeSize--;
+	}
+
+	//Rebalances a node whose left subtree has become two levels taller than its right subtree, and returns the node that takes its place.
+	//"shorter" is set if the subtree is now one level shorter than it was before the rotation
+	std::uint32_t fixLeftHeavy(std::uint32_t x, bool& shorter)
+	{
+		node& top = nodes[x];
+		std::uint32_t y = top.leftChild();
+		node& left = nodes[y];
+		int leftBalance = left.balance();
+		//Single right rotation
+		if (leftBalance <= 0)
+		{
+			top.setLeftChild(left.rightChild());
+			left.setRightChild(x);
+			//A left child with equal subtrees can only happen after a remove, and then the height stays the same
+			if (leftBalance == 0)
+			{
+				top.setBalance(-1);
+				left.setBalance(1);
+				shorter = false;
+			}
+			else
+			{
+				top.setBalance(0);
+				left.setBalance(0);
+				shorter = true;
+			}
+			return y;
+		}
+		//Double rotation, where the right child of the left child takes the place of the node
+		std::uint32_t z = left.rightChild();
+		node& middle = nodes[z];
+		int middleBalance = middle.balance();
+		left.setRightChild(middle.leftChild());
+		top.setLeftChild(middle.rightChild());
+		middle.setLeftChild(y);
+		middle.setRightChild(x);
+		top.setBalance(middleBalance == -1 ? 1 : 0);
+		left.setBalance(middleBalance == 1 ? -1 : 0);
+		middle.setBalance(0);
+		shorter = true;
+		return z;
+	}
+
+	//Rebalances a node whose right subtree has become two levels taller than its left subtree, and returns the node that takes its place.
+	//"shorter" is set if the subtree is now one level shorter than it was before the rotation
+	std::uint32_t fixRightHeavy(std::uint32_t x, bool& shorter)
+	{
+		node& top = nodes[x];
+		std::uint32_t y = top.rightChild();
+		node& right = nodes[y];
+		int rightBalance = right.balance();
+		//Single left rotation
+		if (rightBalance >= 0)
+		{
+			top.setRightChild(right.leftChild());
+			right.setLeftChild(x);
+			if (rightBalance == 0)
+			{
+				top.setBalance(1);
+				right.setBalance(-1);
+				shorter = false;
+			}
+			else
+			{
+				top.setBalance(0);
+				right.setBalance(0);
+				shorter = true;
+			}
+			return y;
+		}
+		//Double rotation, where the left child of the right child takes the place of the node
+		std::uint32_t z = right.leftChild();
+		node& middle = nodes[z];
+		int middleBalance = middle.balance();
+		right.setLeftChild(middle.rightChild());
+		top.setRightChild(middle.leftChild());
+		middle.setRightChild(y);
+		middle.setLeftChild(x);
+		top.setBalance(middleBalance == 1 ? -1 : 0);
+		right.setBalance(middleBalance == -1 ? 1 : 0);
+		middle.setBalance(0);
+		shorter = true;
+		return z;
+	}
+
+	//Inserts a value below a node, if it isn't in the subtree yet. Returns the new root of the subtree, and sets "grew" if the subtree got taller.
+	//The nodes are referred to by index, since creating a node can move the whole array
+	template<typename DataType>
+	std::uint32_t insertAt(std::uint32_t index, DataType&& data, bool& grew, bool& inserted)
+	{
+		if (index == NoNode)
+		{
+			grew = true;
+			inserted = true;
+			return createNode(std::forward<DataType>(data));
+		}
+		if (comparer(data, valueAt(index)))
+		{
+			std::uint32_t child = insertAt(nodes[index].leftChild(), std::forward<DataType>(data), grew, inserted);
+			nodes[index].setLeftChild(child);
+			if (grew)
+			{
+				//The left subtree got taller
+				int balance = nodes[index].balance() - 1;
+				grew = balance == -1;
+				if (balance == -2)
+				{
+					bool shorter;
+					return fixLeftHeavy(index, shorter);
+				}
+				nodes[index].setBalance(balance);
+			}
+		}
+		else if (comparer(valueAt(index), data))
+		{
+			std::uint32_t child = insertAt(nodes[index].rightChild(), std::forward<DataType>(data), grew, inserted);
+			nodes[index].setRightChild(child);
+			if (grew)
+			{
+				//The right subtree got taller
+				int balance = nodes[index].balance() + 1;
+				grew = balance == 1;
+				if (balance == 2)
+				{
+					bool shorter;
+					return fixRightHeavy(index, shorter);
+				}
+				nodes[index].setBalance(balance);
+			}
+		}
+		//The value is already in the tree
+		else
+		{
+			grew = false;
+			inserted = false;
+		}
+		return index;
+	}
+
+	//Updates a node after its left subtree got shorter, and returns the node that takes its place. "shorter" is set if the node's subtree got shorter too
+	std::uint32_t leftShrunk(std::uint32_t index, bool& shorter)
+	{
+		int balance = nodes[index].balance() + 1;
+		if (balance == 2)
+		{
+			return fixRightHeavy(index, shorter);
+		}
+		nodes[index].setBalance(balance);
+		shorter = balance == 0;
+		return index;
+	}
+
+	//Updates a node after its right subtree got shorter, and returns the node that takes its place. "shorter" is set if the node's subtree got shorter too
+	std::uint32_t rightShrunk(std::uint32_t index, bool& shorter)
+	{
+		int balance = nodes[index].balance() - 1;
+		if (balance == -2)
+		{
+			return fixLeftHeavy(index, shorter);
+		}
+		nodes[index].setBalance(balance);
+		shorter = balance == 0;
+		return index;
+	}
+
+	//Unlinks the smallest node of a subtree without destroying it, and stores its index in "smallest". Returns the new root of the subtree
+	std::uint32_t unlinkMinimum(std::uint32_t index, bool& shorter, std::uint32_t& smallest)
+	{
+		if (nodes[index].leftChild() == NoNode)
+		{
+			smallest = index;
+			shorter = true;
+			return nodes[index].rightChild();
+		}
+		std::uint32_t child = unlinkMinimum(nodes[index].leftChild(), shorter, smallest);
+		nodes[index].setLeftChild(child);
+		return shorter ? leftShrunk(index, shorter) : index;
+	}
+
+	//Removes a value from below a node, if it is in the subtree. Returns the new root of the subtree, and sets "shorter" if the subtree got shorter
+	template<typename DataType>
+	std::uint32_t removeAt(std::uint32_t index, const DataType& data, bool& shorter, bool& removed)
+	{
+		if (index == NoNode)
+		{
+			shorter = false;
+			removed = false;
+			return NoNode;
+		}
+		if (comparer(data, valueAt(index)))
+		{
+			std::uint32_t child = removeAt(nodes[index].leftChild(), data, shorter, removed);
+			nodes[index].setLeftChild(child);
+			return shorter ? leftShrunk(index, shorter) : index;
+		}
+		if (comparer(valueAt(index), data))
+		{
+			std::uint32_t child = removeAt(nodes[index].rightChild(), data, shorter, removed);
+			nodes[index].setRightChild(child);
+			return shorter ? rightShrunk(index, shorter) : index;
+		}
+
+		removed = true;
+		node& found = nodes[index];
+		//If the node has at most one child, then the child takes its place
+		if (found.leftChild() == NoNode || found.rightChild() == NoNode)
+		{
+			std::uint32_t child = found.leftChild() != NoNode ? found.leftChild() : found.rightChild();
+			destroyNode(index);
+			shorter = true;
+			return child;
+		}
+		//Otherwise, the smallest node of the right subtree takes its place. The node is moved by relinking it, so no values are moved
+		std::uint32_t successor;
+		std::uint32_t right = unlinkMinimum(found.rightChild(), shorter, successor);
+		//Both links are copied over, which moves the balance factor along with the children
+		nodes[successor].leftLink = found.leftLink;
+		nodes[successor].rightLink = found.rightLink;
+		nodes[successor].setRightChild(right);
+		destroyNode(index);
+		return shorter ? rightShrunk(successor, shorter) : successor;
+	}
+
+	//Swaps the arenas of two trees, leaving their comparers where they are
+	void swapNodes(compact_search_tree<T, Comparer>& other) noexcept
+	{
+		std::swap(nodes, other.nodes);
+		std::swap(capacity, other.capacity);
+		std::swap(used, other.used);
+		std::swap(root, other.root);
+		std::swap(freeHead, other.freeHead);
+		std::swap(treeSize, other.treeSize);
+	}
+
+	//Finds a value in the tree. Returns NoNode if the value isn't there
+	template<typename DataType>
+	std::uint32_t findNode(const DataType& data) const
+	{
+		std::uint32_t current = root;
+		while (current != NoNode)
+		{
+			const T& value = valueAt(current);
+			if (comparer(data, value))
+			{
+				current = nodes[current].leftChild();
+			}
+			else if (comparer(value, data))
+			{
+				current = nodes[current].rightChild();
+			}
+			else
+			{
+				return current;
+			}
+		}
+		return NoNode;
+	}
+
+	//Creates an iterator to the first value where "goLeft(value)" is true. "goLeft" must be false for every value before some point, and true after it
+	template<typename GoLeft>
+	const_iterator searchFor(GoLeft goLeft) const
+	{
+		const_iterator result(this);
+		//Only the nodes where the search goes left come after the result, so only they are added to the path
+		for (std::uint32_t current = root; current != NoNode;)
+		{
+			if (goLeft(valueAt(current)))
+			{
+				result.path[result.depth++] = current;
+				current = nodes[current].leftChild();
+			}
+			else
+			{
+				current = nodes[current].rightChild();
+			}
+		}
+		return result;
+	}
+
+public:
+	//Default constructor for a compact search tree
+	compact_search_tree() : comparer(sorting_impl::make_default_comparer<Comparer, T>()) {}
+
+	compact_search_tree(Comparer&& comp) : comparer(std::move(comp)) {}
+
+	//Constructs a tree from a list of items
+	compact_search_tree(std::initializer_list<T> list) : compact_search_tree()
+	{
+		reserve(static_cast<int>(list.size()));
+		for (auto& i : list)
+		{
+			insert(i);
+		}
+	}
+
+	//Copies a tree. If the values are trivially copyable, then the whole arena is copied with a single memcpy.
+	//Otherwise, the values are copied one at a time, keeping the same layout
+	compact_search_tree(const compact_search_tree<T, Comparer>& copy) : comparer(copy.comparer)
+	{
+		if (copy.used == 0)
+		{
+			return;
+		}
+
+		nodes = allocateNodes(copy.used);
+		try
+		{
+			transferNodes<false>(static_cast<const node*>(copy.nodes), nodes, copy.used);
+		}
+		catch (...)
+		{
+			freeNodes(nodes);
+			throw;
+		}
+		capacity = copy.used;
+		used = copy.used;
+		root = copy.root;
+		freeHead = copy.freeHead;
+		treeSize = copy.treeSize;
+	}
+
+	compact_search_tree(compact_search_tree<T, Comparer>&& move) noexcept : comparer(std::move(move.comparer))
+	{
+		swapNodes(move);
+	}
+
+	compact_search_tree<T, Comparer>& operator=(const compact_search_tree<T, Comparer>& copy)
+	{
+		if (&copy != this)
+		{
+			compact_search_tree<T, Comparer> temp{ copy };
+			swap(temp);
+		}
+		return *this;
+	}
+
+	compact_search_tree<T, Comparer>& operator=(compact_search_tree<T, Comparer>&& move) noexcept
+	{
+		if (&move != this)
+		{
+			clear();
+			freeNodes(nodes);
+			nodes = nullptr;
+			capacity = 0;
+			swap(move);
+		}
+		return *this;
+	}
+
+	~compact_search_tree()
+	{
+		destroyValues(nodes, used);
+		freeNodes(nodes);
+	}
+
+	//Swaps the contents of two trees
+	void swap(compact_search_tree<T, Comparer>& other) noexcept
+	{
+		swapNodes(other);
+		std::swap(comparer, other.comparer);
+	}
+
+	//Inserts a value into the tree. Returns false if the value is already in the tree
+	template<typename DataType>
+	bool insert(DataType&& data)
+	{
+		bool grew = false;
+		bool inserted = false;
+		root = insertAt(root, std::forward<DataType>(data), grew, inserted);
+		return inserted;
+	}
+
+	//Removes a value from the tree. The node is added to the free list and reused by a later insert. Returns false if the value is not in the tree
+	template<typename DataType>
+	bool remove(const DataType& data)
+	{
+		bool shorter = false;
+		bool removed = false;
+		root = removeAt(root, data, shorter, removed);
+		return removed;
+	}
+
+	//Clears the tree. The arena is kept, so the tree can be filled again without allocating
+	void clear()
+	{
+		destroyValues(nodes, used);
+		used = 0;
+		root = NoNode;
+		freeHead = NoNode;
+		treeSize = 0;
+	}
+
+	//Makes sure the arena can hold at least "newCapacity" nodes without growing
+	void reserve(int newCapacity)
+	{
+		if (newCapacity < 0 || static_cast<std::uint32_t>(newCapacity) > MaxNodes)
+		{
+			throw struct_exception("The capacity is out of range");
+		}
+		if (static_cast<std::uint32_t>(newCapacity) > capacity)
+		{
+			reallocate(static_cast<std::uint32_t>(newCapacity));
+		}
+	}
+
+	//Gets how many nodes the tree can hold before the arena has to grow
+	int getCapacity() const
+	{
+		return static_cast<int>(capacity);
+	}
+
+	//Returns true if the value is in the tree
+	template<typename DataType>
+	bool contains(const DataType& data) const
+	{
+		return findNode(data) != NoNode;
+	}
+
+	//Attempts to find data in the tree and returns an iterator to that data. If the data could not be found, then the end() iterator is returned
+	template<typename DataType>
+	const_iterator find(const DataType& data) const
+	{
+		const_iterator result = lower_bound(data);
+		if (result != end() && comparer(data, *result))
+		{
+			return end();
+		}
+		return result;
+	}
+
+	//Returns an iterator to the first value that is not less than "data". Returns end() if every value is less than "data"
+	template<typename DataType>
+	const_iterator lower_bound(const DataType& data) const
+	{
+		return searchFor([this, &data](const T& value) { return !comparer(value, data); });
+	}
+
+	//Returns an iterator to the first value that is greater than "data". Returns end() if no value is greater than "data"
+	template<typename DataType>
+	const_iterator upper_bound(const DataType& data) const
+	{
+		return searchFor([this, &data](const T& value) { return static_cast<bool>(comparer(data, value)); });
+	}
+
+	//Get the beginning iterator, which points to the smallest value
+	const_iterator begin() const
+	{
+		const_iterator result(this);
+		result.pushLeft(root);
+		return result;
+	}
+
+	//Gets the ending iterator
+	const_iterator end() const
+	{
+		return const_iterator(this);
+	}
+
+	//Gets how many values are in the tree
+	int getSize() const
+	{
+		return treeSize;
+	}
+
+	//Gets the height of the tree. An empty tree has a height of 0
+	int getHeight() const
+	{
+		int height = 0;
+		//The taller side of every node is known from its balance factor, so the height is found by following it down
+		for (std::uint32_t current = root; current != NoNode; height++)
+		{
+			current = nodes[current].balance() > 0 ? nodes[current].rightChild() : nodes[current].leftChild();
+		}
+		return height;
+	}
+
+	//Returns a vector with all the values traversed from lowest to largest value
+	std::vector<T> traverse() const
+	{
+		std::vector<T> result;
+		result.reserve(treeSize);
+		for (const T& value : *this)
+		{
+			result.push_back(value);
+		}
+		return result;
+	}
+};
+
+//Two 31-bit links and no padding, so an int node costs 8 bytes on top of its value
+static_assert(sizeof(compact_search_tree<int>::node) == 12, "A compact_search_tree node for an int should take 12 bytes");
+
+//Used for printing a compact_search_tree to a stream
+template<typename T, typename Comparer>
+std::ostream& operator<<(std::ostream& os, const compact_search_tree<T, Comparer>& tree) {
+	os << '[';
+
+	bool first = true;
+	for (const auto& value : tree) {
+		if (!first) {
+			os << ", ";
+		}
+		os << value;
+		first = false;
+	}
+
+	os << ']';
+
+	return os;
+}
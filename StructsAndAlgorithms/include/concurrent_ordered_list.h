@@ -0,0 +1,283 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <utility>
+#include <vector>
+#include <common.h>
+#include <epoch_reclaimer.h>
+
+//A sorted set of unique items that any amount of threads can insert into, erase from and search at the same time without any locks (Harris and Michael's list).
+//Erasing a node happens in two steps. First, the node's next pointer gets a "deleted" mark, which stops any new nodes from being linked after it.
+//Then the node is unlinked from the list. Any thread that finds a marked node while searching helps unlink it.
+//Unlinked nodes are handed to an epoch_reclaimer, so they aren't deleted while other threads could still be reading them
+template<typename T, typename Comparer = std::function<bool(const T&, const T&)>>
+class concurrent_ordered_list {
+	//Represents a node in the list
+	struct node {
+		//The value of the node
+		T value;
+		//A pointer to the next node. The lowest bit is set when this node has been erased
+		std::atomic<std::uintptr_t> next;
+
+		template<typename DataType>
+		node(DataType&& data, std::uintptr_t nextPtr) :
+			value(std::forward<DataType>(data)),
+			next(nextPtr) {}
+	};
+
+	//The mark that is stored in the lowest bit of a next pointer when a node has been erased
+	static constexpr std::uintptr_t DeletedMark = 1;
+
+	//Returns true if the link has the deleted mark
+	static bool isMarked(std::uintptr_t link)
+	{
+		return (link & DeletedMark) != 0;
+	}
+
+	//Gets the node a link points to, without the mark
+	static node* toNode(std::uintptr_t link)
+	{
+		return reinterpret_cast<node*>(link & ~DeletedMark);
+	}
+
+	//Turns a node pointer into an unmarked link
+	static std::uintptr_t toLink(node* n)
+	{
+		return reinterpret_cast<std::uintptr_t>(n);
+	}
+
+	//The link to the first node in the list
+	alignas(CacheLineSize) std::atomic<std::uintptr_t> head{ 0 };
+	//Roughly how many nodes are in the list
+	alignas(CacheLineSize) std::atomic<int> size{ 0 };
+	//Used for deleting erased nodes once no threads can be reading them
+	epoch_reclaimer reclaimer;
+	Comparer comparer;
+
+	//The result of searching for a value
+	struct position {
+		//The link that points to "current"
+		std::atomic<std::uintptr_t>* previous;
+		//The first node that is not less than the value, or nullptr if every node is less
+		node* current;
+	};
+
+	//Finds where a value belongs in the list. Any erased nodes that are found along the way are unlinked and retired.
+	//Returns true if "current" is equal to the value
+	template<typename DataType>
+	bool search(const DataType& data, position& result, epoch_reclaimer::guard& guard)
+	{
+	retry:
+		std::atomic<std::uintptr_t>* previous = &head;
+		node* current = toNode(previous->load(std::memory_order_acquire));
+
+		while (current != nullptr)
+		{
+			std::uintptr_t next = current->next.load(std::memory_order_acquire);
+
+			//If the current node has been erased, then help unlink it
+			if (isMarked(next))
+			{
+				std::uintptr_t expected = toLink(current);
+				//If the previous link has changed, then the list changed underneath us, so start over
+				if (!previous->compare_exchange_strong(expected, next & ~DeletedMark, std::memory_order_acq_rel))
+				{
+					goto retry;
+				}
+				guard.retire(current);
+				current = toNode(next);
+				continue;
+			}
+
+			//If the current node is not less than the value, then we found the position
+			if (!comparer(current->value, data))
+			{
+				result = position{ previous, current };
+				return !comparer(data, current->value);
+			}
+
+			previous = &current->next;
+			current = toNode(next);
+		}
+
+		result = position{ previous, nullptr };
+		return false;
+	}
+
+	//Inserts a node with the value. Returns false if the value is already in the list
+	template<typename DataType>
+	bool insertValue(DataType&& data)
+	{
+		auto guard = reclaimer.enter();
+		//Create the node up front, since the value may be moved into it
+		node* newNode = new node(std::forward<DataType>(data), 0);
+		position pos;
+
+		while (true)
+		{
+			if (search(newNode->value, pos, guard))
+			{
+				//The node was never visible to other threads, so it can be deleted right away
+				delete newNode;
+				return false;
+			}
+
+			newNode->next.store(toLink(pos.current), std::memory_order_relaxed);
+
+			//Link the node in. If the previous link changed or was marked as deleted, then search again
+			std::uintptr_t expected = toLink(pos.current);
+			if (pos.previous->compare_exchange_strong(expected, toLink(newNode), std::memory_order_acq_rel))
+			{
+				size.fetch_add(1, std::memory_order_relaxed);
+				return true;
+			}
+		}
+	}
+
+	//Deletes every node. Only safe when no other threads are using the list
+	void deleteAll()
+	{
+		node* current = toNode(head.load(std::memory_order_relaxed));
+		while (current != nullptr)
+		{
+			node* next = toNode(current->next.load(std::memory_order_relaxed));
+			delete current;
+			current = next;
+		}
+		head.store(0, std::memory_order_relaxed);
+		size.store(0, std::memory_order_relaxed);
+	}
+
+public:
+	//Default constructor for a concurrent ordered list
+	concurrent_ordered_list() : comparer(sorting_impl::DefaultComparer<T>) {}
+
+	concurrent_ordered_list(Comparer&& comp) : comparer(std::move(comp)) {}
+
+	//The list can't be copied or moved while other threads could be using it
+	concurrent_ordered_list(const concurrent_ordered_list<T, Comparer>&) = delete;
+	concurrent_ordered_list<T, Comparer>& operator=(const concurrent_ordered_list<T, Comparer>&) = delete;
+
+	//No other threads can be using the list when it is destroyed
+	~concurrent_ordered_list()
+	{
+		deleteAll();
+	}
+
+	//Inserts a value into the list. Returns false if the value is already in the list. Safe to call from any thread
+	bool insert(const T& value)
+	{
+		return insertValue(value);
+	}
+
+	//Inserts a value into the list. Returns false if the value is already in the list. Safe to call from any thread
+	bool insert(T&& value)
+	{
+		return insertValue(std::move(value));
+	}
+
+	//Erases a value from the list. Returns false if the value is not in the list. Safe to call from any thread
+	template<typename DataType>
+	bool erase(const DataType& data)
+	{
+		auto guard = reclaimer.enter();
+		position pos;
+
+		while (true)
+		{
+			if (!search(data, pos, guard))
+			{
+				return false;
+			}
+
+			//Mark the node as deleted. If another thread marked it first, then that thread erased it and we search again
+			std::uintptr_t next = pos.current->next.load(std::memory_order_acquire);
+			if (isMarked(next) || !pos.current->next.compare_exchange_strong(next, next | DeletedMark, std::memory_order_acq_rel))
+			{
+				continue;
+			}
+			size.fetch_sub(1, std::memory_order_relaxed);
+
+			//Try to unlink the node. If that fails, then searching again will unlink it
+			std::uintptr_t expected = toLink(pos.current);
+			if (pos.previous->compare_exchange_strong(expected, next, std::memory_order_acq_rel))
+			{
+				guard.retire(pos.current);
+			}
+			else
+			{
+				search(data, pos, guard);
+			}
+			return true;
+		}
+	}
+
+	//Returns true if the value is in the list. This never changes any links, so readers don't slow each other down. Safe to call from any thread
+	template<typename DataType>
+	bool contains(const DataType& data)
+	{
+		auto guard = reclaimer.enter();
+		node* current = toNode(head.load(std::memory_order_acquire));
+
+		//Skip over every node that is less than the value, whether it has been erased or not
+		while (current != nullptr && comparer(current->value, data))
+		{
+			current = toNode(current->next.load(std::memory_order_acquire));
+		}
+
+		//The value is in the list if the node is equal to it and hasn't been erased
+		return current != nullptr && !comparer(data, current->value) && !isMarked(current->next.load(std::memory_order_acquire));
+	}
+
+	//Gets roughly how many values are in the list. This can be out of date by the time it returns if other threads are using the list
+	int getSize() const
+	{
+		return size.load(std::memory_order_relaxed);
+	}
+
+	//Returns a vector with all the values that are in the list, from lowest to largest. Safe to call from any thread,
+	//but values that are inserted or erased while this runs may or may not be included
+	std::vector<T> traverse()
+	{
+		auto guard = reclaimer.enter();
+		std::vector<T> elements{};
+
+		for (node* current = toNode(head.load(std::memory_order_acquire)); current != nullptr;)
+		{
+			std::uintptr_t next = current->next.load(std::memory_order_acquire);
+			if (!isMarked(next))
+			{
+				elements.push_back(current->value);
+			}
+			current = toNode(next);
+		}
+		return elements;
+	}
+
+	//Removes every value from the list. Only safe when no other threads are using the list
+	void clear()
+	{
+		deleteAll();
+	}
+};
+
+//Used for printing a concurrent_ordered_list to a stream. Values that are inserted or erased while printing may or may not be printed
+template<typename T, typename Comparer>
+std::ostream& operator<<(std::ostream& os, concurrent_ordered_list<T, Comparer>& list) {
+	os << '[';
+
+	bool first = true;
+	for (const auto& value : list.traverse()) {
+		if (!first) {
+			os << ", ";
+		}
+		os << value;
+		first = false;
+	}
+
+	os << ']';
+
+	return os;
+}
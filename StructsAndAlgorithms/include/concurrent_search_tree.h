@@ -0,0 +1,226 @@
+#pragma once
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <utility>
+#include <vector>
+#include <common.h>
+#include <epoch_reclaimer.h>
+#include <path_copying.h>
+
+//A sorted set of unique items that many threads can search while one thread at a time changes it. Readers never take a lock or wait for a writer.
+//The tree is an AVL tree whose nodes are never changed once other threads can see them. A writer copies the nodes on the path it changes (path copying),
+//builds the new version of the tree next to the old one, and then publishes the new root with a single atomic store. Readers that loaded the old root keep
+//seeing the old version, so every read sees one consistent version of the tree. Writers are serialized with a mutex.
+//The nodes that a write replaces are handed to an epoch_reclaimer, so they aren't deleted while readers could still be reading them
+template<typename T, typename Comparer = std::function<bool(const T&, const T&)>>
+class concurrent_search_tree : path_copy_impl::path_copy_tree<T, Comparer> {
+	using base = path_copy_impl::path_copy_tree<T, Comparer>;
+	using node = typename base::node_type;
+
+	//The root of the current version of the tree
+	alignas(CacheLineSize) std::atomic<node*> root{ nullptr };
+	//How many values are in the current version of the tree
+	std::atomic<int> treeSize{ 0 };
+	//Used for deleting replaced nodes once no readers can be reading them
+	epoch_reclaimer reclaimer;
+	//Only one write can happen at a time
+	alignas(CacheLineSize) std::mutex writeLock;
+
+	//Runs a write that builds a new version of the tree from the current root, and then publishes it. If the write throws, the tree is left unchanged
+	template<typename Write>
+	void publish(Write&& write, int sizeChange)
+	{
+		node* newRoot = this->copyPath(root.load(std::memory_order_relaxed), std::forward<Write>(write));
+		root.store(newRoot, std::memory_order_release);
+		treeSize.store(treeSize.load(std::memory_order_relaxed) + sizeChange, std::memory_order_relaxed);
+
+		//Readers may still be reading the replaced nodes through the old root
+		auto guard = reclaimer.enter();
+		for (node* n : this->replaced)
+		{
+			guard.retire(n);
+		}
+	}
+
+	//Deletes every node of a subtree. Only safe when no readers can be reading it
+	static void deleteSubtree(node* n)
+	{
+		std::vector<node*> stack;
+		if (n != nullptr)
+		{
+			stack.push_back(n);
+		}
+		while (!stack.empty())
+		{
+			node* current = stack.back();
+			stack.pop_back();
+			if (current->leftChild != nullptr)
+			{
+				stack.push_back(current->leftChild);
+			}
+			if (current->rightChild != nullptr)
+			{
+				stack.push_back(current->rightChild);
+			}
+			delete current;
+		}
+	}
+
+public:
+	//A read-only iterator over the values of a snapshot, in sorted order
+	using const_iterator = path_copy_impl::const_iterator<T>;
+
+	//A read-only view of one version of the tree. Writes that happen after the snapshot is taken don't change it. The snapshot holds an epoch_reclaimer guard,
+	//so the nodes it can see aren't deleted while it exists. Keep snapshots short-lived, since no replaced nodes can be freed while one is held
+	class snapshot {
+		friend class concurrent_search_tree<T, Comparer>;
+
+		epoch_reclaimer::guard guard;
+		const node* root;
+		const concurrent_search_tree<T, Comparer>* tree;
+
+		explicit snapshot(concurrent_search_tree<T, Comparer>* owner) :
+			guard(owner->reclaimer.enter()),
+			root(owner->root.load(std::memory_order_acquire)),
+			tree(owner) {}
+
+	public:
+		//Returns true if the value is in this version of the tree
+		template<typename DataType>
+		bool contains(const DataType& data) const
+		{
+			return tree->findNode(root, data) != nullptr;
+		}
+
+		//Gets the iterator to the smallest value
+		const_iterator begin() const
+		{
+			return const_iterator(root);
+		}
+
+		//Gets the ending iterator
+		const_iterator end() const
+		{
+			return const_iterator();
+		}
+	};
+
+	//Default constructor for a concurrent search tree
+	concurrent_search_tree() : base(sorting_impl::DefaultComparer<T>) {}
+
+	concurrent_search_tree(Comparer&& comp) : base(std::move(comp)) {}
+
+	//The tree can't be copied or moved while other threads could be using it
+	concurrent_search_tree(const concurrent_search_tree<T, Comparer>&) = delete;
+	concurrent_search_tree<T, Comparer>& operator=(const concurrent_search_tree<T, Comparer>&) = delete;
+
+	//No other threads can be using the tree when it is destroyed
+	~concurrent_search_tree()
+	{
+		deleteSubtree(root.load(std::memory_order_relaxed));
+	}
+
+	//Inserts a value into the tree. Returns false if the value is already in the tree. Safe to call from any thread, but only one write runs at a time
+	template<typename DataType>
+	bool insert(DataType&& data)
+	{
+		std::lock_guard<std::mutex> lock{ writeLock };
+		//Check first, so nothing is copied if the value is already in the tree
+		if (this->findNode(root.load(std::memory_order_relaxed), data) != nullptr)
+		{
+			return false;
+		}
+		publish([this, &data](node* current) { return this->insertAt(current, std::forward<DataType>(data)); }, 1);
+		return true;
+	}
+
+	//Removes a value from the tree. Returns false if the value is not in the tree. Safe to call from any thread, but only one write runs at a time
+	template<typename DataType>
+	bool remove(const DataType& data)
+	{
+		std::lock_guard<std::mutex> lock{ writeLock };
+		if (this->findNode(root.load(std::memory_order_relaxed), data) == nullptr)
+		{
+			return false;
+		}
+		publish([this, &data](node* current) { return this->removeAt(current, data); }, -1);
+		return true;
+	}
+
+	//Removes every value from the tree. Safe to call from any thread. Readers that are still reading the old version can finish reading it
+	void clear()
+	{
+		std::lock_guard<std::mutex> lock{ writeLock };
+		node* oldRoot = root.exchange(nullptr, std::memory_order_acq_rel);
+		treeSize.store(0, std::memory_order_relaxed);
+
+		auto guard = reclaimer.enter();
+		std::vector<node*> stack;
+		if (oldRoot != nullptr)
+		{
+			stack.push_back(oldRoot);
+		}
+		while (!stack.empty())
+		{
+			node* current = stack.back();
+			stack.pop_back();
+			if (current->leftChild != nullptr)
+			{
+				stack.push_back(current->leftChild);
+			}
+			if (current->rightChild != nullptr)
+			{
+				stack.push_back(current->rightChild);
+			}
+			guard.retire(current);
+		}
+	}
+
+	//Returns true if the value is in the tree. This never takes a lock or waits for a writer. Safe to call from any thread
+	template<typename DataType>
+	bool contains(const DataType& data)
+	{
+		auto guard = reclaimer.enter();
+		return this->findNode(root.load(std::memory_order_acquire), data) != nullptr;
+	}
+
+	//Takes a snapshot of the current version of the tree, which can be searched and iterated over without seeing any later writes. Safe to call from any thread
+	snapshot get_snapshot()
+	{
+		return snapshot(this);
+	}
+
+	//Gets how many values are in the tree. This can be out of date by the time it returns if another thread is writing to the tree
+	int getSize() const
+	{
+		return treeSize.load(std::memory_order_relaxed);
+	}
+
+	//Returns a vector with all the values in the current version of the tree, from lowest to largest. Safe to call from any thread
+	std::vector<T> traverse()
+	{
+		auto view = get_snapshot();
+		return std::vector<T>(view.begin(), view.end());
+	}
+};
+
+//Used for printing a concurrent_search_tree to a stream. The values are printed from a single version of the tree
+template<typename T, typename Comparer>
+std::ostream& operator<<(std::ostream& os, concurrent_search_tree<T, Comparer>& tree) {
+	os << '[';
+
+	bool first = true;
+	for (const auto& value : tree.traverse()) {
+		if (!first) {
+			os << ", ";
+		}
+		os << value;
+		first = false;
+	}
+
+	os << ']';
+
+	return os;
+}
@@ -0,0 +1,166 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include <common.h>
+#include <struct_exception.h>
+
+//Frees memory that lock-free structures have removed, once no thread could still be reading it (epoch based reclamation).
+//Threads enter a "guard" before touching shared nodes. Removed nodes are "retired" instead of deleted, and they are only deleted
+//after the global epoch has moved forward twice, which can only happen once every thread inside a guard has seen the newer epochs
+class epoch_reclaimer {
+public:
+	//The maximum amount of guards that can be active at the same time
+	static constexpr int MaxParticipants = 128;
+
+private:
+	//The epoch value of a participant that is not inside a guard
+	static constexpr std::uint64_t Inactive = std::numeric_limits<std::uint64_t>::max();
+	//How many nodes a participant retires before it tries to advance the global epoch
+	static constexpr int RetiresPerAdvance = 64;
+
+	//A node that has been removed, but may still be read by other threads
+	struct retired_node {
+		void* pointer;
+		void (*deleter)(void*);
+		//The global epoch when the node was retired. The node can be deleted once the global epoch is two past this
+		std::uint64_t epoch;
+	};
+
+	//The state of a single guard. Each participant sits on its own cache line so guards don't slow each other down
+	struct alignas(CacheLineSize) participant {
+		//Whether a guard is currently using this participant
+		std::atomic<bool> inUse{ false };
+		//The epoch this participant entered at, or Inactive if it isn't inside a guard
+		std::atomic<std::uint64_t> epoch{ Inactive };
+		//The last epoch this participant has seen. Only accessed by the guard that is using the participant
+		std::uint64_t lastEpoch = 0;
+		//How many nodes have been retired since the last attempt to advance the epoch
+		int retiresSinceAdvance = 0;
+		//The nodes that have been retired but not deleted yet, from oldest to newest. Only accessed by the guard that is using the participant
+		std::vector<retired_node> limbo;
+	};
+
+	//The current global epoch
+	alignas(CacheLineSize) std::atomic<std::uint64_t> globalEpoch{ 0 };
+	//The list of participants
+	participant participants[MaxParticipants];
+
+	//Deletes the nodes in a limbo list that were retired at least two epochs before "current"
+	static void freeExpired(std::vector<retired_node>& limbo, std::uint64_t current)
+	{
+		//The list is ordered by epoch, so the expired nodes are all at the front
+		std::size_t expired = 0;
+		while (expired < limbo.size() && limbo[expired].epoch + 2 <= current)
+		{
+			limbo[expired].deleter(limbo[expired].pointer);
+			expired++;
+		}
+		limbo.erase(limbo.begin(), limbo.begin() + expired);
+	}
+
+	//Claims an unused participant. Starts searching from the participant this thread used last time, which is usually still free
+	participant* claim()
+	{
+		static thread_local int hint = 0;
+		for (int attempt = 0; attempt < MaxParticipants; attempt++)
+		{
+			int index = (hint + attempt) % MaxParticipants;
+			bool expected = false;
+			if (!participants[index].inUse.load(std::memory_order_relaxed) &&
+				participants[index].inUse.compare_exchange_strong(expected, true, std::memory_order_acquire))
+			{
+				hint = index;
+				return &participants[index];
+			}
+		}
+		throw struct_exception("Too many threads are using the epoch_reclaimer at the same time");
+	}
+
+	//Moves the global epoch forward if every active participant has seen the current one
+	void tryAdvance(std::uint64_t current)
+	{
+		for (auto& other : participants)
+		{
+			std::uint64_t otherEpoch = other.epoch.load(std::memory_order_seq_cst);
+			if (otherEpoch != Inactive && otherEpoch != current)
+			{
+				return;
+			}
+		}
+		globalEpoch.compare_exchange_strong(current, current + 1, std::memory_order_seq_cst);
+	}
+
+public:
+	//Keeps every node that is reachable when the guard is created alive until the guard is destroyed
+	class guard {
+		friend class epoch_reclaimer;
+
+		epoch_reclaimer* reclaimer;
+		participant* self;
+
+		explicit guard(epoch_reclaimer* owner) : reclaimer(owner), self(owner->claim())
+		{
+			//Announce the current epoch. If the epoch moves forward while announcing, then announce again so the announcement is never behind
+			std::uint64_t current = reclaimer->globalEpoch.load(std::memory_order_seq_cst);
+			do
+			{
+				self->epoch.store(current, std::memory_order_seq_cst);
+			} while (!reclaimer->globalEpoch.compare_exchange_strong(current, current, std::memory_order_seq_cst));
+
+			//If the epoch has moved on since this participant was last used, then some of the nodes it retired may be safe to delete now
+			if (self->lastEpoch != current)
+			{
+				freeExpired(self->limbo, current);
+				self->lastEpoch = current;
+			}
+		}
+
+	public:
+		guard(const guard&) = delete;
+		guard& operator=(const guard&) = delete;
+
+		~guard()
+		{
+			self->epoch.store(Inactive, std::memory_order_release);
+			self->inUse.store(false, std::memory_order_release);
+		}
+
+		//Marks a node as removed. The deleter is called once no other thread can be reading the node
+		template<typename NodeType>
+		void retire(NodeType* node)
+		{
+			//The node is tagged with the global epoch rather than the epoch of this guard, since the global epoch may already be one ahead
+			std::uint64_t current = reclaimer->globalEpoch.load(std::memory_order_seq_cst);
+			self->limbo.push_back(retired_node{ node, [](void* pointer) { delete static_cast<NodeType*>(pointer); }, current });
+
+			//Every so often, try to move the epoch forward so retired nodes can be freed
+			if (++self->retiresSinceAdvance >= RetiresPerAdvance)
+			{
+				self->retiresSinceAdvance = 0;
+				reclaimer->tryAdvance(current);
+			}
+		}
+	};
+
+	epoch_reclaimer() = default;
+
+	epoch_reclaimer(const epoch_reclaimer&) = delete;
+	epoch_reclaimer& operator=(const epoch_reclaimer&) = delete;
+
+	//Deletes every retired node. No guards can be active when the reclaimer is destroyed
+	~epoch_reclaimer()
+	{
+		for (auto& participant : participants)
+		{
+			freeExpired(participant.limbo, std::numeric_limits<std::uint64_t>::max());
+		}
+	}
+
+	//Enters a guard for the calling thread
+	guard enter()
+	{
+		return guard(this);
+	}
+};
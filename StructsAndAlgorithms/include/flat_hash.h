@@ -0,0 +1,809 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <ostream>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <common.h>
+#include <struct_exception.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FLAT_HASH_SSE2 1
+#endif
+
+//This namespace contains implementation details
+namespace flat_hash_impl
+{
+	//The mapped type of a set, which has no values
+	struct no_value {};
+
+	//How many slots are probed at once. Each group of slots has 16 control bytes, which fit in one SSE2 register
+	constexpr int GroupSize = 16;
+
+	//The control byte of a slot that has never held a key since the table was built. A search stops at a group that has one of these
+	constexpr std::int8_t Empty = -128;
+	//The control byte of a slot whose key was removed from a full group. A search has to keep going past it, since keys after it may have probed through the full group
+	constexpr std::int8_t Deleted = -2;
+	//Every other control byte is 0 to 127, and holds the lowest 7 bits of the hash of the slot's key
+
+	//Returns the index of the lowest set bit. "mask" can't be 0
+	inline int lowest_bit(std::uint32_t mask)
+	{
+#if defined(__GNUC__)
+		return __builtin_ctz(mask);
+#else
+		int index = 0;
+		while ((mask & 1) == 0)
+		{
+			mask >>= 1;
+			index++;
+		}
+		return index;
+#endif
+	}
+
+	//Returns a mask with a bit set for every control byte of a group that equals "value"
+	inline std::uint32_t match(const std::int8_t* group, std::int8_t value)
+	{
+#if defined(FLAT_HASH_SSE2)
+		__m128i controls = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+		return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(controls, _mm_set1_epi8(value))));
+#else
+		std::uint32_t mask = 0;
+		for (int i = 0; i < GroupSize; i++)
+		{
+			if (group[i] == value)
+			{
+				mask |= 1U << i;
+			}
+		}
+		return mask;
+#endif
+	}
+
+	//Returns a mask with a bit set for every slot of a group that is empty or deleted. These are the only negative control bytes, so this is just the sign bits
+	inline std::uint32_t match_free(const std::int8_t* group)
+	{
+#if defined(FLAT_HASH_SSE2)
+		return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(group))));
+#else
+		std::uint32_t mask = 0;
+		for (int i = 0; i < GroupSize; i++)
+		{
+			if (group[i] < 0)
+			{
+				mask |= 1U << i;
+			}
+		}
+		return mask;
+#endif
+	}
+
+	//An open addressing hash table in the style of a Swiss table. The keys (and values of a map) are stored directly in one array of slots,
+	//and a separate array has one control byte per slot that says if it's empty, deleted or full, along with 7 bits of the hash of its key.
+	//A search picks a group of 16 slots from the hash, and compares all 16 control bytes to the hash at once with SSE2. Only slots whose bytes match have their keys compared,
+	//so almost every key compared is the one being looked for. If no key matches and the group has an empty slot, then the key isn't in the table. Otherwise the next group is probed.
+	//Removing a key from a group that has an empty slot just empties it again, since no search could have gone past that group. Only keys removed from full groups leave a deleted marker,
+	//and those are cleared out whenever the table is rebuilt. The table is rebuilt at twice the size once 7/8 of the slots are used
+	template<typename Key, typename Mapped, typename Hasher, typename KeyEqual>
+	class hash_table
+	{
+	protected:
+		static constexpr bool IsMap = !std::is_same<Mapped, no_value>::value;
+
+		//A map stores each key and value next to each other, so finding a key brings its value into the cache
+		using slot_type = typename std::conditional<IsMap, std::pair<Key, Mapped>, Key>::type;
+		using slot_allocator = std::allocator<slot_type>;
+		using slot_traits = std::allocator_traits<slot_allocator>;
+
+		std::int8_t* controls = nullptr; //The control byte of every slot
+		slot_type* slots = nullptr; //The storage for the slots. Only the slots with a control byte of 0 or more have been constructed
+		int capacity = 0; //How many slots there are. This is 0 or a power of two that is at least GroupSize
+		int tableSize = 0; //How many keys are in the table
+		int growthLeft = 0; //How many more empty slots can be used before the table has to be rebuilt
+		Hasher hasher;
+		KeyEqual equal;
+		slot_allocator allocator;
+
+		static const Key& keyOf(const slot_type& slot)
+		{
+			if constexpr (IsMap)
+			{
+				return slot.first;
+			}
+			else
+			{
+				return slot;
+			}
+		}
+
+		//Whether the hasher is known not to throw
+		static constexpr bool NothrowHasher = noexcept(std::declval<const Hasher&>()(std::declval<const Key&>()));
+
+		std::uint64_t hashOf(const Key& key) const
+		{
+			return hash_impl::mix(static_cast<std::uint64_t>(hasher(key)));
+		}
+
+		//The control byte for a key with a certain hash
+		static std::int8_t tagOf(std::uint64_t hash)
+		{
+			return static_cast<std::int8_t>(hash & 0x7F);
+		}
+
+		//How many keys a table with "slotCount" slots can hold before it has to grow
+		static int maxLoad(int slotCount)
+		{
+			return slotCount - slotCount / 8;
+		}
+
+		//The smallest capacity that can hold "count" keys
+		static int capacityFor(int count)
+		{
+			int result = GroupSize;
+			while (maxLoad(result) < count)
+			{
+				result *= 2;
+			}
+			return result;
+		}
+
+		//Finds the slot of a key with a certain hash. Returns -1 if the key isn't in the table.
+		//The groups are probed in a triangular sequence (1, 2, 3... groups apart), which visits every group once since the number of groups is a power of two
+		int findIndex(const Key& key, std::uint64_t hash) const
+		{
+			if (tableSize == 0)
+			{
+				return -1;
+			}
+			std::int8_t tag = tagOf(hash);
+			std::size_t groupMask = static_cast<std::size_t>(capacity / GroupSize) - 1;
+			std::size_t group = static_cast<std::size_t>(hash >> 7) & groupMask;
+			for (std::size_t step = 1; ; step++)
+			{
+				const std::int8_t* groupControls = controls + group * GroupSize;
+				for (std::uint32_t mask = match(groupControls, tag); mask != 0; mask &= mask - 1)
+				{
+					int index = static_cast<int>(group * GroupSize) + lowest_bit(mask);
+					if (equal(keyOf(slots[index]), key))
+					{
+						return index;
+					}
+				}
+				//There is always an empty slot somewhere, since the table never gets completely full
+				if (match(groupControls, Empty) != 0)
+				{
+					return -1;
+				}
+				group = (group + step) & groupMask;
+			}
+		}
+
+		//Finds the first empty or deleted slot on the probe sequence of a hash, in a table with "tableControls" as its control bytes and "tableCapacity" slots
+		static int findFreeIndex(const std::int8_t* tableControls, int tableCapacity, std::uint64_t hash)
+		{
+			std::size_t groupMask = static_cast<std::size_t>(tableCapacity / GroupSize) - 1;
+			std::size_t group = static_cast<std::size_t>(hash >> 7) & groupMask;
+			for (std::size_t step = 1; ; step++)
+			{
+				std::uint32_t mask = match_free(tableControls + group * GroupSize);
+				if (mask != 0)
+				{
+					return static_cast<int>(group * GroupSize) + lowest_bit(mask);
+				}
+				group = (group + step) & groupMask;
+			}
+		}
+
+		int findFreeIndex(std::uint64_t hash) const
+		{
+			return findFreeIndex(controls, capacity, hash);
+		}
+
+		//Moves every key into a new table of "newCapacity" slots, which also clears out the deleted slots. A capacity of 0 frees the table, and can only be used when it's empty.
+		//The new table is built on the side and only replaces the old one once every key is in it. If anything throws, then the new table is thrown away and the old one is left as it was.
+		//Keys are moved if their move constructor can't throw, and copied otherwise. A hasher that can throw is run on every key before any key is moved, so it can't throw part way through
+		void resize(int newCapacity)
+		{
+			std::int8_t* newControls = nullptr;
+			slot_type* newSlots = nullptr;
+			if (newCapacity > 0)
+			{
+				newControls = new std::int8_t[newCapacity];
+				try
+				{
+					newSlots = slot_traits::allocate(allocator, static_cast<std::size_t>(newCapacity));
+				}
+				catch (...)
+				{
+					delete[] newControls;
+					throw;
+				}
+				std::memset(newControls, static_cast<unsigned char>(Empty), static_cast<std::size_t>(newCapacity));
+			}
+
+			try
+			{
+				std::vector<std::uint64_t> hashes;
+				if constexpr (!NothrowHasher)
+				{
+					hashes.reserve(static_cast<std::size_t>(tableSize));
+					for (int i = 0; i < capacity; i++)
+					{
+						if (controls[i] >= 0)
+						{
+							hashes.push_back(hashOf(keyOf(slots[i])));
+						}
+					}
+				}
+
+				//The new table has no deleted slots and no equal keys, so each key goes into the first free slot it probes
+				std::size_t next = 0;
+				for (int i = 0; i < capacity; i++)
+				{
+					if (controls[i] >= 0)
+					{
+						std::uint64_t hash = NothrowHasher ? hashOf(keyOf(slots[i])) : hashes[next++];
+						int index = findFreeIndex(newControls, newCapacity, hash);
+						slot_traits::construct(allocator, newSlots + index, std::move_if_noexcept(slots[i]));
+						newControls[index] = tagOf(hash);
+					}
+				}
+			}
+			catch (...)
+			{
+				//Destroy the keys that made it into the new table. The old table still has every key
+				for (int i = 0; i < newCapacity; i++)
+				{
+					if (newControls[i] >= 0)
+					{
+						slot_traits::destroy(allocator, newSlots + i);
+					}
+				}
+				freeTable(newControls, newSlots, newCapacity);
+				throw;
+			}
+
+			//Every key is in the new table, so the old one can go
+			destroySlots();
+			freeTable(controls, slots, capacity);
+			controls = newControls;
+			slots = newSlots;
+			capacity = newCapacity;
+			growthLeft = maxLoad(newCapacity) - tableSize;
+		}
+
+		void freeTable(std::int8_t* oldControls, slot_type* oldSlots, int oldCapacity)
+		{
+			if (oldCapacity > 0)
+			{
+				slot_traits::deallocate(allocator, oldSlots, static_cast<std::size_t>(oldCapacity));
+				delete[] oldControls;
+			}
+		}
+
+		//Destroys every key in the table, without changing the control bytes
+		void destroySlots()
+		{
+			for (int i = 0; i < capacity; i++)
+			{
+				if (controls[i] >= 0)
+				{
+					slot_traits::destroy(allocator, slots + i);
+				}
+			}
+		}
+
+		//Inserts a key with a slot built from "args", if the key isn't in the table yet. Returns the index of the key's slot, and true if it was inserted.
+		//Nothing is built if the key is already in the table
+		template<typename... Args>
+		std::pair<int, bool> emplaceKey(const Key& key, Args&&... args)
+		{
+			std::uint64_t hash = hashOf(key);
+			int found = findIndex(key, hash);
+			if (found >= 0)
+			{
+				return { found, false };
+			}
+			//Make room for the key. If at least half of the used slots are deleted, then the table is rebuilt at the same size to clear them out instead of growing
+			if (growthLeft == 0)
+			{
+				resize(capacity > 0 && tableSize <= maxLoad(capacity) / 2 ? capacity : (capacity == 0 ? GroupSize : capacity * 2));
+			}
+			int index = findFreeIndex(hash);
+			slot_traits::construct(allocator, slots + index, std::forward<Args>(args)...);
+			if (controls[index] == Empty)
+			{
+				growthLeft--;
+			}
+			controls[index] = tagOf(hash);
+			tableSize++;
+			return { index, true };
+		}
+
+		//Removes the key in a slot
+		void removeAt(int index)
+		{
+			slot_traits::destroy(allocator, slots + index);
+			tableSize--;
+			//If the group of the slot has an empty slot, then no search has ever probed past it, so the slot can be emptied instead of being marked as deleted
+			if (match(controls + (index / GroupSize) * GroupSize, Empty) != 0)
+			{
+				controls[index] = Empty;
+				growthLeft++;
+			}
+			else
+			{
+				controls[index] = Deleted;
+			}
+		}
+
+		/*An iterator for going over the keys of the table in slot order, which has nothing to do with the order they were inserted in. The is_const flag is to determine
+		  if the values of a map can be changed through the iterator. The keys can never be changed, since that would move them to a different slot.
+		  Inserting a key can rebuild the table, which breaks every iterator. Removing a key only breaks iterators to that key*/
+		template<bool is_const>
+		class iterator_base
+		{
+			friend class hash_table<Key, Mapped, Hasher, KeyEqual>;
+
+			const hash_table<Key, Mapped, Hasher, KeyEqual>* table;
+			//The index of the slot. This is the capacity of the table for the end of the table
+			int index;
+
+			iterator_base(const hash_table<Key, Mapped, Hasher, KeyEqual>* table, int index) : table(table), index(index) {}
+
+			//Moves forward to the next full slot, or to the end. The rest of a group is checked at once, so runs of free slots are skipped quickly
+			void skipFreeSlots()
+			{
+				while (index < table->capacity && table->controls[index] < 0)
+				{
+					int groupStart = index - index % GroupSize;
+					std::uint32_t full = ~match_free(table->controls + groupStart) & (0xFFFFU << (index % GroupSize)) & 0xFFFFU;
+					index = full != 0 ? groupStart + lowest_bit(full) : groupStart + GroupSize;
+				}
+			}
+
+		public:
+			//An implicit copy constructor for implicity converting non-const iterators to const versions
+			iterator_base(const iterator_base<false>& other) : table(other.table), index(other.index) {}
+
+			//These type definitions are required for iterators
+			using value_type = typename std::conditional<IsMap, std::pair<const Key, Mapped>, Key>::type;
+			using reference = typename std::conditional<IsMap, std::pair<const Key&, make_const_if_true<Mapped, is_const>&>, const Key&>::type;
+			using pointer = const value_type*;
+			using iterator_category = std::forward_iterator_tag;
+			using difference_type = int;
+
+			//Pre-increments the iterator to the next key
+			iterator_base<is_const>& operator++()
+			{
+				if (index >= table->capacity)
+				{
+					throw struct_exception("Cannot iterate past the end of the table");
+				}
+				index++;
+				skipFreeSlots();
+				return *this;
+			}
+
+			//Post-increments the iterator to the next key
+			iterator_base<is_const> operator++(int)
+			{
+				iterator_base<is_const> previous = *this;
+				++(*this);
+				return previous;
+			}
+
+			//Gets the key the iterator points to
+			const Key& key() const
+			{
+				return keyOf(table->slots[index]);
+			}
+
+			//Gets the value the iterator points to. Only available for maps
+			make_const_if_true<Mapped, is_const>& value() const
+			{
+				static_assert(IsMap, "Only a flat_hash_map stores values");
+				return table->slots[index].second;
+			}
+
+			//Gets the key the iterator points to, or a pair of the key and value for a map
+			reference operator*() const
+			{
+				if constexpr (IsMap)
+				{
+					return reference(table->slots[index].first, table->slots[index].second);
+				}
+				else
+				{
+					return table->slots[index];
+				}
+			}
+
+			//Used for dereferencing the key. Only available for sets, since the pair stored by a map has a key that isn't const
+			const Key* operator->() const
+			{
+				static_assert(!IsMap, "Use key() and value() to access the entries of a flat_hash_map");
+				return &table->slots[index];
+			}
+
+			//Tests for equality
+			bool operator==(const iterator_base<is_const>& rhs) const
+			{
+				return table == rhs.table && index == rhs.index;
+			}
+
+			//Tests for inequality
+			bool operator!=(const iterator_base<is_const>& rhs) const
+			{
+				return !(*this == rhs);
+			}
+		};
+
+	public:
+		//A non_const version of the iterator. For a set, this can't change anything either
+		using iterator = iterator_base<false>;
+		//A const version of the iterator
+		using const_iterator = iterator_base<true>;
+
+		//Constructs an empty table. No memory is allocated until the first key is inserted
+		hash_table(Hasher hasher = Hasher(), KeyEqual equal = KeyEqual()) : hasher(std::move(hasher)), equal(std::move(equal)) {}
+
+		//A copy constructor. The control bytes are copied as they are, and each key is copied into the same slot, so no keys are hashed
+		hash_table(const hash_table& other) : hasher(other.hasher), equal(other.equal)
+		{
+			copyFrom(other);
+		}
+
+		//A move constructor for taking the slots of another table
+		hash_table(hash_table&& other) noexcept :
+			controls(other.controls),
+			slots(other.slots),
+			capacity(other.capacity),
+			tableSize(other.tableSize),
+			growthLeft(other.growthLeft),
+			hasher(std::move(other.hasher)),
+			equal(std::move(other.equal))
+		{
+			other.controls = nullptr;
+			other.slots = nullptr;
+			other.capacity = 0;
+			other.tableSize = 0;
+			other.growthLeft = 0;
+		}
+
+		hash_table& operator=(const hash_table& other)
+		{
+			if (&other != this)
+			{
+				release();
+				hasher = other.hasher;
+				equal = other.equal;
+				copyFrom(other);
+			}
+			return *this;
+		}
+
+		hash_table& operator=(hash_table&& other) noexcept
+		{
+			if (&other != this)
+			{
+				release();
+				std::swap(controls, other.controls);
+				std::swap(slots, other.slots);
+				std::swap(capacity, other.capacity);
+				std::swap(tableSize, other.tableSize);
+				std::swap(growthLeft, other.growthLeft);
+				hasher = std::move(other.hasher);
+				equal = std::move(other.equal);
+			}
+			return *this;
+		}
+
+		~hash_table()
+		{
+			release();
+		}
+
+		//Removes every key from the table. The slots are kept, so inserting the keys again doesn't allocate anything
+		void clear()
+		{
+			if (capacity > 0)
+			{
+				destroySlots();
+				std::memset(controls, static_cast<unsigned char>(Empty), static_cast<std::size_t>(capacity));
+			}
+			tableSize = 0;
+			growthLeft = maxLoad(capacity);
+		}
+
+		//Makes sure the table can hold "count" keys without being rebuilt
+		void reserve(int count)
+		{
+			if (count > maxLoad(capacity))
+			{
+				resize(capacityFor(count));
+			}
+		}
+
+		//Rebuilds the table with at least "slotCount" slots and enough room for every key. This also clears out the deleted slots.
+		//rehash(0) shrinks the table to the smallest size that fits the keys, and frees it if it's empty
+		void rehash(int slotCount)
+		{
+			int newCapacity = tableSize > 0 || slotCount > 0 ? capacityFor(tableSize) : 0;
+			while (newCapacity < slotCount)
+			{
+				newCapacity *= 2;
+			}
+			resize(newCapacity);
+		}
+
+		//Removes a key from the table. Returns true if the key was removed
+		bool remove(const Key& key)
+		{
+			int index = findIndex(key, hashOf(key));
+			if (index < 0)
+			{
+				return false;
+			}
+			removeAt(index);
+			return true;
+		}
+
+		//Removes the key an iterator points to. Returns true if the key was removed
+		bool remove(const_iterator position)
+		{
+			if (position.index >= capacity || controls[position.index] < 0)
+			{
+				return false;
+			}
+			removeAt(position.index);
+			return true;
+		}
+
+		//Attempts to find a key in the table and returns an iterator to it. If the key could not be found, then the end() iterator is returned
+		iterator find(const Key& key)
+		{
+			int index = findIndex(key, hashOf(key));
+			return iterator(this, index < 0 ? capacity : index);
+		}
+
+		//Attempts to find a key in the table and returns an iterator to it. If the key could not be found, then the end() iterator is returned
+		const_iterator find(const Key& key) const
+		{
+			int index = findIndex(key, hashOf(key));
+			return const_iterator(this, index < 0 ? capacity : index);
+		}
+
+		//Returns true if the key is in the table
+		bool contains(const Key& key) const
+		{
+			return findIndex(key, hashOf(key)) >= 0;
+		}
+
+		//Get the beginning iterator, which points to the key in the first full slot
+		iterator begin()
+		{
+			iterator result(this, 0);
+			result.skipFreeSlots();
+			return result;
+		}
+
+		//Get the beginning iterator, which points to the key in the first full slot
+		const_iterator begin() const
+		{
+			const_iterator result(this, 0);
+			result.skipFreeSlots();
+			return result;
+		}
+
+		//Get the beginning iterator, which points to the key in the first full slot
+		const_iterator cbegin() const
+		{
+			return begin();
+		}
+
+		//Gets the ending iterator
+		iterator end()
+		{
+			return iterator(this, capacity);
+		}
+
+		//Gets the ending iterator
+		const_iterator end() const
+		{
+			return const_iterator(this, capacity);
+		}
+
+		//Gets the ending iterator
+		const_iterator cend() const
+		{
+			return end();
+		}
+
+		//Gets how many keys are in the table
+		int getSize() const
+		{
+			return tableSize;
+		}
+
+		//Gets how many slots the table has
+		int getCapacity() const
+		{
+			return capacity;
+		}
+
+	protected:
+		//Creates an iterator to a slot found by emplaceKey()
+		iterator toIterator(int index)
+		{
+			return iterator(this, index);
+		}
+
+		//Gets the slot of an iterator
+		slot_type& slotOf(int index)
+		{
+			return slots[index];
+		}
+
+	private:
+		//Destroys every key and frees the table
+		void release()
+		{
+			if (capacity > 0)
+			{
+				destroySlots();
+				freeTable(controls, slots, capacity);
+			}
+			controls = nullptr;
+			slots = nullptr;
+			capacity = 0;
+			tableSize = 0;
+			growthLeft = 0;
+		}
+
+		//Copies the slots of another table into this one, which must be empty and have no memory. If a copy throws, the keys that were copied are destroyed again
+		void copyFrom(const hash_table& other)
+		{
+			if (other.capacity == 0)
+			{
+				return;
+			}
+			resize(other.capacity);
+			int i = 0;
+			try
+			{
+				for (; i < other.capacity; i++)
+				{
+					if (other.controls[i] >= 0)
+					{
+						slot_traits::construct(allocator, slots + i, other.slots[i]);
+					}
+				}
+			}
+			catch (...)
+			{
+				//Only the slots before "i" were constructed, so the rest are marked empty before they are destroyed
+				std::memset(controls + i, static_cast<unsigned char>(Empty), static_cast<std::size_t>(capacity - i));
+				std::memcpy(controls, other.controls, static_cast<std::size_t>(i));
+				release();
+				throw;
+			}
+			std::memcpy(controls, other.controls, static_cast<std::size_t>(capacity));
+			tableSize = other.tableSize;
+			growthLeft = other.growthLeft;
+		}
+	};
+}
+
+//An unordered set stored in an open addressing hash table (a Swiss table). The keys are stored directly in one array, with no nodes, so a search that finds its key
+//usually reads one cache line of control bytes and one slot. Searches compare 16 control bytes at a time with SSE2 when it's available.
+//The keys must be movable. Duplicate keys are not allowed
+template<typename T, typename Hasher = std::hash<T>, typename KeyEqual = std::equal_to<T>>
+class flat_hash_set : public flat_hash_impl::hash_table<T, flat_hash_impl::no_value, Hasher, KeyEqual>
+{
+	using base = flat_hash_impl::hash_table<T, flat_hash_impl::no_value, Hasher, KeyEqual>;
+
+public:
+	using base::base;
+	using typename base::iterator;
+	using typename base::const_iterator;
+
+	//Constructs an empty set. No memory is allocated until the first key is inserted
+	flat_hash_set() : base() {}
+
+	//Creates a set from a list of keys. Duplicate keys are only inserted once
+	flat_hash_set(std::initializer_list<T> list) : base()
+	{
+		this->reserve(static_cast<int>(list.size()));
+		for (const T& key : list)
+		{
+			insert(key);
+		}
+	}
+
+	//Inserts a new key into the set. Returns end() if the key is already in the set
+	//The template parameter is to allow the function to take both rvalues and lvalues
+	template<typename DataType>
+	iterator insert(DataType&& data)
+	{
+		T key(std::forward<DataType>(data));
+		std::pair<int, bool> result = this->emplaceKey(key, std::move(key));
+		return result.second ? this->toIterator(result.first) : this->end();
+	}
+};
+
+//An unordered map stored in an open addressing hash table, with the same layout as flat_hash_set. Each key is stored right next to its value,
+//so finding a key also brings its value into the cache. Iterators give a pair of references to the key and value, or use key() and value()
+template<typename Key, typename Value, typename Hasher = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+class flat_hash_map : public flat_hash_impl::hash_table<Key, Value, Hasher, KeyEqual>
+{
+	using base = flat_hash_impl::hash_table<Key, Value, Hasher, KeyEqual>;
+
+public:
+	using base::base;
+	using typename base::iterator;
+	using typename base::const_iterator;
+
+	//Inserts a key and value into the map. Returns end() if the key is already in the map, in which case its value is left unchanged
+	template<typename KeyType, typename ValueType>
+	iterator insert(KeyType&& key, ValueType&& value)
+	{
+		Key newKey(std::forward<KeyType>(key));
+		std::pair<int, bool> result = this->emplaceKey(newKey, std::piecewise_construct, std::forward_as_tuple(std::move(newKey)), std::forward_as_tuple(std::forward<ValueType>(value)));
+		return result.second ? this->toIterator(result.first) : this->end();
+	}
+
+	//Gets the value for a key. If the key isn't in the map, then it is added with a default constructed value. The map is only searched once
+	Value& operator[](const Key& key)
+	{
+		return this->slotOf(this->emplaceKey(key, std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple()).first).second;
+	}
+
+	//Gets the value for a key. Throws a struct_exception if the key isn't in the map
+	Value& at(const Key& key)
+	{
+		iterator found = this->find(key);
+		if (found == this->end())
+		{
+			throw struct_exception("The key is not in the map");
+		}
+		return found.value();
+	}
+
+	//Gets the value for a key. Throws a struct_exception if the key isn't in the map
+	const Value& at(const Key& key) const
+	{
+		const_iterator found = this->find(key);
+		if (found == this->end())
+		{
+			throw struct_exception("The key is not in the map");
+		}
+		return found.value();
+	}
+};
+
+//Used for printing a set to a stream, in slot order
+template<typename T, typename Hasher, typename KeyEqual>
+std::ostream& operator<<(std::ostream& stream, const flat_hash_set<T, Hasher, KeyEqual>& set)
+{
+	stream << "[";
+	for (auto i = set.begin(); i != set.end(); ++i)
+	{
+		if (i != set.begin())
+		{
+			stream << ", ";
+		}
+		stream << *i;
+	}
+	return stream << "]";
+}
@@ -0,0 +1,373 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <ostream>
+#include <type_traits>
+#include <vector>
+#include <common.h>
+#include <struct_exception.h>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
+//This namespace contains implementation details
+namespace frozen_impl
+{
+	//Asks the CPU to start loading the memory at an address into the cache. The address doesn't need to be valid, since a prefetch never faults
+	inline void prefetch(std::uintptr_t address)
+	{
+#if defined(__GNUC__)
+		__builtin_prefetch(reinterpret_cast<const void*>(address));
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+		_mm_prefetch(reinterpret_cast<const char*>(address), _MM_HINT_T0);
+#endif
+	}
+
+	//Goes up from a node while it is a right child, and then up once more. In the array layout, this removes the trailing 1 bits of the index and one more bit.
+	//This is how a search finds its result, and how an iterator finds the next value when a node has no right subtree
+	inline std::size_t climb(std::size_t index)
+	{
+#if defined(__GNUC__)
+		return index >> (__builtin_ctzll(~static_cast<unsigned long long>(index)) + 1);
+#else
+		while (index & 1)
+		{
+			index >>= 1;
+		}
+		return index >> 1;
+#endif
+	}
+
+	//Allocates memory aligned to a cache line, so the children of a node that are a few levels down always start at the beginning of a cache line
+	template<typename T>
+	struct cache_aligned_allocator
+	{
+		using value_type = T;
+
+		cache_aligned_allocator() = default;
+
+		template<typename U>
+		cache_aligned_allocator(const cache_aligned_allocator<U>&) noexcept {}
+
+		T* allocate(std::size_t count)
+		{
+			return static_cast<T*>(::operator new(sizeof(T) * count, std::align_val_t(CacheLineSize)));
+		}
+
+		void deallocate(T* pointer, std::size_t) noexcept
+		{
+			::operator delete(pointer, std::align_val_t(CacheLineSize));
+		}
+
+		template<typename U>
+		bool operator==(const cache_aligned_allocator<U>&) const noexcept
+		{
+			return true;
+		}
+
+		template<typename U>
+		bool operator!=(const cache_aligned_allocator<U>&) const noexcept
+		{
+			return false;
+		}
+	};
+}
+
+//A read-only copy of a sorted set of values, stored in a single array in the order a breadth-first walk of a perfectly balanced tree would visit them (the Eytzinger layout).
+//The value at index i has its children at 2i and 2i + 1, so a search doesn't follow any pointers, and the top levels of the tree share a few cache lines.
+//Searches don't branch on the comparison, and they prefetch the nodes a few levels below, so the search can keep several cache misses going at once.
+//Use binary_search_tree::freeze() to create one from a tree in O(n)
+template<typename T, typename Comparer = std::function<bool(const T&, const T&)>>
+class frozen_search_tree
+{
+	//The values in the Eytzinger layout. Index 0 isn't part of the tree, so the root is at index 1
+	std::vector<T, frozen_impl::cache_aligned_allocator<T>> values;
+	//How many values are in the tree
+	std::size_t treeSize = 0;
+	Comparer comparer;
+	//Whether the comparer is the < operator. For numbers, the comparison is then done directly instead of calling the comparer
+	bool naturalOrder = false;
+
+	//How far apart the prefetched nodes are. The nodes at index i * PrefetchStride onwards are the descendants of node i that are log2(PrefetchStride) levels down,
+	//and they fill one cache line
+	static constexpr std::size_t PrefetchStride = [] {
+		std::size_t stride = 2;
+		while (stride * 2 * sizeof(T) <= CacheLineSize)
+		{
+			stride *= 2;
+		}
+		return stride;
+	}();
+
+	//Finds the index of the first value where "goRight(value)" is false, or 0 if there is none. "goRight" must be true for every value before some point, and false after it.
+	//Each level adds the comparison result to the index instead of branching on it, so there are no mispredicted branches
+	template<typename GoRight>
+	std::size_t searchIndex(GoRight goRight) const
+	{
+		const T* data = values.data();
+		std::uintptr_t base = reinterpret_cast<std::uintptr_t>(data);
+		std::size_t index = 1;
+		while (index <= treeSize)
+		{
+			frozen_impl::prefetch(base + index * PrefetchStride * sizeof(T));
+			index = 2 * index + static_cast<std::size_t>(goRight(data[index]));
+		}
+		//The search went right at every level below the result, and then went left from it
+		return frozen_impl::climb(index);
+	}
+
+	//Finds the index of the first value that is not less than "data", or 0 if there is none
+	std::size_t lowerBoundIndex(const T& data) const
+	{
+		if constexpr (std::is_arithmetic<T>::value)
+		{
+			if (naturalOrder)
+			{
+				return searchIndex([&data](const T& value) { return value < data; });
+			}
+		}
+		return searchIndex([this, &data](const T& value) { return static_cast<bool>(comparer(value, data)); });
+	}
+
+	//Finds the index of the first value that is greater than "data", or 0 if there is none
+	std::size_t upperBoundIndex(const T& data) const
+	{
+		if constexpr (std::is_arithmetic<T>::value)
+		{
+			if (naturalOrder)
+			{
+				return searchIndex([&data](const T& value) { return !(data < value); });
+			}
+		}
+		return searchIndex([this, &data](const T& value) { return !comparer(data, value); });
+	}
+
+	//Gets the index of the smallest value, or 0 if the tree is empty
+	std::size_t firstIndex() const
+	{
+		if (treeSize == 0)
+		{
+			return 0;
+		}
+		std::size_t index = 1;
+		while (index * 2 <= treeSize)
+		{
+			index *= 2;
+		}
+		return index;
+	}
+
+public:
+	//A read-only iterator that goes over the values in sorted order
+	class const_iterator
+	{
+		friend class frozen_search_tree<T, Comparer>;
+
+		const frozen_search_tree<T, Comparer>* tree;
+		//The index of the value. 0 is the end of the tree
+		std::size_t index;
+
+		const_iterator(const frozen_search_tree<T, Comparer>* tree, std::size_t index) : tree(tree), index(index) {}
+
+	public:
+		//These type definitions are required for iterators
+		using value_type = T;
+		using reference = const T&;
+		using pointer = const T*;
+		using iterator_category = std::forward_iterator_tag;
+		using difference_type = std::ptrdiff_t;
+
+		//Moves to the next value in sorted order
+		const_iterator& operator++()
+		{
+			if (index == 0)
+			{
+				throw struct_exception("Cannot iterate past the end of the tree");
+			}
+			//If there is a right subtree, then the next value is the smallest value in it
+			if (index * 2 + 1 <= tree->treeSize)
+			{
+				index = index * 2 + 1;
+				while (index * 2 <= tree->treeSize)
+				{
+					index *= 2;
+				}
+			}
+			//Otherwise, it is the first parent that is reached from a left child
+			else
+			{
+				index = frozen_impl::climb(index);
+			}
+			return *this;
+		}
+
+		const_iterator operator++(int)
+		{
+			const_iterator previous = *this;
+			++(*this);
+			return previous;
+		}
+
+		const T& operator*() const
+		{
+			return tree->values[index];
+		}
+
+		const T* operator->() const
+		{
+			return &tree->values[index];
+		}
+
+		bool operator==(const const_iterator& rhs) const
+		{
+			return index == rhs.index && tree == rhs.tree;
+		}
+
+		bool operator!=(const const_iterator& rhs) const
+		{
+			return !(*this == rhs);
+		}
+	};
+
+	using iterator = const_iterator;
+
+	//Creates an empty tree
+	frozen_search_tree() : comparer(sorting_impl::DefaultComparer<T>)
+	{
+		naturalOrder = sorting_impl::is_natural_order<T>(comparer);
+	}
+
+	//Creates a tree from a range of values that is already sorted by the comparer and has no duplicates. This takes O(n) time
+	template<typename Iterator>
+	frozen_search_tree(Iterator begin, Iterator end, Comparer comp = sorting_impl::DefaultComparer<T>) : comparer(std::move(comp))
+	{
+		naturalOrder = sorting_impl::is_natural_order<T>(comparer);
+
+		//The values are needed in a different order than they are read, so they are stored first unless the range already allows random access
+		if constexpr (std::is_base_of<std::random_access_iterator_tag, typename std::iterator_traits<Iterator>::iterator_category>::value)
+		{
+			assign(begin, static_cast<std::size_t>(end - begin));
+		}
+		else
+		{
+			std::vector<T> sorted(begin, end);
+			assign(sorted.begin(), sorted.size());
+		}
+	}
+
+	//Replaces the values with "count" values from a sorted random-access range that has no duplicates. This takes O(n) time
+	template<typename RandomIterator>
+	void assign(RandomIterator sorted, std::size_t count)
+	{
+		//Walk the layout in sorted order to find which sorted value goes at each index
+		std::vector<std::size_t> sortedIndex(count + 1);
+		std::size_t index = 0;
+		if (count > 0)
+		{
+			index = 1;
+			while (index * 2 <= count)
+			{
+				index *= 2;
+			}
+		}
+		for (std::size_t i = 0; i < count; i++)
+		{
+			sortedIndex[index] = i;
+			if (index * 2 + 1 <= count)
+			{
+				index = index * 2 + 1;
+				while (index * 2 <= count)
+				{
+					index *= 2;
+				}
+			}
+			else
+			{
+				index = frozen_impl::climb(index);
+			}
+		}
+
+		std::vector<T, frozen_impl::cache_aligned_allocator<T>> newValues;
+		newValues.reserve(count + 1);
+		if (count > 0)
+		{
+			//Index 0 is never searched, but it is filled with a value so T doesn't need a default constructor
+			newValues.push_back(sorted[0]);
+		}
+		for (std::size_t i = 1; i <= count; i++)
+		{
+			newValues.push_back(sorted[sortedIndex[i]]);
+		}
+
+		values = std::move(newValues);
+		treeSize = count;
+	}
+
+	//Returns an iterator to the first value that is not less than "data". Returns end() if every value is less than "data"
+	const_iterator lower_bound(const T& data) const
+	{
+		return const_iterator(this, lowerBoundIndex(data));
+	}
+
+	//Returns an iterator to the first value that is greater than "data". Returns end() if no value is greater than "data"
+	const_iterator upper_bound(const T& data) const
+	{
+		return const_iterator(this, upperBoundIndex(data));
+	}
+
+	//Attempts to find data in the tree and returns an iterator to that data. If the data could not be found, then the end() iterator is returned
+	const_iterator find(const T& data) const
+	{
+		std::size_t index = lowerBoundIndex(data);
+		if (index != 0 && comparer(data, values[index]))
+		{
+			index = 0;
+		}
+		return const_iterator(this, index);
+	}
+
+	//Returns true if the data is in the tree
+	bool contains(const T& data) const
+	{
+		return find(data) != end();
+	}
+
+	//Gets the iterator to the smallest value
+	const_iterator begin() const
+	{
+		return const_iterator(this, firstIndex());
+	}
+
+	//Gets the ending iterator
+	const_iterator end() const
+	{
+		return const_iterator(this, 0);
+	}
+
+	//Gets how many values are in the tree
+	int getSize() const
+	{
+		return static_cast<int>(treeSize);
+	}
+};
+
+//Used for printing the tree to a stream
+template<typename T, typename Comparer>
+std::ostream& operator<<(std::ostream& stream, const frozen_search_tree<T, Comparer>& tree)
+{
+	stream << "[";
+	for (auto i = tree.begin(); i != tree.end(); ++i)
+	{
+		if (i != tree.begin())
+		{
+			stream << ", ";
+		}
+		stream << *i;
+	}
+	return stream << "]";
+}
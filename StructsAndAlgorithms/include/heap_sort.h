@@ -3,29 +3,46 @@
 #include <type_traits>
 #include <common.h>
 #include <binary_search_tree.h>
+#include <cstddef>
 #include <functional>
+#include <utility>
 #include <vector>
 
-//Runs a heap sort algorithm on the iterator range with the specified comparer
+//Runs a heap sort algorithm on the iterator range with the specified comparer.
+//Each value is stored with its position in the range, and equal values are ordered by position. So every value is kept, even if it only compares equal to another one, and the sort is stable
 template<typename iteratorType, typename Comparer>
 void heap_sort(iteratorType&& begin, iteratorType&& end, Comparer&& comparer)
 {
 	using valueType = typename std::remove_reference<decltype(*begin)>::type;
-
-	binary_search_tree<valueType> tree {};
+	using entryType = std::pair<valueType, std::size_t>;
+	using treeType = binary_search_tree<entryType, std::function<bool(const entryType&, const entryType&)>>;
+
+	std::function<bool(const valueType&, const valueType&)> valueComparer(std::forward<Comparer>(comparer));
+	treeType tree{ std::function<bool(const entryType&, const entryType&)>([&valueComparer](const entryType& a, const entryType& b) {
+		if (valueComparer(a.first, b.first))
+		{
+			return true;
+		}
+		if (valueComparer(b.first, a.first))
+		{
+			return false;
+		}
+		return a.second < b.second;
+	}) };
 
 	//Add all the values into the tree
 	//When all the values are inserted, we can use the tree's iterator to iterate from lowest to highest value
+	std::size_t position = 0;
 	for (auto i = begin; i != end; i++)
 	{
-		tree.insert(std::move(*i));
+		tree.insert(entryType(std::move(*i), position++));
 	}
 
 	auto k = begin;
 
 	for (auto i = tree.begin(); i != tree.end(); i++)
 	{
-		*k = std::move(*i);
+		*k = std::move(i->first);
 		++k;
 	}
 }
@@ -34,12 +51,12 @@ void heap_sort(iteratorType&& begin, iteratorType&& end, Comparer&& comparer)
 template<typename iteratorType>
 void heap_sort(iteratorType&& begin, iteratorType&& end)
 {
-	heap_sort(std::forward<iteratorType>(begin), std::forward<iteratorType>(end), sorting_impl::DefaultComparer<decltype(*begin)>);
+	heap_sort(std::forward<iteratorType>(begin), std::forward<iteratorType>(end), sorting_impl::DefaultComparer<typename std::decay<decltype(*begin)>::type>);
 }
 
 //Runs a heap sort algorithm on the list
 template<typename iteratable>
 void heap_sort(iteratable& list)
 {
-	heap_sort(std::begin(list), std::end(list), sorting_impl::DefaultComparer<decltype(*std::begin(list))>);
+	heap_sort(std::begin(list), std::end(list), sorting_impl::DefaultComparer<typename std::decay<decltype(*std::begin(list))>::type>);
 }
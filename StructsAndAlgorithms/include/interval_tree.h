@@ -0,0 +1,316 @@
+#pragma once
+#include <memory>
+#include <ostream>
+#include <utility>
+#include <vector>
+#include <common.h>
+#include <struct_exception.h>
+#include <binary_search_tree.h>
+
+//A closed interval from "low" to "high", which includes both endpoints
+template<typename T>
+struct interval
+{
+	using value_type = T;
+
+	T low;
+	T high;
+
+	//Returns true if the two intervals share at least one point
+	bool overlaps(const T& otherLow, const T& otherHigh) const
+	{
+		return !(high < otherLow) && !(otherHigh < low);
+	}
+
+	bool operator==(const interval<T>& rhs) const
+	{
+		return !(low < rhs.low) && !(rhs.low < low) && !(high < rhs.high) && !(rhs.high < high);
+	}
+
+	bool operator!=(const interval<T>& rhs) const
+	{
+		return !(*this == rhs);
+	}
+};
+
+//Used for printing an interval to a stream
+template<typename T>
+std::ostream& operator<<(std::ostream& stream, const interval<T>& value)
+{
+	return stream << "[" << value.low << ", " << value.high << "]";
+}
+
+//An augmentation for a binary_search_tree of intervals, which stores the highest endpoint of every interval in the subtree of a node.
+//This lets a search skip every subtree that ends before the interval it is looking for
+struct bst_max_endpoint
+{
+	template<typename T>
+	struct node_data
+	{
+		typename T::value_type maxEnd{}; //The highest "high" endpoint in the subtree, including the node itself
+	};
+
+	template<typename Node>
+	static void update(Node* node)
+	{
+		node->maxEnd = node->data.high;
+		if (node->leftChild != nullptr && node->maxEnd < node->leftChild->maxEnd)
+		{
+			node->maxEnd = node->leftChild->maxEnd;
+		}
+		if (node->rightChild != nullptr && node->maxEnd < node->rightChild->maxEnd)
+		{
+			node->maxEnd = node->rightChild->maxEnd;
+		}
+	}
+};
+
+//This namespace contains implementation details
+namespace interval_impl
+{
+	//Orders intervals by their low endpoints, and then by their high endpoints
+	template<typename T>
+	struct interval_comparer
+	{
+		bool operator()(const interval<T>& lhs, const interval<T>& rhs) const
+		{
+			return lhs.low < rhs.low || (!(rhs.low < lhs.low) && lhs.high < rhs.high);
+		}
+	};
+}
+
+//A set of closed intervals, stored in an AVL binary_search_tree that is ordered by the low endpoints and augmented with the highest endpoint of every subtree.
+//The augmentation is kept up to date through every insert, remove and rotation of the tree. The tree is a private base, since an interval with its low endpoint
+//past its high endpoint would break the overlap searches. Only the functions that read or remove intervals are made public, and every way of adding intervals checks them.
+//An interval can only be in the tree once
+template<typename T, typename Allocator = std::allocator<interval<T>>>
+class interval_tree : binary_search_tree<interval<T>, interval_impl::interval_comparer<T>, Allocator, bst_max_endpoint>
+{
+	using base = binary_search_tree<interval<T>, interval_impl::interval_comparer<T>, Allocator, bst_max_endpoint>;
+
+	interval_tree(base&& tree) : base(std::move(tree)) {}
+
+	//Throws a struct_exception if the low endpoint of an interval is past the high endpoint
+	static void validate(const T& low, const T& high)
+	{
+		if (high < low)
+		{
+			throw struct_exception("The low endpoint of an interval can't be greater than its high endpoint");
+		}
+	}
+
+	//Calls "visit" on every interval in the subtree of "node" that overlaps [low, high], in sorted order
+	template<typename Iterator, typename Visit>
+	static void visitOverlapping(Iterator node, const Iterator& end, const T& low, const T& high, Visit& visit)
+	{
+		while (node != end)
+		{
+			//Every interval in the subtree ends before "low"
+			if (node.getAugmentation().maxEnd < low)
+			{
+				return;
+			}
+			visitOverlapping(node.getLeft(), end, low, high, visit);
+			//This interval, and every interval in the right subtree, starts after "high"
+			if (high < node->low)
+			{
+				return;
+			}
+			if (!(node->high < low))
+			{
+				visit(*node);
+			}
+			node = node.getRight();
+		}
+	}
+
+public:
+	using iterator = typename base::iterator;
+	using const_iterator = typename base::const_iterator;
+
+	//The functions of the tree that can't add an interval
+	using base::clear;
+	using base::contains;
+	using base::lower_bound;
+	using base::upper_bound;
+	using base::equal_range;
+	using base::floor;
+	using base::ceiling;
+	using base::range;
+	using base::begin;
+	using base::cbegin;
+	using base::end;
+	using base::cend;
+	using base::getRoot;
+	using base::erase_batch;
+	using base::freeze;
+	using base::getSize;
+	using base::traverse;
+
+	//Finds the interval [low, high]. Returns end() if it isn't in the tree
+	iterator find(const T& low, const T& high)
+	{
+		return base::find(interval<T>{ low, high });
+	}
+
+	const_iterator find(const T& low, const T& high) const
+	{
+		return base::find(interval<T>{ low, high });
+	}
+
+	iterator find(const interval<T>& value)
+	{
+		return base::find(value);
+	}
+
+	const_iterator find(const interval<T>& value) const
+	{
+		return base::find(value);
+	}
+
+	//Gets the interval with the lowest low endpoint
+	iterator minimum()
+	{
+		return base::minimum();
+	}
+
+	const_iterator minimum() const
+	{
+		return base::minimum();
+	}
+
+	//Gets the interval with the highest low endpoint
+	iterator maximum()
+	{
+		return base::maximum();
+	}
+
+	const_iterator maximum() const
+	{
+		return base::maximum();
+	}
+
+	//Default constructor for an interval tree
+	interval_tree() : base() {}
+
+	interval_tree(const Allocator& alloc) : base(interval_impl::interval_comparer<T>(), alloc) {}
+
+	interval_tree(const std::initializer_list<interval<T>> list) : interval_tree(from_unsorted(list.begin(), list.end())) {}
+
+	//Creates a perfectly balanced interval tree in O(n) from a range of intervals that is already sorted by low and then high endpoint, and has no duplicates.
+	//The highest endpoints of the subtrees are worked out as the tree is built. Throws a struct_exception if an interval has its low endpoint past its high endpoint
+	template<typename Iterator>
+	static interval_tree<T, Allocator> from_sorted(Iterator begin, Iterator end, const Allocator& alloc = Allocator())
+	{
+		interval_tree<T, Allocator> tree{ base::from_sorted(begin, end, interval_impl::interval_comparer<T>(), alloc) };
+		for (const interval<T>& value : tree)
+		{
+			validate(value.low, value.high);
+		}
+		return tree;
+	}
+
+	//Creates a perfectly balanced interval tree from a range of intervals in any order. The intervals are sorted and duplicates are removed, then the tree is built in O(n)
+	template<typename Iterator>
+	static interval_tree<T, Allocator> from_unsorted(Iterator begin, Iterator end, const Allocator& alloc = Allocator())
+	{
+		std::vector<interval<T>> values(begin, end);
+		for (const interval<T>& value : values)
+		{
+			validate(value.low, value.high);
+		}
+		return interval_tree<T, Allocator>{ base::from_unsorted(values.begin(), values.end(), interval_impl::interval_comparer<T>(), alloc) };
+	}
+
+	//Inserts the interval [low, high]. Returns end() if the interval is already in the tree.
+	//Throws a struct_exception if "low" is greater than "high"
+	iterator insert(const T& low, const T& high)
+	{
+		validate(low, high);
+		return base::insert(interval<T>{ low, high });
+	}
+
+	iterator insert(const interval<T>& value)
+	{
+		return insert(value.low, value.high);
+	}
+
+	//Removes the interval [low, high]. Returns true if it was in the tree
+	bool remove(const T& low, const T& high)
+	{
+		return base::remove(interval<T>{ low, high });
+	}
+
+	bool remove(const interval<T>& value)
+	{
+		return base::remove(value);
+	}
+
+	bool remove(iterator elementToDelete)
+	{
+		return base::remove(elementToDelete);
+	}
+
+	//Calls "visit" with every interval that overlaps [low, high], in sorted order. Subtrees that end before "low" or start after "high" are skipped,
+	//so this takes O(log n) when nothing overlaps and O(k log n) at worst for k overlapping intervals.
+	//When the overlapping intervals are close together in the tree, as they are when the intervals don't nest much, it is close to O(log n + k)
+	template<typename Visit>
+	void for_each_overlapping(const T& low, const T& high, Visit&& visit) const
+	{
+		visitOverlapping(this->getRoot(), this->end(), low, high, visit);
+	}
+
+	//Returns every interval that overlaps [low, high], in sorted order
+	std::vector<interval<T>> overlapping(const T& low, const T& high) const
+	{
+		std::vector<interval<T>> result;
+		for_each_overlapping(low, high, [&](const interval<T>& value) { result.push_back(value); });
+		return result;
+	}
+
+	//Returns every interval that contains "point", in sorted order
+	std::vector<interval<T>> stabbing(const T& point) const
+	{
+		return overlapping(point, point);
+	}
+
+	//Returns true if any interval overlaps [low, high]. Only one path from the root is searched, so this takes O(log n)
+	bool overlaps_any(const T& low, const T& high) const
+	{
+		const_iterator node = this->getRoot();
+		while (node != this->end())
+		{
+			if (node->overlaps(low, high))
+			{
+				return true;
+			}
+			//If anything in the left subtree reaches "low", then either it overlaps, or it starts after "high" and so does everything to the right
+			const_iterator left = node.getLeft();
+			if (left != this->end() && !(left.getAugmentation().maxEnd < low))
+			{
+				node = left;
+			}
+			else
+			{
+				node = node.getRight();
+			}
+		}
+		return false;
+	}
+};
+
+//Used for printing the tree to a stream
+template<typename T, typename Allocator>
+std::ostream& operator<<(std::ostream& stream, const interval_tree<T, Allocator>& tree)
+{
+	stream << "[";
+	for (auto i = tree.begin(); i != tree.end(); ++i)
+	{
+		if (i != tree.begin())
+		{
+			stream << ", ";
+		}
+		stream << *i;
+	}
+	return stream << "]";
+}
@@ -1,11 +1,15 @@
 #pragma once
+#include <algorithm>
+#include <new>
 #include <type_traits>
 #include <initializer_list>
 #include <ostream>
 #include <common.h>
 #include <struct_exception.h>
 #include <functional>
+#include <iterator>
 #include <utility>
+#include <vector>
 
 //Represents a list of items connected to each other via pointers
 template<typename T>
@@ -52,6 +56,17 @@ public:
 		node_type* _node;
 		//The list the node came from
 		list_type* _list;
+		//The generation of the list when this iterator was created. Used for detecting iterators that were invalidated by compact()
+		unsigned int _generation;
+
+		//Throws an exception if the list has been compacted since this iterator was created
+		void checkValid() const
+		{
+			if (!is_valid())
+			{
+				throw struct_exception("The iterator was invalidated by compacting the list");
+			}
+		}
 
 	public:
 		using value_type = make_const_if_true<T, is_const>;
@@ -60,11 +75,18 @@ public:
 		using iterator_category = std::bidirectional_iterator_tag;
 		using difference_type = int;
 
-		node_iterator_base(node_type* node, list_type* list) : _node(node), _list(list) {}
+		node_iterator_base(node_type* node, list_type* list) : _node(node), _list(list), _generation(list->generation) {}
+
+		//Returns false if the list has been compacted since this iterator was created. The end() iterator is always valid
+		bool is_valid() const
+		{
+			return _node == nullptr || _generation == _list->generation;
+		}
 
 		//Pre-increments the iterator to the next value
 		node_iterator_base<is_const>& operator++()
 		{
+			checkValid();
 			//If we are at the end of the list
 			if (_node == nullptr)
 			{
@@ -80,6 +102,7 @@ public:
 		//Post-increments the iterator to the next value
 		node_iterator_base<is_const> operator++(int)
 		{
+			checkValid();
 			//If we are at the end of the list
 			if (_node == nullptr)
 			{
@@ -97,6 +120,7 @@ public:
 		//Pre-decrements the iterator to the previous value
 		node_iterator_base<is_const>& operator--()
 		{
+			checkValid();
 			//If the node is nullptr, then the iterator refers to the element past the end of the list
 			if (_node == nullptr)
 			{
@@ -130,6 +154,7 @@ public:
 		//Post-decrements the iterator to the previous value
 		node_iterator_base<is_const> operator--(int)
 		{
+			checkValid();
 			//Store the current state of the iterator
 			node_iterator_base<is_const> previousState = *this;
 			//If the node is nullptr, then we are at the end of the list
@@ -165,12 +190,14 @@ public:
 		//Used to get the value of the iterator
 		reference operator*()
 		{
+			checkValid();
 			//Return a reference to the value
 			return _node->value;
 		}
 		//Used for dereferencing the value
 		pointer operator->()
 		{
+			checkValid();
 			//Return a pointer to the value
 			return &_node->value;
 		}
@@ -207,9 +234,339 @@ private:
 	//How many nodes are in the linked list
 	int size = 0;
 
+	//A block of nodes that were allocated together by compact()
+	struct node_slab {
+		//The first node in the block
+		node* nodes;
+		//How many nodes the block can hold
+		int capacity;
+		//How many nodes in the block are still in use. The block is freed once this reaches zero
+		int used;
+	};
+
+	//The blocks of nodes that are owned by this list, sorted by address
+	std::vector<node_slab> slabs;
+	//Increased every time the list is compacted, so iterators from before then can be detected
+	unsigned int generation = 0;
+
+	//How many nodes apart the checkpoints are. 0 means checkpoints are disabled
+	int checkpointInterval = 0;
+	//Every "checkpointInterval"-th node, starting from the first node. Used for splitting the list into chunks without walking over every node
+	std::vector<node*> checkpoints;
+	//Whether the checkpoints are up to date. Adding or removing nodes anywhere other than the back of the list makes them out of date.
+	//They are only rebuilt by non-const calls, so const calls never write to the list and can be made from several threads at once
+	bool checkpointsValid = true;
+
+	//Allocates memory for a block of nodes. The nodes are not constructed
+	static node* allocateSlab(int capacity)
+	{
+		return static_cast<node*>(::operator new(sizeof(node) * capacity, std::align_val_t(alignof(node))));
+	}
+
+	//Frees the memory of a block of nodes
+	static void freeSlab(node* nodes)
+	{
+		::operator delete(nodes, std::align_val_t(alignof(node)));
+	}
+
+	//Finds the block that a node was allocated in. Returns slabs.end() if the node was allocated on its own
+	typename std::vector<node_slab>::iterator findSlab(const node* n)
+	{
+		std::less<const node*> less{};
+		//Find the last block that starts at or before the node
+		auto slab = std::upper_bound(slabs.begin(), slabs.end(), n, [&less](const node* ptr, const node_slab& s) {
+			return less(ptr, s.nodes);
+		});
+		if (slab == slabs.begin())
+		{
+			return slabs.end();
+		}
+		--slab;
+		return less(n, slab->nodes + slab->capacity) ? slab : slabs.end();
+	}
+
+	//Destroys a node that has been unlinked from the list, and frees its memory
+	void releaseNode(node* n)
+	{
+		if (slabs.empty())
+		{
+			delete n;
+			return;
+		}
+
+		auto slab = findSlab(n);
+		if (slab == slabs.end())
+		{
+			delete n;
+			return;
+		}
+
+		//Nodes in a block are destroyed in place. The block itself is freed once all of its nodes are gone
+		n->~node();
+		if (--slab->used == 0)
+		{
+			freeSlab(slab->nodes);
+			slabs.erase(slab);
+		}
+	}
+
+	//Adds a block to the list of blocks, keeping them sorted by address
+	void addSlab(const node_slab& slab)
+	{
+		std::less<const node*> less{};
+		auto position = std::upper_bound(slabs.begin(), slabs.end(), slab, [&less](const node_slab& a, const node_slab& b) {
+			return less(a.nodes, b.nodes);
+		});
+		slabs.insert(position, slab);
+	}
+
+	//A chain of linked nodes that are not part of a list yet
+	struct node_chain {
+		node* first = nullptr;
+		node* last = nullptr;
+		int count = 0;
+	};
+
+	//Creates a chain of nodes from the values in the range [begin, end). If the range can be measured up front, then every node
+	//is constructed in one block that is allocated in a single batch. If an exception occurs, every node that was created is freed.
+	//"knownCount" is the length of the range if the caller already knows it, or -1 to measure it
+	template<typename InputIterator>
+	static node_chain buildChain(InputIterator begin, InputIterator end, node_slab& slab, std::ptrdiff_t knownCount = -1)
+	{
+		node_chain chain{};
+		slab = node_slab{ nullptr, 0, 0 };
+
+		if constexpr (std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<InputIterator>::iterator_category>::value)
+		{
+			std::ptrdiff_t count = knownCount >= 0 ? knownCount : static_cast<std::ptrdiff_t>(std::distance(begin, end));
+			if (count <= 0)
+			{
+				return chain;
+			}
+
+			node* storage = allocateSlab(static_cast<int>(count));
+			int constructed = 0;
+			try
+			{
+				for (; begin != end; ++begin)
+				{
+					//Link the nodes while they are constructed, so the values are only read once
+					new (storage + constructed) node(*begin, nullptr, constructed > 0 ? storage + (constructed - 1) : nullptr);
+					if (constructed > 0)
+					{
+						storage[constructed - 1].next = storage + constructed;
+					}
+					constructed++;
+				}
+			}
+			catch (...)
+			{
+				for (int i = 0; i < constructed; i++)
+				{
+					storage[i].~node();
+				}
+				freeSlab(storage);
+				throw;
+			}
+
+			slab = node_slab{ storage, constructed, constructed };
+			chain.first = storage;
+			chain.last = storage + (constructed - 1);
+			chain.count = constructed;
+		}
+		//The range can only be read once, so the nodes have to be allocated one at a time
+		else
+		{
+			try
+			{
+				for (; begin != end; ++begin)
+				{
+					node* newNode = new node(*begin, nullptr, chain.last);
+					if (chain.last != nullptr)
+					{
+						chain.last->next = newNode;
+					}
+					else
+					{
+						chain.first = newNode;
+					}
+					chain.last = newNode;
+					chain.count++;
+				}
+			}
+			catch (...)
+			{
+				while (chain.first != nullptr)
+				{
+					node* next = chain.first->next;
+					delete chain.first;
+					chain.first = next;
+				}
+				throw;
+			}
+		}
+		return chain;
+	}
+
+	//Links a chain of nodes into the list before "elementToInsertBefore", and takes ownership of the block the nodes were allocated in
+	void linkChain(const node_chain& chain, const node_slab& slab, node* elementToInsertBefore)
+	{
+		if (chain.count == 0)
+		{
+			return;
+		}
+		if (slab.nodes != nullptr)
+		{
+			addSlab(slab);
+		}
+
+		node* previousNode = elementToInsertBefore != nullptr ? elementToInsertBefore->prev : last;
+		chain.first->prev = previousNode;
+		chain.last->next = elementToInsertBefore;
+
+		if (previousNode != nullptr)
+		{
+			previousNode->next = chain.first;
+		}
+		else
+		{
+			first = chain.first;
+		}
+
+		if (elementToInsertBefore != nullptr)
+		{
+			elementToInsertBefore->prev = chain.last;
+		}
+		else
+		{
+			last = chain.last;
+		}
+
+		//If the nodes were added to the back of the list, then the existing checkpoints are still valid, and only the new nodes need to be checked
+		if (elementToInsertBefore == nullptr && checkpointInterval != 0 && checkpointsValid)
+		{
+			int index = size;
+			for (node* current = chain.first; current != nullptr; current = current->next, index++)
+			{
+				if (index % checkpointInterval == 0)
+				{
+					checkpoints.push_back(current);
+				}
+			}
+		}
+		else if (elementToInsertBefore != nullptr)
+		{
+			invalidateCheckpoints();
+		}
+		size += chain.count;
+	}
+
+	//Replaces the contents of the list with a copy of another list. The size of the other list is already known, so it is only walked over once
+	void copyFrom(const linked_list<T>& copy)
+	{
+		slabs.reserve(slabs.size() + 1);
+		node_slab slab;
+		node_chain chain = buildChain(copy.begin(), copy.end(), slab, copy.size);
+		clear();
+		linkChain(chain, slab, nullptr);
+	}
+
+	//Updates the checkpoints after a node has been added to the back of the list
+	void checkpointPushedBack()
+	{
+		//If the new node lands on a checkpoint interval, then add it as a checkpoint
+		if (checkpointInterval != 0 && checkpointsValid && (size - 1) % checkpointInterval == 0)
+		{
+			checkpoints.push_back(last);
+		}
+	}
+
+	//Marks the checkpoints as out of date. They get rebuilt the next time the list is split
+	void invalidateCheckpoints()
+	{
+		checkpointsValid = false;
+	}
+
+	//Rebuilds the checkpoints if they are out of date
+	void rebuildCheckpoints()
+	{
+		if (checkpointsValid)
+		{
+			return;
+		}
+		checkpoints.clear();
+		int index = 0;
+		for (node* current = first; current != nullptr; current = current->next, index++)
+		{
+			if (index % checkpointInterval == 0)
+			{
+				checkpoints.push_back(current);
+			}
+		}
+		checkpointsValid = true;
+	}
+
+	//Splits the list into "chunkCount" ranges of nearly equal size. Used by split()
+	template<typename IteratorType, typename ListType>
+	static std::vector<std::pair<IteratorType, IteratorType>> splitList(ListType* list, int chunkCount)
+	{
+		std::vector<std::pair<IteratorType, IteratorType>> chunks;
+		if (list->size == 0)
+		{
+			return chunks;
+		}
+		if (chunkCount > list->size)
+		{
+			chunkCount = list->size;
+		}
+		if (chunkCount < 1)
+		{
+			chunkCount = 1;
+		}
+		chunks.reserve(chunkCount);
+
+		IteratorType chunkBegin(list->first, list);
+		//If the checkpoints are up to date, then every chunk starts on a checkpoint, so no nodes need to be walked over
+		if (list->checkpointInterval != 0 && list->checkpointsValid)
+		{
+			int checkpointCount = static_cast<int>(list->checkpoints.size());
+			if (chunkCount > checkpointCount)
+			{
+				chunkCount = checkpointCount;
+			}
+			for (int i = 1; i < chunkCount; i++)
+			{
+				IteratorType chunkEnd(list->checkpoints[static_cast<size_t>(i) * checkpointCount / chunkCount], list);
+				chunks.emplace_back(chunkBegin, chunkEnd);
+				chunkBegin = chunkEnd;
+			}
+		}
+		//Without usable checkpoints, the chunk boundaries are found by walking over the list once
+		else
+		{
+			IteratorType chunkEnd = chunkBegin;
+			for (int i = 1; i < chunkCount; i++)
+			{
+				int chunkSize = (list->size * i / chunkCount) - (list->size * (i - 1) / chunkCount);
+				for (int j = 0; j < chunkSize; j++)
+				{
+					++chunkEnd;
+				}
+				chunks.emplace_back(chunkBegin, chunkEnd);
+				chunkBegin = chunkEnd;
+			}
+		}
+		chunks.emplace_back(chunkBegin, IteratorType(nullptr, list));
+		return chunks;
+	}
+
 	//Inserts a new node. The node will be inserted before the "elementToInsertBefore" iterator
 	node_iterator insert(node* newNode, const node_iterator elementToInsertBefore)
 	{
+		if (!elementToInsertBefore.is_valid())
+		{
+			throw struct_exception("The iterator was invalidated by compacting the list");
+		}
 		//If the iterator is equal to the end() iterator
 		if (elementToInsertBefore.get_node() == nullptr)
 		{
@@ -231,6 +588,8 @@ private:
 			}
 			//Increase the size of the list
 			size++;
+			//The node was added to the back of the list, so the checkpoints are still valid
+			checkpointPushedBack();
 		}
 		//If the iterator is not the end() iterator
 		else
@@ -260,6 +619,8 @@ private:
 			newNode->next = nextNode;
 			//Increase the size of the list
 			size++;
+			//Every node after the new node has moved, so the checkpoints are out of date
+			invalidateCheckpoints();
 		}
 		//return a new iterator that points to the new node
 		return node_iterator(newNode, this);
@@ -269,42 +630,73 @@ public:
 	linked_list() {}
 	//Constructs a linked list from a list of items
 	linked_list(std::initializer_list<T> list) {
-		for (auto& i : list)
-		{
-			push_back(i);
-		}
+		assign(list.begin(), list.end());
+	}
+
+	//Constructs a linked list from the values in the range [begin, end). The nodes are allocated in a single batch
+	template<typename InputIterator, typename = decltype(*std::declval<InputIterator&>(), ++std::declval<InputIterator&>())>
+	linked_list(InputIterator begin, InputIterator end) {
+		assign(begin, end);
 	}
 
-	linked_list(const linked_list<T>& copy)
+	//Copies a list. The nodes are allocated in a single batch, and each value is copied straight into its node
+	linked_list(const linked_list<T>& copy) : checkpointInterval(copy.checkpointInterval)
 	{
-		clear();
-		for (auto value : copy)
-		{
-			push_back(value);
-		}
+		copyFrom(copy);
 	}
 
 	linked_list(linked_list<T>&& move) noexcept :
 		first(std::move(move.first)),
 		last(std::move(move.last)),
-		size(std::move(move.size))
+		size(std::move(move.size)),
+		slabs(std::move(move.slabs)),
+		checkpointInterval(move.checkpointInterval),
+		checkpoints(std::move(move.checkpoints)),
+		checkpointsValid(move.checkpointsValid)
 	{
 		move.first = nullptr;
 		move.last = nullptr;
 		move.size = 0;
+		move.checkpoints.clear();
+		move.checkpointsValid = true;
+		move.slabs.clear();
 	}
 
 	linked_list<T>& operator=(const linked_list<T>& copy)
 	{
-		clear();
-		for (auto value : copy)
+		if (&copy != this)
 		{
-			push_back(value);
+			copyFrom(copy);
+			checkpointInterval = copy.checkpointInterval;
+			invalidateCheckpoints();
 		}
 		return *this;
 	}
 
-	linked_list<T>& operator=(linked_list<T>&& move) = default;
+	linked_list<T>& operator=(linked_list<T>&& move) noexcept
+	{
+		if (&move == this)
+		{
+			return *this;
+		}
+		//Free the current nodes, then take the nodes of the other list
+		clear();
+		first = move.first;
+		last = move.last;
+		size = move.size;
+		checkpointInterval = move.checkpointInterval;
+		checkpoints = std::move(move.checkpoints);
+		checkpointsValid = move.checkpointsValid;
+		slabs = std::move(move.slabs);
+
+		move.first = nullptr;
+		move.last = nullptr;
+		move.size = 0;
+		move.checkpoints.clear();
+		move.checkpointsValid = true;
+		move.slabs.clear();
+		return *this;
+	}
 
 	~linked_list()
 	{
@@ -319,11 +711,13 @@ public:
 		{
 			node* previousNode = currentNode;
 			currentNode = currentNode->next;
-			delete previousNode;
+			releaseNode(previousNode);
 		}
 		first = nullptr;
 		last = nullptr;
 		size = 0;
+		checkpoints.clear();
+		checkpointsValid = true;
 	}
 
 	//Gets an iterator to the first node
@@ -393,6 +787,8 @@ public:
 
 		first = newNode;
 		++size;
+		//Every node has moved back by one, so the checkpoints are out of date
+		invalidateCheckpoints();
 		return node_iterator(first, this);
 	}
 
@@ -413,6 +809,8 @@ public:
 
 		first = newNode;
 		++size;
+		//Every node has moved back by one, so the checkpoints are out of date
+		invalidateCheckpoints();
 		return node_iterator(first, this);
 	}
 
@@ -433,6 +831,7 @@ public:
 
 		last = newNode;
 		++size;
+		checkpointPushedBack();
 		return node_iterator(last, this);
 	}
 
@@ -453,6 +852,7 @@ public:
 
 		last = newNode;
 		++size;
+		checkpointPushedBack();
 		return node_iterator(last, this);
 	}
 
@@ -474,6 +874,8 @@ public:
 
 		first = newNode;
 		++size;
+		//Every node has moved back by one, so the checkpoints are out of date
+		invalidateCheckpoints();
 		return node_iterator(first, this);
 	}
 
@@ -495,6 +897,7 @@ public:
 
 		last = newNode;
 		++size;
+		checkpointPushedBack();
 		return node_iterator(last, this);
 	}
 	
@@ -514,16 +917,18 @@ public:
 
 				auto old = first;
 				first = first->next;
-				delete old;
+				releaseNode(old);
 			}
 			else
 			{
-				delete first;
+				releaseNode(first);
 				first = nullptr;
 			}
 
 			
 			--size;
+			//Every node has moved forward by one, so the checkpoints are out of date
+			invalidateCheckpoints();
 			return true;
 		}
 		return false;
@@ -534,6 +939,12 @@ public:
 	{
 		if (last != nullptr)
 		{
+			//If the last node is a checkpoint, then remove it. The rest of the checkpoints are still valid
+			if (checkpointsValid && !checkpoints.empty() && checkpoints.back() == last)
+			{
+				checkpoints.pop_back();
+			}
+
 			if (first == last)
 			{
 				first = nullptr;
@@ -545,11 +956,11 @@ public:
 
 				auto old = last;
 				last = last->prev;
-				delete old;
+				releaseNode(old);
 			}
 			else
 			{
-				delete last;
+				releaseNode(last);
 				last = nullptr;
 			}
 			
@@ -565,6 +976,194 @@ public:
 		return size;
 	}
 
+	//Enables checkpoints on every "interval"-th node, which lets split() divide the list into chunks without walking over every node.
+	//Adding to the back of the list keeps the checkpoints up to date. Any other change marks them as out of date, and they are rebuilt by the next non-const split()
+	void enable_checkpoints(int interval)
+	{
+		if (interval <= 0)
+		{
+			throw struct_exception("The checkpoint interval must be greater than zero");
+		}
+		checkpointInterval = interval;
+		invalidateCheckpoints();
+		rebuildCheckpoints();
+	}
+
+	//Disables checkpoints and frees the memory they used
+	void disable_checkpoints()
+	{
+		checkpointInterval = 0;
+		checkpoints.clear();
+		checkpoints.shrink_to_fit();
+		checkpointsValid = true;
+	}
+
+	//Gets how many nodes apart the checkpoints are. Returns 0 if checkpoints are disabled
+	int getCheckpointInterval() const
+	{
+		return checkpointInterval;
+	}
+
+	//Splits the list into at most "chunkCount" ranges of nearly equal size. Each range is a pair of [begin, end) iterators.
+	//With checkpoints enabled, out of date checkpoints are rebuilt first, and the split is O(n / interval). Without checkpoints, this walks over the list once
+	std::vector<std::pair<node_iterator, node_iterator>> split(int chunkCount)
+	{
+		if (checkpointInterval != 0)
+		{
+			rebuildCheckpoints();
+		}
+		return splitList<node_iterator>(this, chunkCount);
+	}
+
+	//Splits the list into at most "chunkCount" ranges of nearly equal size. Each range is a pair of [begin, end) iterators.
+	//This is O(n / interval) if checkpoints are enabled and up to date. Otherwise, this walks over the list once, since a const call never rebuilds the checkpoints
+	std::vector<std::pair<const_node_iterator, const_node_iterator>> split(int chunkCount) const
+	{
+		return splitList<const_node_iterator>(this, chunkCount);
+	}
+
+	//Moves all the nodes of another list onto the back of this list in O(1). The other list is left empty
+	void splice_back(linked_list<T>&& other)
+	{
+		if (other.first == nullptr || &other == this)
+		{
+			return;
+		}
+		//Make room for the other list's blocks up front, so nothing can fail once the nodes start moving
+		slabs.reserve(slabs.size() + other.slabs.size());
+
+		if (last != nullptr)
+		{
+			last->next = other.first;
+			other.first->prev = last;
+		}
+		else
+		{
+			first = other.first;
+		}
+		last = other.last;
+		size += other.size;
+		//The checkpoints of the other list don't line up with this list's interval, so rebuild them later
+		invalidateCheckpoints();
+
+		//The blocks of the other list's nodes now belong to this list
+		for (auto& slab : other.slabs)
+		{
+			addSlab(slab);
+		}
+
+		other.first = nullptr;
+		other.last = nullptr;
+		other.size = 0;
+		other.checkpoints.clear();
+		other.checkpointsValid = true;
+		other.slabs.clear();
+	}
+
+	//Moves every node into one block of memory, in the same order as the list, so iterating over the list reads memory in order.
+	//This is worth calling after many inserts and removals have scattered the nodes around memory.
+	//Every iterator from before the list was compacted becomes invalid, and using one throws an exception. The end() iterator stays valid
+	void compact()
+	{
+		if (size == 0)
+		{
+			return;
+		}
+
+		//Make room for the new block up front, so nothing can fail once the old nodes start being freed
+		slabs.reserve(slabs.size() + 1);
+		node* storage = allocateSlab(size);
+		int constructed = 0;
+
+		//Move the values into the new block. If a value can't be moved without throwing, then it is copied, so the list is unchanged if an exception occurs
+		try
+		{
+			for (node* current = first; current != nullptr; current = current->next)
+			{
+				new (storage + constructed) node(std::move_if_noexcept(current->value), nullptr, nullptr);
+				constructed++;
+			}
+		}
+		catch (...)
+		{
+			for (int i = 0; i < constructed; i++)
+			{
+				storage[i].~node();
+			}
+			freeSlab(storage);
+			throw;
+		}
+
+		//Link the new nodes together
+		for (int i = 0; i < size; i++)
+		{
+			storage[i].prev = i > 0 ? &storage[i - 1] : nullptr;
+			storage[i].next = i < size - 1 ? &storage[i + 1] : nullptr;
+		}
+
+		//Free the old nodes
+		node* currentNode = first;
+		while (currentNode != nullptr)
+		{
+			node* previousNode = currentNode;
+			currentNode = currentNode->next;
+			releaseNode(previousNode);
+		}
+
+		first = storage;
+		last = storage + (size - 1);
+		addSlab(node_slab{ storage, size, size });
+		++generation;
+		invalidateCheckpoints();
+	}
+
+	//Gets how many times the list has been compacted. Iterators that were created before the last compaction are invalid
+	unsigned int getGeneration() const
+	{
+		return generation;
+	}
+
+	//Replaces the contents of the list with the values in the range [begin, end). The new nodes are allocated in a single batch.
+	//If an exception occurs while copying the values, the list is left unchanged
+	template<typename InputIterator, typename = decltype(*std::declval<InputIterator&>(), ++std::declval<InputIterator&>())>
+	void assign(InputIterator begin, InputIterator end)
+	{
+		//Make room for the new block up front, so nothing can fail once the old nodes are freed
+		slabs.reserve(slabs.size() + 1);
+		node_slab slab;
+		node_chain chain = buildChain(begin, end, slab);
+		clear();
+		linkChain(chain, slab, nullptr);
+	}
+
+
+	//Replaces the contents of the list with a list of items
+	void assign(std::initializer_list<T> list)
+	{
+		assign(list.begin(), list.end());
+	}
+
+	//Inserts the values in the range [begin, end) before the specified position. The new nodes are allocated in a single batch and linked in one pass.
+	//Returns an iterator to the first new node, or the position if the range is empty. If an exception occurs, the list is left unchanged
+	template<typename InputIterator, typename = decltype(*std::declval<InputIterator&>(), ++std::declval<InputIterator&>())>
+	node_iterator insert(const node_iterator elementToInsertBefore, InputIterator begin, InputIterator end)
+	{
+		if (!elementToInsertBefore.is_valid())
+		{
+			throw struct_exception("The iterator was invalidated by compacting the list");
+		}
+		//Make room for the new block up front, so nothing can fail once the nodes are built
+		slabs.reserve(slabs.size() + 1);
+		node_slab slab;
+		node_chain chain = buildChain(begin, end, slab);
+		if (chain.count == 0)
+		{
+			return elementToInsertBefore;
+		}
+		linkChain(chain, slab, elementToInsertBefore.get_node());
+		return node_iterator(chain.first, this);
+	}
+
 	//Inserts a new element before the specified position. Returns an iterator to the new node
 	node_iterator insert(const T& value, const node_iterator elementToInsertBefore)
 	{
@@ -628,6 +1227,10 @@ public:
 			//Cannot delete the end() iterator, since that doesn't have a valid value
 			throw struct_exception("The passed in iterator does not point to a valid element");
 		}
+		if (!elementToRemove.is_valid())
+		{
+			throw struct_exception("The iterator was invalidated by compacting the list");
+		}
 		//Get the node of the element to remove
 		node* node = elementToRemove.get_node();
 
@@ -659,8 +1262,10 @@ public:
 		}
 		//Decrease the size
 		size--;
+		//The removed node could have been a checkpoint, so the checkpoints are out of date
+		invalidateCheckpoints();
 		//Delete the current node
-		delete node;
+		releaseNode(node);
 	}
 
 	//Finds a node with the specified value
@@ -843,7 +1448,7 @@ typename linked_list<T>::node_iterator minimum(linked_list<T>& list, Comparer& c
 
 //Used for printing a linked_list to the console
 template<typename T>
-std::ostream& operator<<(std::ostream& os, const linked_list<T> list) {
+std::ostream& operator<<(std::ostream& os, const linked_list<T>& list) {
 	if (list.getSize() == 0) {
 		os << "[]";
 	}
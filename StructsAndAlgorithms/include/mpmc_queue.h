@@ -0,0 +1,335 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <common.h>
+#include <struct_exception.h>
+
+//A bounded, lock-free queue that any amount of threads can push to and pop from at the same time.
+//The queue is a ring buffer where every slot has a sequence number. A thread claims a slot by advancing the enqueue or dequeue position,
+//and the sequence number of the slot tells other threads whether the value in it has been written or read yet (Dmitry Vyukov's design)
+template<typename T>
+class mpmc_queue {
+	//Values are moved into their slot after the slot has been claimed, so that step must not be able to fail
+	static_assert(std::is_nothrow_move_constructible<T>::value, "mpmc_queue requires a type that can be moved without throwing");
+
+	//Represents a single slot in the ring buffer
+	struct cell {
+		//If the sequence equals the position of a push, then the slot is free for that push
+		//If the sequence equals the position of a pop + 1, then the slot holds a value for that pop
+		std::atomic<std::size_t> sequence;
+		//The storage for the value. The value only exists while the slot is full
+		alignas(T) unsigned char storage[sizeof(T)];
+
+		T* value() {
+			return std::launder(reinterpret_cast<T*>(storage));
+		}
+	};
+
+	//The ring buffer of slots
+	cell* buffer;
+	//The capacity minus one. The capacity is always a power of two, so this is used to wrap positions around the buffer
+	std::size_t mask;
+
+	//The position of the next push. Kept on its own cache line so producers and consumers don't slow each other down
+	alignas(CacheLineSize) std::atomic<std::size_t> enqueuePos{ 0 };
+	//The position of the next pop
+	alignas(CacheLineSize) std::atomic<std::size_t> dequeuePos{ 0 };
+
+	//Waits a little bit before a blocking operation tries again
+	static void backoff(int& attempts)
+	{
+		//Spin for a few attempts, then give the rest of the time slice to other threads
+		if (++attempts > 16)
+		{
+			std::this_thread::yield();
+		}
+	}
+
+	//Claims up to "maxCount" consecutive slots for pushing. Returns how many slots were claimed and stores the first claimed position in "pos"
+	std::size_t claimPush(std::size_t maxCount, std::size_t& pos)
+	{
+		pos = enqueuePos.load(std::memory_order_relaxed);
+		while (true)
+		{
+			//Count how many of the slots after the position are free
+			std::size_t count = 0;
+			while (count < maxCount && count <= mask && buffer[(pos + count) & mask].sequence.load(std::memory_order_acquire) == pos + count)
+			{
+				count++;
+			}
+
+			if (count == 0)
+			{
+				//If the first slot still holds a value from the previous lap around the buffer, then the queue is full
+				std::intptr_t difference = static_cast<std::intptr_t>(buffer[pos & mask].sequence.load(std::memory_order_acquire)) - static_cast<std::intptr_t>(pos);
+				if (difference < 0)
+				{
+					return 0;
+				}
+				//Otherwise, another producer has claimed the slot, so try again from the new position
+				pos = enqueuePos.load(std::memory_order_relaxed);
+			}
+			//Try to claim the free slots. If another producer got there first, "pos" is updated and we try again
+			else if (enqueuePos.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed))
+			{
+				return count;
+			}
+		}
+	}
+
+	//Claims up to "maxCount" consecutive slots for popping. Returns how many slots were claimed and stores the first claimed position in "pos"
+	std::size_t claimPop(std::size_t maxCount, std::size_t& pos)
+	{
+		pos = dequeuePos.load(std::memory_order_relaxed);
+		while (true)
+		{
+			//Count how many of the slots after the position hold a value
+			std::size_t count = 0;
+			while (count < maxCount && count <= mask && buffer[(pos + count) & mask].sequence.load(std::memory_order_acquire) == pos + count + 1)
+			{
+				count++;
+			}
+
+			if (count == 0)
+			{
+				//If the first slot hasn't been written yet, then the queue is empty
+				std::intptr_t difference = static_cast<std::intptr_t>(buffer[pos & mask].sequence.load(std::memory_order_acquire)) - static_cast<std::intptr_t>(pos + 1);
+				if (difference < 0)
+				{
+					return 0;
+				}
+				//Otherwise, another consumer has claimed the slot, so try again from the new position
+				pos = dequeuePos.load(std::memory_order_relaxed);
+			}
+			//Try to claim the full slots. If another consumer got there first, "pos" is updated and we try again
+			else if (dequeuePos.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed))
+			{
+				return count;
+			}
+		}
+	}
+
+	//Moves a value into a claimed slot and marks it as full
+	void fill(std::size_t pos, T&& value)
+	{
+		cell& slot = buffer[pos & mask];
+		new (slot.storage) T(std::move(value));
+		slot.sequence.store(pos + 1, std::memory_order_release);
+	}
+
+	//Moves the value out of a claimed slot and marks it as free for the next lap around the buffer
+	T drain(std::size_t pos)
+	{
+		cell& slot = buffer[pos & mask];
+		T result = std::move(*slot.value());
+		slot.value()->~T();
+		slot.sequence.store(pos + mask + 1, std::memory_order_release);
+		return result;
+	}
+
+public:
+	//Constructs a queue that can hold at least "capacity" values. The capacity is rounded up to a power of two
+	explicit mpmc_queue(std::size_t capacity)
+	{
+		if (capacity == 0)
+		{
+			throw struct_exception("The capacity of a queue must be greater than zero");
+		}
+
+		//Round the capacity up to a power of two
+		std::size_t powerOfTwo = 1;
+		while (powerOfTwo < capacity)
+		{
+			powerOfTwo <<= 1;
+		}
+
+		buffer = static_cast<cell*>(::operator new(sizeof(cell) * powerOfTwo));
+		mask = powerOfTwo - 1;
+
+		//Each slot starts out free for the push that has the same position
+		for (std::size_t i = 0; i < powerOfTwo; i++)
+		{
+			new (&buffer[i].sequence) std::atomic<std::size_t>(i);
+		}
+	}
+
+	//The queue can't be copied or moved while other threads could be using it
+	mpmc_queue(const mpmc_queue<T>&) = delete;
+	mpmc_queue<T>& operator=(const mpmc_queue<T>&) = delete;
+
+	~mpmc_queue()
+	{
+		//Destroy any values that are still in the queue
+		std::size_t pos;
+		while (claimPop(1, pos) == 1)
+		{
+			drain(pos);
+		}
+		::operator delete(static_cast<void*>(buffer));
+	}
+
+	//Attempts to add a value to the back of the queue. Returns false if the queue is full
+	bool try_push(const T& value)
+	{
+		//Copy the value before claiming a slot, so a throwing copy can't leave a claimed slot empty
+		T copy(value);
+		return try_push(std::move(copy));
+	}
+
+	//Attempts to add a value to the back of the queue. Returns false if the queue is full
+	bool try_push(T&& value)
+	{
+		std::size_t pos;
+		if (claimPush(1, pos) == 0)
+		{
+			return false;
+		}
+		fill(pos, std::move(value));
+		return true;
+	}
+
+	//Attempts to construct a value at the back of the queue. Returns false if the queue is full
+	template<typename... Args>
+	bool try_emplace(Args&&... arguments)
+	{
+		return try_push(T(std::forward<Args>(arguments)...));
+	}
+
+	//Adds a value to the back of the queue. Waits until there is room if the queue is full
+	void push(const T& value)
+	{
+		T copy(value);
+		push(std::move(copy));
+	}
+
+	//Adds a value to the back of the queue. Waits until there is room if the queue is full
+	void push(T&& value)
+	{
+		int attempts = 0;
+		while (!try_push(std::move(value)))
+		{
+			backoff(attempts);
+		}
+	}
+
+	//Attempts to remove the value at the front of the queue and store it in "result". Returns false if the queue is empty
+	bool try_pop(T& result)
+	{
+		std::size_t pos;
+		if (claimPop(1, pos) == 0)
+		{
+			return false;
+		}
+		result = drain(pos);
+		return true;
+	}
+
+	//Removes the value at the front of the queue. Waits until there is a value if the queue is empty
+	T pop()
+	{
+		int attempts = 0;
+		std::size_t pos;
+		while (claimPop(1, pos) == 0)
+		{
+			backoff(attempts);
+		}
+		return drain(pos);
+	}
+
+	//Attempts to push as many values from the range [first, last) as there is room for, using a single claim on the queue.
+	//Returns how many values were pushed, starting from "first"
+	template<typename ForwardIterator>
+	std::size_t try_push_batch(ForwardIterator first, ForwardIterator last)
+	{
+		//The values are constructed after their slots have been claimed, so that must not be able to fail
+		static_assert(std::is_nothrow_constructible<T, decltype(*first)>::value, "Batch pushes require values that can be constructed without throwing. Use std::make_move_iterator to move the values");
+
+		std::size_t requested = static_cast<std::size_t>(std::distance(first, last));
+		if (requested == 0)
+		{
+			return 0;
+		}
+
+		std::size_t pos;
+		std::size_t count = claimPush(requested, pos);
+		for (std::size_t i = 0; i < count; i++, ++first)
+		{
+			cell& slot = buffer[(pos + i) & mask];
+			new (slot.storage) T(*first);
+			slot.sequence.store(pos + i + 1, std::memory_order_release);
+		}
+		return count;
+	}
+
+	//Pushes all the values in the range [first, last). Waits whenever the queue is full
+	template<typename ForwardIterator>
+	void push_batch(ForwardIterator first, ForwardIterator last)
+	{
+		int attempts = 0;
+		while (first != last)
+		{
+			std::size_t count = try_push_batch(first, last);
+			if (count == 0)
+			{
+				backoff(attempts);
+			}
+			else
+			{
+				std::advance(first, count);
+				attempts = 0;
+			}
+		}
+	}
+
+	//Attempts to pop up to "maxCount" values using a single claim on the queue. The values are written to "output". Returns how many values were popped
+	template<typename OutputIterator>
+	std::size_t try_pop_batch(OutputIterator output, std::size_t maxCount)
+	{
+		if (maxCount == 0)
+		{
+			return 0;
+		}
+
+		std::size_t pos;
+		std::size_t count = claimPop(maxCount, pos);
+		for (std::size_t i = 0; i < count; i++)
+		{
+			*output = drain(pos + i);
+			++output;
+		}
+		return count;
+	}
+
+	//Pops between 1 and "maxCount" values. Waits until there is at least one value if the queue is empty. Returns how many values were popped
+	template<typename OutputIterator>
+	std::size_t pop_batch(OutputIterator output, std::size_t maxCount)
+	{
+		int attempts = 0;
+		std::size_t count;
+		while ((count = try_pop_batch(output, maxCount)) == 0 && maxCount != 0)
+		{
+			backoff(attempts);
+		}
+		return count;
+	}
+
+	//Gets how many values the queue can hold
+	std::size_t capacity() const
+	{
+		return mask + 1;
+	}
+
+	//Gets roughly how many values are in the queue. This can be out of date by the time it returns if other threads are using the queue
+	std::size_t approximate_size() const
+	{
+		std::size_t pushes = enqueuePos.load(std::memory_order_relaxed);
+		std::size_t pops = dequeuePos.load(std::memory_order_relaxed);
+		return pushes > pops ? pushes - pops : 0;
+	}
+};
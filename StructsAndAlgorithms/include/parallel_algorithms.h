@@ -0,0 +1,212 @@
+#pragma once
+
+#include <exception>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <common.h>
+#include <linked_list.h>
+
+//This namespace contains implementation details
+namespace parallel_impl
+{
+	//Lists with fewer nodes than this are processed on the calling thread, since starting threads would cost more than it saves
+	constexpr int MinimumParallelSize = 4096;
+
+	//Gets how many threads to use. A thread count of 0 means one thread per core
+	inline int resolve_thread_count(int threadCount, int listSize)
+	{
+		if (threadCount <= 0)
+		{
+			threadCount = static_cast<int>(std::thread::hardware_concurrency());
+			if (threadCount <= 0)
+			{
+				threadCount = 1;
+			}
+		}
+		if (listSize < MinimumParallelSize)
+		{
+			return 1;
+		}
+		return threadCount;
+	}
+
+	//Runs "func(chunkIndex)" for every chunk. The first chunk runs on the calling thread and the others run on their own threads.
+	//If any of the chunks throw an exception, the first exception is rethrown once every thread has finished
+	template<typename Func>
+	void run_chunks(int chunkCount, Func&& func)
+	{
+		if (chunkCount == 0)
+		{
+			return;
+		}
+
+		std::vector<std::exception_ptr> errors(chunkCount);
+		std::vector<std::thread> threads;
+		threads.reserve(chunkCount);
+
+		for (int i = 1; i < chunkCount; i++)
+		{
+			threads.emplace_back([&func, &errors, i]() {
+				try
+				{
+					func(i);
+				}
+				catch (...)
+				{
+					errors[i] = std::current_exception();
+				}
+			});
+		}
+
+		try
+		{
+			func(0);
+		}
+		catch (...)
+		{
+			errors[0] = std::current_exception();
+		}
+
+		for (auto& thread : threads)
+		{
+			thread.join();
+		}
+
+		for (auto& error : errors)
+		{
+			if (error)
+			{
+				std::rethrow_exception(error);
+			}
+		}
+	}
+
+	//Folds every chunk into its own copy of "identity", then combines the results in list order. Used by parallel_reduce()
+	template<typename Chunks, typename Result, typename Accumulate, typename Combine>
+	Result reduce_chunks(const Chunks& chunks, Result identity, Accumulate& accumulate, Combine& combine)
+	{
+		std::vector<Result> results(chunks.size(), identity);
+
+		run_chunks(static_cast<int>(chunks.size()), [&chunks, &results, &accumulate](int index) {
+			Result result = results[index];
+			for (auto i = chunks[index].first; i != chunks[index].second; ++i)
+			{
+				result = accumulate(std::move(result), *i);
+			}
+			results[index] = std::move(result);
+		});
+
+		//Combine the results of each chunk in order, so operations that aren't commutative still work
+		Result total = std::move(identity);
+		for (auto& result : results)
+		{
+			total = combine(std::move(total), std::move(result));
+		}
+		return total;
+	}
+
+	//Builds a list for every chunk, then joins them onto the cleared output list in order. Used by parallel_transform()
+	template<typename Chunks, typename U, typename Func>
+	void transform_chunks(const Chunks& chunks, linked_list<U>& output, Func& func)
+	{
+		std::vector<linked_list<U>> results(chunks.size());
+
+		run_chunks(static_cast<int>(chunks.size()), [&chunks, &results, &func](int index) {
+			for (auto i = chunks[index].first; i != chunks[index].second; ++i)
+			{
+				results[index].push_back(func(*i));
+			}
+		});
+
+		output.clear();
+		for (auto& result : results)
+		{
+			output.splice_back(std::move(result));
+		}
+	}
+}
+
+//Calls "func" on every value in the list, spread across multiple threads. The order the values are visited in is not defined.
+//Enabling checkpoints on the list lets it be split into chunks without walking over it first. A thread count of 0 uses one thread per core
+template<typename T, typename Func>
+void parallel_for_each(linked_list<T>& list, Func func, int threadCount = 0)
+{
+	auto chunks = list.split(parallel_impl::resolve_thread_count(threadCount, list.getSize()));
+
+	parallel_impl::run_chunks(static_cast<int>(chunks.size()), [&chunks, &func](int index) {
+		for (auto i = chunks[index].first; i != chunks[index].second; ++i)
+		{
+			func(*i);
+		}
+	});
+}
+
+//Calls "func" on every value in the list, spread across multiple threads. The order the values are visited in is not defined.
+//Up to date checkpoints on the list let it be split into chunks without walking over it first. Out of date checkpoints are not rebuilt, since the list is const.
+//A thread count of 0 uses one thread per core
+template<typename T, typename Func>
+void parallel_for_each(const linked_list<T>& list, Func func, int threadCount = 0)
+{
+	auto chunks = list.split(parallel_impl::resolve_thread_count(threadCount, list.getSize()));
+
+	parallel_impl::run_chunks(static_cast<int>(chunks.size()), [&chunks, &func](int index) {
+		for (auto i = chunks[index].first; i != chunks[index].second; ++i)
+		{
+			func(*i);
+		}
+	});
+}
+
+//Combines all the values in the list across multiple threads. Each thread folds its chunk into a copy of "identity" with "accumulate(result, value)",
+//and the results of the chunks are then combined in list order with "combine(a, b)". "identity" must not change a result when combined with it.
+//Out of date checkpoints are rebuilt first, so the list can be split into chunks without walking over it
+template<typename T, typename Result, typename Accumulate, typename Combine>
+Result parallel_reduce(linked_list<T>& list, Result identity, Accumulate accumulate, Combine combine, int threadCount = 0)
+{
+	auto chunks = list.split(parallel_impl::resolve_thread_count(threadCount, list.getSize()));
+	return parallel_impl::reduce_chunks(chunks, std::move(identity), accumulate, combine);
+}
+
+//Combines all the values in the list across multiple threads. See the non-const overload.
+//Out of date checkpoints are not rebuilt, since the list is const, so the list is walked over once to split it
+template<typename T, typename Result, typename Accumulate, typename Combine>
+Result parallel_reduce(const linked_list<T>& list, Result identity, Accumulate accumulate, Combine combine, int threadCount = 0)
+{
+	auto chunks = list.split(parallel_impl::resolve_thread_count(threadCount, list.getSize()));
+	return parallel_impl::reduce_chunks(chunks, std::move(identity), accumulate, combine);
+}
+
+//Combines all the values in the list across multiple threads with an associative operation, such as addition.
+//"identity" must not change a result when combined with it, such as 0 for addition
+template<typename T, typename Result, typename Operation>
+Result parallel_reduce(linked_list<T>& list, Result identity, Operation operation, int threadCount = 0)
+{
+	return parallel_reduce(list, std::move(identity), operation, operation, threadCount);
+}
+
+//Combines all the values in the list across multiple threads with an associative operation, such as addition.
+//"identity" must not change a result when combined with it, such as 0 for addition
+template<typename T, typename Result, typename Operation>
+Result parallel_reduce(const linked_list<T>& list, Result identity, Operation operation, int threadCount = 0)
+{
+	return parallel_reduce(list, std::move(identity), operation, operation, threadCount);
+}
+
+//Stores "func(value)" for every value of the input list in the output list, in the same order. The output list is cleared first.
+//Each thread builds the nodes for its own chunk, and the chunks are then joined together in O(1) each. Out of date checkpoints on the input are rebuilt first
+template<typename T, typename U, typename Func>
+void parallel_transform(linked_list<T>& input, linked_list<U>& output, Func func, int threadCount = 0)
+{
+	auto chunks = input.split(parallel_impl::resolve_thread_count(threadCount, input.getSize()));
+	parallel_impl::transform_chunks(chunks, output, func);
+}
+
+//Stores "func(value)" for every value of the input list in the output list, in the same order. See the non-const overload.
+//Out of date checkpoints are not rebuilt, since the input is const
+template<typename T, typename U, typename Func>
+void parallel_transform(const linked_list<T>& input, linked_list<U>& output, Func func, int threadCount = 0)
+{
+	auto chunks = input.split(parallel_impl::resolve_thread_count(threadCount, input.getSize()));
+	parallel_impl::transform_chunks(chunks, output, func);
+}
@@ -0,0 +1,359 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+#include <vector>
+#include <struct_exception.h>
+
+//The shared parts of the trees that are built by path copying (concurrent_search_tree and persistent_search_tree).
+//A node of these trees is never changed once it is part of a version of the tree that others can see. A write copies the nodes on the path it changes,
+//rebalances the copies as an AVL tree, and returns the root of the new version. The old version is still whole, and shares every node off the path with the new one
+namespace path_copy_impl
+{
+	//Returns a version number that no other write has used, in any tree. Copies of a tree share nodes, so the numbers have to be unique across every tree,
+	//or a write to one copy could take a node stamped by a write to another copy as its own and change it in place
+	inline std::uint64_t next_write_version()
+	{
+		static std::atomic<std::uint64_t> lastVersion{ 0 };
+		return lastVersion.fetch_add(1, std::memory_order_relaxed) + 1;
+	}
+
+	//Represents a node in a path copied tree
+	template<typename T>
+	struct node {
+		T data;
+		node* leftChild = nullptr;
+		node* rightChild = nullptr;
+		int height = 1;
+		//How many parents and roots point to the node. Only used by trees that free nodes by counting references
+		std::atomic<int> references{ 1 };
+		//The write that created the node. Nodes created by the current write aren't part of any version yet, so the write can still change them
+		std::uint64_t version;
+
+		template<typename DataType>
+		node(DataType&& data, std::uint64_t version) :
+			data(std::forward<DataType>(data)),
+			version(version) {}
+
+		//Copies a node, so the copy can be changed by a write
+		node(const node& other, std::uint64_t version) :
+			data(other.data),
+			leftChild(other.leftChild),
+			rightChild(other.rightChild),
+			height(other.height),
+			version(version) {}
+	};
+
+	//A read-only iterator over the values of one version of a tree, in sorted order. The nodes don't point to their parents, since a node can be shared by many versions,
+	//so the iterator keeps the path of nodes it still has to come back to
+	template<typename T>
+	class const_iterator {
+		//The nodes whose values haven't been visited yet, on the way back up. The top of the stack is the current node
+		std::vector<const node<T>*> path;
+
+		//Adds a node and its chain of left children to the path
+		void pushLeft(const node<T>* n)
+		{
+			for (; n != nullptr; n = n->leftChild)
+			{
+				path.push_back(n);
+			}
+		}
+
+	public:
+		//These type definitions are required for iterators
+		using value_type = T;
+		using reference = const T&;
+		using pointer = const T*;
+		using iterator_category = std::forward_iterator_tag;
+		using difference_type = std::ptrdiff_t;
+
+		//Creates an end iterator
+		const_iterator() = default;
+
+		//Creates an iterator to the smallest value under a root
+		explicit const_iterator(const node<T>* root)
+		{
+			pushLeft(root);
+		}
+
+		//Creates an iterator to the first value under a root where "goLeft(value)" is true. "goLeft" must be false for every value before some point, and true after it
+		template<typename GoLeft>
+		const_iterator(const node<T>* root, GoLeft goLeft)
+		{
+			//Only the nodes where the search goes left come after the result, so only they are added to the path
+			while (root != nullptr)
+			{
+				if (goLeft(root->data))
+				{
+					path.push_back(root);
+					root = root->leftChild;
+				}
+				else
+				{
+					root = root->rightChild;
+				}
+			}
+		}
+
+		//Moves to the next value in sorted order
+		const_iterator& operator++()
+		{
+			if (path.empty())
+			{
+				throw struct_exception("Cannot iterate past the end of the tree");
+			}
+			const node<T>* current = path.back();
+			path.pop_back();
+			pushLeft(current->rightChild);
+			return *this;
+		}
+
+		const_iterator operator++(int)
+		{
+			const_iterator previous = *this;
+			++(*this);
+			return previous;
+		}
+
+		const T& operator*() const
+		{
+			return path.back()->data;
+		}
+
+		const T* operator->() const
+		{
+			return &path.back()->data;
+		}
+
+		//Two iterators are equal if they point to the same node, or are both at the end
+		bool operator==(const const_iterator& rhs) const
+		{
+			return path.empty() ? rhs.path.empty() : (!rhs.path.empty() && path.back() == rhs.path.back());
+		}
+
+		bool operator!=(const const_iterator& rhs) const
+		{
+			return !(*this == rhs);
+		}
+	};
+
+	//Builds new versions of a tree by path copying. The tree that derives from this decides when the old nodes can be freed
+	template<typename T, typename Comparer>
+	class path_copy_tree {
+	protected:
+		using node_type = node<T>;
+
+		Comparer comparer;
+		//The version of the current write, so the nodes created by the write can be told apart from the nodes of earlier versions and of other trees
+		std::uint64_t writeVersion = 0;
+		//The nodes of the old version that the current write has replaced
+		std::vector<node_type*> replaced;
+		//The nodes that the current write has created. Every one of them ends up in the new version
+		std::vector<node_type*> created;
+
+		path_copy_tree(Comparer&& comp) : comparer(std::move(comp)) {}
+
+		//Finds a value under a root. Returns nullptr if the value isn't there
+		template<typename DataType>
+		const node_type* findNode(const node_type* current, const DataType& data) const
+		{
+			while (current != nullptr)
+			{
+				if (comparer(data, current->data))
+				{
+					current = current->leftChild;
+				}
+				else if (comparer(current->data, data))
+				{
+					current = current->rightChild;
+				}
+				else
+				{
+					return current;
+				}
+			}
+			return nullptr;
+		}
+
+		//Returns true if a node was created by the current write
+		bool isNew(const node_type* n) const
+		{
+			return n->version == writeVersion;
+		}
+
+		//Creates a node for the current write
+		template<typename... Args>
+		node_type* createNode(Args&&... args)
+		{
+			created.reserve(created.size() + 1);
+			node_type* newNode = new node_type(std::forward<Args>(args)..., writeVersion);
+			created.push_back(newNode);
+			return newNode;
+		}
+
+		//Returns a version of a node that the current write can change. Nodes created by this write are returned as they are, and older nodes are copied
+		node_type* writable(node_type* n)
+		{
+			if (isNew(n))
+			{
+				return n;
+			}
+			replaced.reserve(replaced.size() + 1);
+			node_type* copy = createNode(static_cast<const node_type&>(*n));
+			replaced.push_back(n);
+			return copy;
+		}
+
+		//Marks an older node as removed from the new version
+		void discard(node_type* n)
+		{
+			replaced.push_back(n);
+		}
+
+		static int heightOf(const node_type* n)
+		{
+			return n != nullptr ? n->height : 0;
+		}
+
+		static void updateHeight(node_type* n)
+		{
+			int leftHeight = heightOf(n->leftChild);
+			int rightHeight = heightOf(n->rightChild);
+			n->height = (leftHeight > rightHeight ? leftHeight : rightHeight) + 1;
+		}
+
+		//Rotates a writable node to the right and returns the node that takes its place. The left child is copied if it is an older node
+		node_type* rightRotation(node_type* y)
+		{
+			node_type* x = writable(y->leftChild);
+			y->leftChild = x->rightChild;
+			x->rightChild = y;
+			updateHeight(y);
+			updateHeight(x);
+			return x;
+		}
+
+		//Rotates a writable node to the left and returns the node that takes its place. The right child is copied if it is an older node
+		node_type* leftRotation(node_type* x)
+		{
+			node_type* y = writable(x->rightChild);
+			x->rightChild = y->leftChild;
+			y->leftChild = x;
+			updateHeight(x);
+			updateHeight(y);
+			return y;
+		}
+
+		//Rebalances a writable node whose subtrees differ in height by at most two, and returns the node that takes its place
+		node_type* rebalance(node_type* n)
+		{
+			updateHeight(n);
+			int balance = heightOf(n->leftChild) - heightOf(n->rightChild);
+			if (balance > 1)
+			{
+				if (heightOf(n->leftChild->leftChild) < heightOf(n->leftChild->rightChild))
+				{
+					n->leftChild = leftRotation(writable(n->leftChild));
+				}
+				return rightRotation(n);
+			}
+			if (balance < -1)
+			{
+				if (heightOf(n->rightChild->rightChild) < heightOf(n->rightChild->leftChild))
+				{
+					n->rightChild = rightRotation(writable(n->rightChild));
+				}
+				return leftRotation(n);
+			}
+			return n;
+		}
+
+		//Inserts a value that isn't in the subtree yet. Every node on the path is copied. Returns the new root of the subtree
+		template<typename DataType>
+		node_type* insertAt(node_type* n, DataType&& data)
+		{
+			if (n == nullptr)
+			{
+				return createNode(std::forward<DataType>(data));
+			}
+			n = writable(n);
+			if (comparer(data, n->data))
+			{
+				n->leftChild = insertAt(n->leftChild, std::forward<DataType>(data));
+			}
+			else
+			{
+				n->rightChild = insertAt(n->rightChild, std::forward<DataType>(data));
+			}
+			return rebalance(n);
+		}
+
+		//Removes the smallest node of a subtree and copies its value into "smallest". Returns the new root of the subtree
+		node_type* removeMinimum(node_type* n, T& smallest)
+		{
+			if (n->leftChild == nullptr)
+			{
+				smallest = n->data;
+				discard(n);
+				return n->rightChild;
+			}
+			n = writable(n);
+			n->leftChild = removeMinimum(n->leftChild, smallest);
+			return rebalance(n);
+		}
+
+		//Removes a value that is in the subtree. Every node on the path is copied. Returns the new root of the subtree
+		template<typename DataType>
+		node_type* removeAt(node_type* n, const DataType& data)
+		{
+			if (comparer(data, n->data))
+			{
+				n = writable(n);
+				n->leftChild = removeAt(n->leftChild, data);
+			}
+			else if (comparer(n->data, data))
+			{
+				n = writable(n);
+				n->rightChild = removeAt(n->rightChild, data);
+			}
+			//If the node has at most one child, then the child takes its place
+			else if (n->leftChild == nullptr || n->rightChild == nullptr)
+			{
+				discard(n);
+				return n->leftChild != nullptr ? n->leftChild : n->rightChild;
+			}
+			//Otherwise, the smallest value of the right subtree takes its place
+			else
+			{
+				n = writable(n);
+				n->rightChild = removeMinimum(n->rightChild, n->data);
+			}
+			return rebalance(n);
+		}
+
+		//Runs a write on the version of the tree under "current", and returns the root of the new version. The old version is left unchanged.
+		//If the write throws, every node it created is deleted again
+		template<typename Write>
+		node_type* copyPath(node_type* current, Write&& write)
+		{
+			writeVersion = next_write_version();
+			replaced.clear();
+			created.clear();
+			try
+			{
+				return write(current);
+			}
+			catch (...)
+			{
+				for (node_type* n : created)
+				{
+					delete n;
+				}
+				throw;
+			}
+		}
+	};
+}
@@ -0,0 +1,243 @@
+#pragma once
+#include <atomic>
+#include <functional>
+#include <ostream>
+#include <utility>
+#include <vector>
+#include <common.h>
+#include <path_copying.h>
+
+//A sorted set of unique items where taking a snapshot is O(1). Copying the tree doesn't copy any nodes. The copy shares the nodes of the original,
+//and each node counts how many parents and trees point to it. A change copies only the O(log n) nodes on the path it changes (path copying), so every other copy
+//keeps seeing the values it had, and the nodes that no copy needs anymore are freed. This is useful for consistent reads while the tree keeps changing, and for undo.
+//The tree is balanced as an AVL tree. Different copies can be used by different threads, since the shared nodes are never changed and the counts are atomic,
+//but a single copy can't be changed by one thread while other threads use it
+template<typename T, typename Comparer = std::function<bool(const T&, const T&)>>
+class persistent_search_tree : path_copy_impl::path_copy_tree<T, Comparer> {
+	using base = path_copy_impl::path_copy_tree<T, Comparer>;
+	using node = typename base::node_type;
+
+	//The root of this version of the tree
+	node* root = nullptr;
+	//How many values are in this version of the tree
+	int treeSize = 0;
+
+	//Adds a reference to a node
+	static void retain(node* n)
+	{
+		if (n != nullptr)
+		{
+			n->references.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	//Removes a reference from a node. If it was the last one, then the node is deleted, and the references it held to its children are removed too
+	static void release(node* n)
+	{
+		while (n != nullptr && n->references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			release(n->leftChild);
+			//Loop on the right child instead of recursing, so a long chain of right children doesn't use up the stack
+			node* right = n->rightChild;
+			delete n;
+			n = right;
+		}
+	}
+
+	//Runs a write on this version of the tree and makes the result the new version. If the write throws, the tree is left unchanged
+	template<typename Write>
+	void commit(Write&& write, int sizeChange)
+	{
+		node* newRoot = this->copyPath(root, std::forward<Write>(write));
+
+		//The new nodes now point to older nodes that other versions may share, so those nodes get another reference
+		for (node* n : this->created)
+		{
+			if (n->leftChild != nullptr && !this->isNew(n->leftChild))
+			{
+				retain(n->leftChild);
+			}
+			if (n->rightChild != nullptr && !this->isNew(n->rightChild))
+			{
+				retain(n->rightChild);
+			}
+		}
+		if (newRoot != nullptr && !this->isNew(newRoot))
+		{
+			retain(newRoot);
+		}
+
+		//Letting go of the old root frees every node that only the old version was using
+		node* oldRoot = root;
+		root = newRoot;
+		treeSize += sizeChange;
+		release(oldRoot);
+	}
+
+public:
+	//A read-only iterator over the values of the tree, in sorted order. Changing the tree invalidates its iterators, but not the iterators of its copies
+	using const_iterator = path_copy_impl::const_iterator<T>;
+	using iterator = const_iterator;
+
+	//Default constructor for a persistent search tree
+	persistent_search_tree() : base(sorting_impl::DefaultComparer<T>) {}
+
+	persistent_search_tree(Comparer&& comp) : base(std::move(comp)) {}
+
+	//Copies the tree in O(1). The copy shares every node with the original, and only the nodes that either of them changes later get copied
+	persistent_search_tree(const persistent_search_tree<T, Comparer>& toCopy) : base(Comparer(toCopy.comparer)), root(toCopy.root), treeSize(toCopy.treeSize)
+	{
+		retain(root);
+	}
+
+	persistent_search_tree(persistent_search_tree<T, Comparer>&& toMove) noexcept : base(std::move(toMove.comparer)), root(toMove.root), treeSize(toMove.treeSize)
+	{
+		toMove.root = nullptr;
+		toMove.treeSize = 0;
+	}
+
+	persistent_search_tree<T, Comparer>& operator=(const persistent_search_tree<T, Comparer>& toCopy)
+	{
+		//Retain first, so assigning a tree to itself or to a copy of itself doesn't free any nodes
+		retain(toCopy.root);
+		release(root);
+		root = toCopy.root;
+		treeSize = toCopy.treeSize;
+		this->comparer = toCopy.comparer;
+		return *this;
+	}
+
+	persistent_search_tree<T, Comparer>& operator=(persistent_search_tree<T, Comparer>&& toMove) noexcept
+	{
+		if (&toMove != this)
+		{
+			release(root);
+			root = toMove.root;
+			treeSize = toMove.treeSize;
+			this->comparer = std::move(toMove.comparer);
+			toMove.root = nullptr;
+			toMove.treeSize = 0;
+		}
+		return *this;
+	}
+
+	~persistent_search_tree()
+	{
+		release(root);
+	}
+
+	//Returns a copy of the current version of the tree in O(1). The snapshot never changes, even while this tree does
+	persistent_search_tree<T, Comparer> snapshot() const
+	{
+		return *this;
+	}
+
+	//Inserts a value into the tree, copying the O(log n) nodes on its path. Returns false if the value is already in the tree
+	template<typename DataType>
+	bool insert(DataType&& data)
+	{
+		//Check first, so nothing is copied if the value is already in the tree
+		if (this->findNode(root, data) != nullptr)
+		{
+			return false;
+		}
+		commit([this, &data](node* current) { return this->insertAt(current, std::forward<DataType>(data)); }, 1);
+		return true;
+	}
+
+	//Removes a value from the tree, copying the O(log n) nodes on its path. Returns false if the value is not in the tree
+	template<typename DataType>
+	bool remove(const DataType& data)
+	{
+		if (this->findNode(root, data) == nullptr)
+		{
+			return false;
+		}
+		commit([this, &data](node* current) { return this->removeAt(current, data); }, -1);
+		return true;
+	}
+
+	//Removes every value from the tree. Copies of the tree keep their values
+	void clear()
+	{
+		release(root);
+		root = nullptr;
+		treeSize = 0;
+	}
+
+	//Returns true if the value is in the tree
+	template<typename DataType>
+	bool contains(const DataType& data) const
+	{
+		return this->findNode(root, data) != nullptr;
+	}
+
+	//Attempts to find data in the tree and returns an iterator to that data. If the data could not be found, then the end() iterator is returned
+	const_iterator find(const T& data) const
+	{
+		const_iterator result = lower_bound(data);
+		if (result != end() && this->comparer(data, *result))
+		{
+			return end();
+		}
+		return result;
+	}
+
+	//Returns an iterator to the first value that is not less than "data". Returns end() if every value is less than "data"
+	const_iterator lower_bound(const T& data) const
+	{
+		return const_iterator(root, [this, &data](const T& value) { return !this->comparer(value, data); });
+	}
+
+	//Returns an iterator to the first value that is greater than "data". Returns end() if no value is greater than "data"
+	const_iterator upper_bound(const T& data) const
+	{
+		return const_iterator(root, [this, &data](const T& value) { return static_cast<bool>(this->comparer(data, value)); });
+	}
+
+	//Get the beginning iterator, which points to the smallest value
+	const_iterator begin() const
+	{
+		return const_iterator(root);
+	}
+
+	//Gets the ending iterator
+	const_iterator end() const
+	{
+		return const_iterator();
+	}
+
+	//Gets how many values are in the tree
+	int getSize() const
+	{
+		return treeSize;
+	}
+
+	//Returns true if two trees are the same version, which means they share their root node and have the same values. This takes O(1) time
+	bool sharesRootWith(const persistent_search_tree<T, Comparer>& other) const
+	{
+		return root == other.root;
+	}
+
+	//Returns a vector with all the values traversed from lowest to largest value
+	std::vector<T> traverse() const
+	{
+		return std::vector<T>(begin(), end());
+	}
+};
+
+//Used for printing the tree to a stream
+template<typename T, typename Comparer>
+std::ostream& operator<<(std::ostream& stream, const persistent_search_tree<T, Comparer>& tree)
+{
+	stream << "[";
+	for (auto i = tree.begin(); i != tree.end(); ++i)
+	{
+		if (i != tree.begin())
+		{
+			stream << ", ";
+		}
+		stream << *i;
+	}
+	return stream << "]";
+}
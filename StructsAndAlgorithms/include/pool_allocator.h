@@ -0,0 +1,224 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+//This namespace contains implementation details
+namespace pool_impl
+{
+	//The first slab holds this many objects. Each new slab is twice as large as the last, up to MaxSlabObjects
+	constexpr std::size_t MinSlabObjects = 64;
+	constexpr std::size_t MaxSlabObjects = 65536;
+
+	//An object that has been freed. It stores a pointer to the next freed object in the same memory
+	struct free_slot {
+		free_slot* next;
+	};
+
+	//The state of a pool. Shared by every copy of an allocator, including copies that have been converted to allocate a different type.
+	//The size of the objects in the slabs is decided by the first object that is allocated, and objects of any other size are passed on to operator new
+	class pool_state {
+		//Every slab that has been allocated
+		std::vector<void*> slabs;
+		//The first freed object
+		free_slot* freeList = nullptr;
+		//The next object in the newest slab that has never been handed out
+		unsigned char* next = nullptr;
+		//The end of the newest slab
+		unsigned char* end = nullptr;
+		//How many objects the next slab will hold
+		std::size_t nextSlabObjects = MinSlabObjects;
+		//The size and alignment of each object in a slab. These are 0 until the first object is allocated
+		std::size_t slotSize = 0;
+		std::size_t slotAlignment = 0;
+
+		//Allocates a new slab and makes it the newest slab
+		void addSlab()
+		{
+			slabs.reserve(slabs.size() + 1);
+			void* slab = ::operator new(slotSize * nextSlabObjects, std::align_val_t(slotAlignment));
+			slabs.push_back(slab);
+			next = static_cast<unsigned char*>(slab);
+			end = next + slotSize * nextSlabObjects;
+			if (nextSlabObjects < MaxSlabObjects)
+			{
+				nextSlabObjects *= 2;
+			}
+		}
+
+	public:
+		pool_state() = default;
+		pool_state(const pool_state&) = delete;
+		pool_state& operator=(const pool_state&) = delete;
+
+		~pool_state()
+		{
+			release();
+		}
+
+		//Returns true if objects of this size and alignment are stored in the slabs
+		bool uses_slabs(std::size_t size, std::size_t alignment)
+		{
+			//A slot has to be able to hold either an object or a free_slot
+			if (alignment < alignof(free_slot))
+			{
+				alignment = alignof(free_slot);
+			}
+			if (size < sizeof(free_slot))
+			{
+				size = sizeof(free_slot);
+			}
+			size = (size + alignment - 1) / alignment * alignment;
+
+			if (slotSize == 0)
+			{
+				slotSize = size;
+				slotAlignment = alignment;
+			}
+			return size == slotSize && alignment == slotAlignment;
+		}
+
+		//Takes an object from the free list, or from the newest slab if the free list is empty
+		void* allocate()
+		{
+			if (freeList != nullptr)
+			{
+				free_slot* slot = freeList;
+				freeList = slot->next;
+				return slot;
+			}
+
+			if (next == end)
+			{
+				addSlab();
+			}
+			void* result = next;
+			next += slotSize;
+			return result;
+		}
+
+		//Adds an object to the free list
+		void deallocate(void* pointer) noexcept
+		{
+			freeList = ::new (pointer) free_slot{ freeList };
+		}
+
+		//Frees every slab and resets the pool
+		void release() noexcept
+		{
+			for (void* slab : slabs)
+			{
+				::operator delete(slab, std::align_val_t(slotAlignment));
+			}
+			slabs.clear();
+			freeList = nullptr;
+			next = nullptr;
+			end = nullptr;
+			nextSlabObjects = MinSlabObjects;
+		}
+
+		//Gets how many slabs have been allocated
+		std::size_t getSlabCount() const
+		{
+			return slabs.size();
+		}
+	};
+
+	//Checks if an allocator can free all of its memory at once with a "release_all()" function
+	template<typename Allocator, typename = void>
+	struct has_release_all : std::false_type {};
+
+	template<typename Allocator>
+	struct has_release_all<Allocator, decltype(void(std::declval<Allocator&>().release_all()))> : std::true_type {};
+}
+
+//An allocator that hands out single objects from large blocks of memory (slabs), and keeps freed objects in a free list so they can be reused.
+//Objects that are allocated one after another end up next to each other in memory, and allocating or freeing an object only takes a few instructions.
+//Copies of the allocator share the same pool. Allocations of more than one object at a time are passed on to operator new.
+//The pool is not thread-safe, so an allocator and its copies should only be used by one thread at a time
+template<typename T>
+class pool_allocator {
+	template<typename U>
+	friend class pool_allocator;
+
+	std::shared_ptr<pool_impl::pool_state> state;
+
+public:
+	using value_type = T;
+	//A copy of a container gets its own pool, and a pool moves along with the container that owns it
+	using propagate_on_container_copy_assignment = std::false_type;
+	using propagate_on_container_move_assignment = std::true_type;
+	using propagate_on_container_swap = std::true_type;
+	using is_always_equal = std::false_type;
+
+	//Creates an allocator with a new, empty pool
+	pool_allocator() : state(std::make_shared<pool_impl::pool_state>()) {}
+
+	pool_allocator(const pool_allocator<T>& other) noexcept = default;
+	pool_allocator<T>& operator=(const pool_allocator<T>& other) noexcept = default;
+
+	//Converts an allocator for a different type. Both allocators share the same pool
+	template<typename U>
+	pool_allocator(const pool_allocator<U>& other) noexcept : state(other.state) {}
+
+	//Allocates memory for "count" objects
+	T* allocate(std::size_t count)
+	{
+		if (count == 1 && state->uses_slabs(sizeof(T), alignof(T)))
+		{
+			return static_cast<T*>(state->allocate());
+		}
+		return static_cast<T*>(::operator new(sizeof(T) * count, std::align_val_t(alignof(T))));
+	}
+
+	//Frees memory for "count" objects. Single objects are added to the free list of the pool
+	void deallocate(T* pointer, std::size_t count) noexcept
+	{
+		if (count == 1 && state->uses_slabs(sizeof(T), alignof(T)))
+		{
+			state->deallocate(pointer);
+			return;
+		}
+		::operator delete(pointer, std::align_val_t(alignof(T)));
+	}
+
+	//Frees every slab at once, without destroying any objects. This is only done if no other allocators share the pool.
+	//Returns false if the pool is shared, in which case nothing is freed. The caller must make sure no objects in the pool are still being used
+	bool release_all() noexcept
+	{
+		if (state.use_count() != 1)
+		{
+			return false;
+		}
+		state->release();
+		return true;
+	}
+
+	//Gets how many slabs the pool has allocated
+	std::size_t getSlabCount() const
+	{
+		return state->getSlabCount();
+	}
+
+	//A copy of a container gets a new pool instead of sharing the pool of the original
+	pool_allocator<T> select_on_container_copy_construction() const
+	{
+		return pool_allocator<T>();
+	}
+
+	//Two allocators are equal if they share the same pool
+	template<typename U>
+	bool operator==(const pool_allocator<U>& other) const noexcept
+	{
+		return state == other.state;
+	}
+
+	template<typename U>
+	bool operator!=(const pool_allocator<U>& other) const noexcept
+	{
+		return state != other.state;
+	}
+};
@@ -0,0 +1,713 @@
+#pragma once
+#include <type_traits>
+#include <initializer_list>
+#include <ostream>
+#include <common.h>
+#include <struct_exception.h>
+#include <functional>
+#include <utility>
+#include <new>
+#include <cstdint>
+
+//An ordered list of unique items. Each node is linked to the next node on several "levels", where each higher level skips over more nodes than the one below it.
+//This gives an expected O(log n) search, insert and remove without needing any rotations or parent pointers
+template<typename T, typename Comparer = std::function<bool(const T&, const T&)>>
+class skip_list {
+public:
+	//The maximum amount of levels a node can have. With a 1/2 promotion chance, this is enough for billions of elements
+	static constexpr int MaxLevel = 32;
+
+	//Represents a node in the skip list
+	struct node {
+		//The value of the node
+		T value;
+		//A pointer to the previous node on the bottom level
+		node* prev;
+		//How many levels this node is linked on
+		int levels;
+		//The pointers to the next node on each level. This array is allocated directly after the node
+		node** next;
+
+		node(const T& val, node* prevPtr, int levelCount, node** nextPtrs) :
+			value(val),
+			prev(prevPtr),
+			levels(levelCount),
+			next(nextPtrs) {}
+
+		node(T&& val, node* prevPtr, int levelCount, node** nextPtrs) :
+			value(std::move(val)),
+			prev(prevPtr),
+			levels(levelCount),
+			next(nextPtrs) {}
+	};
+
+	//Represents an iterator for iterating over all the nodes in a skip_list in sorted order
+	template<bool is_const>
+	class node_iterator_base {
+
+		friend node_iterator_base<!is_const>;
+		friend class skip_list<T, Comparer>;
+
+		using list_type = make_const_if_true<skip_list<T, Comparer>, is_const>;
+
+		//The node this iterator is currently accessing
+		node* _node;
+		//The list the node came from
+		list_type* _list;
+
+	public:
+		using value_type = T;
+		using reference = const T&;
+		using pointer = const T*;
+		using iterator_category = std::bidirectional_iterator_tag;
+		using difference_type = int;
+
+		node_iterator_base(node* node, list_type* list) : _node(node), _list(list) {}
+
+		//An implicit conversion for turning non-const iterators into const versions
+		template<bool other_const, typename = typename std::enable_if<is_const || !other_const>::type>
+		node_iterator_base(const node_iterator_base<other_const>& other) : _node(other._node), _list(other._list) {}
+
+		//Pre-increments the iterator to the next value
+		node_iterator_base<is_const>& operator++()
+		{
+			//If we are at the end of the list
+			if (_node == nullptr)
+			{
+				//We can't iterate past it
+				throw struct_exception("Attempting to iterate past the end of the list");
+			}
+
+			//Move to the next node on the bottom level
+			_node = _node->next[0];
+			//Return the iterator
+			return *this;
+		}
+		//Post-increments the iterator to the next value
+		node_iterator_base<is_const> operator++(int)
+		{
+			//Store the current state of the iterator
+			node_iterator_base<is_const> previousState = *this;
+			//Move to the next node
+			this->operator++();
+			//Return the previous state of the iterator
+			return previousState;
+		}
+
+		//Pre-decrements the iterator to the previous value
+		node_iterator_base<is_const>& operator--()
+		{
+			//If the node is nullptr, then the iterator refers to the element past the end of the list
+			if (_node == nullptr)
+			{
+				//Set this iterator to the last VALID node in the list
+				_node = _list->last;
+
+				//If the last element is null, then the list is empty
+				if (_node == nullptr)
+				{
+					throw struct_exception("Attempting to iterate over an empty skip list");
+				}
+			}
+			//If there is no previous element, then we are at the beginning already
+			else if (_node->prev == nullptr)
+			{
+				throw struct_exception("Attempting to iterate past the beginning of the list");
+			}
+			//Set the node to the previous element
+			else
+			{
+				_node = _node->prev;
+			}
+			//Return a reference to the iterator
+			return *this;
+		}
+		//Post-decrements the iterator to the previous value
+		node_iterator_base<is_const> operator--(int)
+		{
+			//Store the current state of the iterator
+			node_iterator_base<is_const> previousState = *this;
+			//Move to the previous node
+			this->operator--();
+			//Return the previous state of the iterator
+			return previousState;
+		}
+
+		//Used to get the value of the iterator
+		//This needs to be const because modifying the value in the list would break its ordering
+		reference operator*() const
+		{
+			//Return a reference to the value
+			return _node->value;
+		}
+		//Used for dereferencing the value
+		//This needs to be const because modifying the value in the list would break its ordering
+		pointer operator->() const
+		{
+			//Return a pointer to the value
+			return &_node->value;
+		}
+
+		node* get_node() const {
+			return _node;
+		}
+
+		//Tests for equality
+		template <bool other_const>
+		bool operator==(const node_iterator_base<other_const>& rhs) const
+		{
+			return rhs._node == _node && rhs._list == _list;
+		}
+		//Tests for inequality
+		template <bool other_const>
+		bool operator!=(const node_iterator_base<other_const>& rhs) const
+		{
+			return rhs._node != _node || rhs._list != _list;
+		}
+	};
+
+	using const_node_iterator = node_iterator_base<true>;
+	using node_iterator = node_iterator_base<false>;
+
+	using iterator = node_iterator;
+	using const_iterator = const_node_iterator;
+
+	//A pair of iterators representing the half-open range [begin, end)
+	template<typename IteratorType>
+	class range_view {
+		IteratorType _begin;
+		IteratorType _end;
+	public:
+		range_view(IteratorType begin, IteratorType end) : _begin(begin), _end(end) {}
+
+		IteratorType begin() const {
+			return _begin;
+		}
+
+		IteratorType end() const {
+			return _end;
+		}
+
+		//Returns true if the range has no elements
+		bool empty() const {
+			return _begin == _end;
+		}
+	};
+
+private:
+	//The first node on each level. Only the first "level" entries are in use
+	node* head[MaxLevel] = {};
+	//The last node on the bottom level
+	node* last = nullptr;
+	//How many levels are currently in use
+	int level = 1;
+	//How many nodes are in the list
+	int size = 0;
+	//The state of the random number generator used to pick node levels
+	std::uint64_t randomState = 0x9E3779B97F4A7C15ull;
+	Comparer comparer;
+
+	//Picks how many levels a new node will be linked on. Each extra level has a 1/2 chance
+	int randomLevel()
+	{
+		//Advance the xorshift generator
+		randomState ^= randomState << 13;
+		randomState ^= randomState >> 7;
+		randomState ^= randomState << 17;
+
+		//Count the trailing one bits of the random number
+		std::uint64_t bits = randomState;
+		int newLevel = 1;
+		while ((bits & 1) != 0 && newLevel < MaxLevel)
+		{
+			++newLevel;
+			bits >>= 1;
+		}
+		return newLevel;
+	}
+
+	//Allocates a node along with its array of next pointers in a single allocation
+	template<typename DataType>
+	node* createNode(DataType&& data, node* prev, int levels)
+	{
+		void* memory = ::operator new(sizeof(node) + sizeof(node*) * levels);
+		node** nextPtrs = reinterpret_cast<node**>(static_cast<char*>(memory) + sizeof(node));
+		try
+		{
+			return new (memory) node(std::forward<DataType>(data), prev, levels, nextPtrs);
+		}
+		//If the value could not be constructed
+		catch (...)
+		{
+			//Free the memory to avoid a memory leak and rethrow the exception
+			::operator delete(memory);
+			throw;
+		}
+	}
+
+	//Destroys a node that was created with createNode
+	static void destroyNode(node* n)
+	{
+		n->~node();
+		::operator delete(static_cast<void*>(n));
+	}
+
+	//Gets the array of next pointers for a node, or the head array if the node is null
+	node** forwardLinks(node* n)
+	{
+		return n == nullptr ? head : n->next;
+	}
+
+	//Finds the last node on each level that is less than the value and stores it in "predecessors". Returns the first node that is not less than the value
+	template<typename DataType>
+	node* findPredecessors(const DataType& data, node** predecessors)
+	{
+		node* current = nullptr;
+		for (int i = level - 1; i >= 0; i--)
+		{
+			//Move forward on this level until the next node is not less than the value
+			node* next = forwardLinks(current)[i];
+			while (next != nullptr && comparer(next->value, data))
+			{
+				current = next;
+				next = current->next[i];
+			}
+			predecessors[i] = current;
+		}
+		return forwardLinks(current)[0];
+	}
+
+	//Finds the first node that is not less than the value
+	template<typename DataType>
+	node* lowerBound(const DataType& data) const
+	{
+		const node* current = nullptr;
+		node* next = nullptr;
+		for (int i = level - 1; i >= 0; i--)
+		{
+			//Move forward on this level until the next node is not less than the value
+			next = current == nullptr ? head[i] : current->next[i];
+			while (next != nullptr && comparer(next->value, data))
+			{
+				current = next;
+				next = current->next[i];
+			}
+		}
+		return next;
+	}
+
+	//Finds the first node that is greater than the value
+	template<typename DataType>
+	node* upperBound(const DataType& data) const
+	{
+		const node* current = nullptr;
+		node* next = nullptr;
+		for (int i = level - 1; i >= 0; i--)
+		{
+			//Move forward on this level while the next node is not greater than the value
+			next = current == nullptr ? head[i] : current->next[i];
+			while (next != nullptr && !comparer(data, next->value))
+			{
+				current = next;
+				next = current->next[i];
+			}
+		}
+		return next;
+	}
+
+	//Inserts a new value into the list. Returns nullptr if the value is already in the list
+	template<typename DataType>
+	node* insertNode(DataType&& data)
+	{
+		node* predecessors[MaxLevel];
+		node* existing = findPredecessors(data, predecessors);
+
+		//If the value is equal to an existing node, then it can't be inserted
+		if (existing != nullptr && !comparer(data, existing->value))
+		{
+			return nullptr;
+		}
+
+		int newLevel = randomLevel();
+		//If the new node is taller than the rest of the list, then the new levels start from the head
+		for (int i = level; i < newLevel; i++)
+		{
+			predecessors[i] = nullptr;
+		}
+		if (newLevel > level)
+		{
+			level = newLevel;
+		}
+
+		node* newNode = createNode(std::forward<DataType>(data), predecessors[0], newLevel);
+
+		//Link the node in on each of its levels
+		for (int i = 0; i < newLevel; i++)
+		{
+			node** links = forwardLinks(predecessors[i]);
+			newNode->next[i] = links[i];
+			links[i] = newNode;
+		}
+
+		//Update the back pointer of the node after the new one
+		if (newNode->next[0] != nullptr)
+		{
+			newNode->next[0]->prev = newNode;
+		}
+		else
+		{
+			last = newNode;
+		}
+
+		size++;
+		return newNode;
+	}
+
+	//Removes the node with the specified value. Returns true if a node has been removed
+	template<typename DataType>
+	bool removeNode(const DataType& data)
+	{
+		node* predecessors[MaxLevel];
+		node* target = findPredecessors(data, predecessors);
+
+		//If the value isn't in the list, then there is nothing to remove
+		if (target == nullptr || comparer(data, target->value))
+		{
+			return false;
+		}
+
+		//Unlink the node from each of its levels
+		for (int i = 0; i < target->levels; i++)
+		{
+			forwardLinks(predecessors[i])[i] = target->next[i];
+		}
+
+		//Update the back pointer of the node after the removed one
+		if (target->next[0] != nullptr)
+		{
+			target->next[0]->prev = target->prev;
+		}
+		else
+		{
+			last = target->prev;
+		}
+
+		//Drop any levels that are now empty
+		while (level > 1 && head[level - 1] == nullptr)
+		{
+			level--;
+		}
+
+		destroyNode(target);
+		size--;
+		return true;
+	}
+
+	//Appends a value that is known to be larger than every value in the list. "tails" stores the last node on each level
+	template<typename DataType>
+	void appendNode(DataType&& data, node** tails)
+	{
+		int newLevel = randomLevel();
+		for (int i = level; i < newLevel; i++)
+		{
+			tails[i] = nullptr;
+		}
+		if (newLevel > level)
+		{
+			level = newLevel;
+		}
+
+		node* newNode = createNode(std::forward<DataType>(data), last, newLevel);
+		for (int i = 0; i < newLevel; i++)
+		{
+			newNode->next[i] = nullptr;
+			forwardLinks(tails[i])[i] = newNode;
+			tails[i] = newNode;
+		}
+		last = newNode;
+		size++;
+	}
+
+	//Copies the contents of another list. The other list is already sorted, so every value can be appended in O(1)
+	void copyFrom(const skip_list<T, Comparer>& toCopy)
+	{
+		node* tails[MaxLevel] = {};
+		for (const node* i = toCopy.head[0]; i != nullptr; i = i->next[0])
+		{
+			appendNode(i->value, tails);
+		}
+	}
+
+public:
+	//Default constructor for a skip list
+	skip_list() : comparer(sorting_impl::DefaultComparer<T>) {}
+
+	skip_list(Comparer&& comp) : comparer(std::move(comp)) {}
+
+	//Constructs a skip list from a list of items
+	skip_list(std::initializer_list<T> list) : skip_list()
+	{
+		for (const auto& value : list)
+		{
+			insert(value);
+		}
+	}
+
+	//A copy constructor for creating a new list from a copy
+	skip_list(const skip_list<T, Comparer>& toCopy) : comparer(toCopy.comparer)
+	{
+		copyFrom(toCopy);
+	}
+
+	//A move constructor for creating a new list by moving the nodes from an old list
+	skip_list(skip_list<T, Comparer>&& toMove) noexcept :
+		last(toMove.last),
+		level(toMove.level),
+		size(toMove.size),
+		randomState(toMove.randomState),
+		comparer(std::move(toMove.comparer))
+	{
+		for (int i = 0; i < MaxLevel; i++)
+		{
+			head[i] = toMove.head[i];
+			toMove.head[i] = nullptr;
+		}
+		toMove.last = nullptr;
+		toMove.level = 1;
+		toMove.size = 0;
+	}
+
+	//A copy assignment operator for making a list identical to a copy
+	skip_list<T, Comparer>& operator=(const skip_list<T, Comparer>& toCopy)
+	{
+		if (this != &toCopy)
+		{
+			clear();
+			comparer = toCopy.comparer;
+			copyFrom(toCopy);
+		}
+		return *this;
+	}
+
+	//A move assignment operator for taking the nodes of an existing list
+	skip_list<T, Comparer>& operator=(skip_list<T, Comparer>&& toMove) noexcept
+	{
+		if (this != &toMove)
+		{
+			clear();
+			for (int i = 0; i < MaxLevel; i++)
+			{
+				head[i] = toMove.head[i];
+				toMove.head[i] = nullptr;
+			}
+			last = toMove.last;
+			level = toMove.level;
+			size = toMove.size;
+			randomState = toMove.randomState;
+			comparer = std::move(toMove.comparer);
+
+			toMove.last = nullptr;
+			toMove.level = 1;
+			toMove.size = 0;
+		}
+		return *this;
+	}
+
+	~skip_list()
+	{
+		clear();
+	}
+
+	//Clears the skip list
+	void clear()
+	{
+		node* currentNode = head[0];
+		while (currentNode != nullptr)
+		{
+			node* previousNode = currentNode;
+			currentNode = currentNode->next[0];
+			destroyNode(previousNode);
+		}
+		for (int i = 0; i < MaxLevel; i++)
+		{
+			head[i] = nullptr;
+		}
+		last = nullptr;
+		level = 1;
+		size = 0;
+	}
+
+	//Inserts a new element into the list. Returns end() if the element is already in the list. Duplicates are not allowed
+	//The template parameter is to allow the function to take both rvalues and lvalues
+	template<typename DataType>
+	node_iterator insert(DataType&& data)
+	{
+		return node_iterator(insertNode(std::forward<DataType>(data)), this);
+	}
+
+	//Removes the element with the specified value. Returns true if an element has been removed
+	template<typename DataType = T>
+	bool remove(const DataType& data)
+	{
+		return removeNode(data);
+	}
+
+	//Removes the element the iterator points to. Returns true if an element has been removed
+	bool remove(const_node_iterator elementToRemove)
+	{
+		//Cannot delete the end() iterator, since that doesn't have a valid value
+		if (elementToRemove.get_node() == nullptr)
+		{
+			return false;
+		}
+		return removeNode(elementToRemove.get_node()->value);
+	}
+
+	//Removes the element the iterator points to. Returns true if an element has been removed
+	bool remove(node_iterator elementToRemove)
+	{
+		return remove(const_node_iterator(elementToRemove));
+	}
+
+	//Finds the element with the specified value. Returns end() if the value could not be found
+	template<typename DataType>
+	node_iterator find(const DataType& data)
+	{
+		node* result = lowerBound(data);
+		//If the closest node isn't equal to the value, then the value isn't in the list
+		if (result != nullptr && comparer(data, result->value))
+		{
+			result = nullptr;
+		}
+		return node_iterator(result, this);
+	}
+
+	//Finds the element with the specified value. Returns end() if the value could not be found
+	template<typename DataType>
+	const_node_iterator find(const DataType& data) const
+	{
+		node* result = lowerBound(data);
+		//If the closest node isn't equal to the value, then the value isn't in the list
+		if (result != nullptr && comparer(data, result->value))
+		{
+			result = nullptr;
+		}
+		return const_node_iterator(result, this);
+	}
+
+	//Returns true if the value is in the list
+	template<typename DataType>
+	bool contains(const DataType& data) const
+	{
+		return find(data) != end();
+	}
+
+	//Returns an iterator to the first element that is not less than the value
+	template<typename DataType>
+	node_iterator lower_bound(const DataType& data)
+	{
+		return node_iterator(lowerBound(data), this);
+	}
+
+	//Returns an iterator to the first element that is not less than the value
+	template<typename DataType>
+	const_node_iterator lower_bound(const DataType& data) const
+	{
+		return const_node_iterator(lowerBound(data), this);
+	}
+
+	//Returns an iterator to the first element that is greater than the value
+	template<typename DataType>
+	node_iterator upper_bound(const DataType& data)
+	{
+		return node_iterator(upperBound(data), this);
+	}
+
+	//Returns an iterator to the first element that is greater than the value
+	template<typename DataType>
+	const_node_iterator upper_bound(const DataType& data) const
+	{
+		return const_node_iterator(upperBound(data), this);
+	}
+
+	//Returns all the elements in the range [low, high). Finding the range is O(log n), and iterating over it is O(k)
+	template<typename DataType>
+	range_view<const_node_iterator> range(const DataType& low, const DataType& high) const
+	{
+		//If the range is backwards, then it is empty
+		if (!comparer(low, high))
+		{
+			return range_view<const_node_iterator>(end(), end());
+		}
+		return range_view<const_node_iterator>(lower_bound(low), lower_bound(high));
+	}
+
+	//Gets an iterator to the first node
+	node_iterator begin() {
+		return node_iterator(head[0], this);
+	}
+
+	//Gets an iterator to the node after the last node
+	node_iterator end() {
+		return node_iterator(nullptr, this);
+	}
+
+	//Gets an iterator to the first node
+	const_node_iterator begin() const {
+		return const_node_iterator(head[0], this);
+	}
+
+	//Gets an iterator to the node after the last node
+	const_node_iterator end() const {
+		return const_node_iterator(nullptr, this);
+	}
+
+	//Gets an iterator to the first node
+	const_node_iterator cbegin() const {
+		return const_node_iterator(head[0], this);
+	}
+
+	//Gets an iterator to the node after the last node
+	const_node_iterator cend() const {
+		return const_node_iterator(nullptr, this);
+	}
+
+	//Returns the smallest value in the list. Returns end() if the list is empty
+	const_node_iterator minimum() const {
+		return const_node_iterator(head[0], this);
+	}
+
+	//Returns the largest value in the list. Returns end() if the list is empty
+	const_node_iterator maximum() const {
+		return const_node_iterator(last, this);
+	}
+
+	//Gets how many nodes are in the skip list
+	int getSize() const
+	{
+		return size;
+	}
+
+	//Gets how many levels are currently in use
+	int getLevel() const
+	{
+		return level;
+	}
+};
+
+//Used for printing a skip_list to a stream
+template<typename T, typename Comparer>
+std::ostream& operator<<(std::ostream& os, const skip_list<T, Comparer>& list) {
+	os << '[';
+
+	for (auto i = list.cbegin(); i != list.cend(); i++) {
+		if (i != list.cbegin()) {
+			os << ", ";
+		}
+		os << *i;
+	}
+
+	os << ']';
+
+	return os;
+}
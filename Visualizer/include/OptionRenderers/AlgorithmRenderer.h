@@ -7,6 +7,7 @@
 #include <OptionRenderers/OptionRenderer.h>
 #include <functional>
 #include <linked_list.h>
+#include <mpmc_queue.h>
 
 // The following macro is used to define a template function that can take
 // different types of algorithms as arguments.
@@ -34,6 +35,18 @@ private:
     //The number thats used for inserting a new number after it
     float beforeNumber = 0.0;
 
+    //Sent from the sorting thread to the UI thread when two values have been swapped
+    struct swap_event {
+        visual_container<float>* a = nullptr;
+        visual_container<float>* b = nullptr;
+    };
+
+    //The swaps that the sorting thread has made, but the UI thread hasn't animated yet
+    mpmc_queue<swap_event> swapEvents{256};
+
+    //Swaps the positions of all the values the sorting thread has swapped since the last frame
+    void applySwapEvents();
+
     //Adds a new value to the list
     void push_front(float value);
 
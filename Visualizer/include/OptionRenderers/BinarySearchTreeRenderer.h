@@ -6,13 +6,27 @@
 #include "binary_search_tree.h"
 #include "visual_container.h"
 
+//Orders the nodes of the tree by their values. It is transparent, so the tree can be searched with a plain number instead of a visual_container
+struct visual_container_comparer {
+    using is_transparent = void;
+
+    bool operator()(const visual_container<float> &a, const visual_container<float> &b) const {
+        return a.value < b.value;
+    }
+
+    bool operator()(float a, const visual_container<float> &b) const {
+        return a < b.value;
+    }
+
+    bool operator()(const visual_container<float> &a, float b) const {
+        return a.value < b;
+    }
+};
+
 class BinarySearchTreeRenderer : public OptionRenderer {
 
 //The binary search tree to be rendered
-binary_search_tree<visual_container<float>> tree{
-    [](const visual_container<float> &a, const visual_container<float> &b) {
-        return a.value < b.value;
-    }};
+binary_search_tree<visual_container<float>, visual_container_comparer> tree{};
 
 //The result of updating node positions
 struct positionResult {
@@ -13,6 +13,7 @@
 
 void AlgorithmRenderer::update(double dt) {
     OptionRenderer::update(dt); // Call parent class update method
+    applySwapEvents(); // Move the values that the sorting thread has swapped
     for (auto& value : numberList) {
         // Use linear interpolation to update the position of each number
         value.x = Lerp(value.x, value.targetX, INTERPOLATION_SPEED * dt);
@@ -60,9 +61,9 @@ void AlgorithmRenderer::render() {
         if (ImGui::Button("Sort")) { // Add a button for sorting the list
             beginSort([&](){
                 #ifdef __cpp_lib_bind_front
-                    algorithmFunc(numberList.begin(),numberList.end(),comparerType(visualValueComparer),std::bind_front(&AlgorithmRenderer::swap, *this));
+                    algorithmFunc(numberList.begin(),numberList.end(),comparerType(visualValueComparer),std::bind_front(&AlgorithmRenderer::swap, this));
                 #else
-                    algorithmFunc(numberList.begin(),numberList.end(),comparerType(visualValueComparer),std::bind(&AlgorithmRenderer::swap,*this, std::placeholders::_1,std::placeholders::_2));
+                    algorithmFunc(numberList.begin(),numberList.end(),comparerType(visualValueComparer),std::bind(&AlgorithmRenderer::swap,this, std::placeholders::_1,std::placeholders::_2));
                 #endif
             });
         }
@@ -130,25 +131,32 @@ const std::string& AlgorithmRenderer::getName() const {
 }
 
 // Swaps two values with each other. Used for visualizing swaps
+// This runs on the sorting thread, so only the values are swapped here. The positions are swapped by the UI thread in applySwapEvents()
 void AlgorithmRenderer::swap(decltype(numberList.begin())& a, decltype(numberList.begin())& b) {
     // If the sorting is stopping, throw an exception to stop the process.
     if (stoppingSort()) {
         throw std::exception();
     }
-    // Store the value of 'a' in a temporary variable.
-    visual_container<float> temp = *a;
-    // Assign 'b' to 'a'.
-    a->value = b->value;
-    a->x = b->x;
-    a->y = b->y;
-    // Assign the temporary variable to 'b'.
-    b->value = temp.value;
-    b->x = temp.x;
-    b->y = temp.y;
+    // Swap the values, since the sorting algorithm needs to see them right away.
+    std::swap(a->value, b->value);
+    // Send the swap to the UI thread so it can animate it.
+    swapEvents.push(swap_event{&(*a), &(*b)});
     // Wait for 500 milliseconds.
     std::this_thread::sleep_for(std::chrono::milliseconds(500));
 }
 
+// Swaps the positions of all the values the sorting thread has swapped since the last frame
+void AlgorithmRenderer::applySwapEvents() {
+    swap_event events[32];
+    std::size_t count;
+    while ((count = swapEvents.try_pop_batch(events, 32)) != 0) {
+        for (std::size_t i = 0; i < count; i++) {
+            std::swap(events[i].a->x, events[i].b->x);
+            std::swap(events[i].a->y, events[i].b->y);
+        }
+    }
+}
+
 // Creates a starting list
 void AlgorithmRenderer::createStarterList() {
     // Add visual containers to the linked_list, representing the starting list.
@@ -237,9 +237,7 @@ bool BinarySearchTreeRenderer::add_number(float number) {
 
 // This function removes a number from the binary search tree and updates the node positions
 bool BinarySearchTreeRenderer::remove_number(float number) {
-    auto result = tree.find(visual_container<float>(number));
-    if (result != tree.end()) {
-        tree.remove(result);
+    if (tree.remove(number)) {
         updateNodePositions(tree.getRoot()); // Update node positions after removal
         return true;
     }
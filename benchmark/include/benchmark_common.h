@@ -0,0 +1,162 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+//Settings shared by every benchmark suite
+struct benchmark_options {
+	//Multiplies the element counts used by the benchmarks. Use values below 1 for quick runs
+	double scale = 1.0;
+
+	//Scales an element count by the scale setting
+	int count(double baseCount) const {
+		int result = static_cast<int>(baseCount * scale);
+		return result < 1 ? 1 : result;
+	}
+};
+
+//Runs a function and returns how many seconds it took
+template<typename Func>
+double time_seconds(Func&& func)
+{
+	auto start = std::chrono::steady_clock::now();
+	func();
+	auto finish = std::chrono::steady_clock::now();
+	return std::chrono::duration<double>(finish - start).count();
+}
+
+//Prints the result of a single benchmark
+inline void print_result(const std::string& name, int elements, double seconds)
+{
+	std::cout << std::left << std::setw(56) << name
+		<< std::right << std::setw(12) << elements << " elements "
+		<< std::setw(12) << std::fixed << std::setprecision(6) << seconds << " Seconds\n";
+}
+
+//Counts the hardware cache misses of the calling thread between start() and stop(). This uses perf_event_open, so it only works on Linux,
+//and only when the kernel allows it (see /proc/sys/kernel/perf_event_paranoid). Otherwise available() returns false and stop() returns -1
+class cache_miss_counter {
+	int descriptor = -1;
+
+public:
+	cache_miss_counter()
+	{
+#if defined(__linux__)
+		perf_event_attr attributes{};
+		attributes.type = PERF_TYPE_HARDWARE;
+		attributes.size = sizeof(attributes);
+		attributes.config = PERF_COUNT_HW_CACHE_MISSES;
+		attributes.disabled = 1;
+		attributes.exclude_kernel = 1;
+		attributes.exclude_hv = 1;
+		descriptor = static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+#endif
+	}
+
+	cache_miss_counter(const cache_miss_counter&) = delete;
+	cache_miss_counter& operator=(const cache_miss_counter&) = delete;
+
+	~cache_miss_counter()
+	{
+#if defined(__linux__)
+		if (descriptor >= 0)
+		{
+			close(descriptor);
+		}
+#endif
+	}
+
+	//Returns true if cache misses can be counted
+	bool available() const
+	{
+		return descriptor >= 0;
+	}
+
+	//Resets the count and starts counting
+	void start()
+	{
+#if defined(__linux__)
+		if (descriptor >= 0)
+		{
+			ioctl(descriptor, PERF_EVENT_IOC_RESET, 0);
+			ioctl(descriptor, PERF_EVENT_IOC_ENABLE, 0);
+		}
+#endif
+	}
+
+	//Stops counting and returns how many cache misses happened since start(), or -1 if they can't be counted
+	long long stop()
+	{
+#if defined(__linux__)
+		long long count = 0;
+		if (descriptor >= 0)
+		{
+			ioctl(descriptor, PERF_EVENT_IOC_DISABLE, 0);
+			if (read(descriptor, &count, sizeof(count)) == sizeof(count))
+			{
+				return count;
+			}
+		}
+#endif
+		return -1;
+	}
+};
+
+//Prints the result of a single benchmark along with how many cache misses there were for each element. "cacheMisses" is -1 if they couldn't be counted
+inline void print_result(const std::string& name, int elements, double seconds, long long cacheMisses)
+{
+	std::cout << std::left << std::setw(56) << name
+		<< std::right << std::setw(12) << elements << " elements "
+		<< std::setw(12) << std::fixed << std::setprecision(6) << seconds << " Seconds ";
+	if (cacheMisses < 0)
+	{
+		std::cout << "   cache misses n/a\n";
+	}
+	else
+	{
+		std::cout << std::setw(8) << std::setprecision(2) << static_cast<double>(cacheMisses) / elements << " cache misses/element\n";
+	}
+}
+
+//Prints the header of a benchmark suite
+inline void print_suite(const std::string& name)
+{
+	std::cout << "\n# " << name << "\n";
+}
+
+//Creates a list of unique random numbers in the range [0, count)
+inline std::vector<int> shuffled_numbers(int count, unsigned int seed = 12345)
+{
+	std::vector<int> numbers(count);
+	for (int i = 0; i < count; i++)
+	{
+		numbers[i] = i;
+	}
+	std::shuffle(numbers.begin(), numbers.end(), std::mt19937(seed));
+	return numbers;
+}
+
+//Prevents the compiler from optimizing away a value that is computed but never used
+template<typename T>
+inline void do_not_optimize(const T& value)
+{
+#if defined(__GNUC__)
+	//Tells the compiler the value is read by code it can't see, so the value has to be computed
+	asm volatile("" : : "r,m"(value) : "memory");
+#else
+	static const void* volatile sink;
+	sink = &value;
+#endif
+}
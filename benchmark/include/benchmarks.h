@@ -0,0 +1,48 @@
+#pragma once
+
+#include <benchmark_common.h>
+
+//Benchmarks skip_list against binary_search_tree
+void skip_list_benchmarks(const benchmark_options& options);
+
+//Benchmarks mpmc_queue throughput with different thread counts
+void mpmc_queue_benchmarks(const benchmark_options& options);
+
+//Benchmarks concurrent_ordered_list against a mutex-protected linked_list with different thread counts
+void concurrent_ordered_list_benchmarks(const benchmark_options& options);
+
+//Benchmarks parallel_for_each, parallel_reduce and parallel_transform against sequential loops over a linked_list
+void parallel_algorithms_benchmarks(const benchmark_options& options);
+
+//Benchmarks linked_list iteration over fragmented and compacted nodes, and copying a list
+void linked_list_benchmarks(const benchmark_options& options);
+
+//Benchmarks compact_linked_list against linked_list
+void compact_linked_list_benchmarks(const benchmark_options& options);
+
+//Benchmarks binary_search_tree construction, copying, tear-down, node allocators, order statistics, range queries, balancing policies, set operations, batch inserts and erases, and multisets
+void binary_search_tree_benchmarks(const benchmark_options& options);
+
+//Benchmarks frozen_search_tree lookups against binary_search_tree, with cache miss counts
+void frozen_search_tree_benchmarks(const benchmark_options& options);
+
+//Benchmarks btree_set insert, find, scan, erase and bulk loading against binary_search_tree
+void btree_benchmarks(const benchmark_options& options);
+
+//Benchmarks concurrent_search_tree reads against a locked binary_search_tree with different reader thread counts and a concurrent writer
+void concurrent_search_tree_benchmarks(const benchmark_options& options);
+
+//Benchmarks persistent_search_tree snapshots against copying a binary_search_tree, and the cost of writes while snapshots are kept
+void persistent_search_tree_benchmarks(const benchmark_options& options);
+
+//Benchmarks compact_search_tree memory use, inserts, lookups, iteration and removes against binary_search_tree, with cache miss counts
+void compact_search_tree_benchmarks(const benchmark_options& options);
+
+//Benchmarks interval_tree inserts, bulk construction and overlap queries against a linear scan
+void interval_tree_benchmarks(const benchmark_options& options);
+
+//Benchmarks blocked_bloom_filter false positive rates and lookups, and bloom_filtered_set searches that miss against a plain binary_search_tree
+void bloom_filter_benchmarks(const benchmark_options& options);
+
+//Benchmarks flat_hash_set and flat_hash_map inserts, lookups, iteration and removes against std::unordered_set and std::unordered_map
+void flat_hash_benchmarks(const benchmark_options& options);
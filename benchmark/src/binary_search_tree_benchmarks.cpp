@@ -0,0 +1,454 @@
+#include <benchmarks.h>
+#include <binary_search_tree.h>
+#include <pool_allocator.h>
+#include <set>
+#include <thread>
+
+namespace {
+	using pool_tree = binary_search_tree<int, std::function<bool(const int&, const int&)>, pool_allocator<int>>;
+	using order_statistics_tree = binary_search_tree<int, std::function<bool(const int&, const int&)>, std::allocator<int>, bst_order_statistics>;
+	using red_black_tree = binary_search_tree<int, std::function<bool(const int&, const int&)>, std::allocator<int>, bst_no_augmentation, bst_red_black_balancing>;
+	using multiset_tree = binary_search_tree<int, std::function<bool(const int&, const int&)>, std::allocator<int>, bst_no_augmentation, bst_avl_balancing, bst_counted_keys>;
+
+	//Inserts the values 1 to "count" in order, then deletes them in reverse order.
+	//These are the worst-case workloads from docs/performance/binary_search_tree_analysis.md
+	template<typename Tree>
+	void sorted_workload(const std::string& name, int count, bool balanced)
+	{
+		Tree tree{};
+		tree.setSelfBalancing(balanced);
+		print_result("insert in order - " + name, count, time_seconds([&]() {
+			for (int i = 1; i <= count; i++)
+			{
+				tree.insert(i);
+			}
+		}));
+		print_result("delete in reverse order - " + name, count, time_seconds([&]() {
+			for (int i = count; i >= 1; i--)
+			{
+				tree.remove(i);
+			}
+		}));
+	}
+
+	//Inserts shuffled values and then removes half of them again, so the freed nodes get reused by the inserts that follow
+	template<typename Tree>
+	double churn_workload(const std::vector<int>& values)
+	{
+		return time_seconds([&]() {
+			Tree tree{};
+			for (int round = 0; round < 4; round++)
+			{
+				for (auto value : values)
+				{
+					tree.insert(value);
+				}
+				for (size_t i = round % 2; i < values.size(); i += 2)
+				{
+					tree.remove(values[i]);
+				}
+			}
+			do_not_optimize(tree);
+		});
+	}
+
+	//Makes a sorted list of "count" unique keys. Lists made with seeds 0 and 1 share half of their keys
+	std::vector<int> set_operation_keys(int count, int seed)
+	{
+		std::vector<int> keys;
+		keys.reserve(count);
+		for (int i = 0; i < count; i++)
+		{
+			//The keys at even indexes are the same in every list, and the keys at odd indexes depend on the seed
+			keys.push_back(i * 3 + (i % 2 == 0 ? 2 : seed));
+		}
+		return keys;
+	}
+
+	//Times a set operation on fresh copies of two trees. Building the trees isn't timed
+	template<typename Operation>
+	double time_set_operation(const std::vector<int>& first, const std::vector<int>& second, Operation&& operation)
+	{
+		auto tree = binary_search_tree<int>::from_sorted(first.begin(), first.end());
+		auto other = binary_search_tree<int>::from_sorted(second.begin(), second.end());
+		return time_seconds([&]() { operation(tree, other); });
+	}
+
+	//Times a batch operation on a fresh tree of the even numbers below "treeSize * 2". Building the tree isn't timed
+	template<typename Tree, typename Operation>
+	double time_batch(int treeSize, Operation&& operation)
+	{
+		std::vector<int> evens(treeSize);
+		for (int i = 0; i < treeSize; i++)
+		{
+			evens[i] = i * 2;
+		}
+		auto tree = Tree::from_sorted(evens.begin(), evens.end());
+		return time_seconds([&]() { operation(tree); });
+	}
+
+	//Compares inserting and erasing a batch one value at a time against insert_batch() and erase_batch(). Half of the erased values are in the tree
+	template<typename Tree>
+	void batch_workload(const std::string& name, int treeSize, const std::vector<int>& batch)
+	{
+		int count = static_cast<int>(batch.size());
+		print_result("insert one at a time - " + name, count, time_batch<Tree>(treeSize, [&](Tree& tree) {
+			for (auto value : batch)
+			{
+				tree.insert(value);
+			}
+		}));
+		print_result("insert_batch - " + name, count, time_batch<Tree>(treeSize, [&](Tree& tree) { tree.insert_batch(batch.begin(), batch.end()); }));
+		print_result("remove one at a time - " + name, count, time_batch<Tree>(treeSize, [&](Tree& tree) {
+			for (auto value : batch)
+			{
+				tree.remove(value - 1);
+			}
+		}));
+		print_result("erase_batch - " + name, count, time_batch<Tree>(treeSize, [&](Tree& tree) {
+			std::vector<int> toErase(batch.size());
+			std::transform(batch.begin(), batch.end(), toErase.begin(), [](int value) { return value - 1; });
+			tree.erase_batch(toErase.begin(), toErase.end());
+		}));
+	}
+}
+
+void binary_search_tree_benchmarks(const benchmark_options& options)
+{
+	print_suite("binary_search_tree bulk construction");
+
+	int count = options.count(1000000);
+	std::vector<int> sorted(count);
+	for (int i = 0; i < count; i++)
+	{
+		sorted[i] = i;
+	}
+	std::vector<int> shuffled = shuffled_numbers(count);
+
+	binary_search_tree<int> source{};
+	print_result("insert - shuffled values one at a time", count, time_seconds([&]() {
+		for (auto value : shuffled)
+		{
+			source.insert(value);
+		}
+	}));
+	print_result("from_sorted", count, time_seconds([&]() {
+		auto tree = binary_search_tree<int>::from_sorted(sorted.begin(), sorted.end());
+		do_not_optimize(tree);
+	}));
+	print_result("from_unsorted - shuffled values", count, time_seconds([&]() {
+		auto tree = binary_search_tree<int>::from_unsorted(shuffled.begin(), shuffled.end());
+		do_not_optimize(tree);
+	}));
+
+	//How trees used to be copied, by inserting every value of the source in sorted order
+	print_result("copy - insert every value", count, time_seconds([&]() {
+		binary_search_tree<int> copy{};
+		for (auto& value : source)
+		{
+			copy.insert(value);
+		}
+		do_not_optimize(copy);
+	}));
+	print_result("copy - copy constructor", count, time_seconds([&]() {
+		binary_search_tree<int> copy{ source };
+		do_not_optimize(copy);
+	}));
+
+	print_suite("binary_search_tree tear-down");
+
+	int teardownCount = options.count(4000000);
+	std::vector<int> teardownValues(teardownCount);
+	for (int i = 0; i < teardownCount; i++)
+	{
+		teardownValues[i] = i;
+	}
+
+	//How trees used to be cleared, by removing one node at a time
+	auto removeTree = binary_search_tree<int>::from_sorted(teardownValues.begin(), teardownValues.end());
+	print_result("remove every node one at a time", teardownCount, time_seconds([&]() {
+		while (removeTree.getSize() > 0)
+		{
+			removeTree.remove(removeTree.begin());
+		}
+	}));
+
+	auto clearTree = binary_search_tree<int>::from_sorted(teardownValues.begin(), teardownValues.end());
+	print_result("clear", teardownCount, time_seconds([&]() { clearTree.clear(); }));
+
+	auto poolClearTree = pool_tree::from_sorted(teardownValues.begin(), teardownValues.end());
+	print_result("clear - pool_allocator", teardownCount, time_seconds([&]() { poolClearTree.clear(); }));
+
+	print_suite("binary_search_tree node allocation - std::allocator vs pool_allocator");
+
+	for (int sortedCount : { 100, 1000, 10000, 100000, options.count(1000000) })
+	{
+		sorted_workload<binary_search_tree<int>>("balanced, std::allocator", sortedCount, true);
+		sorted_workload<pool_tree>("balanced, pool_allocator", sortedCount, true);
+	}
+	//Without balancing the tree becomes a line, so every operation walks the whole tree and the larger sizes take minutes
+	for (int sortedCount : { 100, 1000, 10000 })
+	{
+		sorted_workload<binary_search_tree<int>>("not balanced, std::allocator", sortedCount, false);
+		sorted_workload<pool_tree>("not balanced, pool_allocator", sortedCount, false);
+	}
+
+	std::vector<int> churnValues = shuffled_numbers(options.count(500000), 99);
+	print_result("shuffled insert/remove churn - std::allocator", static_cast<int>(churnValues.size()) * 4, churn_workload<binary_search_tree<int>>(churnValues));
+	print_result("shuffled insert/remove churn - pool_allocator", static_cast<int>(churnValues.size()) * 4, churn_workload<pool_tree>(churnValues));
+
+	print_suite("binary_search_tree order statistics");
+
+	int statisticsCount = options.count(1000000);
+	std::vector<int> statisticsValues = shuffled_numbers(statisticsCount, 7);
+	binary_search_tree<int> plainTree{};
+	order_statistics_tree statisticsTree{};
+	print_result("insert - no augmentation", statisticsCount, time_seconds([&]() {
+		for (auto value : statisticsValues)
+		{
+			plainTree.insert(value);
+		}
+	}));
+	print_result("insert - bst_order_statistics", statisticsCount, time_seconds([&]() {
+		for (auto value : statisticsValues)
+		{
+			statisticsTree.insert(value);
+		}
+	}));
+
+	//Look up the values at evenly spread percentiles, such as the median
+	int queries = 20;
+	print_result("k-th smallest - walk the iterator", queries, time_seconds([&]() {
+		long long total = 0;
+		for (int q = 0; q < queries; q++)
+		{
+			auto i = plainTree.begin();
+			for (int k = 0; k < statisticsCount / queries * q; k++)
+			{
+				++i;
+			}
+			total += *i;
+		}
+		do_not_optimize(total);
+	}));
+	print_result("k-th smallest - select", queries, time_seconds([&]() {
+		long long total = 0;
+		for (int q = 0; q < queries; q++)
+		{
+			total += *statisticsTree.select(statisticsCount / queries * q);
+		}
+		do_not_optimize(total);
+	}));
+
+	int rankQueries = options.count(1000000);
+	print_result("rank", rankQueries, time_seconds([&]() {
+		long long total = 0;
+		for (int q = 0; q < rankQueries; q++)
+		{
+			total += statisticsTree.rank(statisticsValues[q % statisticsCount]);
+		}
+		do_not_optimize(total);
+	}));
+
+	print_suite("binary_search_tree range queries");
+
+	print_result("iterate over every value", statisticsCount, time_seconds([&]() {
+		long long total = 0;
+		for (auto value : plainTree)
+		{
+			total += value;
+		}
+		do_not_optimize(total);
+	}));
+
+	//Sum 1000 values starting at evenly spread positions, like a query for every value between two keys
+	int rangeQueries = 100;
+	//Scanning from begin() is slow, so it only runs a fifth of the queries
+	print_result("1000 value range - scan from begin()", rangeQueries / 5, time_seconds([&]() {
+		long long total = 0;
+		for (int q = 0; q < rangeQueries; q += 5)
+		{
+			int low = statisticsCount / rangeQueries * q;
+			for (auto i = plainTree.begin(); i != plainTree.end() && *i < low + 1000; ++i)
+			{
+				if (*i >= low)
+				{
+					total += *i;
+				}
+			}
+		}
+		do_not_optimize(total);
+	}));
+	print_result("1000 value range - range()", rangeQueries, time_seconds([&]() {
+		long long total = 0;
+		for (int q = 0; q < rangeQueries; q++)
+		{
+			int low = statisticsCount / rangeQueries * q;
+			for (auto value : plainTree.range(low, low + 1000))
+			{
+				total += value;
+			}
+		}
+		do_not_optimize(total);
+	}));
+
+	print_suite("binary_search_tree balancing - AVL vs red-black");
+
+	for (int sortedCount : { options.count(100000), options.count(1000000) })
+	{
+		sorted_workload<binary_search_tree<int>>("AVL", sortedCount, true);
+		sorted_workload<red_black_tree>("red-black", sortedCount, true);
+	}
+	print_result("shuffled insert/remove churn - AVL", static_cast<int>(churnValues.size()) * 4, churn_workload<binary_search_tree<int>>(churnValues));
+	print_result("shuffled insert/remove churn - red-black", static_cast<int>(churnValues.size()) * 4, churn_workload<red_black_tree>(churnValues));
+
+	//Searching shows the cost of the red-black tree being taller
+	binary_search_tree<int> avlTree{};
+	red_black_tree redBlackTree{};
+	for (auto value : statisticsValues)
+	{
+		avlTree.insert(value);
+		redBlackTree.insert(value);
+	}
+	auto findEvery = [&statisticsValues](const auto& tree) {
+		return time_seconds([&]() {
+			int found = 0;
+			for (auto value : statisticsValues)
+			{
+				if (tree.find(value) != tree.end())
+				{
+					found++;
+				}
+			}
+			do_not_optimize(found);
+		});
+	};
+	print_result("find - AVL", statisticsCount, findEvery(avlTree));
+	print_result("find - red-black", statisticsCount, findEvery(redBlackTree));
+	std::cout << "height - AVL " << avlTree.getRoot().getHeight() << ", red-black " << redBlackTree.getRoot().getHeight() << "\n";
+
+	print_suite("binary_search_tree set operations - one value at a time vs join-based");
+
+	int setCount = options.count(10000000);
+	int threads = static_cast<int>(std::thread::hardware_concurrency());
+	std::string threadName = threads > 1 ? std::to_string(threads) + " threads" : "1 thread (all cores)";
+	std::vector<int> first = set_operation_keys(setCount, 0);
+	std::vector<int> second = set_operation_keys(setCount, 1);
+
+	print_result("union - insert every value", setCount, time_set_operation(first, second, [](auto& tree, auto& other) {
+		for (auto value : other)
+		{
+			tree.insert(value);
+		}
+	}));
+	print_result("union_with - 1 thread", setCount, time_set_operation(first, second, [](auto& tree, auto& other) { tree.union_with(std::move(other), 1); }));
+	print_result("union_with - " + threadName, setCount, time_set_operation(first, second, [](auto& tree, auto& other) { tree.union_with(std::move(other), 0); }));
+	print_result("intersection - find every value", setCount, time_set_operation(first, second, [&first](auto& tree, auto& other) {
+		for (auto value : first)
+		{
+			if (other.find(value) == other.end())
+			{
+				tree.remove(value);
+			}
+		}
+	}));
+	print_result("intersect_with - 1 thread", setCount, time_set_operation(first, second, [](auto& tree, auto& other) { tree.intersect_with(std::move(other), 1); }));
+	print_result("intersect_with - " + threadName, setCount, time_set_operation(first, second, [](auto& tree, auto& other) { tree.intersect_with(std::move(other), 0); }));
+	print_result("difference - remove every value", setCount, time_set_operation(first, second, [](auto& tree, auto& other) {
+		for (auto value : other)
+		{
+			tree.remove(value);
+		}
+	}));
+	print_result("difference - 1 thread", setCount, time_set_operation(first, second, [](auto& tree, auto& other) { tree.difference(std::move(other), 1); }));
+	print_result("difference - " + threadName, setCount, time_set_operation(first, second, [](auto& tree, auto& other) { tree.difference(std::move(other), 0); }));
+
+	//Merging a small tree into a large one only splits the large tree along a few paths
+	std::vector<int> few = set_operation_keys(setCount / 1000, 1);
+	print_result("small union - insert every value", setCount / 1000, time_set_operation(first, few, [](auto& tree, auto& other) {
+		for (auto value : other)
+		{
+			tree.insert(value);
+		}
+	}));
+	print_result("small union - union_with", setCount / 1000, time_set_operation(first, few, [](auto& tree, auto& other) { tree.union_with(std::move(other), 1); }));
+
+	print_suite("binary_search_tree batch insert and erase - one value at a time vs split/join");
+
+	//The batches go into a tree of a million even keys. Sorted batches are runs of neighboring odd keys, and unsorted batches are odd keys from the whole range
+	int batchTreeSize = options.count(1000000);
+	for (int batchSize : { options.count(10000), options.count(100000), options.count(1000000) })
+	{
+		std::vector<int> unsortedBatch = shuffled_numbers(batchTreeSize, 5);
+		unsortedBatch.resize(std::min(batchSize, batchTreeSize));
+		std::vector<int> sortedBatch(unsortedBatch.size());
+		int start = (batchTreeSize - static_cast<int>(sortedBatch.size())) / 2;
+		for (size_t i = 0; i < sortedBatch.size(); i++)
+		{
+			sortedBatch[i] = (start + static_cast<int>(i)) * 2 + 1;
+		}
+		for (auto& value : unsortedBatch)
+		{
+			value = value * 2 + 1;
+		}
+		std::string size = std::to_string(sortedBatch.size());
+		batch_workload<binary_search_tree<int>>("AVL, sorted " + size, batchTreeSize, sortedBatch);
+		batch_workload<binary_search_tree<int>>("AVL, unsorted " + size, batchTreeSize, unsortedBatch);
+		batch_workload<red_black_tree>("red-black, sorted " + size, batchTreeSize, sortedBatch);
+	}
+
+	print_suite("binary_search_tree multiset - heavy key repetition");
+
+	//Every key is repeated about a thousand times
+	int repeatedCount = options.count(2000000);
+	int distinctCount = repeatedCount / 1000 > 0 ? repeatedCount / 1000 : 1;
+	std::vector<int> repeated = shuffled_numbers(repeatedCount);
+	for (auto& value : repeated)
+	{
+		value %= distinctCount;
+	}
+	multiset_tree countedTree{};
+	std::multiset<int> standardMultiset{};
+	print_result("insert - bst_counted_keys", repeatedCount, time_seconds([&]() {
+		for (auto value : repeated)
+		{
+			countedTree.insert(value);
+		}
+	}));
+	print_result("insert - std::multiset", repeatedCount, time_seconds([&]() {
+		for (auto value : repeated)
+		{
+			standardMultiset.insert(value);
+		}
+	}));
+	//std::multiset::count() walks every copy of the key, so each key is only counted once
+	print_result("count every key - bst_counted_keys", distinctCount, time_seconds([&]() {
+		long long total = 0;
+		for (int key = 0; key < distinctCount; key++)
+		{
+			total += countedTree.count(key);
+		}
+		do_not_optimize(total);
+	}));
+	print_result("count every key - std::multiset", distinctCount, time_seconds([&]() {
+		long long total = 0;
+		for (int key = 0; key < distinctCount; key++)
+		{
+			total += static_cast<long long>(standardMultiset.count(key));
+		}
+		do_not_optimize(total);
+	}));
+	print_result("remove one at a time - bst_counted_keys", repeatedCount, time_seconds([&]() {
+		for (auto value : repeated)
+		{
+			countedTree.remove(value);
+		}
+	}));
+	print_result("remove one at a time - std::multiset", repeatedCount, time_seconds([&]() {
+		for (auto value : repeated)
+		{
+			standardMultiset.erase(standardMultiset.find(value));
+		}
+	}));
+	std::cout << "nodes - bst_counted_keys " << distinctCount << ", std::multiset " << repeatedCount << "\n";
+}
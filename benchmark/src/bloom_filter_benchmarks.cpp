@@ -0,0 +1,94 @@
+#include <benchmarks.h>
+#include <binary_search_tree.h>
+#include <bloom_filter.h>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+	//Creates "count" random lookups, where "hitPercent" percent are even numbers below count * 2 (which are in the set) and the rest are odd (which aren't)
+	std::vector<int> make_lookups(int count, int hitPercent, unsigned int seed)
+	{
+		std::mt19937 random(seed);
+		std::vector<int> lookups;
+		lookups.reserve(count);
+		for (int i = 0; i < count; i++)
+		{
+			int value = static_cast<int>(random() % static_cast<unsigned int>(count)) * 2;
+			lookups.push_back(static_cast<int>(random() % 100) < hitPercent ? value : value + 1);
+		}
+		return lookups;
+	}
+
+	//Times contains() for every lookup on a set
+	template<typename Set>
+	void time_contains(const std::string& name, const Set& set, const std::vector<int>& lookups)
+	{
+		int found = 0;
+		print_result(name, static_cast<int>(lookups.size()), time_seconds([&]() {
+			for (int value : lookups)
+			{
+				if (set.contains(value))
+				{
+					found++;
+				}
+			}
+		}));
+		do_not_optimize(found);
+	}
+}
+
+void bloom_filter_benchmarks(const benchmark_options& options)
+{
+	int count = options.count(1000000);
+	std::vector<int> values = shuffled_numbers(count, 5);
+	for (auto& value : values)
+	{
+		value *= 2;
+	}
+
+	print_suite("blocked_bloom_filter false positive rates (even numbers inserted, odd numbers looked up)");
+	for (double rate : { 0.1, 0.01, 0.001 })
+	{
+		blocked_bloom_filter<int> filter(count, rate);
+		filter.insert(values.begin(), values.end());
+		int falsePositives = 0;
+		double seconds = time_seconds([&]() {
+			for (int i = 0; i < count; i++)
+			{
+				if (filter.might_contain(i * 2 + 1))
+				{
+					falsePositives++;
+				}
+			}
+		});
+		print_result("might_contain misses - target rate " + std::to_string(rate), count, seconds);
+		std::cout << "Measured false positive rate " << static_cast<double>(falsePositives) / count << ", "
+			<< static_cast<double>(filter.getByteSize()) * 8 / count << " bits per value\n";
+	}
+
+	print_suite("bloom_filtered_set against binary_search_tree (int values)");
+
+	binary_search_tree<int> tree;
+	bloom_filtered_set<int> filtered;
+	print_result("insert - binary_search_tree", count, time_seconds([&]() {
+		for (int value : values)
+		{
+			tree.insert(value);
+		}
+	}));
+	print_result("insert - bloom_filtered_set", count, time_seconds([&]() {
+		for (int value : values)
+		{
+			filtered.insert(value);
+		}
+	}));
+
+	for (int hitPercent : { 0, 10, 50, 100 })
+	{
+		std::vector<int> lookups = make_lookups(count, hitPercent, 13);
+		std::string suffix = " - " + std::to_string(hitPercent) + "% hits";
+		time_contains("contains - binary_search_tree" + suffix, tree, lookups);
+		time_contains("contains - bloom_filtered_set" + suffix, filtered, lookups);
+	}
+}
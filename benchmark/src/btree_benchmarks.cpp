@@ -0,0 +1,100 @@
+#include <benchmarks.h>
+#include <binary_search_tree.h>
+#include <btree.h>
+
+namespace {
+	//Runs the insert, find, erase and scan benchmarks on one kind of tree. "keys" are the keys to insert, in the order to insert them
+	template<typename Tree>
+	void run_tree(const std::string& name, const std::vector<int>& keys, const std::vector<int>& lookups)
+	{
+		int size = static_cast<int>(keys.size());
+		Tree tree{};
+		print_result("insert - " + name, size, time_seconds([&]() {
+			for (auto key : keys)
+			{
+				tree.insert(key);
+			}
+		}));
+
+		//Half of the lookups are for keys that aren't in the tree
+		long long cacheMisses = 0;
+		cache_miss_counter counter;
+		int found = 0;
+		counter.start();
+		double seconds = time_seconds([&]() {
+			for (auto key : lookups)
+			{
+				if (tree.find(key) != tree.end())
+				{
+					found++;
+				}
+			}
+		});
+		cacheMisses = counter.stop();
+		do_not_optimize(found);
+		print_result("find - " + name, static_cast<int>(lookups.size()), seconds, cacheMisses);
+
+		long long sum = 0;
+		print_result("scan - " + name, size, time_seconds([&]() {
+			for (auto value : tree)
+			{
+				sum += value;
+			}
+		}));
+		do_not_optimize(sum);
+
+		//Erase every key, in a different order than they were inserted
+		std::vector<int> erase = keys;
+		std::reverse(erase.begin(), erase.end());
+		print_result("erase - " + name, size, time_seconds([&]() {
+			for (auto key : erase)
+			{
+				tree.remove(key);
+			}
+		}));
+	}
+}
+
+void btree_benchmarks(const benchmark_options& options)
+{
+	print_suite("btree_set against binary_search_tree");
+
+	int lookupCount = options.count(2000000);
+	for (int size : { options.count(1000000), options.count(10000000), options.count(100000000) })
+	{
+		std::vector<int> keys = shuffled_numbers(size, 99);
+		for (auto& key : keys)
+		{
+			key *= 2;
+		}
+		std::vector<int> lookups = shuffled_numbers(size * 2);
+		lookups.resize(std::min<size_t>(lookups.size(), lookupCount));
+
+		std::string sizeName = std::to_string(size) + " keys";
+		run_tree<btree_set<int>>("btree_set, " + sizeName, keys, lookups);
+		run_tree<btree_set<int, std::function<bool(const int&, const int&)>, 4096>>("btree_set with 4KB nodes, " + sizeName, keys, lookups);
+		//A binary_search_tree node is about 40 bytes, so 100 million of them don't fit in memory on most machines
+		if (size < options.count(100000000))
+		{
+			run_tree<binary_search_tree<int>>("binary_search_tree, " + sizeName, keys, lookups);
+		}
+	}
+
+	print_suite("btree_set bulk loading");
+	for (int size : { options.count(1000000), options.count(10000000) })
+	{
+		std::vector<int> sorted(size);
+		for (int i = 0; i < size; i++)
+		{
+			sorted[i] = i;
+		}
+		btree_set<int> tree{};
+		print_result("from_sorted - " + std::to_string(size) + " keys", size, time_seconds([&]() {
+			tree = btree_set<int>::from_sorted(sorted.begin(), sorted.end());
+		}));
+		binary_search_tree<int> bst{};
+		print_result("binary_search_tree from_sorted - " + std::to_string(size) + " keys", size, time_seconds([&]() {
+			bst = binary_search_tree<int>::from_sorted(sorted.begin(), sorted.end());
+		}));
+	}
+}
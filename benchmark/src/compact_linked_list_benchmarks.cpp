@@ -0,0 +1,68 @@
+#include <benchmarks.h>
+#include <compact_linked_list.h>
+#include <linked_list.h>
+
+namespace {
+	//Fills a list, then removes and re-adds a quarter of the values to churn the nodes
+	template<typename ListType>
+	double fill(ListType& list, int count)
+	{
+		return time_seconds([&]() {
+			for (int i = 0; i < count; i++)
+			{
+				list.push_back(i);
+			}
+			for (int i = 0; i < count / 4; i++)
+			{
+				list.pop_front();
+				list.push_back(i);
+			}
+		});
+	}
+
+	//Sums every value in the list
+	template<typename ListType>
+	double iterate(const ListType& list)
+	{
+		long long sum = 0;
+		double seconds = time_seconds([&]() {
+			for (auto value : list)
+			{
+				sum += value;
+			}
+		});
+		do_not_optimize(sum);
+		return seconds;
+	}
+
+	//Copies the list
+	template<typename ListType>
+	double copy(const ListType& list)
+	{
+		return time_seconds([&]() {
+			ListType copied{ list };
+			do_not_optimize(copied);
+		});
+	}
+
+	template<typename ListType>
+	void run(const std::string& name, int count)
+	{
+		ListType list{};
+		print_result(name + " - fill", count, fill(list, count));
+		print_result(name + " - iterate", count, iterate(list));
+		print_result(name + " - copy", count, copy(list));
+	}
+}
+
+void compact_linked_list_benchmarks(const benchmark_options& options)
+{
+	print_suite("compact_linked_list vs linked_list (int values)");
+
+	std::cout << "Bytes per node: linked_list " << sizeof(linked_list<int>::node)
+		<< " (plus allocator overhead), compact_linked_list " << sizeof(compact_linked_list<int>::node) << "\n";
+
+	int count = options.count(5000000);
+	run<linked_list<int>>("linked_list", count);
+	run<compact_linked_list<int>>("compact_linked_list", count);
+}
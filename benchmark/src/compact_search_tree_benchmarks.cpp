@@ -0,0 +1,143 @@
+#include <benchmarks.h>
+#include <binary_search_tree.h>
+#include <compact_search_tree.h>
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+namespace {
+	//How many bytes the counting_allocator has handed out and not freed yet
+	std::size_t allocatedBytes = 0;
+
+	//An allocator that keeps track of how much memory the nodes of a binary_search_tree use
+	template<typename T>
+	struct counting_allocator {
+		using value_type = T;
+
+		counting_allocator() = default;
+
+		template<typename U>
+		counting_allocator(const counting_allocator<U>&) {}
+
+		T* allocate(std::size_t count)
+		{
+			allocatedBytes += sizeof(T) * count;
+			return std::allocator<T>().allocate(count);
+		}
+
+		void deallocate(T* pointer, std::size_t count)
+		{
+			allocatedBytes -= sizeof(T) * count;
+			std::allocator<T>().deallocate(pointer, count);
+		}
+
+		template<typename U>
+		bool operator==(const counting_allocator<U>&) const { return true; }
+
+		template<typename U>
+		bool operator!=(const counting_allocator<U>&) const { return false; }
+	};
+
+	using counted_tree = binary_search_tree<int, std::function<bool(const int&, const int&)>, counting_allocator<int>>;
+
+	//Looks up every key and counts how many are found. Returns the time taken, and stores the number of cache misses in "cacheMisses"
+	template<typename Tree>
+	double run_lookups(const Tree& tree, const std::vector<int>& keys, long long& cacheMisses)
+	{
+		cache_miss_counter counter;
+		int found = 0;
+		counter.start();
+		double seconds = time_seconds([&]() {
+			for (auto key : keys)
+			{
+				if (tree.find(key) != tree.end())
+				{
+					found++;
+				}
+			}
+		});
+		cacheMisses = counter.stop();
+		do_not_optimize(found);
+		return seconds;
+	}
+
+	//Sums every value in the tree in sorted order. Returns the time taken, and stores the number of cache misses in "cacheMisses"
+	template<typename Tree>
+	double run_iteration(const Tree& tree, long long& cacheMisses)
+	{
+		cache_miss_counter counter;
+		long long sum = 0;
+		counter.start();
+		double seconds = time_seconds([&]() {
+			for (int value : tree)
+			{
+				sum += value;
+			}
+		});
+		cacheMisses = counter.stop();
+		do_not_optimize(sum);
+		return seconds;
+	}
+
+	//Inserts shuffled keys, looks them up, iterates over them and then removes them
+	template<typename Tree>
+	void run(const std::string& name, const std::vector<int>& values, const std::vector<int>& keys)
+	{
+		Tree tree{};
+		int count = static_cast<int>(values.size());
+		print_result("insert - " + name, count, time_seconds([&]() {
+			for (auto value : values)
+			{
+				tree.insert(value * 2);
+			}
+		}));
+
+		long long cacheMisses = 0;
+		double seconds = run_lookups(tree, keys, cacheMisses);
+		print_result("find - " + name, static_cast<int>(keys.size()), seconds, cacheMisses);
+		seconds = run_iteration(tree, cacheMisses);
+		print_result("iterate - " + name, count, seconds, cacheMisses);
+
+		print_result("remove - " + name, count, time_seconds([&]() {
+			for (auto value : values)
+			{
+				tree.remove(value * 2);
+			}
+		}));
+	}
+}
+
+void compact_search_tree_benchmarks(const benchmark_options& options)
+{
+	print_suite("compact_search_tree memory against binary_search_tree (int values)");
+
+	int count = options.count(1000000);
+	std::vector<int> values = shuffled_numbers(count, 7);
+
+	{
+		counted_tree tree{};
+		for (auto value : values)
+		{
+			tree.insert(value);
+		}
+		std::size_t treeBytes = allocatedBytes;
+		compact_search_tree<int> compact;
+		for (auto value : values)
+		{
+			compact.insert(value);
+		}
+		std::size_t compactBytes = static_cast<std::size_t>(compact.getCapacity()) * sizeof(compact_search_tree<int>::node);
+
+		std::cout << "Bytes per node: binary_search_tree " << treeBytes / count << " (plus allocator overhead), compact_search_tree "
+			<< sizeof(compact_search_tree<int>::node) << "\n";
+		std::cout << "Total bytes for " << count << " values: binary_search_tree " << treeBytes
+			<< ", compact_search_tree " << compactBytes << " (arena capacity " << compact.getCapacity() << ")\n";
+	}
+
+	print_suite("compact_search_tree throughput against binary_search_tree (int values)");
+
+	//Every other key is in the tree, so half of the lookups miss
+	std::vector<int> keys = shuffled_numbers(count * 2, 11);
+	run<binary_search_tree<int>>("binary_search_tree", values, keys);
+	run<compact_search_tree<int>>("compact_search_tree", values, keys);
+}
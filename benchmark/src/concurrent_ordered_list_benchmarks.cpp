@@ -0,0 +1,117 @@
+#include <benchmarks.h>
+#include <concurrent_ordered_list.h>
+#include <linked_list.h>
+#include <mutex>
+#include <thread>
+
+namespace {
+	//A sorted linked_list behind a single mutex. This is the baseline the lock-free list is compared against
+	class locked_sorted_list {
+		linked_list<int> list;
+		std::mutex mutex;
+
+		//Finds the first node that is not less than the value
+		linked_list<int>::iterator position(int value)
+		{
+			auto i = list.begin();
+			while (i != list.end() && *i < value)
+			{
+				++i;
+			}
+			return i;
+		}
+
+	public:
+		bool insert(int value)
+		{
+			std::lock_guard<std::mutex> guard{ mutex };
+			auto i = position(value);
+			if (i != list.end() && *i == value)
+			{
+				return false;
+			}
+			list.insert(value, i);
+			return true;
+		}
+
+		bool erase(int value)
+		{
+			std::lock_guard<std::mutex> guard{ mutex };
+			auto i = position(value);
+			if (i == list.end() || *i != value)
+			{
+				return false;
+			}
+			list.pop_element(i);
+			return true;
+		}
+
+		bool contains(int value)
+		{
+			std::lock_guard<std::mutex> guard{ mutex };
+			auto i = position(value);
+			return i != list.end() && *i == value;
+		}
+	};
+
+	//Runs a mix of 80% contains, 10% insert and 10% erase on "threadCount" threads
+	template<typename ListType>
+	double run_mix(int threadCount, int operations, int keyRange)
+	{
+		ListType list{};
+		//Start with half of the keys in the list
+		for (int i = 0; i < keyRange; i += 2)
+		{
+			list.insert(i);
+		}
+
+		std::vector<std::thread> threads;
+		std::atomic<int> hits{ 0 };
+		double seconds = time_seconds([&]() {
+			for (int t = 0; t < threadCount; t++)
+			{
+				threads.emplace_back([&list, &hits, t, operations, threadCount, keyRange]() {
+					unsigned int state = 7919 * (t + 1);
+					int localHits = 0;
+					for (int i = 0; i < operations / threadCount; i++)
+					{
+						state = state * 1103515245 + 12345;
+						int key = (state >> 8) % keyRange;
+						int choice = (state >> 4) % 10;
+						if (choice == 0)
+						{
+							list.insert(key);
+						}
+						else if (choice == 1)
+						{
+							list.erase(key);
+						}
+						else if (list.contains(key))
+						{
+							localHits++;
+						}
+					}
+					hits += localHits;
+				});
+			}
+			for (auto& thread : threads)
+			{
+				thread.join();
+			}
+		});
+		do_not_optimize(hits);
+		return seconds;
+	}
+}
+
+void concurrent_ordered_list_benchmarks(const benchmark_options& options)
+{
+	print_suite("concurrent_ordered_list scaling (80% contains, 10% insert, 10% erase, 1024 keys)");
+
+	int operations = options.count(2000000);
+	for (int threadCount : { 1, 2, 4, 8, 16, 32 })
+	{
+		print_result(std::to_string(threadCount) + " thread(s) - mutex + linked_list", operations, run_mix<locked_sorted_list>(threadCount, operations, 1024));
+		print_result(std::to_string(threadCount) + " thread(s) - concurrent_ordered_list", operations, run_mix<concurrent_ordered_list<int>>(threadCount, operations, 1024));
+	}
+}
@@ -0,0 +1,165 @@
+#include <benchmarks.h>
+#include <binary_search_tree.h>
+#include <concurrent_search_tree.h>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+
+namespace {
+	//A binary_search_tree behind a mutex. This is the baseline the concurrent tree is compared against
+	template<typename Mutex>
+	class locked_tree {
+		binary_search_tree<int> tree;
+		Mutex mutex;
+
+	public:
+		bool insert(int value)
+		{
+			std::lock_guard<Mutex> guard{ mutex };
+			return tree.insert(value) != tree.end();
+		}
+
+		bool remove(int value)
+		{
+			std::lock_guard<Mutex> guard{ mutex };
+			return tree.remove(value);
+		}
+
+		//Readers take a shared lock if the mutex has one, so they only wait for the writer
+		bool contains(int value)
+		{
+			if constexpr (std::is_same<Mutex, std::shared_mutex>::value)
+			{
+				std::shared_lock<Mutex> guard{ mutex };
+				return tree.find(value) != tree.end();
+			}
+			else
+			{
+				std::lock_guard<Mutex> guard{ mutex };
+				return tree.find(value) != tree.end();
+			}
+		}
+	};
+
+	//Runs "lookups" contains() calls split over "readerCount" threads, while one more thread keeps inserting and removing keys.
+	//Returns the time the readers took, and stores how many writes finished in that time in "writes"
+	template<typename TreeType>
+	double run_readers(int readerCount, int lookups, int keyRange, int& writes)
+	{
+		TreeType tree{};
+		//The readers look up the even keys, and the writer inserts and removes the odd keys
+		for (int i = 0; i < keyRange; i += 2)
+		{
+			tree.insert(i);
+		}
+
+		std::atomic<bool> done{ false };
+		std::atomic<int> writeCount{ 0 };
+		std::thread writer([&]() {
+			unsigned int state = 4242;
+			int localWrites = 0;
+			while (!done.load(std::memory_order_relaxed))
+			{
+				state = state * 1103515245 + 12345;
+				int key = static_cast<int>((state >> 8) % keyRange) | 1;
+				if ((state >> 4) % 2 == 0)
+				{
+					tree.insert(key);
+				}
+				else
+				{
+					tree.remove(key);
+				}
+				localWrites++;
+			}
+			writeCount = localWrites;
+		});
+
+		std::vector<std::thread> readers;
+		std::atomic<int> hits{ 0 };
+		double seconds = time_seconds([&]() {
+			for (int t = 0; t < readerCount; t++)
+			{
+				readers.emplace_back([&tree, &hits, t, lookups, readerCount, keyRange]() {
+					unsigned int state = 7919 * (t + 1);
+					int localHits = 0;
+					for (int i = 0; i < lookups / readerCount; i++)
+					{
+						state = state * 1103515245 + 12345;
+						if (tree.contains(static_cast<int>((state >> 8) % keyRange)))
+						{
+							localHits++;
+						}
+					}
+					hits += localHits;
+				});
+			}
+			for (auto& reader : readers)
+			{
+				reader.join();
+			}
+		});
+		done = true;
+		writer.join();
+		writes = writeCount;
+		do_not_optimize(hits);
+		return seconds;
+	}
+
+	template<typename TreeType>
+	void print_readers(const std::string& name, int readerCount, int lookups, int keyRange)
+	{
+		int writes = 0;
+		double seconds = run_readers<TreeType>(readerCount, lookups, keyRange, writes);
+		std::string readers = std::to_string(readerCount) + (readerCount == 1 ? " reader - " : " readers - ");
+		print_result("reads, " + readers + name, lookups, seconds);
+		//How many writes the writer finished while the readers ran
+		print_result("writes, " + readers + name, writes, seconds);
+	}
+}
+
+void concurrent_search_tree_benchmarks(const benchmark_options& options)
+{
+	int keyRange = options.count(200000);
+	print_suite("concurrent_search_tree read scaling (contains() on " + std::to_string(keyRange / 2) + " keys, with one writer inserting and removing)");
+
+	int lookups = options.count(4000000);
+	for (int readerCount : { 1, 2, 4, 8, 16, 32 })
+	{
+		print_readers<locked_tree<std::mutex>>("mutex + binary_search_tree", readerCount, lookups, keyRange);
+		print_readers<locked_tree<std::shared_mutex>>("shared_mutex + binary_search_tree", readerCount, lookups, keyRange);
+		print_readers<concurrent_search_tree<int>>("concurrent_search_tree", readerCount, lookups, keyRange);
+	}
+
+	print_suite("concurrent_search_tree single-threaded writes");
+
+	int writeCount = options.count(1000000);
+	std::vector<int> values = shuffled_numbers(writeCount);
+	binary_search_tree<int> plainTree{};
+	concurrent_search_tree<int> concurrentTree{};
+	print_result("insert - binary_search_tree", writeCount, time_seconds([&]() {
+		for (auto value : values)
+		{
+			plainTree.insert(value);
+		}
+	}));
+	print_result("insert - concurrent_search_tree", writeCount, time_seconds([&]() {
+		for (auto value : values)
+		{
+			concurrentTree.insert(value);
+		}
+	}));
+	print_result("remove - binary_search_tree", writeCount, time_seconds([&]() {
+		for (auto value : values)
+		{
+			plainTree.remove(value);
+		}
+	}));
+	print_result("remove - concurrent_search_tree", writeCount, time_seconds([&]() {
+		for (auto value : values)
+		{
+			concurrentTree.remove(value);
+		}
+	}));
+}
@@ -0,0 +1,133 @@
+#include <benchmarks.h>
+#include <flat_hash.h>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+	//Wraps std::unordered_set with the function names of flat_hash_set, so both can be run by the same benchmark
+	struct std_set {
+		std::unordered_set<int> set;
+
+		void reserve(int count) { set.reserve(static_cast<std::size_t>(count)); }
+		void insert(int key) { set.insert(key); }
+		bool contains(int key) const { return set.find(key) != set.end(); }
+		bool remove(int key) { return set.erase(key) == 1; }
+		std::unordered_set<int>::const_iterator begin() const { return set.begin(); }
+		std::unordered_set<int>::const_iterator end() const { return set.end(); }
+	};
+
+	//Wraps std::unordered_map with the function names of flat_hash_map
+	struct std_map {
+		std::unordered_map<int, int> map;
+
+		void reserve(int count) { map.reserve(static_cast<std::size_t>(count)); }
+		void insert(int key, int value) { map.emplace(key, value); }
+		int& operator[](int key) { return map[key]; }
+		bool contains(int key) const { return map.find(key) != map.end(); }
+		bool remove(int key) { return map.erase(key) == 1; }
+	};
+
+	//Times looking up every key. Every other key is in the set, so half of the lookups miss
+	template<typename Set>
+	void time_lookups(const std::string& name, const Set& set, const std::vector<int>& keys)
+	{
+		int found = 0;
+		print_result("contains (half miss) - " + name, static_cast<int>(keys.size()), time_seconds([&]() {
+			for (int key : keys)
+			{
+				if (set.contains(key))
+				{
+					found++;
+				}
+			}
+		}));
+		do_not_optimize(found);
+	}
+
+	//Inserts shuffled keys with and without reserving first, looks them up, iterates over them and then removes them
+	template<typename Set>
+	void run_set(const std::string& name, const std::vector<int>& values, const std::vector<int>& keys)
+	{
+		int count = static_cast<int>(values.size());
+		{
+			Set set{};
+			print_result("insert - " + name, count, time_seconds([&]() {
+				for (int value : values)
+				{
+					set.insert(value * 2);
+				}
+			}));
+		}
+
+		Set set{};
+		set.reserve(count);
+		print_result("insert after reserve - " + name, count, time_seconds([&]() {
+			for (int value : values)
+			{
+				set.insert(value * 2);
+			}
+		}));
+
+		time_lookups(name, set, keys);
+
+		long long sum = 0;
+		print_result("iterate - " + name, count, time_seconds([&]() {
+			for (int key : set)
+			{
+				sum += key;
+			}
+		}));
+		do_not_optimize(sum);
+
+		print_result("remove - " + name, count, time_seconds([&]() {
+			for (int value : values)
+			{
+				set.remove(value * 2);
+			}
+		}));
+	}
+
+	//Inserts shuffled keys, updates their values with operator[], looks them up and then removes them
+	template<typename Map>
+	void run_map(const std::string& name, const std::vector<int>& values, const std::vector<int>& keys)
+	{
+		int count = static_cast<int>(values.size());
+		Map map{};
+		print_result("insert - " + name, count, time_seconds([&]() {
+			for (int value : values)
+			{
+				map.insert(value * 2, value);
+			}
+		}));
+		print_result("operator[] - " + name, count, time_seconds([&]() {
+			for (int value : values)
+			{
+				map[value * 2]++;
+			}
+		}));
+		time_lookups(name, map, keys);
+		print_result("remove - " + name, count, time_seconds([&]() {
+			for (int value : values)
+			{
+				map.remove(value * 2);
+			}
+		}));
+	}
+}
+
+void flat_hash_benchmarks(const benchmark_options& options)
+{
+	int count = options.count(1000000);
+	std::vector<int> values = shuffled_numbers(count, 17);
+	std::vector<int> keys = shuffled_numbers(count * 2, 19);
+
+	print_suite("flat_hash_set against std::unordered_set (int keys)");
+	run_set<std_set>("std::unordered_set", values, keys);
+	run_set<flat_hash_set<int>>("flat_hash_set", values, keys);
+
+	print_suite("flat_hash_map against std::unordered_map (int keys and values)");
+	run_map<std_map>("std::unordered_map", values, keys);
+	run_map<flat_hash_map<int, int>>("flat_hash_map", values, keys);
+}
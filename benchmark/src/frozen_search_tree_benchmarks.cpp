@@ -0,0 +1,60 @@
+#include <benchmarks.h>
+#include <binary_search_tree.h>
+#include <frozen_search_tree.h>
+
+namespace {
+	//Looks up every key and counts how many are found. Returns the time taken, and stores the number of cache misses in "cacheMisses"
+	template<typename Tree>
+	double run_lookups(const Tree& tree, const std::vector<int>& keys, long long& cacheMisses)
+	{
+		cache_miss_counter counter;
+		int found = 0;
+		counter.start();
+		double seconds = time_seconds([&]() {
+			for (auto key : keys)
+			{
+				if (tree.find(key) != tree.end())
+				{
+					found++;
+				}
+			}
+		});
+		cacheMisses = counter.stop();
+		do_not_optimize(found);
+		return seconds;
+	}
+}
+
+void frozen_search_tree_benchmarks(const benchmark_options& options)
+{
+	print_suite("frozen_search_tree lookups against binary_search_tree");
+
+	int lookups = options.count(2000000);
+	for (int size : { options.count(10000), options.count(1000000), options.count(10000000) })
+	{
+		//Every other key is in the tree, so half of the lookups miss
+		std::vector<int> sorted(size);
+		for (int i = 0; i < size; i++)
+		{
+			sorted[i] = i * 2;
+		}
+		std::vector<int> keys = shuffled_numbers(size * 2);
+		keys.resize(std::min<size_t>(keys.size(), lookups));
+
+		//The tree is built from shuffled inserts, so the nodes are spread over the heap like a tree that has been used for a while
+		binary_search_tree<int> tree{};
+		for (auto value : shuffled_numbers(size, 99))
+		{
+			tree.insert(value * 2);
+		}
+
+		frozen_search_tree<int> frozen;
+		print_result("freeze - " + std::to_string(size) + " keys", size, time_seconds([&]() { frozen = tree.freeze(); }));
+
+		long long cacheMisses = 0;
+		double seconds = run_lookups(tree, keys, cacheMisses);
+		print_result("find - binary_search_tree, " + std::to_string(size) + " keys", static_cast<int>(keys.size()), seconds, cacheMisses);
+		seconds = run_lookups(frozen, keys, cacheMisses);
+		print_result("find - frozen_search_tree, " + std::to_string(size) + " keys", static_cast<int>(keys.size()), seconds, cacheMisses);
+	}
+}
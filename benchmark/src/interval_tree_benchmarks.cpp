@@ -0,0 +1,92 @@
+#include <benchmarks.h>
+#include <interval_tree.h>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+	//Creates "count" intervals that start at random points in [0, count * 10) and are up to "maxLength" long
+	std::vector<interval<int>> random_intervals(int count, int maxLength, unsigned int seed)
+	{
+		std::mt19937 random(seed);
+		std::vector<interval<int>> intervals;
+		intervals.reserve(count);
+		for (int i = 0; i < count; i++)
+		{
+			int low = static_cast<int>(random() % (static_cast<unsigned int>(count) * 10));
+			intervals.push_back(interval<int>{ low, low + static_cast<int>(random() % static_cast<unsigned int>(maxLength)) });
+		}
+		return intervals;
+	}
+
+	//Runs the same overlap queries against the tree and against a scan over every interval
+	void run_queries(const std::string& name, const interval_tree<int>& tree, const std::vector<interval<int>>& intervals, const std::vector<int>& starts, int queryLength)
+	{
+		int queries = static_cast<int>(starts.size());
+		long long found = 0;
+		print_result("tree overlap queries - " + name, queries, time_seconds([&]() {
+			for (int start : starts)
+			{
+				tree.for_each_overlapping(start, start + queryLength, [&](const interval<int>&) { found++; });
+			}
+		}));
+
+		long long scanned = 0;
+		print_result("linear scan overlap queries - " + name, queries, time_seconds([&]() {
+			for (int start : starts)
+			{
+				for (auto& value : intervals)
+				{
+					if (value.overlaps(start, start + queryLength))
+					{
+						scanned++;
+					}
+				}
+			}
+		}));
+		std::cout << "Overlapping intervals found: tree " << found << ", linear scan " << scanned << "\n";
+		do_not_optimize(found);
+		do_not_optimize(scanned);
+	}
+}
+
+void interval_tree_benchmarks(const benchmark_options& options)
+{
+	print_suite("interval_tree construction and overlap queries against a linear scan");
+
+	int count = options.count(200000);
+	std::vector<interval<int>> intervals = random_intervals(count, 100, 3);
+
+	interval_tree<int> tree;
+	print_result("insert one at a time", count, time_seconds([&]() {
+		for (auto& value : intervals)
+		{
+			tree.insert(value);
+		}
+	}));
+
+	std::vector<interval<int>> sorted = tree.traverse();
+	print_result("from_sorted", count, time_seconds([&]() {
+		interval_tree<int> built = interval_tree<int>::from_sorted(sorted.begin(), sorted.end());
+		do_not_optimize(built.getSize());
+	}));
+
+	//Queries start at random points. The scan reads every interval for each query, so only a few thousand are run
+	std::mt19937 random(9);
+	std::vector<int> starts;
+	for (int i = 0; i < options.count(1000); i++)
+	{
+		starts.push_back(static_cast<int>(random() % (static_cast<unsigned int>(count) * 10)));
+	}
+	run_queries("short queries", tree, sorted, starts, 10);
+	run_queries("long queries", tree, sorted, starts, 10000);
+
+	//A few intervals that cover everything can't be pruned, but they don't slow down the search for the rest
+	std::vector<interval<int>> nested = sorted;
+	for (int i = 0; i < 100; i++)
+	{
+		nested.push_back(interval<int>{ -i, count * 10 + i });
+		tree.insert(nested.back());
+	}
+	run_queries("short queries with 100 covering intervals", tree, nested, starts, 10);
+}
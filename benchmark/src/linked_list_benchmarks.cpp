@@ -0,0 +1,102 @@
+#include <benchmarks.h>
+#include <linked_list.h>
+#include <random>
+
+namespace {
+	//Creates a list whose nodes are scattered around memory. The nodes are built across many lists at random and then joined,
+	//so neighbouring nodes were allocated far apart, like a list that has gone through many inserts and removals
+	linked_list<int> fragmented_list(int count)
+	{
+		const int pieceCount = 1024;
+		std::vector<linked_list<int>> pieces(pieceCount);
+		std::mt19937 random(12345);
+		std::uniform_int_distribution<int> pick(0, pieceCount - 1);
+
+		for (int i = 0; i < count; i++)
+		{
+			pieces[pick(random)].push_back(i);
+			//Leave gaps between the nodes, like a list that has had nodes removed
+			if (i % 4 == 0)
+			{
+				pieces[pick(random)].push_back(i);
+				pieces[pick(random)].pop_back();
+			}
+		}
+
+		linked_list<int> list{};
+		for (auto& piece : pieces)
+		{
+			list.splice_back(std::move(piece));
+		}
+		return list;
+	}
+
+	//Sums every value in the list
+	double iterate(const linked_list<int>& list, int passes)
+	{
+		long long sum = 0;
+		double seconds = time_seconds([&]() {
+			for (int pass = 0; pass < passes; pass++)
+			{
+				for (auto value : list)
+				{
+					sum += value;
+				}
+			}
+		});
+		do_not_optimize(sum);
+		return seconds;
+	}
+}
+
+void linked_list_benchmarks(const benchmark_options& options)
+{
+	print_suite("linked_list iteration before and after compact()");
+
+	int count = options.count(2000000);
+	const int passes = 5;
+
+	linked_list<int> list = fragmented_list(count);
+	print_result("iterate - fragmented", count * passes, iterate(list, passes));
+
+	print_result("compact", count, time_seconds([&]() { list.compact(); }));
+	print_result("iterate - compacted", count * passes, iterate(list, passes));
+
+	print_suite("linked_list copying");
+
+	int copyCount = options.count(10000000);
+	std::vector<int> values(copyCount);
+	for (int i = 0; i < copyCount; i++)
+	{
+		values[i] = i;
+	}
+	//Build the source list in one block, so reading it costs the same for every method
+	linked_list<int> source(values.begin(), values.end());
+
+	//How the list used to be copied, with one allocation per node
+	print_result("copy - push_back one at a time", copyCount, time_seconds([&]() {
+		linked_list<int> copy{};
+		for (const auto& value : source)
+		{
+			copy.push_back(value);
+		}
+		do_not_optimize(copy);
+	}));
+
+	print_result("copy - copy constructor (one batch)", copyCount, time_seconds([&]() {
+		linked_list<int> copy{ source };
+		do_not_optimize(copy);
+	}));
+
+	print_result("construct from a vector range", copyCount, time_seconds([&]() {
+		linked_list<int> copy(values.begin(), values.end());
+		do_not_optimize(copy);
+	}));
+
+	linked_list<int> target{};
+	print_result("insert a range into the middle", copyCount, time_seconds([&]() {
+		target.push_back(0);
+		target.push_back(1);
+		target.insert(--target.end(), values.begin(), values.end());
+	}));
+}
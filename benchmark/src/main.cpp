@@ -0,0 +1,61 @@
+#include <benchmarks.h>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+//Usage: AlgoBenchmarks [suite|all] [scale]
+//The scale multiplies the element counts of every benchmark. For example, a scale of 0.1 runs every benchmark with a tenth of the elements
+int main(int argc, char** argv)
+{
+	std::string suiteToRun = argc > 1 ? argv[1] : "all";
+
+	benchmark_options options{};
+	if (argc > 2)
+	{
+		options.scale = std::atof(argv[2]);
+	}
+
+	//The list of all the benchmark suites that can be run
+	std::vector<std::pair<std::string, std::function<void(const benchmark_options&)>>> suites = {
+		{ "skip_list", skip_list_benchmarks },
+		{ "mpmc_queue", mpmc_queue_benchmarks },
+		{ "concurrent_ordered_list", concurrent_ordered_list_benchmarks },
+		{ "parallel_algorithms", parallel_algorithms_benchmarks },
+		{ "linked_list", linked_list_benchmarks },
+		{ "compact_linked_list", compact_linked_list_benchmarks },
+		{ "binary_search_tree", binary_search_tree_benchmarks },
+		{ "frozen_search_tree", frozen_search_tree_benchmarks },
+		{ "btree", btree_benchmarks },
+		{ "concurrent_search_tree", concurrent_search_tree_benchmarks },
+		{ "persistent_search_tree", persistent_search_tree_benchmarks },
+		{ "compact_search_tree", compact_search_tree_benchmarks },
+		{ "interval_tree", interval_tree_benchmarks },
+		{ "bloom_filter", bloom_filter_benchmarks },
+		{ "flat_hash", flat_hash_benchmarks },
+	};
+
+	bool ranSuite = false;
+	for (auto& suite : suites)
+	{
+		if (suiteToRun == "all" || suiteToRun == suite.first)
+		{
+			suite.second(options);
+			ranSuite = true;
+		}
+	}
+
+	//If the suite could not be found, print the available suites
+	if (!ranSuite)
+	{
+		std::cout << "Unknown benchmark suite \"" << suiteToRun << "\". Available suites:\n";
+		for (auto& suite : suites)
+		{
+			std::cout << "  " << suite.first << "\n";
+		}
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,91 @@
+#include <benchmarks.h>
+#include <mpmc_queue.h>
+#include <atomic>
+#include <thread>
+
+namespace {
+	//Runs "threadCount" producers and "threadCount" consumers that pass "total" values through the queue
+	double run_handoff(int threadCount, int total, std::size_t batchSize)
+	{
+		mpmc_queue<int> queue{ 1024 };
+		std::atomic<int> popped{ 0 };
+		std::atomic<long long> sum{ 0 };
+		std::vector<std::thread> threads;
+
+		double seconds = time_seconds([&]() {
+			int perProducer = total / threadCount;
+			for (int p = 0; p < threadCount; p++)
+			{
+				threads.emplace_back([&queue, p, perProducer, batchSize]() {
+					std::vector<int> batch(batchSize);
+					for (int i = 0; i < perProducer; i += static_cast<int>(batchSize))
+					{
+						//Fill up the next batch of values
+						std::size_t count = 0;
+						for (; count < batchSize && i + static_cast<int>(count) < perProducer; count++)
+						{
+							batch[count] = p + i + static_cast<int>(count);
+						}
+
+						if (count == 1)
+						{
+							queue.push(batch[0]);
+						}
+						else
+						{
+							queue.push_batch(batch.begin(), batch.begin() + count);
+						}
+					}
+				});
+			}
+
+			int expected = perProducer * threadCount;
+			for (int c = 0; c < threadCount; c++)
+			{
+				threads.emplace_back([&queue, &popped, &sum, expected, batchSize]() {
+					std::vector<int> values(batchSize);
+					long long localSum = 0;
+					while (popped.load(std::memory_order_relaxed) < expected)
+					{
+						std::size_t count = queue.try_pop_batch(values.begin(), batchSize);
+						if (count == 0)
+						{
+							std::this_thread::yield();
+							continue;
+						}
+						for (std::size_t i = 0; i < count; i++)
+						{
+							localSum += values[i];
+						}
+						popped.fetch_add(static_cast<int>(count), std::memory_order_relaxed);
+					}
+					sum += localSum;
+				});
+			}
+
+			for (auto& thread : threads)
+			{
+				thread.join();
+			}
+		});
+		do_not_optimize(sum);
+		return seconds;
+	}
+}
+
+void mpmc_queue_benchmarks(const benchmark_options& options)
+{
+	print_suite("mpmc_queue throughput (producers = consumers = thread count)");
+
+	int total = options.count(4000000);
+	for (int threadCount : { 1, 2, 4, 8, 16, 32 })
+	{
+		for (std::size_t batchSize : { 1, 32 })
+		{
+			double seconds = run_handoff(threadCount, total, batchSize);
+			std::string name = std::to_string(threadCount) + " thread(s), batch " + std::to_string(batchSize)
+				+ " - " + std::to_string(static_cast<long long>(total / seconds)) + " values/s";
+			print_result(name, total, seconds);
+		}
+	}
+}
@@ -0,0 +1,94 @@
+#include <benchmarks.h>
+#include <linked_list.h>
+#include <parallel_algorithms.h>
+#include <thread>
+
+namespace {
+	//A small amount of work per value, so the benchmarks measure more than just walking the nodes
+	int mix(int value)
+	{
+		unsigned int x = static_cast<unsigned int>(value);
+		x ^= x >> 16;
+		x *= 0x45d9f3bu;
+		x ^= x >> 16;
+		return static_cast<int>(x & 0xFFFF);
+	}
+
+	//Creates a list with the numbers [0, count)
+	linked_list<int> make_list(int count, int checkpointInterval)
+	{
+		linked_list<int> list{};
+		if (checkpointInterval > 0)
+		{
+			list.enable_checkpoints(checkpointInterval);
+		}
+		for (int i = 0; i < count; i++)
+		{
+			list.push_back(i);
+		}
+		return list;
+	}
+}
+
+void parallel_algorithms_benchmarks(const benchmark_options& options)
+{
+	int count = options.count(10000000);
+	int cores = static_cast<int>(std::thread::hardware_concurrency());
+	print_suite("parallel algorithms over linked_list (" + std::to_string(cores) + " hardware thread(s))");
+
+	linked_list<int> plain = make_list(count, 0);
+	linked_list<int> checkpointed = make_list(count, 1024);
+
+	//Splitting the list into chunks
+	print_result("split into 8 chunks - walking the list", count, time_seconds([&]() { do_not_optimize(plain.split(8)); }));
+	print_result("split into 8 chunks - checkpoints every 1024 nodes", count, time_seconds([&]() { do_not_optimize(checkpointed.split(8)); }));
+
+	//for_each
+	print_result("for_each - sequential", count, time_seconds([&]() {
+		for (auto& value : checkpointed)
+		{
+			value = mix(value);
+		}
+	}));
+	for (int threadCount : { 1, 2, 4, 8 })
+	{
+		print_result("for_each - " + std::to_string(threadCount) + " thread(s)", count, time_seconds([&]() {
+			parallel_for_each(checkpointed, [](int& value) { value = mix(value); }, threadCount);
+		}));
+	}
+
+	//reduce
+	long long sum = 0;
+	print_result("reduce - sequential", count, time_seconds([&]() {
+		for (auto value : checkpointed)
+		{
+			sum += mix(value);
+		}
+	}));
+	for (int threadCount : { 1, 2, 4, 8 })
+	{
+		print_result("reduce - " + std::to_string(threadCount) + " thread(s)", count, time_seconds([&]() {
+			sum += parallel_reduce(checkpointed, 0LL, [](long long result, int value) { return result + mix(value); },
+				[](long long a, long long b) { return a + b; }, threadCount);
+		}));
+	}
+	do_not_optimize(sum);
+
+	//transform
+	print_result("transform - sequential", count, time_seconds([&]() {
+		linked_list<int> output{};
+		for (auto value : checkpointed)
+		{
+			output.push_back(mix(value));
+		}
+		do_not_optimize(output);
+	}));
+	for (int threadCount : { 1, 2, 4, 8 })
+	{
+		print_result("transform - " + std::to_string(threadCount) + " thread(s)", count, time_seconds([&]() {
+			linked_list<int> output{};
+			parallel_transform(checkpointed, output, mix, threadCount);
+			do_not_optimize(output);
+		}));
+	}
+}
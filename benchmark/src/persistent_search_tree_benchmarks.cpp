@@ -0,0 +1,80 @@
+#include <benchmarks.h>
+#include <binary_search_tree.h>
+#include <persistent_search_tree.h>
+
+void persistent_search_tree_benchmarks(const benchmark_options& options)
+{
+	int count = options.count(200000);
+	std::vector<int> values = shuffled_numbers(count);
+	print_suite("persistent_search_tree snapshots (" + std::to_string(count) + " values)");
+
+	binary_search_tree<int> plainTree{};
+	persistent_search_tree<int> persistentTree{};
+	for (auto value : values)
+	{
+		plainTree.insert(value);
+		persistentTree.insert(value);
+	}
+
+	//A binary_search_tree has to copy every node to keep an unchanging version of itself
+	int copies = options.count(20);
+	print_result("snapshot - binary_search_tree copy", copies, time_seconds([&]() {
+		for (int i = 0; i < copies; i++)
+		{
+			binary_search_tree<int> copy = plainTree;
+			do_not_optimize(copy);
+		}
+	}));
+	int snapshots = options.count(2000000);
+	print_result("snapshot - persistent_search_tree", snapshots, time_seconds([&]() {
+		for (int i = 0; i < snapshots; i++)
+		{
+			auto copy = persistentTree.snapshot();
+			do_not_optimize(copy);
+		}
+	}));
+
+	print_suite("persistent_search_tree writes");
+
+	//Removing and inserting every value again, so the size of the tree stays about the same
+	auto churn = [&](auto& tree) {
+		for (auto value : values)
+		{
+			tree.remove(value);
+			tree.insert(value);
+		}
+	};
+	print_result("remove + insert - binary_search_tree", count, time_seconds([&]() { churn(plainTree); }));
+	print_result("remove + insert - persistent_search_tree", count, time_seconds([&]() { churn(persistentTree); }));
+
+	//With a snapshot after every write, the copied paths can't be freed, so every write keeps its O(log n) new nodes
+	std::vector<persistent_search_tree<int>> history;
+	history.reserve(static_cast<size_t>(count) * 2);
+	print_result("remove + insert, snapshot after each", count, time_seconds([&]() {
+		for (auto value : values)
+		{
+			persistentTree.remove(value);
+			history.push_back(persistentTree.snapshot());
+			persistentTree.insert(value);
+			history.push_back(persistentTree.snapshot());
+		}
+	}));
+	print_result("find - binary_search_tree", count, time_seconds([&]() {
+		int hits = 0;
+		for (auto value : values)
+		{
+			hits += plainTree.find(value) != plainTree.end() ? 1 : 0;
+		}
+		do_not_optimize(hits);
+	}));
+	print_result("find - persistent_search_tree", count, time_seconds([&]() {
+		int hits = 0;
+		for (auto value : values)
+		{
+			hits += persistentTree.contains(value) ? 1 : 0;
+		}
+		do_not_optimize(hits);
+	}));
+	int historySize = static_cast<int>(history.size());
+	print_result("free history - persistent_search_tree", historySize, time_seconds([&]() { history.clear(); }));
+}
@@ -0,0 +1,91 @@
+#include <benchmarks.h>
+#include <binary_search_tree.h>
+#include <skip_list.h>
+
+namespace {
+	//Inserts every number, doing a lookup of an earlier number after every ten inserts
+	template<typename Container>
+	double insert_heavy(const std::vector<int>& numbers)
+	{
+		Container container{};
+		int found = 0;
+		double seconds = time_seconds([&]() {
+			for (size_t i = 0; i < numbers.size(); i++)
+			{
+				container.insert(numbers[i]);
+				if (i % 10 == 0 && container.find(numbers[i / 2]) != container.end())
+				{
+					found++;
+				}
+			}
+		});
+		do_not_optimize(found);
+		return seconds;
+	}
+
+	//Runs many short range scans over an already filled container. The tree has no range query, so it has to scan from the lower value with find
+	double scan_heavy_tree(const std::vector<int>& numbers, int scans, int width)
+	{
+		binary_search_tree<int> tree{};
+		for (auto number : numbers)
+		{
+			tree.insert(number);
+		}
+
+		long long sum = 0;
+		double seconds = time_seconds([&]() {
+			for (int i = 0; i < scans; i++)
+			{
+				int low = numbers[i % numbers.size()];
+				for (auto j = tree.find(low); j != tree.end() && *j < low + width; ++j)
+				{
+					sum += *j;
+				}
+			}
+		});
+		do_not_optimize(sum);
+		return seconds;
+	}
+
+	//Runs many short range scans over an already filled skip list
+	double scan_heavy_skip_list(const std::vector<int>& numbers, int scans, int width)
+	{
+		skip_list<int> list{};
+		for (auto number : numbers)
+		{
+			list.insert(number);
+		}
+
+		long long sum = 0;
+		double seconds = time_seconds([&]() {
+			for (int i = 0; i < scans; i++)
+			{
+				int low = numbers[i % numbers.size()];
+				for (auto value : list.range(low, low + width))
+				{
+					sum += value;
+				}
+			}
+		});
+		do_not_optimize(sum);
+		return seconds;
+	}
+}
+
+void skip_list_benchmarks(const benchmark_options& options)
+{
+	print_suite("skip_list vs binary_search_tree");
+
+	for (double baseCount : { 10000.0, 100000.0, 1000000.0 })
+	{
+		int count = options.count(baseCount);
+		auto numbers = shuffled_numbers(count);
+
+		print_result("Insert-heavy - binary_search_tree", count, insert_heavy<binary_search_tree<int>>(numbers));
+		print_result("Insert-heavy - skip_list", count, insert_heavy<skip_list<int>>(numbers));
+
+		int scans = count / 10 < 1 ? 1 : count / 10;
+		print_result("Scan-heavy (width 64) - binary_search_tree", count, scan_heavy_tree(numbers, scans, 64));
+		print_result("Scan-heavy (width 64) - skip_list", count, scan_heavy_skip_list(numbers, scans, 64));
+	}
+}
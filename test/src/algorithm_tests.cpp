@@ -233,4 +233,45 @@ TEST(HeapSortAlgorithm, SortEmpty)
 
 	//Test if the list has been properly sorted
 	ASSERT_EQ(testList, sortedList);
+}
+
+TEST(HeapSortAlgorithm, SortDuplicates)
+{
+	//Create a starting list where most values are repeated
+	linked_list<int> testList{};
+	testList.push_back(5);
+	testList.push_back(3);
+	testList.push_back(5);
+	testList.push_back(1);
+	testList.push_back(3);
+	testList.push_back(5);
+
+	//The same elements, but sorted. Every duplicate is kept
+	linked_list<int> sortedList{};
+	sortedList.push_back(1);
+	sortedList.push_back(3);
+	sortedList.push_back(3);
+	sortedList.push_back(5);
+	sortedList.push_back(5);
+	sortedList.push_back(5);
+
+	//Sort the list
+	heap_sort(testList);
+
+	//Test if the list has been properly sorted
+	ASSERT_EQ(testList, sortedList);
+
+	//Sorting with a comparer uses that comparer's order
+	std::vector<int> values{ 2, 7, 2, 9, 7 };
+	heap_sort(values.begin(), values.end(), [](const int& a, const int& b) { return a > b; });
+	ASSERT_EQ(values, std::vector<int>({ 9, 7, 7, 2, 2 }));
+}
+
+TEST(HeapSortAlgorithm, SortEqualKeysKeepsValues)
+{
+	//Values that compare equal but hold different data must all be kept, in the order they started in
+	std::vector<std::pair<int, char>> values{ { 2, 'b' }, { 1, 'x' }, { 2, 'c' }, { 1, 'y' } };
+	heap_sort(values.begin(), values.end(), [](const std::pair<int, char>& a, const std::pair<int, char>& b) { return a.first < b.first; });
+	std::vector<std::pair<int, char>> expected{ { 1, 'x' }, { 1, 'y' }, { 2, 'b' }, { 2, 'c' } };
+	ASSERT_EQ(values, expected);
 }
\ No newline at end of file
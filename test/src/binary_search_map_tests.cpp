@@ -0,0 +1,183 @@
+#include <gtest/gtest.h>
+#include <common.h>
+#include <binary_search_map.h>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+namespace {
+	//A string key that counts how many of it have been built or copied. Moving a key doesn't count
+	struct counted_key {
+		static int built;
+		std::string text;
+
+		counted_key(std::string_view text) : text(text) { built++; }
+		counted_key(const counted_key& other) : text(other.text) { built++; }
+		counted_key(counted_key&& other) noexcept : text(std::move(other.text)) {}
+		counted_key& operator=(const counted_key& other) = default;
+		counted_key& operator=(counted_key&& other) = default;
+
+		bool operator<(const counted_key& rhs) const
+		{
+			return text < rhs.text;
+		}
+	};
+
+	int counted_key::built = 0;
+
+	//Orders counted_keys, and compares them with string_views without building a key
+	struct counted_key_comparer {
+		using is_transparent = void;
+
+		bool operator()(const counted_key& lhs, const counted_key& rhs) const
+		{
+			return lhs.text < rhs.text;
+		}
+
+		bool operator()(std::string_view lhs, const counted_key& rhs) const
+		{
+			return lhs < rhs.text;
+		}
+
+		bool operator()(const counted_key& lhs, std::string_view rhs) const
+		{
+			return lhs.text < rhs;
+		}
+	};
+}
+
+TEST(BinarySearchMap, InsertFindTest)
+{
+	binary_search_map<int, std::string> map;
+	std::map<int, std::string> expected;
+	std::mt19937 random(5);
+
+	for (int i = 0; i < 5000; i++)
+	{
+		int key = static_cast<int>(random() % 1000);
+		switch (random() % 3)
+		{
+		case 0:
+			ASSERT_EQ(map.insert(key, std::to_string(i)) != map.end(), expected.emplace(key, std::to_string(i)).second);
+			break;
+		case 1:
+			map[key] += "a";
+			expected[key] += "a";
+			break;
+		default:
+			ASSERT_EQ(map.remove(key), expected.erase(key) == 1);
+			break;
+		}
+		ASSERT_EQ(map.getSize(), static_cast<int>(expected.size()));
+	}
+
+	for (int key = -1; key <= 1000; key++)
+	{
+		ASSERT_EQ(map.contains(key), expected.count(key) == 1);
+		auto found = map.find(key);
+		if (expected.count(key) == 1)
+		{
+			ASSERT_NE(found, map.end());
+			ASSERT_EQ(found->second, expected[key]);
+			ASSERT_EQ(map.at(key), expected[key]);
+		}
+		else
+		{
+			ASSERT_EQ(found, map.end());
+			ASSERT_THROW(map.at(key), struct_exception);
+		}
+		auto lower = map.lower_bound(key);
+		auto expectedLower = expected.lower_bound(key);
+		ASSERT_EQ(lower == map.end(), expectedLower == expected.end());
+		if (lower != map.end())
+		{
+			ASSERT_EQ(lower->first, expectedLower->first);
+		}
+	}
+
+	//try_emplace leaves the value of an existing key alone
+	auto first = map.try_emplace(2000, 3, 'x');
+	ASSERT_TRUE(first.second);
+	ASSERT_EQ(first.first->second, "xxx");
+	auto second = map.try_emplace(2000, "y");
+	ASSERT_FALSE(second.second);
+	ASSERT_EQ(second.first, first.first);
+	ASSERT_EQ(map[2000], "xxx");
+
+	binary_search_map<std::string, int> small;
+	small["b"] = 2;
+	small["a"] = 1;
+	std::stringstream stream;
+	stream << small;
+	ASSERT_EQ(stream.str(), "[a: 1, b: 2]");
+}
+
+TEST(BinarySearchMap, HeterogeneousLookupTest)
+{
+	binary_search_map<counted_key, int, counted_key_comparer> map;
+	for (int i = 0; i < 100; i++)
+	{
+		map.insert(counted_key(std::to_string(i)), i);
+	}
+
+	//Searching with a string_view never builds a key
+	counted_key::built = 0;
+	std::string_view key = "42";
+	ASSERT_TRUE(map.contains(key));
+	ASSERT_EQ(map.find(key)->second, 42);
+	ASSERT_EQ(map.at(key), 42);
+	ASSERT_EQ(map.lower_bound(std::string_view("425"))->first.text, "43");
+	ASSERT_FALSE(map.contains(std::string_view("100")));
+	ASSERT_EQ(counted_key::built, 0);
+
+	//operator[] searches once, and only builds a key if it inserts one
+	map[key] = 7;
+	ASSERT_EQ(counted_key::built, 0);
+	map[std::string_view("new")] = 8;
+	ASSERT_EQ(counted_key::built, 1);
+	ASSERT_EQ(map.at(std::string_view("new")), 8);
+
+	ASSERT_TRUE(map.remove(key));
+	ASSERT_FALSE(map.contains(key));
+	ASSERT_EQ(map.getSize(), 100);
+
+	//With a comparer that isn't transparent, other key types are converted to the key once per search instead of once per comparison
+	binary_search_map<counted_key, int> plainMap;
+	for (int i = 0; i < 100; i++)
+	{
+		plainMap.insert(counted_key(std::to_string(i)), i);
+	}
+	counted_key::built = 0;
+	ASSERT_EQ(plainMap.at(std::string_view("42")), 42);
+	ASSERT_EQ(counted_key::built, 1);
+}
+
+TEST(BinarySearchMap, MoveKeyTest)
+{
+	binary_search_map<counted_key, int, counted_key_comparer> map;
+
+	//A key passed as an rvalue is moved into the pair instead of copied
+	counted_key::built = 0;
+	ASSERT_NE(map.insert(counted_key("a"), 1), map.end());
+	ASSERT_TRUE(map.try_emplace(counted_key("b"), 2).second);
+	map[counted_key("c")] = 3;
+	ASSERT_EQ(counted_key::built, 3);
+
+	//A key passed as an lvalue is copied, and is left unchanged
+	counted_key key("d");
+	counted_key::built = 0;
+	map.insert(key, 4);
+	ASSERT_EQ(counted_key::built, 1);
+	ASSERT_EQ(key.text, "d");
+
+	//Nothing is built or moved if the key is already in the map
+	counted_key existing("a");
+	counted_key::built = 0;
+	ASSERT_FALSE(map.try_emplace(std::move(existing), 5).second);
+	ASSERT_EQ(existing.text, "a");
+	ASSERT_EQ(map.at(std::string_view("a")), 1);
+	ASSERT_EQ(counted_key::built, 0);
+	ASSERT_EQ(map.getSize(), 4);
+}
@@ -1,6 +1,15 @@
 #include <gtest/gtest.h>
 #include <common.h>
 #include "binary_search_tree.h"
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
 
 TEST(BinarySearchTree, Insert)
 {
@@ -298,4 +307,942 @@ TEST(BinarySearchTree, PrintTest)
 
 	//Test if the string is the same as the expected output
 	ASSERT_TRUE(result == std::string("[20, 30, 40, 50, 60, 70, 80]"));
-}
\ No newline at end of file
+}
+
+//Checks that every node's height matches its children, and that the tree is as balanced as possible. Returns the height of the subtree
+template<typename Iterator>
+int checkPerfectBalance(Iterator node, int& count)
+{
+	//Only the end() iterator has a height of 0
+	if (node.getHeight() == 0)
+	{
+		return 0;
+	}
+	int left = checkPerfectBalance(node.getLeft(), count);
+	int right = checkPerfectBalance(node.getRight(), count);
+	EXPECT_LE(left > right ? left - right : right - left, 1);
+	EXPECT_EQ(node.getHeight(), (left > right ? left : right) + 1);
+	count++;
+	return node.getHeight();
+}
+
+TEST(BinarySearchTree, FromSortedTest)
+{
+	std::vector<int> values;
+	for (int i = 0; i < 1000; i++)
+	{
+		values.push_back(i * 2);
+	}
+
+	auto tree = binary_search_tree<int>::from_sorted(values.begin(), values.end());
+	ASSERT_EQ(tree.getSize(), 1000);
+	ASSERT_EQ(tree.traverse(), values);
+
+	//A perfectly balanced tree of 1000 nodes has a height of 10
+	ASSERT_EQ(tree.getRoot().getHeight(), 10);
+	int count = 0;
+	checkPerfectBalance(tree.getRoot(), count);
+	ASSERT_EQ(count, 1000);
+
+	//The tree still works normally after being built
+	ASSERT_TRUE(tree.find(500) != tree.end());
+	ASSERT_TRUE(tree.find(501) == tree.end());
+	ASSERT_TRUE(tree.insert(501) != tree.end());
+	ASSERT_TRUE(tree.remove(0));
+	ASSERT_EQ(tree.getSize(), 1000);
+	ASSERT_EQ(*tree.minimum(), 2);
+
+	//An empty range gives an empty tree
+	auto empty = binary_search_tree<int>::from_sorted(values.end(), values.end());
+	ASSERT_EQ(empty.getSize(), 0);
+	ASSERT_TRUE(empty.begin() == empty.end());
+}
+
+TEST(BinarySearchTree, FromSortedComparerTest)
+{
+	//The range only needs to be sorted by the tree's comparer
+	std::vector<int> descending{ 9, 7, 5, 3, 1 };
+	auto tree = binary_search_tree<int>::from_sorted(descending.begin(), descending.end(), [](const int& a, const int& b) { return a > b; });
+	ASSERT_EQ(tree.traverse(), descending);
+	ASSERT_TRUE(tree.insert(4) != tree.end());
+	ASSERT_EQ(tree.traverse(), (std::vector<int>{ 9, 7, 5, 4, 3, 1 }));
+}
+
+TEST(BinarySearchTree, FromUnsortedTest)
+{
+	std::vector<std::string> values{ "pear", "apple", "fig", "apple", "kiwi", "fig" };
+	auto tree = binary_search_tree<std::string>::from_unsorted(values.begin(), values.end());
+	ASSERT_EQ(tree.getSize(), 4);
+	ASSERT_EQ(tree.traverse(), (std::vector<std::string>{ "apple", "fig", "kiwi", "pear" }));
+
+	//Initializer lists are built the same way
+	binary_search_tree<int> numbers{ 5, 1, 4, 1, 3 };
+	ASSERT_EQ(numbers.traverse(), (std::vector<int>{ 1, 3, 4, 5 }));
+}
+
+TEST(BinarySearchTree, BalancedCopyTest)
+{
+	//Inserting in order with self-balancing disabled creates a tree that is just a line of nodes
+	binary_search_tree<int> line{};
+	line.setSelfBalancing(false);
+	for (int i = 0; i < 100; i++)
+	{
+		line.insert(i);
+	}
+
+	//The copy is perfectly balanced and separate from the original
+	binary_search_tree<int> copy{ line };
+	ASSERT_EQ(copy.traverse(), line.traverse());
+	int count = 0;
+	checkPerfectBalance(copy.getRoot(), count);
+	ASSERT_EQ(count, 100);
+	copy.remove(50);
+	ASSERT_TRUE(line.find(50) != line.end());
+
+	binary_search_tree<int> assigned{ 1000, 2000 };
+	assigned = line;
+	ASSERT_EQ(assigned.traverse(), line.traverse());
+	assigned = assigned;
+	ASSERT_EQ(assigned.getSize(), 100);
+}
+
+//A value that counts how many instances are alive
+struct counted_value
+{
+	static int alive;
+	int value;
+
+	counted_value(int value) : value(value) { alive++; }
+	counted_value(const counted_value& other) : value(other.value) { alive++; }
+	~counted_value() { alive--; }
+
+	bool operator<(const counted_value& other) const { return value < other.value; }
+};
+
+int counted_value::alive = 0;
+
+TEST(BinarySearchTree, ClearFreesEveryNodeTest)
+{
+	{
+		binary_search_tree<counted_value> tree{};
+		for (int i = 0; i < 1000; i++)
+		{
+			tree.insert(counted_value((i * 7919) % 1000));
+		}
+		ASSERT_EQ(counted_value::alive, 1000);
+
+		tree.clear();
+		ASSERT_EQ(counted_value::alive, 0);
+		ASSERT_EQ(tree.getSize(), 0);
+		ASSERT_TRUE(tree.begin() == tree.end());
+
+		//The tree can be used again after being cleared
+		tree.insert(counted_value(5));
+		tree.insert(counted_value(3));
+		ASSERT_EQ(tree.getSize(), 2);
+		ASSERT_EQ(tree.minimum()->value, 3);
+	}
+	//The destructor frees the rest
+	ASSERT_EQ(counted_value::alive, 0);
+}
+
+TEST(BinarySearchTree, ClearDeepTreeTest)
+{
+	//Without self-balancing, inserting in order creates a tree that is as deep as it is large
+	binary_search_tree<int> tree{};
+	tree.setSelfBalancing(false);
+	for (int i = 0; i < 5000; i++)
+	{
+		tree.insert(5000 - i);
+	}
+	ASSERT_EQ(tree.getSize(), 5000);
+
+	tree.clear();
+	ASSERT_EQ(tree.getSize(), 0);
+	ASSERT_TRUE(tree.getRoot() == tree.end());
+}
+
+TEST(BinarySearchTree, SortedInsertStaysBalancedTest)
+{
+	//Inserting in ascending or descending order must still give a tree whose subtrees never differ in height by more than 1
+	binary_search_tree<int> ascending{};
+	binary_search_tree<int> descending{};
+	for (int i = 0; i < 4096; i++)
+	{
+		ascending.insert(i);
+		descending.insert(4096 - i);
+	}
+	int count = 0;
+	checkPerfectBalance(ascending.getRoot(), count);
+	checkPerfectBalance(descending.getRoot(), count);
+	ASSERT_EQ(count, 8192);
+	//An AVL tree of 4096 nodes is at most 1.44 * log2(4096) nodes high
+	ASSERT_LE(ascending.getRoot().getHeight(), 17);
+
+	//Removing in order keeps the tree balanced as well
+	for (int i = 0; i < 4096; i += 2)
+	{
+		ASSERT_TRUE(ascending.remove(i));
+	}
+	count = 0;
+	checkPerfectBalance(ascending.getRoot(), count);
+	ASSERT_EQ(count, 2048);
+	ASSERT_EQ(*ascending.minimum(), 1);
+}
+
+using order_statistics_tree = binary_search_tree<int, std::function<bool(const int&, const int&)>, std::allocator<int>, bst_order_statistics>;
+
+//Checks that select(), rank() and advance() agree with a sorted list of the values in the tree
+void checkOrderStatistics(order_statistics_tree& tree, const std::vector<int>& expected)
+{
+	ASSERT_EQ(tree.getSize(), static_cast<int>(expected.size()));
+	for (int i = 0; i < static_cast<int>(expected.size()); i++)
+	{
+		auto value = tree.select(i);
+		ASSERT_TRUE(value != tree.end());
+		ASSERT_EQ(*value, expected[i]);
+		ASSERT_EQ(tree.rank(expected[i]), i);
+	}
+	ASSERT_TRUE(tree.select(static_cast<int>(expected.size())) == tree.end());
+	ASSERT_TRUE(tree.select(-1) == tree.end());
+}
+
+TEST(BinarySearchTree, OrderStatisticsTest)
+{
+	order_statistics_tree tree{};
+	std::vector<int> expected;
+
+	//Insert shuffled values, so every kind of rotation happens
+	for (int i = 0; i < 500; i++)
+	{
+		int value = (i * 7919) % 1000;
+		tree.insert(value);
+		expected.insert(std::lower_bound(expected.begin(), expected.end(), value), value);
+	}
+	checkOrderStatistics(tree, expected);
+
+	//Remove every third value, including nodes with two children
+	for (int i = 0; i < 500; i += 3)
+	{
+		int value = (i * 7919) % 1000;
+		ASSERT_TRUE(tree.remove(value));
+		expected.erase(std::lower_bound(expected.begin(), expected.end(), value));
+	}
+	checkOrderStatistics(tree, expected);
+
+	//Values that aren't in the tree are ranked by how many values are smaller
+	ASSERT_EQ(tree.rank(-5), 0);
+	ASSERT_EQ(tree.rank(100000), tree.getSize());
+	ASSERT_EQ(tree.count_range(100, 200), std::lower_bound(expected.begin(), expected.end(), 200) - std::lower_bound(expected.begin(), expected.end(), 100));
+	ASSERT_EQ(tree.count_range(200, 100), 0);
+	ASSERT_EQ(tree.count_range(-1000, 5000), tree.getSize());
+
+	//Copies and trees built from sorted values have their subtree sizes filled in
+	order_statistics_tree copy{ tree };
+	checkOrderStatistics(copy, expected);
+	auto built = order_statistics_tree::from_sorted(expected.begin(), expected.end());
+	checkOrderStatistics(built, expected);
+}
+
+TEST(BinarySearchTree, OrderStatisticsUnbalancedTest)
+{
+	order_statistics_tree tree{};
+	tree.setSelfBalancing(false);
+	std::vector<int> expected;
+	for (int i = 0; i < 200; i++)
+	{
+		tree.insert(200 - i);
+		expected.insert(expected.begin(), 200 - i);
+	}
+	checkOrderStatistics(tree, expected);
+	tree.remove(100);
+	expected.erase(expected.begin() + 99);
+	checkOrderStatistics(tree, expected);
+}
+
+TEST(BinarySearchTree, AdvanceTest)
+{
+	std::vector<int> values;
+	for (int i = 0; i < 100; i++)
+	{
+		values.push_back(i * 10);
+	}
+	auto tree = order_statistics_tree::from_sorted(values.begin(), values.end());
+
+	auto i = tree.begin();
+	i.advance(42);
+	ASSERT_EQ(*i, 420);
+	i.advance(-40);
+	ASSERT_EQ(*i, 20);
+	//The iterator can still be incremented normally after advancing
+	++i;
+	ASSERT_EQ(*i, 30);
+	i.advance(0);
+	ASSERT_EQ(*i, 30);
+
+	//Advancing one past the largest value gives end(), and end() can be moved backwards
+	i.advance(97);
+	ASSERT_TRUE(i == tree.end());
+	i.advance(-1);
+	ASSERT_EQ(*i, 990);
+
+	ASSERT_THROW(i.advance(2), struct_exception);
+	ASSERT_THROW(tree.begin().advance(-1), struct_exception);
+
+	const order_statistics_tree& constTree = tree;
+	auto constIterator = constTree.begin();
+	constIterator.advance(5);
+	ASSERT_EQ(*constIterator, 50);
+	ASSERT_EQ(*constTree.select(99), 990);
+}
+
+TEST(BinarySearchTree, BoundsTest)
+{
+	binary_search_tree<int> tree{ 10, 20, 30, 40, 50 };
+
+	ASSERT_EQ(*tree.lower_bound(20), 20);
+	ASSERT_EQ(*tree.lower_bound(21), 30);
+	ASSERT_EQ(*tree.lower_bound(-100), 10);
+	ASSERT_TRUE(tree.lower_bound(51) == tree.end());
+
+	ASSERT_EQ(*tree.upper_bound(20), 30);
+	ASSERT_EQ(*tree.upper_bound(19), 20);
+	ASSERT_TRUE(tree.upper_bound(50) == tree.end());
+
+	auto found = tree.equal_range(30);
+	ASSERT_EQ(*found.first, 30);
+	ASSERT_EQ(*found.second, 40);
+	auto missing = tree.equal_range(35);
+	ASSERT_TRUE(missing.first == missing.second);
+	ASSERT_EQ(*missing.first, 40);
+
+	ASSERT_EQ(*tree.floor(35), 30);
+	ASSERT_EQ(*tree.floor(30), 30);
+	ASSERT_EQ(*tree.floor(1000), 50);
+	ASSERT_TRUE(tree.floor(9) == tree.end());
+	ASSERT_EQ(*tree.ceiling(35), 40);
+	ASSERT_EQ(*tree.ceiling(40), 40);
+	ASSERT_TRUE(tree.ceiling(51) == tree.end());
+
+	const binary_search_tree<int>& constTree = tree;
+	ASSERT_EQ(*constTree.lower_bound(11), 20);
+	ASSERT_EQ(*constTree.upper_bound(10), 20);
+	ASSERT_EQ(*constTree.floor(11), 10);
+	ASSERT_EQ(*constTree.ceiling(11), 20);
+	ASSERT_EQ(*constTree.equal_range(10).first, 10);
+
+	binary_search_tree<int> empty{};
+	ASSERT_TRUE(empty.lower_bound(0) == empty.end());
+	ASSERT_TRUE(empty.floor(0) == empty.end());
+}
+
+TEST(BinarySearchTree, RangeTest)
+{
+	binary_search_tree<int> tree{};
+	for (int i = 0; i < 1000; i++)
+	{
+		tree.insert((i * 7919) % 1000);
+	}
+
+	std::vector<int> values;
+	for (auto value : tree.range(250, 260))
+	{
+		values.push_back(value);
+	}
+	ASSERT_EQ(values, (std::vector<int>{ 250, 251, 252, 253, 254, 255, 256, 257, 258, 259 }));
+
+	//The bounds don't need to be in the tree
+	tree.remove(250);
+	values.clear();
+	for (auto value : tree.range(249, 252))
+	{
+		values.push_back(value);
+	}
+	ASSERT_EQ(values, (std::vector<int>{ 249, 251 }));
+
+	//An empty or backwards range has no values
+	ASSERT_TRUE(tree.range(5, 5).empty());
+	ASSERT_TRUE(tree.range(10, 5).empty());
+	ASSERT_TRUE(tree.range(2000, 3000).empty());
+
+	//A range that goes past the largest value ends at end()
+	const binary_search_tree<int>& constTree = tree;
+	int count = 0;
+	for (auto value : constTree.range(990, 5000))
+	{
+		ASSERT_GE(value, 990);
+		count++;
+	}
+	ASSERT_EQ(count, 10);
+}
+
+using red_black_tree = binary_search_tree<int, std::function<bool(const int&, const int&)>, std::allocator<int>, bst_no_augmentation, bst_red_black_balancing>;
+
+//Checks the red-black rules in a subtree and returns how many black nodes are on every path down to a leaf
+template<typename Iterator>
+int checkRedBlack(Iterator node, Iterator end, int& count)
+{
+	//Missing children count as black
+	if (node == end)
+	{
+		return 1;
+	}
+	count++;
+	//A red node never has a red child
+	if (node.isRed())
+	{
+		EXPECT_FALSE(node.getLeft().isRed());
+		EXPECT_FALSE(node.getRight().isRed());
+	}
+	int leftBlack = checkRedBlack(node.getLeft(), end, count);
+	int rightBlack = checkRedBlack(node.getRight(), end, count);
+	EXPECT_EQ(leftBlack, rightBlack);
+	return leftBlack + (node.isRed() ? 0 : 1);
+}
+
+TEST(BinarySearchTree, RedBlackTest)
+{
+	red_black_tree tree{};
+	std::set<int> expected{};
+	std::mt19937 random(3);
+
+	//Randomly insert and remove values, and check the rules of the tree as it changes
+	for (int i = 0; i < 20000; i++)
+	{
+		int value = static_cast<int>(random() % 1000);
+		if (random() % 3 != 0)
+		{
+			ASSERT_EQ(tree.insert(value) != tree.end(), expected.insert(value).second);
+		}
+		else
+		{
+			ASSERT_EQ(tree.remove(value), expected.erase(value) == 1);
+		}
+
+		if (i % 500 == 0)
+		{
+			int count = 0;
+			ASSERT_FALSE(tree.getRoot().isRed());
+			checkRedBlack(tree.getRoot(), tree.end(), count);
+			ASSERT_EQ(count, static_cast<int>(expected.size()));
+			ASSERT_EQ(tree.traverse(), std::vector<int>(expected.begin(), expected.end()));
+		}
+	}
+
+	//Sorted inserts keep the tree within twice the height of a perfectly balanced tree
+	red_black_tree sorted{};
+	for (int i = 0; i < 4096; i++)
+	{
+		sorted.insert(i);
+	}
+	ASSERT_LE(sorted.getRoot().getHeight(), 24);
+	int count = 0;
+	checkRedBlack(sorted.getRoot(), sorted.end(), count);
+	ASSERT_EQ(count, 4096);
+}
+
+TEST(BinarySearchTree, RedBlackBuildTest)
+{
+	//Trees built from sorted values, or copied, are colored correctly for every size
+	for (int size = 0; size < 70; size++)
+	{
+		std::vector<int> values;
+		for (int i = 0; i < size; i++)
+		{
+			values.push_back(i);
+		}
+		auto tree = red_black_tree::from_sorted(values.begin(), values.end());
+		red_black_tree copy{ tree };
+		for (auto* current : { &tree, &copy })
+		{
+			int count = 0;
+			ASSERT_FALSE(current->getRoot().isRed());
+			checkRedBlack(current->getRoot(), current->end(), count);
+			ASSERT_EQ(count, size);
+		}
+
+		//The built tree can still be changed
+		for (int i = 0; i < size; i += 3)
+		{
+			ASSERT_TRUE(tree.remove(i));
+		}
+		tree.insert(-1);
+		int count = 0;
+		checkRedBlack(tree.getRoot(), tree.end(), count);
+		ASSERT_EQ(count, tree.getSize());
+	}
+
+	//Turning balancing back on rebuilds the tree
+	red_black_tree tree{};
+	tree.setSelfBalancing(false);
+	for (int i = 0; i < 100; i++)
+	{
+		tree.insert(i);
+	}
+	ASSERT_EQ(tree.getRoot().getHeight(), 100);
+	tree.setSelfBalancing(true);
+	ASSERT_EQ(tree.getRoot().getHeight(), 7);
+	int count = 0;
+	checkRedBlack(tree.getRoot(), tree.end(), count);
+	ASSERT_EQ(count, 100);
+}
+
+TEST(BinarySearchTree, RedBlackOrderStatisticsTest)
+{
+	//The augmentation data stays correct through the rotations of a red-black tree
+	binary_search_tree<int, std::function<bool(const int&, const int&)>, std::allocator<int>, bst_order_statistics, bst_red_black_balancing> tree{};
+	std::set<int> expected{};
+	std::mt19937 random(11);
+	for (int i = 0; i < 5000; i++)
+	{
+		int value = static_cast<int>(random() % 500);
+		if (random() % 3 != 0)
+		{
+			tree.insert(value);
+			expected.insert(value);
+		}
+		else
+		{
+			tree.remove(value);
+			expected.erase(value);
+		}
+	}
+	std::vector<int> sorted(expected.begin(), expected.end());
+	for (int i = 0; i < static_cast<int>(sorted.size()); i++)
+	{
+		ASSERT_EQ(*tree.select(i), sorted[i]);
+		ASSERT_EQ(tree.rank(sorted[i]), i);
+	}
+}
+
+TEST(BinarySearchTree, SplitJoinTest)
+{
+	binary_search_tree<int> tree{};
+	for (int i = 0; i < 1000; i++)
+	{
+		tree.insert(i * 2);
+	}
+
+	//Splitting at a value that isn't in the tree, and at one that is
+	auto upper = tree.split(1001);
+	ASSERT_EQ(tree.getSize(), 501);
+	ASSERT_EQ(upper.getSize(), 499);
+	ASSERT_EQ(*tree.maximum(), 1000);
+	ASSERT_EQ(*upper.minimum(), 1002);
+	auto middle = tree.split(500);
+	ASSERT_EQ(tree.getSize(), 250);
+	ASSERT_EQ(middle.getSize(), 251);
+	ASSERT_EQ(*middle.minimum(), 500);
+
+	int count = 0;
+	checkPerfectBalance(tree.getRoot(), count);
+	checkPerfectBalance(middle.getRoot(), count);
+	checkPerfectBalance(upper.getRoot(), count);
+	ASSERT_EQ(count, 1000);
+
+	//Joining a tree with values that aren't all greater throws, and leaves both trees unchanged
+	ASSERT_THROW(middle.join(std::move(tree)), struct_exception);
+	ASSERT_EQ(tree.getSize(), 250);
+
+	//Joining trees of very different heights keeps the result balanced
+	binary_search_tree<int> small{ 5000 };
+	upper.join(std::move(small));
+	tree.join(std::move(middle));
+	tree.join(std::move(upper));
+	ASSERT_EQ(tree.getSize(), 1001);
+	ASSERT_EQ(middle.getSize(), 0);
+	count = 0;
+	checkPerfectBalance(tree.getRoot(), count);
+	ASSERT_EQ(count, 1001);
+	std::vector<int> expected;
+	for (int i = 0; i < 1000; i++)
+	{
+		expected.push_back(i * 2);
+	}
+	expected.push_back(5000);
+	ASSERT_EQ(tree.traverse(), expected);
+
+	//The subtree sizes are kept up to date, so the size of a split tree is found in O(1)
+	order_statistics_tree statistics = order_statistics_tree::from_sorted(expected.begin(), expected.end());
+	auto statisticsUpper = statistics.split(1500);
+	checkOrderStatistics(statistics, std::vector<int>(expected.begin(), expected.begin() + 750));
+	checkOrderStatistics(statisticsUpper, std::vector<int>(expected.begin() + 750, expected.end()));
+}
+
+TEST(BinarySearchTree, SetOperationsTest)
+{
+	std::mt19937 random(21);
+	//The larger trees are split between threads, and the smaller trees use very different sizes
+	for (int size : { 0, 50, 20000 })
+	{
+		for (int otherSize : { 0, 30, 3000, 30000 })
+		{
+			std::set<int> a;
+			std::set<int> b;
+			for (int i = 0; i < size; i++)
+			{
+				a.insert(static_cast<int>(random() % 100000));
+			}
+			for (int i = 0; i < otherSize; i++)
+			{
+				b.insert(static_cast<int>(random() % 100000));
+			}
+			std::vector<int> expectedUnion;
+			std::vector<int> expectedIntersection;
+			std::vector<int> expectedDifference;
+			std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expectedUnion));
+			std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expectedIntersection));
+			std::set_difference(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expectedDifference));
+
+			auto treeA = binary_search_tree<int>::from_sorted(a.begin(), a.end());
+			auto treeB = binary_search_tree<int>::from_sorted(b.begin(), b.end());
+
+			//The const overloads leave the other tree unchanged
+			auto unionTree = treeA;
+			unionTree.union_with(treeB, 4);
+			ASSERT_EQ(unionTree.traverse(), expectedUnion);
+			ASSERT_EQ(unionTree.getSize(), static_cast<int>(expectedUnion.size()));
+			auto intersectionTree = treeA;
+			intersectionTree.intersect_with(treeB, 4);
+			ASSERT_EQ(intersectionTree.traverse(), expectedIntersection);
+			ASSERT_EQ(intersectionTree.getSize(), static_cast<int>(expectedIntersection.size()));
+			auto differenceTree = treeA;
+			differenceTree.difference(treeB, 4);
+			ASSERT_EQ(differenceTree.traverse(), expectedDifference);
+			ASSERT_EQ(differenceTree.getSize(), static_cast<int>(expectedDifference.size()));
+			ASSERT_EQ(treeB.getSize(), static_cast<int>(b.size()));
+
+			int count = 0;
+			checkPerfectBalance(unionTree.getRoot(), count);
+			checkPerfectBalance(intersectionTree.getRoot(), count);
+			checkPerfectBalance(differenceTree.getRoot(), count);
+
+			//The rvalue overloads move the nodes of the other tree, and leave it empty
+			auto movedA = treeA;
+			auto movedB = treeB;
+			movedA.union_with(std::move(movedB), 4);
+			ASSERT_EQ(movedA.traverse(), expectedUnion);
+			ASSERT_EQ(movedB.getSize(), 0);
+			movedA = treeA;
+			movedB = treeB;
+			movedA.intersect_with(std::move(movedB), 1);
+			ASSERT_EQ(movedA.traverse(), expectedIntersection);
+			movedA = treeA;
+			movedB = treeB;
+			movedA.difference(std::move(movedB), 2);
+			ASSERT_EQ(movedA.traverse(), expectedDifference);
+			ASSERT_EQ(movedA.getSize(), static_cast<int>(expectedDifference.size()));
+			count = 0;
+			checkPerfectBalance(movedA.getRoot(), count);
+			ASSERT_EQ(count, static_cast<int>(expectedDifference.size()));
+		}
+	}
+
+	//Trees with their own pools can't free each other's nodes, so the values are copied instead
+	using pool_tree = binary_search_tree<int, std::function<bool(const int&, const int&)>, pool_allocator<int>>;
+	pool_tree first{};
+	pool_tree second{};
+	for (int i = 0; i < 100; i++)
+	{
+		first.insert(i);
+		second.insert(i + 50);
+	}
+	first.union_with(std::move(second));
+	ASSERT_EQ(first.getSize(), 150);
+	ASSERT_EQ(second.getSize(), 0);
+	first.difference(first);
+	ASSERT_EQ(first.getSize(), 0);
+}
+
+TEST(BinarySearchTree, SetOperationsThrowTest)
+{
+	//The comparer throws once its budget runs out, which may happen on any of the worker threads
+	using throwing_tree = binary_search_tree<counted_value>;
+	std::atomic<int> callsLeft{ 1 << 30 };
+	auto makeComparer = [&callsLeft]()
+	{
+		return std::function<bool(const counted_value&, const counted_value&)>([&callsLeft](const counted_value& left, const counted_value& right)
+		{
+			if (callsLeft.fetch_sub(1) <= 0)
+			{
+				throw struct_exception("Out of comparisons");
+			}
+			return left < right;
+		});
+	};
+	std::vector<counted_value> evens;
+	std::vector<counted_value> thirds;
+	for (int i = 0; i < 20000; i++)
+	{
+		evens.push_back(counted_value(i * 2));
+		thirds.push_back(counted_value(i * 3));
+	}
+	int valuesAlive = counted_value::alive;
+
+	for (int threadCount : { 1, 4 })
+	{
+		for (int operation = 0; operation < 4; operation++)
+		{
+			for (int budget : { 0, 1, 10, 500, 5000, 30000 })
+			{
+				callsLeft = 1 << 30;
+				auto tree = throwing_tree::from_sorted(evens.begin(), evens.end(), makeComparer());
+				auto other = throwing_tree::from_sorted(thirds.begin(), thirds.end(), makeComparer());
+				callsLeft = budget;
+				bool threw = false;
+				try
+				{
+					switch (operation)
+					{
+					case 0:
+						tree.union_with(other, threadCount);
+						break;
+					case 1:
+						tree.intersect_with(other, threadCount);
+						break;
+					case 2:
+						tree.difference(std::move(other), threadCount);
+						break;
+					default:
+						tree.erase_batch(thirds.begin(), thirds.end());
+						break;
+					}
+				}
+				catch (const struct_exception&)
+				{
+					threw = true;
+				}
+				callsLeft = 1 << 30;
+
+				//A failed operation leaves an empty tree, unless it threw before the tree was touched
+				int count = 0;
+				checkPerfectBalance(tree.getRoot(), count);
+				ASSERT_EQ(count, tree.getSize());
+				if (threw)
+				{
+					ASSERT_TRUE(tree.getSize() == 0 || (operation == 3 && tree.getSize() == static_cast<int>(evens.size())));
+					int size = tree.getSize();
+					tree.insert(counted_value(1));
+					ASSERT_EQ(tree.getSize(), size + 1);
+				}
+			}
+			ASSERT_EQ(counted_value::alive, valuesAlive);
+		}
+	}
+}
+
+TEST(BinarySearchTree, MultisetTest)
+{
+	using multiset_tree = binary_search_tree<int, std::function<bool(const int&, const int&)>, std::allocator<int>, bst_order_statistics, bst_avl_balancing, bst_counted_keys>;
+	multiset_tree tree{};
+	std::multiset<int> expected{};
+	std::mt19937 random(8);
+
+	//Many inserts of a few keys only create one node per key
+	for (int i = 0; i < 20000; i++)
+	{
+		int value = static_cast<int>(random() % 100);
+		if (random() % 4 != 0)
+		{
+			auto inserted = tree.insert(value);
+			ASSERT_TRUE(inserted != tree.end());
+			ASSERT_EQ(*inserted, value);
+			expected.insert(value);
+		}
+		else if (random() % 2 == 0)
+		{
+			ASSERT_EQ(tree.remove(value), expected.count(value) > 0);
+			auto found = expected.find(value);
+			if (found != expected.end())
+			{
+				expected.erase(found);
+			}
+		}
+		else
+		{
+			ASSERT_EQ(tree.remove_all(value), static_cast<int>(expected.erase(value)));
+		}
+		ASSERT_EQ(tree.getSize(), static_cast<int>(expected.size()));
+	}
+	ASSERT_LE(tree.getDistinctSize(), 100);
+	ASSERT_EQ(tree.traverse(), std::vector<int>(expected.begin(), expected.end()));
+	for (int i = 0; i < 100; i++)
+	{
+		ASSERT_EQ(tree.count(i), static_cast<int>(expected.count(i)));
+	}
+
+	//Iterating visits each distinct value once, with its count
+	int total = 0;
+	for (auto i = tree.begin(); i != tree.end(); ++i)
+	{
+		ASSERT_EQ(i.getCount(), static_cast<int>(expected.count(*i)));
+		total += i.getCount();
+	}
+	ASSERT_EQ(total, tree.getSize());
+	int count = 0;
+	checkPerfectBalance(tree.getRoot(), count);
+	ASSERT_EQ(count, tree.getDistinctSize());
+
+	//Copies keep the counts
+	multiset_tree copy = tree;
+	ASSERT_EQ(copy.getSize(), tree.getSize());
+	ASSERT_EQ(copy.traverse(), tree.traverse());
+
+	//Building from a range counts the duplicates instead of dropping them
+	std::vector<int> values{ 4, 1, 4, 2, 4, 1 };
+	auto built = multiset_tree::from_unsorted(values.begin(), values.end());
+	ASSERT_EQ(built.getSize(), 6);
+	ASSERT_EQ(built.getDistinctSize(), 3);
+	ASSERT_EQ(built.count(4), 3);
+	std::stringstream stream;
+	stream << built;
+	ASSERT_EQ(stream.str(), "[1, 1, 2, 4, 4, 4]");
+
+	//Removing through an iterator removes one copy
+	ASSERT_TRUE(built.remove(built.find(4)));
+	ASSERT_EQ(built.count(4), 2);
+	built.clear();
+	ASSERT_EQ(built.getSize(), 0);
+
+	//Removing a node with two children moves the count along with the value, for both balancing policies
+	binary_search_tree<int, std::function<bool(const int&, const int&)>, std::allocator<int>, bst_no_augmentation, bst_red_black_balancing, bst_counted_keys> redBlack{};
+	std::multiset<int> redBlackExpected{};
+	for (int i = 0; i < 5000; i++)
+	{
+		int value = static_cast<int>(random() % 200);
+		if (random() % 3 != 0)
+		{
+			redBlack.insert(value);
+			redBlackExpected.insert(value);
+		}
+		else
+		{
+			ASSERT_EQ(redBlack.remove_all(value), static_cast<int>(redBlackExpected.erase(value)));
+		}
+	}
+	ASSERT_EQ(redBlack.traverse(), std::vector<int>(redBlackExpected.begin(), redBlackExpected.end()));
+
+	//A tree with unique keys still rejects duplicates
+	binary_search_tree<int> unique{};
+	unique.insert(1);
+	ASSERT_TRUE(unique.insert(1) == unique.end());
+	ASSERT_EQ(unique.count(1), 1);
+	ASSERT_EQ(unique.remove_all(1), 1);
+	ASSERT_EQ(unique.count(1), 0);
+}
+
+TEST(BinarySearchTree, TransparentLookupTest)
+{
+	//With std::less<>, the tree of strings can be searched with string literals and string_views without building a string
+	binary_search_tree<std::string, std::less<>> tree;
+	for (int i = 0; i < 100; i++)
+	{
+		tree.insert(std::to_string(i));
+	}
+	ASSERT_TRUE(tree.contains("42"));
+	ASSERT_FALSE(tree.contains(std::string_view("420")));
+	ASSERT_EQ(tree.count("7"), 1);
+	ASSERT_EQ(*tree.find(std::string_view("13")), "13");
+	ASSERT_EQ(*tree.lower_bound("425"), "43");
+	ASSERT_EQ(*tree.upper_bound(std::string_view("43")), "44");
+	ASSERT_EQ(*tree.floor("425"), "42");
+	ASSERT_EQ(*tree.ceiling("425"), "43");
+	ASSERT_TRUE(tree.remove("42"));
+	ASSERT_FALSE(tree.remove("42"));
+	ASSERT_EQ(tree.getSize(), 99);
+
+	//try_emplace searches with the key, and only builds the value if it is inserted
+	auto inserted = tree.try_emplace("abc", 3, 'z');
+	ASSERT_TRUE(inserted.second);
+	ASSERT_EQ(*inserted.first, "zzz");
+	ASSERT_FALSE(tree.try_emplace("zzz", "ignored").second);
+
+	//Comparers that aren't transparent still work with values that convert to T
+	binary_search_tree<std::string> plain;
+	plain.insert(std::string("a"));
+	ASSERT_TRUE(plain.contains("a"));
+	ASSERT_TRUE(plain.remove("a"));
+	ASSERT_EQ(plain.getSize(), 0);
+
+	//try_emplace keeps a red-black tree valid
+	binary_search_tree<int, std::function<bool(const int&, const int&)>, std::allocator<int>, bst_no_augmentation, bst_red_black_balancing> redBlack;
+	for (int i = 0; i < 1000; i++)
+	{
+		ASSERT_TRUE(redBlack.try_emplace(i, i).second);
+	}
+	ASSERT_FALSE(redBlack.try_emplace(5, 5).second);
+	ASSERT_EQ(redBlack.getSize(), 1000);
+	ASSERT_FALSE(redBlack.getRoot().isRed());
+	ASSERT_LE(redBlack.getRoot().getHeight(), 20);
+}
+
+TEST(BinarySearchTree, BatchTest)
+{
+	std::mt19937 random(29);
+	std::set<int> expected;
+	order_statistics_tree tree{};
+	red_black_tree redBlack{};
+	binary_search_tree<int> unbalanced{};
+	unbalanced.setSelfBalancing(false);
+
+	for (int round = 0; round < 20; round++)
+	{
+		//Unsorted batches with repeated values, and sorted batches of neighboring keys
+		std::vector<int> batch;
+		int start = static_cast<int>(random() % 5000);
+		for (int i = 0; i < 500; i++)
+		{
+			batch.push_back(round % 2 == 0 ? static_cast<int>(random() % 5000) : start + i);
+		}
+		int inserted = 0;
+		for (int value : batch)
+		{
+			inserted += expected.insert(value).second ? 1 : 0;
+		}
+		ASSERT_EQ(tree.insert_batch(batch.begin(), batch.end()), inserted);
+		ASSERT_EQ(redBlack.insert_batch(batch.begin(), batch.end()), inserted);
+		ASSERT_EQ(unbalanced.insert_batch(batch.begin(), batch.end()), inserted);
+
+		std::vector<int> toErase;
+		for (int i = 0; i < 300; i++)
+		{
+			toErase.push_back(static_cast<int>(random() % 5000));
+		}
+		int erased = 0;
+		for (int value : toErase)
+		{
+			erased += static_cast<int>(expected.erase(value));
+		}
+		ASSERT_EQ(tree.erase_batch(toErase.begin(), toErase.end()), erased);
+		ASSERT_EQ(redBlack.erase_batch(toErase.begin(), toErase.end()), erased);
+		ASSERT_EQ(unbalanced.erase_batch(toErase.begin(), toErase.end()), erased);
+
+		std::vector<int> values(expected.begin(), expected.end());
+		checkOrderStatistics(tree, values);
+		int count = 0;
+		checkPerfectBalance(tree.getRoot(), count);
+		ASSERT_EQ(count, static_cast<int>(values.size()));
+		count = 0;
+		checkRedBlack(redBlack.getRoot(), redBlack.end(), count);
+		ASSERT_EQ(count, static_cast<int>(values.size()));
+		ASSERT_EQ(redBlack.traverse(), values);
+		ASSERT_EQ(unbalanced.traverse(), values);
+	}
+
+	//Batches work on empty trees, and with several threads
+	binary_search_tree<int> empty{};
+	ASSERT_EQ(empty.erase_batch({ 1, 2 }), 0);
+	ASSERT_EQ(empty.insert_batch({ 3, 1, 2, 3 }, 4), 3);
+	ASSERT_EQ(empty.traverse(), std::vector<int>({ 1, 2, 3 }));
+	ASSERT_EQ(empty.erase_batch({ 3, 1, 2, 3 }), 3);
+	ASSERT_EQ(empty.getSize(), 0);
+
+	//A multiset counts every value of the batch, and each value of an erased batch removes one copy
+	using multiset_tree = binary_search_tree<int, std::function<bool(const int&, const int&)>, std::allocator<int>, bst_no_augmentation, bst_avl_balancing, bst_counted_keys>;
+	multiset_tree multiset{};
+	ASSERT_EQ(multiset.insert_batch({ 5, 1, 5, 3, 5, 1 }), 6);
+	ASSERT_EQ(multiset.count(5), 3);
+	ASSERT_EQ(multiset.getDistinctSize(), 3);
+	ASSERT_EQ(multiset.erase_batch({ 5, 5, 1, 7 }), 3);
+	ASSERT_EQ(multiset.traverse(), std::vector<int>({ 1, 3, 5 }));
+}
@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+#include <common.h>
+#include <bloom_filter.h>
+#include <binary_search_tree.h>
+#include <compact_search_tree.h>
+#include <random>
+#include <set>
+#include <string>
+
+TEST(BloomFilter, FalsePositiveTest)
+{
+	for (double rate : { 0.05, 0.01, 0.001 })
+	{
+		blocked_bloom_filter<int> filter(100000, rate);
+		for (int i = 0; i < 100000; i++)
+		{
+			filter.insert(i * 2);
+		}
+		ASSERT_EQ(filter.getSize(), 100000);
+
+		//A value that was inserted is always found
+		for (int i = 0; i < 100000; i++)
+		{
+			ASSERT_TRUE(filter.might_contain(i * 2));
+		}
+
+		//Odd numbers were never inserted, so every one that is found is a false positive
+		int falsePositives = 0;
+		for (int i = 0; i < 100000; i++)
+		{
+			if (filter.might_contain(i * 2 + 1))
+			{
+				falsePositives++;
+			}
+		}
+		ASSERT_LT(falsePositives / 100000.0, rate * 1.5);
+	}
+
+	blocked_bloom_filter<std::string> strings(100);
+	strings.insert("apple");
+	strings.insert("banana");
+	ASSERT_TRUE(strings.might_contain("apple"));
+	ASSERT_TRUE(strings.might_contain("banana"));
+	strings.clear();
+	ASSERT_EQ(strings.getSize(), 0);
+	ASSERT_FALSE(strings.might_contain("apple"));
+
+	ASSERT_THROW(blocked_bloom_filter<int>(100, 0.0), struct_exception);
+	ASSERT_THROW(blocked_bloom_filter<int>(100, 1.0), struct_exception);
+}
+
+TEST(BloomFilter, FilteredSetTest)
+{
+	bloom_filtered_set<int> set(16);
+	bloom_filtered_set<int, compact_search_tree<int>> compact;
+	std::set<int> expected;
+	std::mt19937 random(31);
+
+	for (int i = 0; i < 100000; i++)
+	{
+		int value = static_cast<int>(random() % 20000);
+		if (random() % 2 == 0)
+		{
+			int before = set.getSize();
+			set.insert(value);
+			ASSERT_EQ(set.getSize() != before, expected.insert(value).second);
+			compact.insert(value);
+		}
+		else
+		{
+			bool removed = expected.erase(value) == 1;
+			ASSERT_EQ(set.remove(value), removed);
+			ASSERT_EQ(compact.remove(value), removed);
+		}
+		ASSERT_EQ(set.getSize(), static_cast<int>(expected.size()));
+		ASSERT_EQ(compact.getSize(), static_cast<int>(expected.size()));
+		//The filter is rebuilt before the values in it outgrow what it was sized for
+		ASSERT_LE(set.getSize(), set.getFilter().getExpectedCount());
+	}
+
+	for (int value = -1; value <= 20000; value++)
+	{
+		bool inSet = expected.count(value) == 1;
+		ASSERT_EQ(set.contains(value), inSet);
+		ASSERT_EQ(compact.contains(value), inSet);
+		ASSERT_EQ(set.find(value) != set.getSet().end(), inSet);
+	}
+
+	//Wrapping a set that already has values builds the filter from them
+	bloom_filtered_set<int> wrapped(binary_search_tree<int>{ 1, 2, 3 });
+	ASSERT_TRUE(wrapped.contains(2));
+	ASSERT_FALSE(wrapped.contains(4));
+	wrapped.clear();
+	ASSERT_FALSE(wrapped.contains(2));
+	ASSERT_EQ(wrapped.getSize(), 0);
+}
@@ -0,0 +1,256 @@
+#include <gtest/gtest.h>
+#include <common.h>
+#include <btree.h>
+#include <map>
+#include <random>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+//Small nodes make the tree split and merge nodes after only a few keys
+template<typename T>
+using small_btree_set = btree_set<T, std::function<bool(const T&, const T&)>, 64>;
+
+TEST(BTree, InsertRemoveTest)
+{
+	small_btree_set<int> tree{};
+	std::set<int> expected{};
+	std::mt19937 random(42);
+
+	//Randomly insert and remove keys, and compare the tree to a std::set after each step
+	for (int i = 0; i < 20000; i++)
+	{
+		int key = static_cast<int>(random() % 2000);
+		if (random() % 3 != 0)
+		{
+			auto result = tree.insert(key);
+			bool inserted = expected.insert(key).second;
+			ASSERT_EQ(result != tree.end(), inserted);
+			if (inserted)
+			{
+				ASSERT_EQ(*result, key);
+			}
+		}
+		else
+		{
+			ASSERT_EQ(tree.remove(key), expected.erase(key) == 1);
+		}
+		ASSERT_EQ(tree.getSize(), static_cast<int>(expected.size()));
+
+		if (i % 1000 == 0)
+		{
+			ASSERT_TRUE(std::equal(tree.begin(), tree.end(), expected.begin(), expected.end()));
+		}
+	}
+	ASSERT_TRUE(std::equal(tree.begin(), tree.end(), expected.begin(), expected.end()));
+
+	//Removing every key leaves an empty tree
+	for (int key : expected)
+	{
+		ASSERT_TRUE(tree.remove(key));
+	}
+	ASSERT_EQ(tree.getSize(), 0);
+	ASSERT_EQ(tree.getHeight(), 0);
+	ASSERT_TRUE(tree.begin() == tree.end());
+}
+
+TEST(BTree, BoundsTest)
+{
+	small_btree_set<int> tree{};
+	for (int i = 0; i < 500; i++)
+	{
+		tree.insert(i * 2);
+	}
+	ASSERT_GT(tree.getHeight(), 2);
+
+	for (int i = -1; i < 1001; i++)
+	{
+		auto lower = tree.lower_bound(i);
+		auto upper = tree.upper_bound(i);
+		int expectedLower = i < 0 ? 0 : (i + 1) / 2 * 2;
+		int expectedUpper = i < 0 ? 0 : i / 2 * 2 + 2;
+		if (expectedLower >= 1000)
+		{
+			ASSERT_TRUE(lower == tree.end());
+		}
+		else
+		{
+			ASSERT_EQ(*lower, expectedLower);
+		}
+		if (expectedUpper >= 1000)
+		{
+			ASSERT_TRUE(upper == tree.end());
+		}
+		else
+		{
+			ASSERT_EQ(*upper, expectedUpper);
+		}
+		ASSERT_EQ(tree.contains(i), i >= 0 && i < 1000 && i % 2 == 0);
+	}
+}
+
+TEST(BTree, BulkLoadTest)
+{
+	//Every size up to 300 checks trees where the last leaves and nodes are partly filled
+	for (int size = 0; size < 300; size++)
+	{
+		std::vector<int> keys;
+		for (int i = 0; i < size; i++)
+		{
+			keys.push_back(i * 3);
+		}
+		auto tree = small_btree_set<int>::from_sorted(keys.begin(), keys.end());
+		ASSERT_EQ(tree.getSize(), size);
+		ASSERT_EQ(std::vector<int>(tree.begin(), tree.end()), keys);
+
+		//A bulk loaded tree can still be changed
+		tree.insert(1);
+		for (int i = 0; i < size; i += 2)
+		{
+			ASSERT_TRUE(tree.remove(i * 3));
+		}
+		ASSERT_TRUE(tree.contains(1));
+		ASSERT_EQ(tree.getSize(), size - (size + 1) / 2 + 1);
+	}
+
+	std::vector<int> unsorted = { 5, 3, 9, 3, 1, 5, 7 };
+	auto tree = btree_set<int>::from_unsorted(unsorted.begin(), unsorted.end());
+	std::stringstream stream;
+	stream << tree;
+	ASSERT_EQ(stream.str(), "[1, 3, 5, 7, 9]");
+
+	//Copies don't share nodes
+	auto copy = tree;
+	copy.remove(5);
+	ASSERT_TRUE(tree.contains(5));
+	ASSERT_FALSE(copy.contains(5));
+	ASSERT_EQ(copy.getSize(), 4);
+}
+
+namespace {
+	//A key that counts how many instances are alive, and throws once it has been copied "copiesLeft" times
+	struct throwing_key
+	{
+		static int alive;
+		static int copiesLeft;
+		int value = 0;
+
+		throwing_key() { alive++; }
+		throwing_key(int value) : value(value) { alive++; }
+		throwing_key(const throwing_key& other) : value(other.value) { alive++; }
+		~throwing_key() { alive--; }
+
+		throwing_key& operator=(const throwing_key& other)
+		{
+			if (copiesLeft-- == 0)
+			{
+				throw std::runtime_error("copy failed");
+			}
+			value = other.value;
+			return *this;
+		}
+
+		bool operator<(const throwing_key& other) const { return value < other.value; }
+	};
+
+	int throwing_key::alive = 0;
+	int throwing_key::copiesLeft = -1;
+}
+
+TEST(BTree, BulkLoadThrowTest)
+{
+	std::vector<throwing_key> keys;
+	for (int i = 0; i < 500; i++)
+	{
+		keys.emplace_back(i);
+	}
+	int keysAlive = throwing_key::alive;
+
+	//Make the copies fail at every point, including part way through the levels of internal nodes, and check that every node gets freed
+	bool finished = false;
+	for (int copies = 0; !finished; copies++)
+	{
+		throwing_key::copiesLeft = copies;
+		try
+		{
+			auto tree = small_btree_set<throwing_key>::from_sorted(keys.begin(), keys.end());
+			ASSERT_EQ(tree.getSize(), 500);
+			finished = true;
+		}
+		catch (const std::runtime_error&)
+		{
+		}
+		ASSERT_EQ(throwing_key::alive, keysAlive);
+	}
+	throwing_key::copiesLeft = -1;
+}
+
+TEST(BTree, KeyTypeTest)
+{
+	//Doubles and strings use different ways of searching a node
+	small_btree_set<double> doubles{};
+	for (int i = 100; i >= 0; i--)
+	{
+		doubles.insert(i * 0.5);
+	}
+	ASSERT_EQ(*doubles.lower_bound(10.25), 10.5);
+	ASSERT_EQ(doubles.getSize(), 101);
+
+	btree_set<std::string> strings{};
+	for (int i = 0; i < 100; i++)
+	{
+		strings.insert(std::to_string(i));
+	}
+	ASSERT_TRUE(strings.contains("42"));
+	ASSERT_EQ(*strings.begin(), "0");
+	ASSERT_EQ(*strings.upper_bound("98"), "99");
+
+	//A comparer changes the order
+	small_btree_set<int> descending{ [](const int& a, const int& b) { return a > b; } };
+	for (int i = 0; i < 100; i++)
+	{
+		descending.insert(i);
+	}
+	ASSERT_EQ(*descending.begin(), 99);
+	ASSERT_EQ(*descending.lower_bound(50), 50);
+	ASSERT_TRUE(descending.remove(50));
+	ASSERT_EQ(*descending.lower_bound(50), 49);
+}
+
+TEST(BTree, MapTest)
+{
+	btree_map<int, std::string, std::function<bool(const int&, const int&)>, 64> map{};
+	std::map<int, std::string> expected{};
+	std::mt19937 random(7);
+
+	for (int i = 0; i < 5000; i++)
+	{
+		int key = static_cast<int>(random() % 500);
+		if (random() % 4 != 0)
+		{
+			map[key] += "a";
+			expected[key] += "a";
+		}
+		else
+		{
+			ASSERT_EQ(map.remove(key), expected.erase(key) == 1);
+		}
+	}
+	ASSERT_EQ(map.getSize(), static_cast<int>(expected.size()));
+
+	auto expectedEntry = expected.begin();
+	for (auto i = map.begin(); i != map.end(); ++i, ++expectedEntry)
+	{
+		ASSERT_EQ(i.key(), expectedEntry->first);
+		ASSERT_EQ((*i).second, expectedEntry->second);
+	}
+
+	//Values can be changed through an iterator, but inserting an existing key doesn't replace it
+	auto entry = map.find(expected.begin()->first);
+	entry.value() = "changed";
+	ASSERT_TRUE(map.insert(expected.begin()->first, "ignored") == map.end());
+	ASSERT_EQ(map.at(expected.begin()->first), "changed");
+	ASSERT_THROW(map.at(-1), struct_exception);
+}
@@ -0,0 +1,159 @@
+#include <gtest/gtest.h>
+#include <common.h>
+#include <compact_linked_list.h>
+#include <insertion_sort.h>
+#include <merge_sort.h>
+#include <bubble_sort.h>
+#include <quick_sort.h>
+#include <sstream>
+#include <string>
+
+TEST(CompactLinkedList, NodeSizeTest)
+{
+	//Each node only costs 8 bytes on top of its value
+	ASSERT_EQ(sizeof(compact_linked_list<int>::node), sizeof(int) + 8);
+	ASSERT_EQ(sizeof(compact_linked_list<double>::node), sizeof(double) + 8);
+}
+
+TEST(CompactLinkedList, PushAndPopTest)
+{
+	compact_linked_list<int> list{};
+	list.push_back(2);
+	list.push_back(3);
+	list.push_front(1);
+	list.emplace_back(4);
+	ASSERT_EQ(list.getSize(), 4);
+	ASSERT_EQ(list, (compact_linked_list<int>{ 1, 2, 3, 4 }));
+
+	ASSERT_TRUE(list.pop_front());
+	ASSERT_TRUE(list.pop_back());
+	ASSERT_EQ(list, (compact_linked_list<int>{ 2, 3 }));
+	ASSERT_EQ(*(--list.end()), 3);
+
+	list.clear();
+	ASSERT_EQ(list.getSize(), 0);
+	ASSERT_FALSE(list.pop_front());
+	ASSERT_FALSE(list.pop_back());
+	ASSERT_TRUE(list.begin() == list.end());
+	ASSERT_THROW(--list.end(), struct_exception);
+}
+
+TEST(CompactLinkedList, InsertAndRemoveTest)
+{
+	compact_linked_list<int> list{ 1, 3, 5 };
+	auto three = list.find(3);
+	list.insert(2, three);
+	list.insert(4, list.find(5));
+	list.insert(6, list.end());
+	ASSERT_EQ(list, (compact_linked_list<int>{ 1, 2, 3, 4, 5, 6 }));
+
+	list.pop_element(three);
+	ASSERT_EQ(list, (compact_linked_list<int>{ 1, 2, 4, 5, 6 }));
+	ASSERT_THROW(list.pop_element(list.end()), struct_exception);
+
+	//Iterators from another list can't be used
+	compact_linked_list<int> other{ 1 };
+	ASSERT_THROW(list.pop_element(other.begin()), struct_exception);
+}
+
+TEST(CompactLinkedList, FreeListTest)
+{
+	compact_linked_list<int> list{};
+	for (int i = 0; i < 100; i++)
+	{
+		list.push_back(i);
+	}
+	int capacity = list.getCapacity();
+
+	//Removed nodes are reused, so the array doesn't grow
+	for (int round = 0; round < 10; round++)
+	{
+		for (int i = 0; i < 50; i++)
+		{
+			list.pop_front();
+		}
+		for (int i = 0; i < 50; i++)
+		{
+			list.push_back(i);
+		}
+	}
+	ASSERT_EQ(list.getSize(), 100);
+	ASSERT_EQ(list.getCapacity(), capacity);
+}
+
+TEST(CompactLinkedList, GrowthTest)
+{
+	compact_linked_list<std::string> list{};
+	auto firstNode = list.push_back("first");
+
+	//Iterators hold indices, so they stay valid when the array grows
+	for (int i = 0; i < 1000; i++)
+	{
+		list.push_back(std::to_string(i));
+	}
+	ASSERT_EQ(*firstNode, std::string("first"));
+
+	//Values from the list can be pushed even if the array has to grow
+	compact_linked_list<std::string> small{};
+	small.reserve(1);
+	small.push_back("value");
+	small.push_back(*small.begin());
+	ASSERT_EQ(small, (compact_linked_list<std::string>{ "value", "value" }));
+}
+
+TEST(CompactLinkedList, CopyAndMoveTest)
+{
+	compact_linked_list<int> numbers{ 5, 6, 7, 8 };
+	numbers.pop_element(numbers.find(6));
+
+	compact_linked_list<int> numbersCopy{ numbers };
+	ASSERT_EQ(numbersCopy, numbers);
+	//The copy keeps the free list, so it can reuse the removed node
+	numbersCopy.push_back(9);
+	ASSERT_EQ(numbersCopy, (compact_linked_list<int>{ 5, 7, 8, 9 }));
+
+	compact_linked_list<std::string> strings{ "a", "b", "c" };
+	strings.pop_front();
+	compact_linked_list<std::string> stringsCopy{};
+	stringsCopy = strings;
+	ASSERT_EQ(stringsCopy, (compact_linked_list<std::string>{ "b", "c" }));
+
+	compact_linked_list<std::string> moved{ std::move(stringsCopy) };
+	ASSERT_EQ(moved, (compact_linked_list<std::string>{ "b", "c" }));
+	ASSERT_EQ(stringsCopy.getSize(), 0);
+
+	stringsCopy = std::move(moved);
+	ASSERT_EQ(stringsCopy, (compact_linked_list<std::string>{ "b", "c" }));
+	ASSERT_EQ(moved.getSize(), 0);
+}
+
+TEST(CompactLinkedList, SortTest)
+{
+	compact_linked_list<int> sorted{ 932, 2819, 3920, 6523, 9201, 9302, 43829 };
+	compact_linked_list<int> unsorted{ 6523, 2819, 9302, 43829, 9201, 3920, 932 };
+
+	auto list = unsorted;
+	insertion_sort(list);
+	ASSERT_EQ(list, sorted);
+
+	list = unsorted;
+	merge_sort(list);
+	ASSERT_EQ(list, sorted);
+
+	list = unsorted;
+	bubble_sort(list);
+	ASSERT_EQ(list, sorted);
+
+	list = unsorted;
+	quick_sort(list);
+	ASSERT_EQ(list, sorted);
+}
+
+TEST(CompactLinkedList, PrintTest)
+{
+	const compact_linked_list<int> list{ 2819, 6523, 43829, 9302 };
+
+	std::stringstream stream;
+	stream << list;
+	ASSERT_EQ(stream.str(), std::string("[2819, 6523, 43829, 9302]"));
+}
@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+#include <common.h>
+#include <compact_search_tree.h>
+#include <cmath>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+TEST(CompactSearchTree, InsertRemoveTest)
+{
+	compact_search_tree<int> tree;
+	std::set<int> expected;
+	std::mt19937 random(17);
+
+	for (int i = 0; i < 50000; i++)
+	{
+		int value = static_cast<int>(random() % 2000);
+		if (random() % 3 != 0)
+		{
+			ASSERT_EQ(tree.insert(value), expected.insert(value).second);
+		}
+		else
+		{
+			ASSERT_EQ(tree.remove(value), expected.erase(value) == 1);
+		}
+		ASSERT_EQ(tree.getSize(), static_cast<int>(expected.size()));
+	}
+	ASSERT_EQ(tree.traverse(), std::vector<int>(expected.begin(), expected.end()));
+	//An AVL tree is never more than about 1.44 times as tall as a perfectly balanced tree
+	ASSERT_LE(tree.getHeight(), static_cast<int>(1.44 * std::log2(expected.size() + 2)));
+
+	for (int i = -1; i <= 2000; i++)
+	{
+		ASSERT_EQ(tree.contains(i), expected.count(i) == 1);
+		ASSERT_EQ(tree.find(i) != tree.end(), expected.count(i) == 1);
+		auto lower = tree.lower_bound(i);
+		auto expectedLower = expected.lower_bound(i);
+		ASSERT_EQ(lower == tree.end(), expectedLower == expected.end());
+		if (lower != tree.end())
+		{
+			ASSERT_EQ(*lower, *expectedLower);
+		}
+		auto upper = tree.upper_bound(i);
+		auto expectedUpper = expected.upper_bound(i);
+		ASSERT_EQ(upper == tree.end(), expectedUpper == expected.end());
+		if (upper != tree.end())
+		{
+			ASSERT_EQ(*upper, *expectedUpper);
+		}
+	}
+
+	//Removed nodes are reused, so filling the tree back up doesn't grow the arena
+	int capacity = tree.getCapacity();
+	for (int i = 0; i < 2000; i++)
+	{
+		tree.remove(i);
+	}
+	ASSERT_EQ(tree.getSize(), 0);
+	ASSERT_EQ(tree.begin(), tree.end());
+	for (int i = 0; i < 2000; i++)
+	{
+		tree.insert(i);
+	}
+	ASSERT_EQ(tree.getCapacity(), capacity);
+	ASSERT_EQ(tree.getHeight(), 11);
+
+	std::stringstream stream;
+	compact_search_tree<int> small{ 3, 1, 2 };
+	stream << small;
+	ASSERT_EQ(stream.str(), "[1, 2, 3]");
+}
+
+TEST(CompactSearchTree, LayoutTest)
+{
+	//The node only adds two 32-bit links, which also hold the balance factor, to the value
+	ASSERT_EQ(sizeof(compact_search_tree<int>::node), 12u);
+	ASSERT_EQ(sizeof(compact_search_tree<long long>::node), 16u);
+
+	//Sorted inserts are the worst case for an unbalanced tree
+	compact_search_tree<int> tree;
+	tree.reserve(1 << 16);
+	ASSERT_EQ(tree.getCapacity(), 1 << 16);
+	for (int i = 0; i < (1 << 16) - 1; i++)
+	{
+		tree.insert(i);
+	}
+	ASSERT_EQ(tree.getHeight(), 16);
+	ASSERT_EQ(tree.getCapacity(), 1 << 16);
+	int expected = 0;
+	for (int value : tree)
+	{
+		ASSERT_EQ(value, expected++);
+	}
+	ASSERT_EQ(expected, (1 << 16) - 1);
+}
+
+TEST(CompactSearchTree, CopyMoveTest)
+{
+	//Strings aren't trivially copyable, so they are moved one at a time when the arena grows
+	compact_search_tree<std::string> tree;
+	std::set<std::string> expected;
+	std::mt19937 random(23);
+	for (int i = 0; i < 5000; i++)
+	{
+		std::string value = "value " + std::to_string(random() % 1000);
+		if (random() % 4 != 0)
+		{
+			tree.insert(value);
+			expected.insert(value);
+		}
+		else
+		{
+			tree.remove(value);
+			expected.erase(value);
+		}
+	}
+	std::vector<std::string> values(expected.begin(), expected.end());
+	ASSERT_EQ(tree.traverse(), values);
+
+	compact_search_tree<std::string> copy = tree;
+	ASSERT_EQ(copy.traverse(), values);
+	copy.insert("new");
+	ASSERT_FALSE(tree.contains("new"));
+
+	compact_search_tree<std::string> moved = std::move(copy);
+	ASSERT_TRUE(moved.contains("new"));
+	ASSERT_EQ(moved.getSize(), static_cast<int>(values.size()) + 1);
+
+	copy = moved;
+	ASSERT_EQ(copy.getSize(), moved.getSize());
+	tree = std::move(moved);
+	ASSERT_TRUE(tree.contains("new"));
+	tree.clear();
+	ASSERT_EQ(tree.getSize(), 0);
+	ASSERT_TRUE(tree.traverse().empty());
+	tree.insert("again");
+	ASSERT_EQ(tree.traverse(), std::vector<std::string>{ "again" });
+}
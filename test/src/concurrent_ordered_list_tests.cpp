@@ -0,0 +1,174 @@
+#include <gtest/gtest.h>
+#include <common.h>
+#include <concurrent_ordered_list.h>
+#include <atomic>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(ConcurrentOrderedList, InsertTest)
+{
+	concurrent_ordered_list<int> list;
+
+	ASSERT_TRUE(list.insert(5));
+	ASSERT_TRUE(list.insert(3));
+	ASSERT_TRUE(list.insert(7));
+	ASSERT_FALSE(list.insert(5));
+	ASSERT_EQ(list.getSize(), 3);
+
+	ASSERT_EQ(list.traverse(), (std::vector<int>{ 3, 5, 7 }));
+}
+
+TEST(ConcurrentOrderedList, EraseAndContainsTest)
+{
+	concurrent_ordered_list<int> list;
+	for (int i = 0; i < 100; i++)
+	{
+		list.insert(i);
+	}
+
+	ASSERT_TRUE(list.contains(50));
+	ASSERT_TRUE(list.erase(50));
+	ASSERT_FALSE(list.erase(50));
+	ASSERT_FALSE(list.contains(50));
+	ASSERT_FALSE(list.contains(100));
+	ASSERT_EQ(list.getSize(), 99);
+
+	//Erased values can be inserted again
+	ASSERT_TRUE(list.insert(50));
+	ASSERT_TRUE(list.contains(50));
+
+	list.clear();
+	ASSERT_EQ(list.getSize(), 0);
+	ASSERT_FALSE(list.contains(0));
+}
+
+TEST(ConcurrentOrderedList, NonTrivialTypeTest)
+{
+	concurrent_ordered_list<std::string> list;
+	ASSERT_TRUE(list.insert(std::string("banana")));
+	ASSERT_TRUE(list.insert(std::string("apple")));
+	ASSERT_TRUE(list.insert(std::string("cherry")));
+	ASSERT_TRUE(list.erase(std::string("banana")));
+
+	std::stringstream stream;
+	stream << list;
+	ASSERT_EQ(stream.str(), std::string("[apple, cherry]"));
+}
+
+TEST(ConcurrentOrderedList, ConcurrentInsertTest)
+{
+	concurrent_ordered_list<int> list;
+	const int threadCount = 8;
+	const int valueCount = 2000;
+
+	std::atomic<int> successes{ 0 };
+	std::vector<std::thread> threads;
+
+	//Every thread tries to insert the same values. Each value should only be inserted once
+	for (int t = 0; t < threadCount; t++)
+	{
+		threads.emplace_back([&list, &successes, t, valueCount]() {
+			for (int i = 0; i < valueCount; i++)
+			{
+				int value = (i * 7 + t * 13) % valueCount;
+				if (list.insert(value))
+				{
+					successes++;
+				}
+			}
+		});
+	}
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	ASSERT_EQ(successes.load(), valueCount);
+	ASSERT_EQ(list.getSize(), valueCount);
+
+	auto values = list.traverse();
+	ASSERT_EQ(values.size(), valueCount);
+	for (int i = 0; i < valueCount; i++)
+	{
+		ASSERT_EQ(values[i], i);
+	}
+}
+
+TEST(ConcurrentOrderedList, ConcurrentStressTest)
+{
+	concurrent_ordered_list<int> list;
+	const int threadCount = 8;
+	const int rounds = 3000;
+	const int keyRange = 256;
+
+	//The keys below "keyRange" are shared by every thread, and are randomly inserted and erased
+	//Each thread also owns a private range of keys, so the final state of those keys is known
+	std::atomic<int> inserted{ 0 };
+	std::atomic<int> erased{ 0 };
+	std::vector<std::thread> threads;
+
+	for (int t = 0; t < threadCount; t++)
+	{
+		threads.emplace_back([&, t]() {
+			unsigned int state = 12345 + t;
+			int ownBase = keyRange + t * rounds;
+			for (int i = 0; i < rounds; i++)
+			{
+				state = state * 1103515245 + 12345;
+				int key = (state >> 8) % keyRange;
+				switch ((state >> 4) % 3)
+				{
+				case 0:
+					if (list.insert(key)) inserted++;
+					break;
+				case 1:
+					if (list.erase(key)) erased++;
+					break;
+				default:
+					list.contains(key);
+					break;
+				}
+
+				//Insert every private key, and erase the odd ones again
+				list.insert(ownBase + i);
+				if (i % 2 == 1)
+				{
+					ASSERT_TRUE(list.erase(ownBase + i));
+				}
+			}
+		});
+	}
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	auto values = list.traverse();
+
+	//The values must be sorted and unique
+	for (size_t i = 1; i < values.size(); i++)
+	{
+		ASSERT_LT(values[i - 1], values[i]);
+	}
+
+	//The shared keys that are left must equal the successful inserts minus the successful erases
+	int sharedLeft = 0;
+	int privateLeft = 0;
+	for (auto value : values)
+	{
+		if (value < keyRange)
+		{
+			sharedLeft++;
+		}
+		else
+		{
+			privateLeft++;
+			ASSERT_EQ((value - keyRange) % rounds % 2, 0);
+		}
+	}
+	ASSERT_EQ(sharedLeft, inserted.load() - erased.load());
+	ASSERT_EQ(privateLeft, threadCount * rounds / 2);
+	ASSERT_EQ(list.getSize(), static_cast<int>(values.size()));
+}
@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+#include <common.h>
+#include <concurrent_search_tree.h>
+#include <atomic>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(ConcurrentSearchTree, InsertRemoveTest)
+{
+	concurrent_search_tree<int> tree;
+	std::set<int> expected;
+	std::mt19937 random(5);
+
+	for (int i = 0; i < 20000; i++)
+	{
+		int value = static_cast<int>(random() % 1000);
+		if (random() % 3 != 0)
+		{
+			ASSERT_EQ(tree.insert(value), expected.insert(value).second);
+		}
+		else
+		{
+			ASSERT_EQ(tree.remove(value), expected.erase(value) == 1);
+		}
+		ASSERT_EQ(tree.getSize(), static_cast<int>(expected.size()));
+	}
+	ASSERT_EQ(tree.traverse(), std::vector<int>(expected.begin(), expected.end()));
+	for (int i = 0; i < 1000; i++)
+	{
+		ASSERT_EQ(tree.contains(i), expected.count(i) == 1);
+	}
+
+	std::stringstream stream;
+	concurrent_search_tree<int> small;
+	small.insert(3);
+	small.insert(1);
+	small.insert(2);
+	stream << small;
+	ASSERT_EQ(stream.str(), "[1, 2, 3]");
+
+	tree.clear();
+	ASSERT_EQ(tree.getSize(), 0);
+	ASSERT_TRUE(tree.traverse().empty());
+}
+
+TEST(ConcurrentSearchTree, SnapshotTest)
+{
+	concurrent_search_tree<std::string> tree;
+	for (int i = 0; i < 100; i++)
+	{
+		tree.insert(std::to_string(i));
+	}
+
+	//A snapshot keeps seeing the version of the tree it was taken from
+	auto view = tree.get_snapshot();
+	for (int i = 0; i < 100; i += 2)
+	{
+		ASSERT_TRUE(tree.remove(std::to_string(i)));
+	}
+	tree.insert("new");
+	ASSERT_TRUE(view.contains("0"));
+	ASSERT_FALSE(view.contains("new"));
+	ASSERT_EQ(std::vector<std::string>(view.begin(), view.end()).size(), 100u);
+
+	ASSERT_FALSE(tree.contains("0"));
+	ASSERT_TRUE(tree.contains("new"));
+	ASSERT_EQ(tree.getSize(), 51);
+}
+
+TEST(ConcurrentSearchTree, ConcurrentReadersTest)
+{
+	concurrent_search_tree<int> tree;
+	const int keyRange = 2000;
+	//The even keys are never removed, and the odd keys are inserted and removed by the writer
+	for (int i = 0; i < keyRange; i += 2)
+	{
+		tree.insert(i);
+	}
+
+	std::atomic<bool> done{ false };
+	std::atomic<int> failures{ 0 };
+	std::vector<std::thread> readers;
+	for (int t = 0; t < 4; t++)
+	{
+		readers.emplace_back([&, t]() {
+			unsigned int state = 777 + t;
+			int rounds = 0;
+			while (!done.load() || rounds < 100)
+			{
+				state = state * 1103515245 + 12345;
+				int key = static_cast<int>((state >> 8) % keyRange) & ~1;
+				if (!tree.contains(key))
+				{
+					failures++;
+				}
+
+				//Every so often, check that a whole version of the tree is sorted and has every even key
+				if (++rounds % 200 == 0)
+				{
+					auto view = tree.get_snapshot();
+					int previous = -1;
+					int evens = 0;
+					for (auto value : view)
+					{
+						if (value <= previous)
+						{
+							failures++;
+						}
+						evens += value % 2 == 0 ? 1 : 0;
+						previous = value;
+					}
+					if (evens != keyRange / 2)
+					{
+						failures++;
+					}
+				}
+			}
+		});
+	}
+
+	std::mt19937 random(9);
+	for (int i = 0; i < 20000; i++)
+	{
+		int key = static_cast<int>(random() % keyRange) | 1;
+		if (random() % 2 == 0)
+		{
+			tree.insert(key);
+		}
+		else
+		{
+			tree.remove(key);
+		}
+	}
+	done = true;
+	for (auto& reader : readers)
+	{
+		reader.join();
+	}
+
+	ASSERT_EQ(failures.load(), 0);
+	auto values = tree.traverse();
+	ASSERT_EQ(static_cast<int>(values.size()), tree.getSize());
+}
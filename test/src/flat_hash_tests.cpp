@@ -0,0 +1,306 @@
+#include <gtest/gtest.h>
+#include <common.h>
+#include <flat_hash.h>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace {
+	//A hasher that gives most keys the same hash, so that groups fill up and searches have to probe past them
+	struct colliding_hasher {
+		std::size_t operator()(int value) const
+		{
+			return static_cast<std::size_t>(value % 3);
+		}
+	};
+
+	//A hasher that throws once it has been called "callsLeft" times
+	struct throwing_hasher {
+		static int callsLeft;
+
+		std::size_t operator()(int value) const
+		{
+			if (callsLeft-- == 0)
+			{
+				throw std::runtime_error("hash failed");
+			}
+			return std::hash<int>()(value);
+		}
+	};
+
+	int throwing_hasher::callsLeft = -1;
+
+	//A key that counts how many instances are alive, and throws once it has been copied or moved "copiesLeft" times.
+	//Its move constructor can throw, so the table has to copy it when it grows
+	struct throwing_key {
+		static int alive;
+		static int copiesLeft;
+		int value;
+
+		throwing_key(int value) : value(value) { alive++; }
+		throwing_key(const throwing_key& other) : value(other.value)
+		{
+			if (copiesLeft-- == 0)
+			{
+				throw std::runtime_error("copy failed");
+			}
+			alive++;
+		}
+		throwing_key(throwing_key&& other) : throwing_key(static_cast<const throwing_key&>(other)) {}
+		~throwing_key() { alive--; }
+
+		bool operator==(const throwing_key& other) const { return value == other.value; }
+	};
+
+	int throwing_key::alive = 0;
+	int throwing_key::copiesLeft = -1;
+
+	struct throwing_key_hasher {
+		std::size_t operator()(const throwing_key& key) const noexcept
+		{
+			return std::hash<int>()(key.value);
+		}
+	};
+
+	//Checks a set against the keys it should have, both by searching and by iterating
+	template<typename Set>
+	void check_set(const Set& set, const std::unordered_set<int>& expected)
+	{
+		ASSERT_EQ(set.getSize(), static_cast<int>(expected.size()));
+		int visited = 0;
+		for (int key : set)
+		{
+			ASSERT_EQ(expected.count(key), 1u);
+			visited++;
+		}
+		ASSERT_EQ(visited, static_cast<int>(expected.size()));
+		for (int key : expected)
+		{
+			ASSERT_TRUE(set.contains(key));
+		}
+	}
+}
+
+TEST(FlatHash, InsertRemoveTest)
+{
+	flat_hash_set<int> set;
+	flat_hash_set<int, colliding_hasher> colliding;
+	std::unordered_set<int> expected;
+	std::mt19937 random(37);
+
+	for (int i = 0; i < 100000; i++)
+	{
+		int key = static_cast<int>(random() % 5000);
+		if (random() % 3 != 0)
+		{
+			//An insert can rebuild the table, which moves end(), so end() is only read after the insert
+			bool inserted = expected.insert(key).second;
+			auto position = set.insert(key);
+			ASSERT_EQ(position != set.end(), inserted);
+			auto collidingPosition = colliding.insert(key);
+			ASSERT_EQ(collidingPosition != colliding.end(), inserted);
+		}
+		else
+		{
+			bool removed = expected.erase(key) == 1;
+			ASSERT_EQ(set.remove(key), removed);
+			ASSERT_EQ(colliding.remove(key), removed);
+		}
+		if (i % 10000 == 0)
+		{
+			check_set(set, expected);
+		}
+	}
+	check_set(set, expected);
+	check_set(colliding, expected);
+
+	for (int key = -1; key <= 5000; key++)
+	{
+		bool inSet = expected.count(key) == 1;
+		ASSERT_EQ(set.contains(key), inSet);
+		ASSERT_EQ(colliding.contains(key), inSet);
+		auto found = set.find(key);
+		ASSERT_EQ(found != set.end(), inSet);
+		if (inSet)
+		{
+			ASSERT_EQ(*found, key);
+		}
+	}
+
+	//Removing through an iterator
+	while (set.begin() != set.end())
+	{
+		ASSERT_TRUE(set.remove(set.begin()));
+	}
+	ASSERT_EQ(set.getSize(), 0);
+	ASSERT_FALSE(set.remove(set.end()));
+
+	std::stringstream stream;
+	flat_hash_set<int> small{ 4 };
+	stream << small;
+	ASSERT_EQ(stream.str(), "[4]");
+}
+
+TEST(FlatHash, CapacityTest)
+{
+	flat_hash_set<int> set;
+	ASSERT_EQ(set.getCapacity(), 0);
+	ASSERT_FALSE(set.contains(1));
+	ASSERT_EQ(set.begin(), set.end());
+
+	//The table is a power of two, and is at most 7/8 full
+	set.reserve(1000);
+	int capacity = set.getCapacity();
+	ASSERT_EQ(capacity, 2048);
+	for (int i = 0; i < 1000; i++)
+	{
+		set.insert(i);
+	}
+	ASSERT_EQ(set.getCapacity(), capacity);
+
+	//Removing and inserting keys over and over again reuses the slots, so the table only ever grows once, when deleted slots fill it up
+	std::mt19937 random(41);
+	int next = 1000;
+	for (int i = 0; i < 200000; i++)
+	{
+		int key = next - 1000 + static_cast<int>(random() % 1000);
+		if (set.remove(key))
+		{
+			set.insert(next++);
+		}
+	}
+	ASSERT_EQ(set.getSize(), 1000);
+	ASSERT_LE(set.getCapacity(), capacity * 2);
+
+	set.rehash(0);
+	ASSERT_EQ(set.getCapacity(), 2048);
+	set.clear();
+	ASSERT_EQ(set.getSize(), 0);
+	ASSERT_EQ(set.getCapacity(), 2048);
+	ASSERT_EQ(set.begin(), set.end());
+	set.rehash(0);
+	ASSERT_EQ(set.getCapacity(), 0);
+	set.insert(5);
+	ASSERT_EQ(set.getCapacity(), 16);
+	set.rehash(100);
+	ASSERT_EQ(set.getCapacity(), 128);
+	ASSERT_TRUE(set.contains(5));
+}
+
+TEST(FlatHash, MapTest)
+{
+	flat_hash_map<std::string, int> map;
+	std::unordered_map<std::string, int> expected;
+	std::mt19937 random(43);
+
+	for (int i = 0; i < 20000; i++)
+	{
+		std::string key = "key " + std::to_string(random() % 2000);
+		switch (random() % 3)
+		{
+		case 0:
+		{
+			auto position = map.insert(key, i);
+			ASSERT_EQ(position != map.end(), expected.emplace(key, i).second);
+			break;
+		}
+		case 1:
+			map[key] += i;
+			expected[key] += i;
+			break;
+		default:
+			ASSERT_EQ(map.remove(key), expected.erase(key) == 1);
+			break;
+		}
+	}
+	ASSERT_EQ(map.getSize(), static_cast<int>(expected.size()));
+	for (auto entry : map)
+	{
+		ASSERT_EQ(expected.at(entry.first), entry.second);
+	}
+	for (auto& entry : expected)
+	{
+		ASSERT_EQ(map.at(entry.first), entry.second);
+	}
+	ASSERT_THROW(map.at("missing"), struct_exception);
+
+	//Values can be changed through the iterators, and copies don't share them
+	flat_hash_map<std::string, int> copy = map;
+	for (auto i = copy.begin(); i != copy.end(); ++i)
+	{
+		i.value() = -1;
+	}
+	for (auto entry : map)
+	{
+		ASSERT_EQ(expected.at(entry.first), entry.second);
+	}
+	ASSERT_EQ(copy.at(expected.begin()->first), -1);
+
+	flat_hash_map<std::string, int> moved = std::move(copy);
+	ASSERT_EQ(moved.getSize(), map.getSize());
+	ASSERT_EQ(copy.getSize(), 0);
+	copy = moved;
+	ASSERT_EQ(copy.getSize(), map.getSize());
+	moved = std::move(map);
+	ASSERT_EQ(moved.at(expected.begin()->first), expected.begin()->second);
+	moved.clear();
+	ASSERT_EQ(moved.getSize(), 0);
+	ASSERT_FALSE(moved.contains(expected.begin()->first));
+}
+
+TEST(FlatHash, ResizeThrowTest)
+{
+	//A hasher that throws while the table grows leaves every key in the table
+	flat_hash_set<int, throwing_hasher> set;
+	std::unordered_set<int> expected;
+	int grown = 0;
+	for (int i = 0; grown < 3; i++)
+	{
+		int capacity = set.getCapacity();
+		//Let the search for the key succeed, and then make the rehash fail a few keys in
+		throwing_hasher::callsLeft = 1 + static_cast<int>(expected.size()) / 2;
+		try
+		{
+			set.insert(i);
+			expected.insert(i);
+		}
+		catch (const std::runtime_error&)
+		{
+			ASSERT_EQ(set.getCapacity(), capacity);
+			grown++;
+		}
+		throwing_hasher::callsLeft = -1;
+		check_set(set, expected);
+	}
+
+	//A key whose copy throws while the table grows is never lost or leaked
+	{
+		flat_hash_set<throwing_key, throwing_key_hasher> keys;
+		std::vector<int> values;
+		int failures = 0;
+		for (int i = 0; failures < 3; i++)
+		{
+			throwing_key::copiesLeft = 1 + static_cast<int>(values.size()) / 2;
+			try
+			{
+				keys.insert(throwing_key(i));
+				values.push_back(i);
+			}
+			catch (const std::runtime_error&)
+			{
+				failures++;
+			}
+			throwing_key::copiesLeft = -1;
+			ASSERT_EQ(keys.getSize(), static_cast<int>(values.size()));
+			ASSERT_EQ(throwing_key::alive, static_cast<int>(values.size()));
+			for (int value : values)
+			{
+				ASSERT_TRUE(keys.contains(throwing_key(value)));
+			}
+		}
+	}
+	ASSERT_EQ(throwing_key::alive, 0);
+}
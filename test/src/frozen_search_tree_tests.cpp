@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include <common.h>
+#include <binary_search_tree.h>
+#include <frozen_search_tree.h>
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+
+TEST(FrozenSearchTree, FreezeTest)
+{
+	binary_search_tree<int> tree{};
+	for (int i = 0; i < 1000; i++)
+	{
+		tree.insert(((i * 7919) % 1000) * 2);
+	}
+
+	auto frozen = tree.freeze();
+	ASSERT_EQ(frozen.getSize(), 1000);
+
+	//Iterating goes over the values in sorted order
+	std::vector<int> values(frozen.begin(), frozen.end());
+	ASSERT_EQ(values, tree.traverse());
+
+	for (int i = 0; i < 2000; i++)
+	{
+		ASSERT_EQ(frozen.contains(i), i % 2 == 0);
+	}
+
+	//The frozen copy doesn't change when the tree does, and can be rebuilt from it
+	tree.insert(1);
+	ASSERT_FALSE(frozen.contains(1));
+	frozen = tree.freeze();
+	ASSERT_TRUE(frozen.contains(1));
+	ASSERT_EQ(frozen.getSize(), 1001);
+}
+
+TEST(FrozenSearchTree, BoundsTest)
+{
+	//Every size up to 70 checks trees where the last level is partly filled
+	for (int size = 0; size < 70; size++)
+	{
+		std::vector<int> values;
+		for (int i = 0; i < size; i++)
+		{
+			values.push_back(i * 10);
+		}
+		frozen_search_tree<int> frozen(values.begin(), values.end());
+		ASSERT_EQ(std::vector<int>(frozen.begin(), frozen.end()), values);
+
+		for (int query = -5; query <= size * 10 + 5; query++)
+		{
+			auto expectedLower = std::lower_bound(values.begin(), values.end(), query);
+			auto lower = frozen.lower_bound(query);
+			if (expectedLower == values.end())
+			{
+				ASSERT_TRUE(lower == frozen.end());
+			}
+			else
+			{
+				ASSERT_EQ(*lower, *expectedLower);
+			}
+
+			auto expectedUpper = std::upper_bound(values.begin(), values.end(), query);
+			auto upper = frozen.upper_bound(query);
+			if (expectedUpper == values.end())
+			{
+				ASSERT_TRUE(upper == frozen.end());
+			}
+			else
+			{
+				ASSERT_EQ(*upper, *expectedUpper);
+			}
+
+			ASSERT_EQ(frozen.find(query) != frozen.end(), std::binary_search(values.begin(), values.end(), query));
+		}
+	}
+}
+
+TEST(FrozenSearchTree, ComparerTest)
+{
+	//A custom comparer is used for searching instead of the < operator
+	std::vector<int> descending{ 50, 40, 30, 20, 10 };
+	frozen_search_tree<int> frozen(descending.begin(), descending.end(), [](const int& a, const int& b) { return a > b; });
+	ASSERT_EQ(*frozen.lower_bound(35), 30);
+	ASSERT_EQ(*frozen.upper_bound(40), 30);
+	ASSERT_TRUE(frozen.contains(20));
+	ASSERT_FALSE(frozen.contains(25));
+
+	//Types that aren't numbers go through the comparer too
+	binary_search_tree<std::string> words{ "pear", "apple", "fig", "kiwi" };
+	auto frozenWords = words.freeze();
+	ASSERT_TRUE(frozenWords.contains("fig"));
+	ASSERT_EQ(*frozenWords.lower_bound("b"), std::string("fig"));
+
+	std::stringstream stream;
+	stream << frozenWords;
+	ASSERT_EQ(stream.str(), std::string("[apple, fig, kiwi, pear]"));
+
+	frozen_search_tree<int> empty;
+	ASSERT_TRUE(empty.begin() == empty.end());
+	ASSERT_FALSE(empty.contains(0));
+	ASSERT_THROW(++empty.begin(), struct_exception);
+}
@@ -0,0 +1,195 @@
+#include <gtest/gtest.h>
+#include <common.h>
+#include <interval_tree.h>
+#include <algorithm>
+#include <random>
+#include <set>
+#include <sstream>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace {
+	using interval_set = std::set<std::pair<int, int>>;
+
+	//Finds the intervals that overlap [low, high] by checking every interval
+	std::vector<interval<int>> brute_force_overlapping(const interval_set& intervals, int low, int high)
+	{
+		std::vector<interval<int>> result;
+		for (auto& value : intervals)
+		{
+			if (value.first <= high && low <= value.second)
+			{
+				result.push_back(interval<int>{ value.first, value.second });
+			}
+		}
+		return result;
+	}
+
+	//Checks that the highest endpoint stored in every node matches its subtree, and returns the highest endpoint of the subtree
+	template<typename Iterator>
+	int check_max_end(Iterator node, const Iterator& end)
+	{
+		int maxEnd = node->high;
+		Iterator left = node.getLeft();
+		Iterator right = node.getRight();
+		if (left != end)
+		{
+			maxEnd = std::max(maxEnd, check_max_end(left, end));
+		}
+		if (right != end)
+		{
+			maxEnd = std::max(maxEnd, check_max_end(right, end));
+		}
+		EXPECT_EQ(node.getAugmentation().maxEnd, maxEnd);
+		return maxEnd;
+	}
+
+	//Used to check that the functions of the underlying tree that add values without checking them can't be called
+	template<typename Tree, typename = void>
+	struct has_insert_batch : std::false_type {};
+
+	template<typename Tree>
+	struct has_insert_batch<Tree, decltype(void(std::declval<Tree&>().insert_batch(std::declval<std::vector<interval<int>>&>().begin(), std::declval<std::vector<interval<int>>&>().end())))> : std::true_type {};
+
+	template<typename Tree, typename = void>
+	struct has_union_with : std::false_type {};
+
+	template<typename Tree>
+	struct has_union_with<Tree, decltype(void(std::declval<Tree&>().union_with(std::declval<const Tree&>())))> : std::true_type {};
+}
+
+TEST(IntervalTree, OverlapTest)
+{
+	interval_tree<int> tree;
+	interval_set expected;
+	std::mt19937 random(29);
+
+	for (int i = 0; i < 20000; i++)
+	{
+		int low = static_cast<int>(random() % 5000);
+		int high = low + static_cast<int>(random() % 100);
+		if (random() % 3 != 0)
+		{
+			ASSERT_EQ(tree.insert(low, high) != tree.end(), expected.emplace(low, high).second);
+		}
+		else if (!expected.empty())
+		{
+			//Remove an interval that is in the tree, so that removals with two children and rotations happen often
+			auto existing = expected.lower_bound({ low, 0 });
+			if (existing == expected.end())
+			{
+				existing = expected.begin();
+			}
+			ASSERT_TRUE(tree.remove(existing->first, existing->second));
+			expected.erase(existing);
+		}
+		if (i % 1000 == 0 && tree.getSize() > 0)
+		{
+			check_max_end(tree.getRoot(), tree.end());
+		}
+	}
+	ASSERT_EQ(tree.getSize(), static_cast<int>(expected.size()));
+	check_max_end(tree.getRoot(), tree.end());
+
+	for (int i = 0; i < 2000; i++)
+	{
+		int low = static_cast<int>(random() % 5200) - 100;
+		int high = low + static_cast<int>(random() % 200);
+		std::vector<interval<int>> result = tree.overlapping(low, high);
+		ASSERT_EQ(result, brute_force_overlapping(expected, low, high));
+		ASSERT_EQ(tree.overlaps_any(low, high), !result.empty());
+		ASSERT_EQ(tree.stabbing(low), brute_force_overlapping(expected, low, low));
+	}
+
+	//A point past every interval overlaps nothing
+	ASSERT_TRUE(tree.stabbing(6000).empty());
+	ASSERT_FALSE(tree.overlaps_any(6000, 7000));
+
+	ASSERT_THROW(tree.insert(5, 4), struct_exception);
+}
+
+TEST(IntervalTree, NestedTest)
+{
+	//Long intervals that contain many short ones are the hardest case for the search, since the long ones can't be skipped
+	interval_tree<int> tree;
+	interval_set expected;
+	for (int i = 0; i < 500; i++)
+	{
+		tree.insert(i, 1000 - i);
+		tree.insert(i * 2, i * 2 + 1);
+		expected.emplace(i, 1000 - i);
+		expected.emplace(i * 2, i * 2 + 1);
+	}
+	check_max_end(tree.getRoot(), tree.end());
+	for (int point = -1; point <= 1001; point += 7)
+	{
+		ASSERT_EQ(tree.stabbing(point), brute_force_overlapping(expected, point, point));
+	}
+
+	int visited = 0;
+	tree.for_each_overlapping(100, 100, [&](const interval<int>& value) {
+		ASSERT_TRUE(value.overlaps(100, 100));
+		visited++;
+	});
+	ASSERT_EQ(visited, 102);
+}
+
+TEST(IntervalTree, FromSortedTest)
+{
+	std::vector<interval<int>> values;
+	for (int i = 0; i < 1000; i++)
+	{
+		values.push_back(interval<int>{ i * 3, i * 3 + (i % 10) });
+	}
+	interval_tree<int> tree = interval_tree<int>::from_sorted(values.begin(), values.end());
+	ASSERT_EQ(tree.getSize(), 1000);
+	ASSERT_EQ(tree.traverse(), values);
+	check_max_end(tree.getRoot(), tree.end());
+	ASSERT_EQ(tree.overlapping(30, 31), (std::vector<interval<int>>{ { 24, 32 }, { 27, 36 }, { 30, 30 } }));
+
+	//Copies are built the same way, so their endpoints are worked out again
+	interval_tree<int> copy = tree;
+	copy.insert(-10, 5000);
+	check_max_end(copy.getRoot(), copy.end());
+	ASSERT_EQ(copy.stabbing(4000).size(), 1u);
+	ASSERT_TRUE(tree.stabbing(4000).empty());
+
+	std::reverse(values.begin(), values.end());
+	interval_tree<int> unsorted = interval_tree<int>::from_unsorted(values.begin(), values.end());
+	ASSERT_EQ(unsorted.getSize(), 1000);
+	check_max_end(unsorted.getRoot(), unsorted.end());
+
+	std::vector<interval<int>> broken{ { 1, 2 }, { 4, 3 } };
+	ASSERT_THROW(interval_tree<int>::from_sorted(broken.begin(), broken.end()), struct_exception);
+
+	std::stringstream stream;
+	interval_tree<int> small{ { 4, 8 }, { 1, 5 } };
+	stream << small;
+	ASSERT_EQ(stream.str(), "[[1, 5], [4, 8]]");
+}
+
+TEST(IntervalTree, TreeFunctionsTest)
+{
+	//Adding intervals only goes through the functions that check them
+	static_assert(!has_insert_batch<interval_tree<int>>::value, "insert_batch would skip checking the intervals");
+	static_assert(!has_union_with<interval_tree<int>>::value, "union_with would skip checking the intervals");
+
+	interval_tree<int> tree{ { 1, 3 }, { 2, 9 }, { 5, 6 }, { 8, 12 } };
+	ASSERT_TRUE(tree.contains(interval<int>{ 2, 9 }));
+	ASSERT_EQ(*tree.find(5, 6), (interval<int>{ 5, 6 }));
+	ASSERT_TRUE(tree.find(5, 7) == tree.end());
+	ASSERT_EQ(*tree.minimum(), (interval<int>{ 1, 3 }));
+	ASSERT_EQ(*tree.maximum(), (interval<int>{ 8, 12 }));
+	ASSERT_EQ(*tree.lower_bound(interval<int>{ 4, 0 }), (interval<int>{ 5, 6 }));
+
+	std::vector<interval<int>> toErase{ { 1, 3 }, { 5, 6 } };
+	ASSERT_EQ(tree.erase_batch(toErase.begin(), toErase.end()), 2);
+	ASSERT_EQ(tree.traverse(), (std::vector<interval<int>>{ { 2, 9 }, { 8, 12 } }));
+	check_max_end(tree.getRoot(), tree.end());
+	ASSERT_EQ(tree.stabbing(10).size(), 1u);
+
+	tree.clear();
+	ASSERT_EQ(tree.getSize(), 0);
+	ASSERT_FALSE(tree.overlaps_any(0, 100));
+}
@@ -1,6 +1,10 @@
 #include <gtest/gtest.h>
 #include <common.h>
 #include <linked_list.h>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
 
 TEST(LinkedListTests, CopyConstructorTest)
 {
@@ -383,4 +387,310 @@ TEST(LinkedListTests, PrintTest)
 
 	//Test if the string is the same as the expected output
 	ASSERT_TRUE(result == std::string("[2819, 6523, 43829, 9302]"));
-}
\ No newline at end of file
+}
+
+TEST(LinkedListTests, SplitTest)
+{
+	linked_list<int> testList{};
+	for (int i = 0; i < 10; i++)
+	{
+		testList.push_back(i);
+	}
+
+	//Split into 3 chunks. Every value should be in exactly one chunk, in order
+	auto chunks = testList.split(3);
+	ASSERT_EQ(chunks.size(), 3);
+	int expected = 0;
+	for (auto& chunk : chunks)
+	{
+		ASSERT_TRUE(chunk.first != chunk.second);
+		for (auto i = chunk.first; i != chunk.second; ++i)
+		{
+			ASSERT_EQ(*i, expected++);
+		}
+	}
+	ASSERT_EQ(expected, 10);
+
+	//More chunks than nodes gives one chunk per node
+	ASSERT_EQ(testList.split(20).size(), 10);
+	//An empty list has no chunks
+	ASSERT_EQ(linked_list<int>{}.split(4).size(), 0);
+}
+
+TEST(LinkedListTests, CheckpointTest)
+{
+	linked_list<int> testList{};
+	ASSERT_THROW(testList.enable_checkpoints(0), struct_exception);
+	testList.enable_checkpoints(4);
+	ASSERT_EQ(testList.getCheckpointInterval(), 4);
+
+	for (int i = 0; i < 100; i++)
+	{
+		testList.push_back(i);
+	}
+
+	//Checks that the chunks cover every value in order, and that each chunk starts on a checkpoint
+	auto checkChunks = [&testList](int chunkCount, int expectedFirst) {
+		auto chunks = testList.split(chunkCount);
+		int expected = expectedFirst;
+		for (auto& chunk : chunks)
+		{
+			if (testList.getCheckpointInterval() != 0)
+			{
+				ASSERT_EQ((*chunk.first - expectedFirst) % 4, 0);
+			}
+			for (auto i = chunk.first; i != chunk.second; ++i)
+			{
+				ASSERT_EQ(*i, expected++);
+			}
+		}
+		ASSERT_EQ(expected, expectedFirst + testList.getSize());
+	};
+
+	checkChunks(5, 0);
+
+	//Popping from the back keeps the checkpoints valid
+	testList.pop_back();
+	testList.pop_back();
+	checkChunks(7, 0);
+
+	//Changing the front of the list makes the checkpoints out of date. A const split can't rebuild them, so it walks over the list instead
+	testList.pop_front();
+	const linked_list<int>& constList = testList;
+	auto constChunks = constList.split(3);
+	ASSERT_EQ(constChunks.size(), 3);
+	ASSERT_EQ(*constChunks[1].first, 33);
+	ASSERT_EQ(*constChunks[2].first, 65);
+
+	//A non-const split rebuilds the checkpoints
+	checkChunks(3, 1);
+	testList.push_front(0);
+	checkChunks(3, 0);
+
+	testList.disable_checkpoints();
+	ASSERT_EQ(testList.getCheckpointInterval(), 0);
+	checkChunks(6, 0);
+}
+
+TEST(LinkedListTests, SpliceBackTest)
+{
+	linked_list<int> first{};
+	first.push_back(1);
+	first.push_back(2);
+
+	linked_list<int> second{};
+	second.push_back(3);
+	second.push_back(4);
+
+	first.splice_back(std::move(second));
+	ASSERT_EQ(first.getSize(), 4);
+	ASSERT_EQ(second.getSize(), 0);
+	ASSERT_TRUE(second.begin() == second.end());
+
+	int expected = 1;
+	for (auto value : first)
+	{
+		ASSERT_EQ(value, expected++);
+	}
+	ASSERT_EQ(*(--first.end()), 4);
+
+	//Splicing onto an empty list takes all the nodes
+	linked_list<int> empty{};
+	empty.splice_back(std::move(first));
+	ASSERT_EQ(empty.getSize(), 4);
+	ASSERT_EQ(first.getSize(), 0);
+}
+
+TEST(LinkedListTests, CompactTest)
+{
+	linked_list<std::string> testList{};
+	for (int i = 0; i < 100; i++)
+	{
+		testList.push_back(std::to_string(i));
+	}
+	//Remove some nodes so the list has gaps
+	for (auto i = testList.begin(); i != testList.end();)
+	{
+		auto current = i++;
+		if (std::stoi(*current) % 3 == 0)
+		{
+			testList.pop_element(current);
+		}
+	}
+
+	testList.compact();
+	ASSERT_EQ(testList.getSize(), 66);
+
+	//The nodes should be in order, and next to each other in memory
+	int expected = 1;
+	const std::string* previous = nullptr;
+	for (auto i = testList.begin(); i != testList.end(); ++i)
+	{
+		ASSERT_EQ(*i, std::to_string(expected));
+		expected += expected % 3 == 2 ? 2 : 1;
+		if (previous != nullptr)
+		{
+			ASSERT_EQ(reinterpret_cast<const char*>(&*i) - reinterpret_cast<const char*>(previous), sizeof(linked_list<std::string>::node));
+		}
+		previous = &*i;
+	}
+
+	//The list still works normally after being compacted
+	testList.pop_front();
+	testList.pop_back();
+	testList.push_back("end");
+	testList.push_front("start");
+	testList.pop_element(testList.find("50"));
+	ASSERT_EQ(testList.getSize(), 65);
+	ASSERT_EQ(*testList.begin(), std::string("start"));
+	ASSERT_EQ(*(--testList.end()), std::string("end"));
+
+	//Compacting again moves the new nodes into the block too
+	testList.compact();
+	ASSERT_EQ(testList.getSize(), 65);
+	ASSERT_EQ(*testList.begin(), std::string("start"));
+	ASSERT_EQ(*(--testList.end()), std::string("end"));
+
+	//Copies and splices of a compacted list work too
+	linked_list<std::string> copy = testList;
+	ASSERT_TRUE(copy == testList);
+	copy.splice_back(std::move(testList));
+	ASSERT_EQ(copy.getSize(), 130);
+	copy.clear();
+	ASSERT_EQ(copy.getSize(), 0);
+}
+
+TEST(LinkedListTests, CompactIteratorTest)
+{
+	linked_list<int> testList{};
+	for (int i = 0; i < 10; i++)
+	{
+		testList.push_back(i);
+	}
+
+	auto oldIterator = testList.begin();
+	auto oldEnd = testList.end();
+	ASSERT_TRUE(oldIterator.is_valid());
+	ASSERT_EQ(testList.getGeneration(), 0);
+
+	testList.compact();
+	ASSERT_EQ(testList.getGeneration(), 1);
+
+	//Iterators from before compacting are detected and can't be used
+	ASSERT_FALSE(oldIterator.is_valid());
+	ASSERT_THROW(*oldIterator, struct_exception);
+	ASSERT_THROW(++oldIterator, struct_exception);
+	ASSERT_THROW(testList.pop_element(oldIterator), struct_exception);
+	ASSERT_THROW(testList.insert(5, oldIterator), struct_exception);
+
+	//The end() iterator is still valid
+	ASSERT_TRUE(oldEnd.is_valid());
+	ASSERT_TRUE(oldEnd == testList.end());
+
+	//New iterators work normally
+	auto newIterator = testList.begin();
+	ASSERT_TRUE(newIterator.is_valid());
+	ASSERT_EQ(*newIterator, 0);
+}
+
+TEST(LinkedListTests, MoveAssignmentReplacesTest)
+{
+	linked_list<int> first{ 1, 2, 3 };
+	linked_list<int> second{ 4, 5 };
+	second.compact();
+
+	//Move assigning frees the old nodes and takes the new ones
+	first = std::move(second);
+	ASSERT_EQ(first.getSize(), 2);
+	ASSERT_EQ(*first.begin(), 4);
+	ASSERT_EQ(second.getSize(), 0);
+	ASSERT_TRUE(second.begin() == second.end());
+}
+
+TEST(LinkedListTests, RangeConstructorTest)
+{
+	std::vector<int> values{ 4, 8, 15, 16, 23, 42 };
+	linked_list<int> testList(values.begin(), values.end());
+	ASSERT_EQ(testList.getSize(), 6);
+	ASSERT_TRUE(std::equal(testList.begin(), testList.end(), values.begin(), values.end()));
+	ASSERT_EQ(*(--testList.end()), 42);
+
+	//A range that can only be read once
+	std::istringstream stream("1 2 3");
+	linked_list<int> streamList{ std::istream_iterator<int>(stream), std::istream_iterator<int>() };
+	ASSERT_EQ(streamList, (linked_list<int>{ 1, 2, 3 }));
+
+	//An empty range
+	linked_list<int> emptyList(values.end(), values.end());
+	ASSERT_EQ(emptyList.getSize(), 0);
+	ASSERT_TRUE(emptyList.begin() == emptyList.end());
+}
+
+TEST(LinkedListTests, AssignTest)
+{
+	linked_list<std::string> testList{ "a", "b" };
+	std::vector<std::string> values{ "x", "y", "z" };
+	testList.assign(values.begin(), values.end());
+	ASSERT_EQ(testList, (linked_list<std::string>{ "x", "y", "z" }));
+
+	//Assigning the list to itself works, since the new nodes are built first
+	testList.assign(testList.begin(), testList.end());
+	ASSERT_EQ(testList, (linked_list<std::string>{ "x", "y", "z" }));
+
+	testList.assign({ "q" });
+	ASSERT_EQ(testList, (linked_list<std::string>{ "q" }));
+
+	//The list still works normally after the values were assigned
+	testList.pop_front();
+	testList.push_back("r");
+	ASSERT_EQ(testList, (linked_list<std::string>{ "r" }));
+}
+
+TEST(LinkedListTests, RangeInsertTest)
+{
+	linked_list<int> testList{ 1, 5 };
+	std::vector<int> middle{ 2, 3, 4 };
+	std::vector<int> back{ 6, 7 };
+
+	auto inserted = testList.insert(testList.find(5), middle.begin(), middle.end());
+	ASSERT_EQ(*inserted, 2);
+	testList.insert(testList.end(), back.begin(), back.end());
+	testList.insert(testList.begin(), middle.begin(), middle.begin() + 1);
+	ASSERT_EQ(testList, (linked_list<int>{ 2, 1, 2, 3, 4, 5, 6, 7 }));
+
+	//Inserting an empty range returns the position
+	auto position = testList.find(5);
+	ASSERT_TRUE(testList.insert(position, back.end(), back.end()) == position);
+
+	//Removing nodes from the middle of an inserted block works
+	testList.pop_element(testList.find(3));
+	testList.pop_back();
+	ASSERT_EQ(testList, (linked_list<int>{ 2, 1, 2, 4, 5, 6 }));
+	ASSERT_EQ(testList.getSize(), 6);
+}
+
+TEST(LinkedListTests, RangeInsertCheckpointTest)
+{
+	linked_list<int> testList{};
+	testList.enable_checkpoints(3);
+	std::vector<int> values(20);
+	for (int i = 0; i < 20; i++)
+	{
+		values[i] = i;
+	}
+
+	//Adding to the back keeps the checkpoints up to date
+	testList.insert(testList.end(), values.begin(), values.begin() + 10);
+	testList.insert(testList.end(), values.begin() + 10, values.end());
+	auto chunks = testList.split(4);
+	int expected = 0;
+	for (auto& chunk : chunks)
+	{
+		ASSERT_EQ(*chunk.first % 3, 0);
+		for (auto i = chunk.first; i != chunk.second; ++i)
+		{
+			ASSERT_EQ(*i, expected++);
+		}
+	}
+	ASSERT_EQ(expected, 20);
+}
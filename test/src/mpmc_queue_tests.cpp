@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+#include <common.h>
+#include <mpmc_queue.h>
+#include <atomic>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(MpmcQueue, CapacityTest)
+{
+	mpmc_queue<int> queue{ 5 };
+
+	//The capacity gets rounded up to a power of two
+	ASSERT_EQ(queue.capacity(), 8);
+	ASSERT_THROW(mpmc_queue<int>{ 0 }, struct_exception);
+}
+
+TEST(MpmcQueue, PushPopTest)
+{
+	mpmc_queue<int> queue{ 4 };
+
+	ASSERT_TRUE(queue.try_push(1));
+	ASSERT_TRUE(queue.try_push(2));
+	ASSERT_TRUE(queue.try_push(3));
+	ASSERT_TRUE(queue.try_push(4));
+	//The queue is full now
+	ASSERT_FALSE(queue.try_push(5));
+	ASSERT_EQ(queue.approximate_size(), 4);
+
+	//Values come out in the same order they went in
+	int value = 0;
+	ASSERT_TRUE(queue.try_pop(value));
+	ASSERT_EQ(value, 1);
+	ASSERT_EQ(queue.pop(), 2);
+
+	//There is room again after popping, and the positions wrap around the buffer
+	ASSERT_TRUE(queue.try_push(5));
+	ASSERT_EQ(queue.pop(), 3);
+	ASSERT_EQ(queue.pop(), 4);
+	ASSERT_EQ(queue.pop(), 5);
+	ASSERT_FALSE(queue.try_pop(value));
+}
+
+TEST(MpmcQueue, BatchTest)
+{
+	mpmc_queue<int> queue{ 8 };
+
+	std::vector<int> values{ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+
+	//Only as many values as there is room for get pushed
+	ASSERT_EQ(queue.try_push_batch(values.begin(), values.end()), 8);
+
+	std::vector<int> popped;
+	ASSERT_EQ(queue.try_pop_batch(std::back_inserter(popped), 3), 3);
+	ASSERT_EQ(popped, (std::vector<int>{ 1, 2, 3 }));
+
+	ASSERT_EQ(queue.try_push_batch(values.begin() + 8, values.end()), 2);
+	ASSERT_EQ(queue.try_pop_batch(std::back_inserter(popped), 100), 7);
+	ASSERT_EQ(popped, values);
+	ASSERT_EQ(queue.try_pop_batch(std::back_inserter(popped), 100), 0);
+}
+
+TEST(MpmcQueue, NonTrivialTypeTest)
+{
+	mpmc_queue<std::string> queue{ 4 };
+
+	queue.push(std::string(100, 'a'));
+	ASSERT_TRUE(queue.try_emplace(50, 'b'));
+
+	std::vector<std::string> values{ "c", "d" };
+	queue.push_batch(std::make_move_iterator(values.begin()), std::make_move_iterator(values.end()));
+
+	ASSERT_EQ(queue.pop(), std::string(100, 'a'));
+	ASSERT_EQ(queue.pop(), std::string(50, 'b'));
+	//The remaining strings are destroyed along with the queue
+}
+
+TEST(MpmcQueue, MultipleThreadsTest)
+{
+	mpmc_queue<int> queue{ 64 };
+
+	const int producerCount = 4;
+	const int consumerCount = 4;
+	const int valuesPerProducer = 20000;
+
+	std::atomic<long long> sum{ 0 };
+	std::atomic<int> popped{ 0 };
+	std::vector<std::thread> threads;
+
+	//Each producer pushes its own range of values, using both single and batch pushes
+	for (int p = 0; p < producerCount; p++)
+	{
+		threads.emplace_back([&queue, p, valuesPerProducer]() {
+			int start = p * valuesPerProducer;
+			for (int i = start; i < start + valuesPerProducer; i += 4)
+			{
+				if (i % 8 == 0)
+				{
+					int batch[4] = { i, i + 1, i + 2, i + 3 };
+					queue.push_batch(batch, batch + 4);
+				}
+				else
+				{
+					for (int j = i; j < i + 4; j++)
+					{
+						queue.push(j);
+					}
+				}
+			}
+		});
+	}
+
+	const int total = producerCount * valuesPerProducer;
+	for (int c = 0; c < consumerCount; c++)
+	{
+		threads.emplace_back([&queue, &sum, &popped, total]() {
+			int values[16];
+			while (popped.load() < total)
+			{
+				std::size_t count = queue.try_pop_batch(values, 16);
+				//Let the producers run if the queue is empty
+				if (count == 0)
+				{
+					std::this_thread::yield();
+				}
+				for (std::size_t i = 0; i < count; i++)
+				{
+					sum += values[i];
+				}
+				popped += static_cast<int>(count);
+			}
+		});
+	}
+
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	//Every value should have been popped exactly once
+	long long expected = (static_cast<long long>(total) - 1) * total / 2;
+	ASSERT_EQ(popped.load(), total);
+	ASSERT_EQ(sum.load(), expected);
+}
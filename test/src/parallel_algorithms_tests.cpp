@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+#include <common.h>
+#include <parallel_algorithms.h>
+#include <atomic>
+#include <string>
+
+TEST(ParallelAlgorithms, ForEachTest)
+{
+	linked_list<int> list{};
+	for (int i = 0; i < 100000; i++)
+	{
+		list.push_back(i);
+	}
+
+	//Double every value on 4 threads
+	parallel_for_each(list, [](int& value) { value *= 2; }, 4);
+
+	int expected = 0;
+	for (auto value : list)
+	{
+		ASSERT_EQ(value, expected);
+		expected += 2;
+	}
+
+	//Count the values through a const list
+	const linked_list<int>& constList = list;
+	std::atomic<int> count{ 0 };
+	parallel_for_each(constList, [&count](const int&) { count++; }, 4);
+	ASSERT_EQ(count.load(), 100000);
+}
+
+TEST(ParallelAlgorithms, ReduceTest)
+{
+	linked_list<int> list{};
+	list.enable_checkpoints(256);
+	for (int i = 1; i <= 100000; i++)
+	{
+		list.push_back(i);
+	}
+
+	long long sum = parallel_reduce(list, 0LL, [](long long a, long long b) { return a + b; }, 4);
+	ASSERT_EQ(sum, 100000LL * 100001 / 2);
+
+	//Adding to the front marks the checkpoints as out of date, and a non-const list has them rebuilt before it's split
+	list.push_front(-100);
+	sum = parallel_reduce(list, 0LL, [](long long a, long long b) { return a + b; }, 4);
+	ASSERT_EQ(sum, 100000LL * 100001 / 2 - 100);
+	const linked_list<int>& constList = list;
+	list.push_front(-200);
+	sum = parallel_reduce(constList, 0LL, [](long long a, long long b) { return a + b; }, 4);
+	ASSERT_EQ(sum, 100000LL * 100001 / 2 - 300);
+
+	//The chunks are combined in order, so operations that aren't commutative still work
+	linked_list<std::string> letters{};
+	for (int i = 0; i < 10000; i++)
+	{
+		letters.push_back(std::string(1, static_cast<char>('a' + i % 26)));
+	}
+	std::string joined = parallel_reduce(letters, std::string(),
+		[](std::string result, const std::string& value) { return result + value; },
+		[](std::string a, const std::string& b) { return a + b; }, 4);
+	ASSERT_EQ(joined.size(), 10000);
+	for (int i = 0; i < 10000; i++)
+	{
+		ASSERT_EQ(joined[i], 'a' + i % 26);
+	}
+
+	//An empty list returns the identity
+	ASSERT_EQ(parallel_reduce(linked_list<int>{}, 5, [](int a, int b) { return a + b; }), 5);
+}
+
+TEST(ParallelAlgorithms, TransformTest)
+{
+	linked_list<int> input{};
+	for (int i = 0; i < 50000; i++)
+	{
+		input.push_back(i);
+	}
+
+	linked_list<std::string> output{};
+	output.push_back("old");
+	parallel_transform(input, output, [](int value) { return std::to_string(value); }, 4);
+
+	ASSERT_EQ(output.getSize(), 50000);
+	int expected = 0;
+	for (auto& value : output)
+	{
+		ASSERT_EQ(value, std::to_string(expected++));
+	}
+
+	//The checkpoints of the input are rebuilt after it changes
+	input.enable_checkpoints(128);
+	input.push_front(-1);
+	parallel_transform(input, output, [](int value) { return std::to_string(value); }, 4);
+	ASSERT_EQ(output.getSize(), 50001);
+	expected = -1;
+	for (auto& value : output)
+	{
+		ASSERT_EQ(value, std::to_string(expected++));
+	}
+}
+
+TEST(ParallelAlgorithms, ExceptionTest)
+{
+	linked_list<int> list{};
+	for (int i = 0; i < 100000; i++)
+	{
+		list.push_back(i);
+	}
+
+	//An exception thrown on any thread is passed on to the caller
+	ASSERT_THROW(parallel_for_each(list, [](int& value) {
+		if (value == 99999)
+		{
+			throw struct_exception("Test exception");
+		}
+	}, 4), struct_exception);
+}
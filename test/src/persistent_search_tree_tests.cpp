@@ -0,0 +1,244 @@
+#include <gtest/gtest.h>
+#include <common.h>
+#include <persistent_search_tree.h>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+	//A value that counts how many copies of it are alive, and how many have ever been made
+	struct counted {
+		static int alive;
+		static int copies;
+		int value;
+
+		counted(int value) : value(value) { alive++; }
+		counted(const counted& other) : value(other.value) { alive++; copies++; }
+		counted& operator=(const counted& other) { value = other.value; copies++; return *this; }
+		~counted() { alive--; }
+
+		bool operator<(const counted& rhs) const
+		{
+			return value < rhs.value;
+		}
+	};
+
+	int counted::alive = 0;
+	int counted::copies = 0;
+}
+
+TEST(PersistentSearchTree, InsertRemoveTest)
+{
+	persistent_search_tree<int> tree;
+	std::set<int> expected;
+	std::mt19937 random(11);
+
+	for (int i = 0; i < 20000; i++)
+	{
+		int value = static_cast<int>(random() % 1000);
+		if (random() % 3 != 0)
+		{
+			ASSERT_EQ(tree.insert(value), expected.insert(value).second);
+		}
+		else
+		{
+			ASSERT_EQ(tree.remove(value), expected.erase(value) == 1);
+		}
+		ASSERT_EQ(tree.getSize(), static_cast<int>(expected.size()));
+	}
+	ASSERT_EQ(tree.traverse(), std::vector<int>(expected.begin(), expected.end()));
+
+	for (int i = -1; i <= 1000; i++)
+	{
+		ASSERT_EQ(tree.contains(i), expected.count(i) == 1);
+		ASSERT_EQ(tree.find(i) != tree.end(), expected.count(i) == 1);
+		auto lower = tree.lower_bound(i);
+		auto expectedLower = expected.lower_bound(i);
+		ASSERT_EQ(lower == tree.end(), expectedLower == expected.end());
+		if (lower != tree.end())
+		{
+			ASSERT_EQ(*lower, *expectedLower);
+		}
+		auto upper = tree.upper_bound(i);
+		auto expectedUpper = expected.upper_bound(i);
+		ASSERT_EQ(upper == tree.end(), expectedUpper == expected.end());
+		if (upper != tree.end())
+		{
+			ASSERT_EQ(*upper, *expectedUpper);
+		}
+	}
+
+	std::stringstream stream;
+	persistent_search_tree<int> small;
+	small.insert(3);
+	small.insert(1);
+	small.insert(2);
+	stream << small;
+	ASSERT_EQ(stream.str(), "[1, 2, 3]");
+
+	tree.clear();
+	ASSERT_EQ(tree.getSize(), 0);
+	ASSERT_TRUE(tree.traverse().empty());
+}
+
+TEST(PersistentSearchTree, SnapshotTest)
+{
+	persistent_search_tree<std::string> tree;
+	for (int i = 0; i < 100; i++)
+	{
+		tree.insert(std::to_string(i));
+	}
+
+	//Every snapshot keeps the values the tree had when it was taken
+	std::vector<persistent_search_tree<std::string>> snapshots;
+	std::vector<std::vector<std::string>> expected;
+	std::mt19937 random(3);
+	for (int i = 0; i < 200; i++)
+	{
+		snapshots.push_back(tree.snapshot());
+		expected.push_back(tree.traverse());
+		ASSERT_TRUE(snapshots.back().sharesRootWith(tree));
+
+		std::string value = std::to_string(random() % 150);
+		if (random() % 2 == 0)
+		{
+			tree.insert(value);
+		}
+		else
+		{
+			tree.remove(value);
+		}
+	}
+	for (size_t i = 0; i < snapshots.size(); i++)
+	{
+		ASSERT_EQ(snapshots[i].traverse(), expected[i]);
+		ASSERT_EQ(snapshots[i].getSize(), static_cast<int>(expected[i].size()));
+	}
+
+	//Changing a snapshot doesn't change the tree it was taken from
+	tree.insert("0");
+	persistent_search_tree<std::string> copy = tree;
+	copy.insert("new");
+	copy.remove("0");
+	ASSERT_FALSE(tree.contains("new"));
+	ASSERT_TRUE(tree.contains("0"));
+	ASSERT_FALSE(copy.contains("0"));
+	ASSERT_FALSE(copy.sharesRootWith(tree));
+
+	//Assigning trees to each other shares their nodes, and clearing one leaves the others whole
+	snapshots[0] = snapshots[1];
+	snapshots[0] = snapshots[0];
+	ASSERT_EQ(snapshots[0].traverse(), expected[1]);
+	snapshots[1].clear();
+	ASSERT_EQ(snapshots[0].traverse(), expected[1]);
+	snapshots[2] = std::move(snapshots[3]);
+	ASSERT_EQ(snapshots[2].traverse(), expected[3]);
+}
+
+TEST(PersistentSearchTree, WriteToCopiesTest)
+{
+	//The original's second write created the node for 1. The snapshot's second write goes through that node, and must copy it rather than change it
+	persistent_search_tree<int> small;
+	small.insert(2);
+	small.insert(1);
+	small.insert(3);
+	auto smallSnapshot = small.snapshot();
+	smallSnapshot.insert(4);
+	smallSnapshot.insert(0);
+	ASSERT_EQ(small.traverse(), std::vector<int>({ 1, 2, 3 }));
+	ASSERT_EQ(smallSnapshot.traverse(), std::vector<int>({ 0, 1, 2, 3, 4 }));
+
+	{
+		std::mt19937 random(11);
+		persistent_search_tree<counted> tree;
+		std::set<int> expected;
+		for (int i = 0; i < 2000; i++)
+		{
+			int value = static_cast<int>(random() % 4000);
+			tree.insert(counted(value));
+			expected.insert(value);
+		}
+
+		//Checks that the original tree still has every value it had before the copies were changed
+		auto checkOriginal = [&tree, &expected]() {
+			ASSERT_EQ(tree.getSize(), static_cast<int>(expected.size()));
+			auto value = expected.begin();
+			for (auto& item : tree)
+			{
+				ASSERT_EQ(item.value, *value++);
+			}
+		};
+
+		//Writes to a copy must never change the nodes it shares with the original, even though the copy has made fewer writes than the original
+		auto changeCopy = [&random](persistent_search_tree<counted>& copy) {
+			for (int i = 0; i < 500; i++)
+			{
+				copy.insert(counted(static_cast<int>(random() % 4000)));
+				copy.remove(counted(static_cast<int>(random() % 4000)));
+			}
+		};
+
+		auto snapshot = tree.snapshot();
+		changeCopy(snapshot);
+		checkOriginal();
+
+		persistent_search_tree<counted> copy = tree;
+		changeCopy(copy);
+		checkOriginal();
+
+		persistent_search_tree<counted> moved = std::move(persistent_search_tree<counted>(tree));
+		changeCopy(moved);
+		checkOriginal();
+
+		//Writes to the original don't change the copies either
+		auto view = tree.snapshot();
+		std::vector<int> viewValues(expected.begin(), expected.end());
+		changeCopy(tree);
+		ASSERT_EQ(view.getSize(), static_cast<int>(viewValues.size()));
+		auto value = viewValues.begin();
+		for (auto& item : view)
+		{
+			ASSERT_EQ(item.value, *value++);
+		}
+	}
+	//Every node is freed once no tree points to it
+	ASSERT_EQ(counted::alive, 0);
+}
+
+TEST(PersistentSearchTree, PathCopyingTest)
+{
+	{
+		persistent_search_tree<counted> tree;
+		const int count = 4096;
+		for (int i = 0; i < count; i++)
+		{
+			tree.insert(counted(i));
+		}
+		ASSERT_EQ(counted::alive, count);
+
+		//Taking a snapshot doesn't copy any values
+		counted::copies = 0;
+		auto view = tree.snapshot();
+		ASSERT_EQ(counted::copies, 0);
+
+		//A write copies only the values on one path, plus the siblings that rotations move, which is O(log n) and far below the 4096 values of the tree
+		for (int i = 0; i < count; i += 64)
+		{
+			counted::copies = 0;
+			ASSERT_TRUE(tree.remove(counted(i)));
+			ASSERT_LE(counted::copies, 40);
+			counted::copies = 0;
+			ASSERT_TRUE(tree.insert(counted(count + i)));
+			ASSERT_LE(counted::copies, 40);
+		}
+		ASSERT_EQ(view.getSize(), count);
+		ASSERT_EQ(view.begin()->value, 0);
+
+		//Only the copied paths exist twice, not the whole tree
+		ASSERT_LT(counted::alive, count + count / 2);
+	}
+	//Every node is freed once no tree points to it
+	ASSERT_EQ(counted::alive, 0);
+}
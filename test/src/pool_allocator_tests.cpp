@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+#include <common.h>
+#include <pool_allocator.h>
+#include <binary_search_tree.h>
+#include <string>
+#include <vector>
+
+using pool_tree = binary_search_tree<int, std::function<bool(const int&, const int&)>, pool_allocator<int>>;
+
+TEST(PoolAllocator, ReuseTest)
+{
+	pool_allocator<double> allocator;
+	double* a = allocator.allocate(1);
+	double* b = allocator.allocate(1);
+	ASSERT_NE(a, b);
+	ASSERT_EQ(allocator.getSlabCount(), 1);
+
+	//A freed object is handed out again by the next allocation
+	allocator.deallocate(a, 1);
+	ASSERT_EQ(allocator.allocate(1), a);
+
+	//Allocations of more than one object don't come from the pool
+	double* many = allocator.allocate(10);
+	many[9] = 1.0;
+	allocator.deallocate(many, 10);
+	allocator.deallocate(a, 1);
+	allocator.deallocate(b, 1);
+
+	//Filling up a slab allocates a new one that is twice as big
+	std::vector<double*> objects;
+	for (int i = 0; i < 64 + 128; i++)
+	{
+		objects.push_back(allocator.allocate(1));
+	}
+	ASSERT_EQ(allocator.getSlabCount(), 2);
+	for (auto object : objects)
+	{
+		allocator.deallocate(object, 1);
+	}
+}
+
+TEST(PoolAllocator, SharedPoolTest)
+{
+	pool_allocator<int> first;
+	pool_allocator<int> copy{ first };
+	pool_allocator<long> converted{ first };
+	ASSERT_TRUE(first == copy);
+	ASSERT_TRUE(first == converted);
+	ASSERT_TRUE(first != pool_allocator<int>());
+	ASSERT_TRUE(first != first.select_on_container_copy_construction());
+
+	first.allocate(1);
+	//The pool can't be released while another allocator is using it
+	ASSERT_FALSE(first.release_all());
+	ASSERT_EQ(first.getSlabCount(), 1);
+}
+
+TEST(PoolAllocator, TreeTest)
+{
+	pool_tree tree;
+	for (int i = 0; i < 10000; i++)
+	{
+		tree.insert((i * 7919) % 10000);
+	}
+	for (int i = 0; i < 10000; i += 2)
+	{
+		ASSERT_TRUE(tree.remove(i));
+	}
+	ASSERT_EQ(tree.getSize(), 5000);
+	auto values = tree.traverse();
+	for (int i = 0; i < 5000; i++)
+	{
+		ASSERT_EQ(values[i], i * 2 + 1);
+	}
+
+	//Copies get their own pool, so they are independent of the original
+	pool_tree copy{ tree };
+	tree.clear();
+	ASSERT_EQ(copy.getSize(), 5000);
+	ASSERT_EQ(*copy.minimum(), 1);
+
+	//The cleared tree can be used again
+	tree.insert(5);
+	ASSERT_EQ(tree.traverse(), (std::vector<int>{ 5 }));
+
+	//Moving a tree takes its nodes along with its pool
+	pool_tree moved{ std::move(copy) };
+	ASSERT_EQ(moved.getSize(), 5000);
+	tree = std::move(moved);
+	ASSERT_EQ(tree.getSize(), 5000);
+	ASSERT_EQ(*tree.maximum(), 9999);
+
+	auto sorted = pool_tree::from_sorted(values.begin(), values.end());
+	ASSERT_EQ(sorted.traverse(), values);
+}
+
+TEST(PoolAllocator, NonTrivialTreeTest)
+{
+	//Strings need to be destroyed, so clearing still visits every node
+	binary_search_tree<std::string, std::function<bool(const std::string&, const std::string&)>, pool_allocator<std::string>> tree;
+	for (int i = 0; i < 1000; i++)
+	{
+		tree.insert(std::string(40, 'a') + std::to_string(i));
+	}
+	ASSERT_EQ(tree.getSize(), 1000);
+	tree.clear();
+	ASSERT_EQ(tree.getSize(), 0);
+	tree.insert(std::string("b"));
+	ASSERT_EQ(*tree.begin(), std::string("b"));
+}
@@ -0,0 +1,165 @@
+#include <gtest/gtest.h>
+#include <common.h>
+#include <skip_list.h>
+#include <sstream>
+#include <vector>
+
+TEST(SkipList, Insert)
+{
+	skip_list<int> list;
+
+	ASSERT_TRUE(list.insert(5) != list.end());
+	ASSERT_TRUE(list.insert(3) != list.end());
+	ASSERT_TRUE(list.insert(7) != list.end());
+	ASSERT_TRUE(list.insert(2) != list.end());
+	ASSERT_TRUE(list.insert(4) != list.end());
+	ASSERT_TRUE(list.insert(5) == list.end());
+	ASSERT_EQ(list.getSize(), 5);
+
+	list.clear();
+	ASSERT_EQ(list.getSize(), 0);
+	ASSERT_TRUE(list.begin() == list.end());
+}
+
+TEST(SkipList, FindAndRemove)
+{
+	skip_list<int> list;
+
+	//Insert a large amount of values so several levels get used
+	for (int i = 0; i < 1000; i++)
+	{
+		list.insert((i * 7919) % 1000);
+	}
+	ASSERT_EQ(list.getSize(), 1000);
+	ASSERT_GT(list.getLevel(), 1);
+
+	ASSERT_TRUE(list.find(500) != list.end());
+	ASSERT_EQ(*list.find(500), 500);
+	ASSERT_TRUE(list.find(1000) == list.end());
+
+	//Remove all the even values
+	for (int i = 0; i < 1000; i += 2)
+	{
+		ASSERT_TRUE(list.remove(i));
+	}
+	ASSERT_FALSE(list.remove(0));
+	ASSERT_EQ(list.getSize(), 500);
+	ASSERT_TRUE(list.find(500) == list.end());
+	ASSERT_TRUE(list.contains(501));
+
+	ASSERT_TRUE(list.remove(list.find(501)));
+	ASSERT_FALSE(list.contains(501));
+	ASSERT_FALSE(list.remove(list.end()));
+}
+
+TEST(SkipList, IteratorTest)
+{
+	skip_list<int> list{ 10, 5, 15, 3, 7, 12, 18 };
+
+	std::vector<int> expected_values = { 3, 5, 7, 10, 12, 15, 18 };
+
+	//Test forward iteration
+	std::vector<int> forward_values;
+	for (auto it = list.begin(); it != list.end(); ++it) {
+		forward_values.push_back(*it);
+	}
+	ASSERT_EQ(forward_values, expected_values);
+
+	//Test backward iteration
+	std::vector<int> backward_values;
+	auto it = list.end();
+	do {
+		--it;
+		backward_values.insert(backward_values.begin(), *it);
+	} while (it != list.begin());
+	ASSERT_EQ(backward_values, expected_values);
+
+	ASSERT_THROW(--list.begin(), struct_exception);
+	ASSERT_THROW(++list.end(), struct_exception);
+}
+
+TEST(SkipList, BoundsTest)
+{
+	skip_list<int> list{ 10, 20, 30, 40, 50 };
+
+	ASSERT_EQ(*list.lower_bound(20), 20);
+	ASSERT_EQ(*list.lower_bound(21), 30);
+	ASSERT_EQ(*list.upper_bound(20), 30);
+	ASSERT_TRUE(list.lower_bound(51) == list.end());
+	ASSERT_TRUE(list.upper_bound(50) == list.end());
+	ASSERT_EQ(*list.minimum(), 10);
+	ASSERT_EQ(*list.maximum(), 50);
+}
+
+TEST(SkipList, RangeTest)
+{
+	skip_list<int> list;
+	for (int i = 0; i < 100; i++)
+	{
+		list.insert(i);
+	}
+
+	std::vector<int> values;
+	for (auto value : list.range(25, 30))
+	{
+		values.push_back(value);
+	}
+	ASSERT_EQ(values, (std::vector<int>{ 25, 26, 27, 28, 29 }));
+
+	ASSERT_TRUE(list.range(30, 25).empty());
+	ASSERT_TRUE(list.range(200, 300).empty());
+}
+
+TEST(SkipList, CopyConstructorTest)
+{
+	skip_list<int> testList{ 6523, 2819, 9302, 43829, 9201, 3920, 932 };
+
+	//Try to make a copy
+	skip_list<int> copy = skip_list<int>(testList);
+	//Test if the copy and the original are equal to each other
+	ASSERT_TRUE(std::equal(copy.begin(), copy.end(), testList.begin(), testList.end()));
+	//Test if the copy can still be searched and iterated backwards
+	ASSERT_TRUE(copy.find(9201) != copy.end());
+	ASSERT_EQ(*(--copy.end()), 43829);
+}
+
+TEST(SkipList, MoveAssignmentTest)
+{
+	skip_list<int> testList{ 6523, 2819, 9302, 43829, 9201, 3920, 932 };
+
+	//Store the original size
+	int originalSize = testList.getSize();
+
+	//Assign the list to the movedList via std::move
+	skip_list<int> movedList;
+	movedList = std::move(testList);
+
+	//Test if the movedList has the same size and the original list's size is 0
+	ASSERT_TRUE(movedList.getSize() == originalSize && testList.getSize() == 0);
+	ASSERT_TRUE(testList.begin() == testList.end());
+}
+
+TEST(SkipList, CustomComparerTest)
+{
+	skip_list<int> list{ [](const int& a, const int& b) { return a > b; } };
+	list.insert(1);
+	list.insert(3);
+	list.insert(2);
+
+	ASSERT_EQ(*list.begin(), 3);
+	ASSERT_EQ(*list.maximum(), 1);
+}
+
+TEST(SkipList, PrintTest)
+{
+	skip_list<int> list{ 50, 30, 20, 40 };
+
+	//Create a string stream
+	std::stringstream stream;
+
+	//Print the list to the stream
+	stream << list;
+
+	//Test if the string is the same as the expected output
+	ASSERT_EQ(stream.str(), std::string("[20, 30, 40, 50]"));
+}